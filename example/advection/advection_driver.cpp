@@ -63,17 +63,21 @@ TaskList AdvectionDriver::MakeTaskList(MeshBlock *pmb, int stage) {
   TaskList tl;
   // we're going to populate our list with multiple kinds of tasks
   // these lambdas just clean up the interface to adding tasks of the relevant kinds
-  auto AddMyTask = [&tl, pmb, stage, this](BlockStageNamesIntegratorTaskFunc func,
+  // the names label the tasks in the profiler summary
+  auto AddMyTask = [&tl, pmb, stage, this](const std::string &name,
+                                           BlockStageNamesIntegratorTaskFunc func,
                                            TaskID dep) {
-    return tl.AddTask<BlockStageNamesIntegratorTask>(func, dep, pmb, stage, stage_name,
-                                                     integrator);
+    return tl.AddTask<BlockStageNamesIntegratorTask>(name, func, dep, pmb, stage,
+                                                     stage_name, integrator);
   };
-  auto AddContainerTask = [&tl](ContainerTaskFunc func, TaskID dep, Container<Real> &rc) {
-    return tl.AddTask<ContainerTask>(func, dep, rc);
+  auto AddContainerTask = [&tl](const std::string &name, ContainerTaskFunc func,
+                                TaskID dep, Container<Real> &rc) {
+    return tl.AddTask<ContainerTask>(name, func, dep, rc);
   };
-  auto AddTwoContainerTask = [&tl](TwoContainerTaskFunc f, TaskID dep,
-                                   Container<Real> &rc1, Container<Real> &rc2) {
-    return tl.AddTask<TwoContainerTask>(f, dep, rc1, rc2);
+  auto AddTwoContainerTask = [&tl](const std::string &name, TwoContainerTaskFunc f,
+                                   TaskID dep, Container<Real> &rc1,
+                                   Container<Real> &rc2) {
+    return tl.AddTask<TwoContainerTask>(name, f, dep, rc1, rc2);
   };
 
   TaskID none(0);
@@ -94,31 +98,43 @@ TaskList AdvectionDriver::MakeTaskList(MeshBlock *pmb, int stage) {
   // effectively, sc1 = sc0 + dudt*dt
   Container<Real> &sc1 = pmb->real_containers.Get(stage_name[stage]);
 
-  auto start_recv = AddContainerTask(Container<Real>::StartReceivingTask, none, sc1);
+  auto start_recv = AddContainerTask("StartReceiving",
+                                     Container<Real>::StartReceivingTask, none, sc1);
 
-  auto advect_flux = AddContainerTask(advection_package::CalculateFluxes, none, sc0);
+  auto advect_flux =
+      AddContainerTask("CalculateFluxes", advection_package::CalculateFluxes, none, sc0);
 
-  auto send_flux =
-      AddContainerTask(Container<Real>::SendFluxCorrectionTask, advect_flux, sc0);
-  auto recv_flux =
-      AddContainerTask(Container<Real>::ReceiveFluxCorrectionTask, advect_flux, sc0);
+  auto send_flux = AddContainerTask(
+      "SendFluxCorrection", Container<Real>::SendFluxCorrectionTask, advect_flux, sc0);
+  auto recv_flux = AddContainerTask("ReceiveFluxCorrection",
+                                    Container<Real>::ReceiveFluxCorrectionTask,
+                                    advect_flux, sc0);
 
   // compute the divergence of fluxes of conserved variables
-  auto flux_div =
-      AddTwoContainerTask(parthenon::Update::FluxDivergence, recv_flux, sc0, dudt);
+  auto flux_div = AddTwoContainerTask(
+      "FluxDivergence", parthenon::Update::FluxDivergence, recv_flux, sc0, dudt);
 
   // apply du/dt to all independent fields in the container
-  auto update_container = AddMyTask(UpdateContainer, flux_div);
+  auto update_container = AddMyTask("UpdateContainer", UpdateContainer, flux_div);
 
   // update ghost cells
-  auto send =
-      AddContainerTask(Container<Real>::SendBoundaryBuffersTask, update_container, sc1);
-  auto recv = AddContainerTask(Container<Real>::ReceiveBoundaryBuffersTask, send, sc1);
-  auto fill_from_bufs = AddContainerTask(Container<Real>::SetBoundariesTask, recv, sc1);
-  auto clear_comm_flags =
-      AddContainerTask(Container<Real>::ClearBoundaryTask, fill_from_bufs, sc1);
+  auto send = AddContainerTask("SendBoundaryBuffers",
+                               Container<Real>::SendBoundaryBuffersTask,
+                               update_container, sc1);
+  auto recv = AddContainerTask("ReceiveBoundaryBuffers",
+                               Container<Real>::ReceiveBoundaryBuffersTask, send, sc1);
+  auto fill_from_bufs =
+      AddContainerTask("SetBoundaries", Container<Real>::SetBoundariesTask, recv, sc1);
+  auto clear_comm_flags = AddContainerTask(
+      "ClearBoundary", Container<Real>::ClearBoundaryTask, fill_from_bufs, sc1);
+
+  // the other ranks wait for the messages these tasks start
+  tl.SetTaskPriority(start_recv, TaskPriority::communication);
+  tl.SetTaskPriority(send_flux, TaskPriority::communication);
+  tl.SetTaskPriority(send, TaskPriority::communication);
 
   auto prolongBound = tl.AddTask<BlockTask>(
+      "ProlongateBoundaries",
       [](MeshBlock *pmb) {
         pmb->pbval->ProlongateBoundaries(0.0, 0.0);
         return TaskStatus::complete;
@@ -126,15 +142,18 @@ TaskList AdvectionDriver::MakeTaskList(MeshBlock *pmb, int stage) {
       fill_from_bufs, pmb);
 
   // set physical boundaries
-  auto set_bc = AddContainerTask(parthenon::ApplyBoundaryConditions, prolongBound, sc1);
+  auto set_bc = AddContainerTask("ApplyBoundaryConditions",
+                                 parthenon::ApplyBoundaryConditions, prolongBound, sc1);
 
   // fill in derived fields
-  auto fill_derived =
-      AddContainerTask(parthenon::FillDerivedVariables::FillDerived, set_bc, sc1);
+  auto fill_derived = AddContainerTask(
+      "FillDerived", parthenon::FillDerivedVariables::FillDerived, set_bc, sc1);
 
   // estimate next time step
   if (stage == integrator->nstages) {
+    // the rank reduces the time step once all blocks have estimated theirs
     auto new_dt = AddContainerTask(
+        "EstimateTimestep",
         [](Container<Real> &rc) {
           MeshBlock *pmb = rc.pmy_block;
           pmb->SetBlockTimestep(parthenon::Update::EstimateTimestep(rc));
@@ -145,6 +164,7 @@ TaskList AdvectionDriver::MakeTaskList(MeshBlock *pmb, int stage) {
     // Update refinement
     if (pmesh->adaptive) {
       auto tag_refine = tl.AddTask<BlockTask>(
+          "CheckRefinement",
           [](MeshBlock *pmb) {
             pmb->pmr->CheckRefinementCondition();
             return TaskStatus::complete;
@@ -158,6 +178,7 @@ TaskList AdvectionDriver::MakeTaskList(MeshBlock *pmb, int stage) {
     // bugs, e.g. the containers for rk stages won't have the same variables as the "base"
     // container, likely leading to strange errors and/or segfaults.
     auto purge_stages = tl.AddTask<BlockTask>(
+        "PurgeStages",
         [](MeshBlock *pmb) {
           pmb->real_containers.PurgeNonBase();
           return TaskStatus::complete;
@@ -167,4 +188,26 @@ TaskList AdvectionDriver::MakeTaskList(MeshBlock *pmb, int stage) {
   return tl;
 }
 
+// The time step is reduced over all ranks while the blocks tag their refinement and
+// purge their stages, instead of after all tasks of the step have completed.
+void AdvectionDriver::AddRankTasks(TaskRegion *region, int stage) {
+  if (stage != integrator->nstages) return;
+  TaskID none(0);
+  const int rank = region->Size() - 1;
+  auto start_reduce = region->AddCollectiveTask<SimpleTask>(
+      rank, "EstimateTimestep",
+      [this]() {
+        StartTimeStepReduction();
+        return TaskStatus::complete;
+      },
+      none);
+  (*region)[rank].SetTaskName(start_reduce, "StartTimeStepReduction");
+  (*region)[rank].AddTask<SimpleTask>(
+      "TimeStepReduced",
+      [this]() {
+        return TimeStepReduced() ? TaskStatus::complete : TaskStatus::incomplete;
+      },
+      start_reduce);
+}
+
 } // namespace advection_example
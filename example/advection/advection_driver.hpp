@@ -35,6 +35,7 @@ class AdvectionDriver : public MultiStageBlockTaskDriver {
   //       DriverUtils::ConstructAndExecuteBlockTasks (driver.hpp)
   //         AdvectionDriver::MakeTaskList (advection.cpp)
   TaskList MakeTaskList(MeshBlock *pmb, int stage);
+  void AddRankTasks(TaskRegion *region, int stage);
 };
 
 // demonstrate making a custom Task type
@@ -81,17 +81,17 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
 AmrTag CheckRefinement(Container<Real> &rc) {
   MeshBlock *pmb = rc.pmy_block;
   // refine on advected, for example.  could also be a derived quantity
-  CellVariable<Real> &v = rc.Get("advected");
-  Real vmin = 1.0;
-  Real vmax = 0.0;
-  for (int k = 0; k < pmb->ncells3; k++) {
-    for (int j = 0; j < pmb->ncells2; j++) {
-      for (int i = 0; i < pmb->ncells1; i++) {
-        vmin = (v(k, j, i) < vmin ? v(k, j, i) : vmin);
-        vmax = (v(k, j, i) > vmax ? v(k, j, i) : vmax);
-      }
-    }
-  }
+  ParArrayND<Real> &v = rc.Get("advected").data;
+  // the reducers initialize both to the identity of min and max
+  Real vmin, vmax;
+  pmb->par_reduce(
+      "advection_package::CheckRefinement", 0, pmb->ncells3 - 1, 0, pmb->ncells2 - 1, 0,
+      pmb->ncells1 - 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lmin, Real &lmax) {
+        lmin = (v(k, j, i) < lmin ? v(k, j, i) : lmin);
+        lmax = (v(k, j, i) > lmax ? v(k, j, i) : lmax);
+      },
+      Kokkos::Min<Real>(vmin), Kokkos::Max<Real>(vmax));
   auto pkg = pmb->packages["advection_package"];
   const auto &refine_tol = pkg->Param<Real>("refine_tol");
   const auto &derefine_tol = pkg->Param<Real>("derefine_tol");
@@ -187,15 +187,14 @@ Real EstimateTimestep(Container<Real> &rc) {
   auto &coords = pmb->coords;
 
   // this is obviously overkill for this constant velocity problem
-  for (int k = ks; k <= ke; k++) {
-    for (int j = js; j <= je; j++) {
-      for (int i = is; i <= ie; i++) {
-        min_dt = std::min(min_dt, coords.Dx(X1DIR, k, j, i) / std::abs(vx));
-        min_dt = std::min(min_dt, coords.Dx(X2DIR, k, j, i) / std::abs(vy));
-        min_dt = std::min(min_dt, coords.Dx(X3DIR, k, j, i) / std::abs(vz));
-      }
-    }
-  }
+  pmb->par_reduce(
+      "advection_package::EstimateTimestep", ks, ke, js, je, is, ie,
+      KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lmin_dt) {
+        lmin_dt = std::min(lmin_dt, coords.Dx(X1DIR, k, j, i) / std::abs(vx));
+        lmin_dt = std::min(lmin_dt, coords.Dx(X2DIR, k, j, i) / std::abs(vy));
+        lmin_dt = std::min(lmin_dt, coords.Dx(X3DIR, k, j, i) / std::abs(vz));
+      },
+      Kokkos::Min<Real>(min_dt));
 
   return cfl * min_dt;
 }
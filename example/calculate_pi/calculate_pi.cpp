@@ -102,22 +102,21 @@ AmrTag CheckRefinement(Container<Real> &rc) {
   int ie = pmb->ie;
   int je = pmb->je;
   int ke = pmb->ke;
-  CellVariable<Real> &v = rc.Get("in_or_out");
+  ParArrayND<Real> &v = rc.Get("in_or_out").data;
   AmrTag delta_level = AmrTag::derefine;
-  Real vmin = 1.0;
-  Real vmax = 0.0;
+  // the reducers initialize both to the identity of min and max
+  Real vmin, vmax;
   // loop over all real cells and one layer of ghost cells and refine
   // if the edge of the circle is found.  The one layer of ghost cells
   // catches the case where the edge is between the cell centers of
   // the first/last real cell and the first ghost cell
-  for (int k = ks; k <= ke; k++) {
-    for (int j = js - 1; j <= je + 1; j++) {
-      for (int i = is - 1; i <= ie + 1; i++) {
-        vmin = (v(k, j, i) < vmin ? v(k, j, i) : vmin);
-        vmax = (v(k, j, i) > vmax ? v(k, j, i) : vmax);
-      }
-    }
-  }
+  pmb->par_reduce(
+      "CheckRefinement", ks, ke, js - 1, je + 1, is - 1, ie + 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lmin, Real &lmax) {
+        lmin = (v(k, j, i) < lmin ? v(k, j, i) : lmin);
+        lmax = (v(k, j, i) > lmax ? v(k, j, i) : lmax);
+      },
+      Kokkos::Min<Real>(vmin), Kokkos::Max<Real>(vmax));
   // was the edge of the circle found?
   if (vmax > 0.95 && vmin < 0.05) { // then yes
     delta_level = AmrTag::refine;
@@ -160,13 +159,12 @@ TaskStatus ComputeArea(MeshBlock *pmb) {
   ParArrayND<Real> &v = rc.Get("in_or_out").data;
   const auto &radius = pmb->packages["calculate_pi"]->Param<Real>("radius");
   Real area = 0.0;
-  for (int k = ks; k <= ke; k++) {
-    for (int j = js; j <= je; j++) {
-      for (int i = is; i <= ie; i++) {
-        area += v(k, j, i) * coords.Area(parthenon::X3DIR, k, j, i);
-      }
-    }
-  }
+  pmb->par_reduce(
+      "ComputeArea", ks, ke, js, je, is, ie,
+      KOKKOS_LAMBDA(const int k, const int j, const int i, Real &larea) {
+        larea += v(k, j, i) * coords.Area(parthenon::X3DIR, k, j, i);
+      },
+      area);
   // std::cout << "area = " << area << std::endl;
   area /= (radius * radius);
   // just stash the area somewhere for later
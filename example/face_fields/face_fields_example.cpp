@@ -69,14 +69,15 @@ DriverStatus FaceFieldExample::Execute() {
     int je = pmb->je;
     int ke = pmb->ke;
     Container<Real> &rc = pmb->real_containers.Get();
-    auto &summed = rc.Get("c.c.interpolated_sum");
-    for (int k = ks; k <= ke; k++) {
-      for (int j = js; j <= je; j++) {
-        for (int i = is; i <= ie; i++) {
-          rank_sum += summed(k, j, i);
-        }
-      }
-    }
+    ParArrayND<Real> &summed = rc.Get("c.c.interpolated_sum").data;
+    Real block_sum = 0.0;
+    pmb->par_reduce(
+        "FaceFieldExample::Execute", ks, ke, js, je, is, ie,
+        KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lsum) {
+          lsum += summed(k, j, i);
+        },
+        block_sum);
+    rank_sum += block_sum;
     pmb = pmb->next;
   }
 #ifdef MPI_PARALLEL
@@ -45,6 +45,8 @@ namespace parthenon {
 class MeshBlock;
 class Coordinates;
 class ParameterInput;
+template <typename T>
+class Container;
 
 //--------------------------------------------------------------------------------------
 //! \struct LogicalLocation
@@ -115,9 +117,9 @@ enum class UserHistoryOperation { sum, max, min };
 //----------------------------------------------------------------------------------------
 // function pointer prototypes for user-defined modules set at runtime
 
-using BValFunc = void (*)(MeshBlock *pmb, Coordinates *pco, ParArrayND<Real> &prim,
-                          FaceField &b, Real time, Real dt, int is, int ie, int js,
-                          int je, int ks, int ke, int ngh);
+// user boundary functions are enrolled per face, see bvals/boundary_conditions.hpp; they
+// replace the Athena++ signature, see "Physical boundary conditions" in docs/README.md
+using BValFunc = void (*)(Container<Real> &rc);
 using AMRFlagFunc = int (*)(MeshBlock *pmb);
 using MeshGenFunc = Real (*)(Real x, RegionSize rs);
 using SrcTermFunc = void (*)(MeshBlock *pmb, const Real time, const Real dt,
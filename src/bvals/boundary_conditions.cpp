@@ -15,252 +15,96 @@
 
 #include "bvals/bvals_interfaces.hpp"
 #include "interface/container.hpp"
-#include "interface/container_iterator.hpp"
 #include "mesh/mesh.hpp"
 
 namespace parthenon {
 
-TaskStatus ApplyBoundaryConditions(Container<Real> &rc) {
-  MeshBlock *pmb = rc.pmy_block;
-  const int is = pmb->is;
-  const int js = pmb->js;
-  const int ks = pmb->ks;
-  const int ie = pmb->ie;
-  const int je = pmb->je;
-  const int ke = pmb->ke;
-  const int imax = pmb->ncells1;
-  const int jmax = pmb->ncells2;
-  const int kmax = pmb->ncells3;
-
-  Metadata m;
-  ContainerIterator<Real> citer(rc, {Metadata::Independent});
-  const int nvars = citer.vars.size();
+namespace BoundaryFunction {
 
-  switch (pmb->boundary_flag[BoundaryFace::inner_x1]) {
-  case BoundaryFlag::outflow:
-    for (int n = 0; n < nvars; n++) {
-      CellVariable<Real> &q = *citer.vars[n];
-      for (int l = 0; l < q.GetDim(4); l++) {
-        for (int k = ks; k <= ke; k++) {
-          for (int j = 0; j < jmax; j++) {
-            for (int i = 0; i < is; i++) {
-              q(l, k, j, i) = q(l, k, j, is);
-            }
-          }
-        }
-      }
-    }
+OutflowBC::OutflowBC(const MeshBlock *pmb, BoundaryFace face) {
+  switch (face) {
+  case BoundaryFace::inner_x1:
+    dir = X1DIR, ref = pmb->is;
     break;
-
-  case BoundaryFlag::reflect:
-    for (int n = 0; n < nvars; n++) {
-      CellVariable<Real> &q = *citer.vars[n];
-      bool vec = q.IsSet(Metadata::Vector);
-      for (int l = 0; l < q.GetDim(4); l++) {
-        Real reflect = (l == 0 && vec ? -1.0 : 1.0);
-        for (int k = ks; k <= ke; k++) {
-          for (int j = 0; j < jmax; j++) {
-            for (int i = 0; i < is; i++) {
-              q(l, k, j, i) = reflect * q(l, k, j, 2 * is - i - 1);
-            }
-          }
-        }
-      }
-    }
+  case BoundaryFace::outer_x1:
+    dir = X1DIR, ref = pmb->ie;
+    break;
+  case BoundaryFace::inner_x2:
+    dir = X2DIR, ref = pmb->js;
+    break;
+  case BoundaryFace::outer_x2:
+    dir = X2DIR, ref = pmb->je;
+    break;
+  case BoundaryFace::inner_x3:
+    dir = X3DIR, ref = pmb->ks;
     break;
-
   default:
+    dir = X3DIR, ref = pmb->ke;
     break;
   }
+}
 
-  switch (pmb->boundary_flag[BoundaryFace::outer_x1]) {
-  case BoundaryFlag::outflow:
-    for (int n = 0; n < nvars; n++) {
-      CellVariable<Real> &q = *citer.vars[n];
-      for (int l = 0; l < q.GetDim(4); l++) {
-        for (int k = ks; k <= ke; k++) {
-          for (int j = 0; j < jmax; j++) {
-            for (int i = ie + 1; i < imax; i++) {
-              q(l, k, j, i) = q(l, k, j, ie);
-            }
-          }
-        }
-      }
-    }
+ReflectBC::ReflectBC(const MeshBlock *pmb, BoundaryFace face,
+                     const ParArray1D<int> &vector_dir)
+    : vector_dir(vector_dir) {
+  // ghost cell s - 1 - m mirrors s + m, ghost cell e + 1 + m mirrors e - m
+  switch (face) {
+  case BoundaryFace::inner_x1:
+    dir = X1DIR, mirror = 2 * pmb->is - 1;
     break;
-
-  case BoundaryFlag::reflect:
-    for (int n = 0; n < nvars; n++) {
-      CellVariable<Real> &q = *citer.vars[n];
-      bool vec = q.IsSet(Metadata::Vector);
-      for (int l = 0; l < q.GetDim(4); l++) {
-        Real reflect = (l == 0 && vec ? -1.0 : 1.0);
-        for (int k = ks; k <= ke; k++) {
-          for (int j = 0; j < jmax; j++) {
-            for (int i = ie + 1; i < imax; i++) {
-              q(l, k, j, i) = reflect * q(l, k, j, 2 * ie - i + 1);
-            }
-          }
-        }
-      }
-    }
+  case BoundaryFace::outer_x1:
+    dir = X1DIR, mirror = 2 * pmb->ie + 1;
+    break;
+  case BoundaryFace::inner_x2:
+    dir = X2DIR, mirror = 2 * pmb->js - 1;
+    break;
+  case BoundaryFace::outer_x2:
+    dir = X2DIR, mirror = 2 * pmb->je + 1;
+    break;
+  case BoundaryFace::inner_x3:
+    dir = X3DIR, mirror = 2 * pmb->ks - 1;
     break;
-
   default:
+    dir = X3DIR, mirror = 2 * pmb->ke + 1;
     break;
   }
+}
 
-  if (pmb->pmy_mesh->ndim >= 2) {
-    switch (pmb->boundary_flag[BoundaryFace::inner_x2]) {
-    case BoundaryFlag::outflow:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        for (int l = 0; l < q.GetDim(4); l++) {
-          for (int k = ks; k <= ke; k++) {
-            for (int j = 0; j < js; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = q(l, k, js, i);
-              }
-            }
-          }
-        }
-      }
-      break;
+} // namespace BoundaryFunction
 
-    case BoundaryFlag::reflect:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        bool vec = q.IsSet(Metadata::Vector);
-        for (int l = 0; l < q.GetDim(4); l++) {
-          Real reflect = (l == 1 && vec ? -1.0 : 1.0);
-          for (int k = ks; k <= ke; k++) {
-            for (int j = 0; j < js; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = reflect * q(l, k, 2 * js - j - 1, i);
-              }
-            }
-          }
-        }
-      }
-      break;
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus ApplyBoundaryConditions(Container<Real> &rc)
+//  \brief applies the physical boundary conditions of all faces of the MeshBlock to all
+//  Independent variables, one kernel per face
 
-    default:
-      break;
-    }
+TaskStatus ApplyBoundaryConditions(Container<Real> &rc) {
+  using BoundaryFunction::OutflowBC;
+  using BoundaryFunction::ReflectBC;
+  MeshBlock *pmb = rc.pmy_block;
+  const int ndim = 1 + (pmb->ncells2 > 1) + (pmb->ncells3 > 1);
 
-    switch (pmb->boundary_flag[BoundaryFace::outer_x2]) {
+  // faces are processed in the order x1, x2, x3 so that the ghost cells at edges and
+  // corners are set from ghost cells that were already filled
+  for (int f = 0; f < 2 * ndim; f++) {
+    const BoundaryFace face = static_cast<BoundaryFace>(f);
+    switch (pmb->boundary_flag[face]) {
     case BoundaryFlag::outflow:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        for (int l = 0; l < q.GetDim(4); l++) {
-          for (int k = ks; k <= ke; k++) {
-            for (int j = je + 1; j < jmax; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = q(l, k, je, i);
-              }
-            }
-          }
-        }
-      }
+      ApplyBoundaryFunctor(rc, face, OutflowBC(pmb, face));
       break;
-
-    case BoundaryFlag::reflect:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        bool vec = q.IsSet(Metadata::Vector);
-        for (int l = 0; l < q.GetDim(4); l++) {
-          Real reflect = (l == 1 && vec ? -1.0 : 1.0);
-          for (int k = ks; k <= ke; k++) {
-            for (int j = je + 1; j < jmax; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = reflect * q(l, k, 2 * je - j + 1, i);
-              }
-            }
-          }
-        }
-      }
-      break;
-
-    default:
+    case BoundaryFlag::reflect: {
+      const auto vector_dir = rc.PackVectorDirections({Metadata::Independent});
+      ApplyBoundaryFunctor(rc, face, ReflectBC(pmb, face, vector_dir));
       break;
     }
-  } // if ndim>=2
-
-  if (pmb->pmy_mesh->ndim >= 3) {
-    switch (pmb->boundary_flag[BoundaryFace::inner_x3]) {
-    case BoundaryFlag::outflow:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        for (int l = 0; l < q.GetDim(4); l++) {
-          for (int k = 0; k < ks; k++) {
-            for (int j = 0; j < jmax; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = q(l, ks, j, i);
-              }
-            }
-          }
-        }
-      }
-      break;
-
-    case BoundaryFlag::reflect:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        bool vec = q.IsSet(Metadata::Vector);
-        for (int l = 0; l < q.GetDim(4); l++) {
-          Real reflect = (l == 2 && vec ? -1.0 : 1.0);
-          for (int k = 0; k < ks; k++) {
-            for (int j = 0; j < jmax; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = reflect * q(l, 2 * ks - k - 1, j, i);
-              }
-            }
-          }
-        }
-      }
-      break;
-
-    default:
+    case BoundaryFlag::user: {
+      BValFunc user_bc = pmb->pmy_mesh->GetUserBoundaryFunction(face);
+      if (user_bc != nullptr) user_bc(rc);
       break;
     }
-
-    switch (pmb->boundary_flag[BoundaryFace::outer_x3]) {
-    case BoundaryFlag::outflow:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        for (int l = 0; l < q.GetDim(4); l++) {
-          for (int k = ke + 1; k < kmax; k++) {
-            for (int j = 0; j < jmax; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = q(l, ke, j, i);
-              }
-            }
-          }
-        }
-      }
-      break;
-
-    case BoundaryFlag::reflect:
-      for (int n = 0; n < nvars; n++) {
-        CellVariable<Real> &q = *citer.vars[n];
-        bool vec = q.IsSet(Metadata::Vector);
-        for (int l = 0; l < q.GetDim(4); l++) {
-          Real reflect = (l == 2 && vec ? -1.0 : 1.0);
-          for (int k = ke + 1; k < kmax; k++) {
-            for (int j = 0; j < jmax; j++) {
-              for (int i = 0; i < imax; i++) {
-                q(l, k, j, i) = reflect * q(l, 2 * ke - k + 1, j, i);
-              }
-            }
-          }
-        }
-      }
-      break;
-
     default:
       break;
     }
-  } // if ndim >= 3
+  }
 
   return TaskStatus::complete;
 }
@@ -13,14 +13,124 @@
 
 #ifndef BVALS_BOUNDARY_CONDITIONS_HPP_
 #define BVALS_BOUNDARY_CONDITIONS_HPP_
+//! \file boundary_conditions.hpp
+//  \brief physical boundary conditions applied by device kernels
+//
+// A physical boundary condition is a device-callable functor
+//   KOKKOS_INLINE_FUNCTION
+//   void operator()(const VariablePack<Real> &q, int n, int k, int j, int i) const
+// that sets the ghost cell (k, j, i) of pack entry n.  ApplyBoundaryFunctor() calls it
+// for all ghost cells of one face and all Independent variables in a single kernel.
+// User-enrolled BValFuncs are host functions that are expected to do the same, e.g.
+//   void MyInnerX1(Container<Real> &rc) {
+//     ApplyBoundaryFunctor(rc, BoundaryFace::inner_x1, MyInflowBC(...));
+//   }
 
 #include "basic_types.hpp"
+#include "bvals/bvals_interfaces.hpp"
 #include "interface/container.hpp"
+#include "interface/metadata.hpp"
+#include "interface/variable_pack.hpp"
+#include "mesh/mesh.hpp"
 
 namespace parthenon {
 
 TaskStatus ApplyBoundaryConditions(Container<Real> &rc);
 
+//----------------------------------------------------------------------------------------
+//! \fn void ApplyBoundaryFunctor(Container<Real> &rc, BoundaryFace face,
+//                                const Function &function)
+//  \brief launches function on all ghost cells of face for all Independent variables
+
+template <typename Function>
+void ApplyBoundaryFunctor(Container<Real> &rc, BoundaryFace face,
+                          const Function &function) {
+  MeshBlock *pmb = rc.pmy_block;
+  auto q = rc.PackVariables({Metadata::Independent});
+  const int nvar = q.GetDim(4);
+  if (nvar == 0) return;
+
+  // the ghost cells of x2 (x3) faces span the x1 (x1 and x2) ghost zones, which have
+  // to be set before
+  int il = 0, iu = pmb->ncells1 - 1, jl = 0, ju = pmb->ncells2 - 1;
+  int kl = 0, ku = pmb->ncells3 - 1;
+  switch (face) {
+  case BoundaryFace::inner_x1:
+    iu = pmb->is - 1, kl = pmb->ks, ku = pmb->ke;
+    break;
+  case BoundaryFace::outer_x1:
+    il = pmb->ie + 1, kl = pmb->ks, ku = pmb->ke;
+    break;
+  case BoundaryFace::inner_x2:
+    ju = pmb->js - 1, kl = pmb->ks, ku = pmb->ke;
+    break;
+  case BoundaryFace::outer_x2:
+    jl = pmb->je + 1, kl = pmb->ks, ku = pmb->ke;
+    break;
+  case BoundaryFace::inner_x3:
+    ku = pmb->ks - 1;
+    break;
+  case BoundaryFace::outer_x3:
+    kl = pmb->ke + 1;
+    break;
+  default:
+    return;
+  }
+  pmb->par_for(
+      "ApplyBoundaryFunctor", 0, nvar - 1, kl, ku, jl, ju, il, iu,
+      KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+        function(q, n, k, j, i);
+      });
+}
+
+namespace BoundaryFunction {
+
+//----------------------------------------------------------------------------------------
+//! \struct OutflowBC
+//  \brief copies the last active cell next to the face into the ghost cells
+
+struct OutflowBC {
+  OutflowBC(const MeshBlock *pmb, BoundaryFace face);
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const VariablePack<Real> &q, const int n, const int k, const int j,
+                  const int i) const {
+    if (dir == X1DIR)
+      q(n, k, j, i) = q(n, k, j, ref);
+    else if (dir == X2DIR)
+      q(n, k, j, i) = q(n, k, ref, i);
+    else
+      q(n, k, j, i) = q(n, ref, j, i);
+  }
+
+  int dir; // direction normal to the face
+  int ref; // index of the last active cell along dir
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct ReflectBC
+//  \brief mirrors the active cells at the face, flipping the normal vector component
+
+struct ReflectBC {
+  // vector_dir(n) is the direction of vector component n of the pack, 0 otherwise
+  ReflectBC(const MeshBlock *pmb, BoundaryFace face, const ParArray1D<int> &vector_dir);
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const VariablePack<Real> &q, const int n, const int k, const int j,
+                  const int i) const {
+    const Real sign = (vector_dir(n) == dir ? -1.0 : 1.0);
+    if (dir == X1DIR)
+      q(n, k, j, i) = sign * q(n, k, j, mirror - i);
+    else if (dir == X2DIR)
+      q(n, k, j, i) = sign * q(n, k, mirror - j, i);
+    else
+      q(n, k, j, i) = sign * q(n, mirror - k, j, i);
+  }
+
+  int dir;    // direction normal to the face
+  int mirror; // sum of the indices of a ghost cell and its image along dir
+  ParArray1D<int> vector_dir;
+};
+
+} // namespace BoundaryFunction
 } // namespace parthenon
 
 #endif // BVALS_BOUNDARY_CONDITIONS_HPP_
@@ -40,6 +40,8 @@ BoundaryFlag GetBoundaryFlag(const std::string &input_string) {
     return BoundaryFlag::outflow;
   } else if (input_string == "periodic") {
     return BoundaryFlag::periodic;
+  } else if (input_string == "user") {
+    return BoundaryFlag::user;
   } else if (input_string == "none") {
     return BoundaryFlag::undef;
   } else if (input_string == "block") {
@@ -71,6 +73,8 @@ std::string GetBoundaryString(BoundaryFlag input_flag) {
     return "outflow";
   case BoundaryFlag::periodic:
     return "periodic";
+  case BoundaryFlag::user:
+    return "user";
   default:
     std::stringstream msg;
     msg << "### FATAL ERROR in GetBoundaryString" << std::endl
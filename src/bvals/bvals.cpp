@@ -54,6 +54,7 @@ BoundaryValues::BoundaryValues(MeshBlock *pmb, BoundaryFlag *input_bcs,
     switch (block_bcs[i]) {
     case BoundaryFlag::reflect:
     case BoundaryFlag::outflow:
+    case BoundaryFlag::user:
       apply_bndry_fn_[i] = true;
       break;
     default: // already initialized to false in class
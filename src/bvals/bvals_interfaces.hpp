@@ -22,6 +22,7 @@
 // TODO(felker): deduplicate forward declarations
 // TODO(felker): consider moving enums and structs in a new file? bvals_structs.hpp?
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -94,7 +95,7 @@ enum BoundaryFace {
 // int to index raw arrays (not ParArrayNDs)--> enumerator vals are explicitly specified
 
 // identifiers for boundary conditions
-enum class BoundaryFlag { block = -1, undef, reflect, outflow, periodic };
+enum class BoundaryFlag { block = -1, undef, reflect, outflow, periodic, user };
 
 // identifiers for types of neighbor blocks (connectivity with current MeshBlock)
 enum class NeighborConnect {
@@ -165,17 +166,33 @@ struct NeighborBlock { // aggregate and POD type. Inheritance breaks standard-la
 // one for each type of "BoundaryQuantity" corresponding to BoundaryVariable
 
 template <int n = 56>
-struct BoundaryData { // aggregate and POD (even when MPI_PARALLEL is defined)
+struct BoundaryData { // aggregate (even when MPI_PARALLEL is defined)
   static constexpr int kMaxNeighbor = n;
   // KGF: "nbmax" only used in bvals_var.cpp, Init/DestroyBoundaryData()
   int nbmax; // actual maximum number of neighboring MeshBlocks
   // currently, sflag[] is only used by Multgrid (send buffers are reused each stage in
   // red-black comm. pattern; need to check if they are available)
-  BoundaryStatus flag[kMaxNeighbor], sflag[kMaxNeighbor];
+  // flag[] is set to BoundaryStatus::arrived by the progress thread if enabled
+  std::atomic<BoundaryStatus> flag[kMaxNeighbor];
+  BoundaryStatus sflag[kMaxNeighbor];
   Real *send[kMaxNeighbor], *recv[kMaxNeighbor];
+  // allocated sizes of send[] and recv[], 0 for buffer ids without a neighbor
+  int send_size[kMaxNeighbor], recv_size[kMaxNeighbor];
 #ifdef MPI_PARALLEL
   MPI_Request req_send[kMaxNeighbor], req_recv[kMaxNeighbor];
+  // set to BoundaryStatus::completed by the progress thread once req_send[] completed
+  std::atomic<BoundaryStatus> send_status[kMaxNeighbor];
 #endif
+  // buffers of neighbors on other ranks of this node, placed in the shared memory of the
+  // receiving rank by NodeBuffers::Setup(): the receive buffer of the neighbor that this
+  // block loads directly and this block's own receive buffer, nullptr for other neighbors
+  Real *node_send[kMaxNeighbor], *node_recv[kMaxNeighbor];
+  // set to 1 by the sender once the buffer is loaded, reset to 0 by the receiver in
+  // ClearBoundary() once the buffer may be loaded again
+  std::atomic<int> *node_sflag[kMaxNeighbor], *node_rflag[kMaxNeighbor];
+  // segments of the buffers of the neighborhood collective placed by
+  // NeighborExchange::Build(), nullptr for neighbors that are not part of it
+  Real *coll_send[kMaxNeighbor], *coll_recv[kMaxNeighbor];
 };
 
 //----------------------------------------------------------------------------------------
@@ -216,7 +233,8 @@ class BoundaryBuffer {
   virtual ~BoundaryBuffer() {}
 
   // universal buffer management methods for Cartesian grids (unrefined and SMR/AMR)
-  virtual void SendBoundaryBuffers() = 0;
+  // false if some buffers could not be sent yet, which a later call sends
+  virtual bool SendBoundaryBuffers() = 0;
   virtual bool ReceiveBoundaryBuffers() = 0;
   // this next fn is used only during problem initialization in mesh.cpp:
   virtual void ReceiveAndSetBoundariesWithWait() = 0;
@@ -253,11 +271,27 @@ class BoundaryVariable : public BoundaryCommunication, public BoundaryBuffer {
   // (usuallly the std::size_t unsigned integer type)
   std::vector<BoundaryVariable *>::size_type bvar_index;
 
-  virtual int ComputeVariableBufferSize(const NeighborIndexes &ni, int cng) = 0;
+  // size of the buffer sent to a neighbor dlevel = -1, 0, 1 levels finer
+  virtual int ComputeVariableBufferSize(const NeighborIndexes &ni, int cng,
+                                        int dlevel) = 0;
   virtual int ComputeFluxCorrectionBufferSize(const NeighborIndexes &ni, int cng) = 0;
 
+  // whether the variable buffers of a neighbor on another rank of this node are exchanged
+  // in shared memory instead of by MPI messages
+  bool NodeShared(const NeighborBlock &nb) const;
+  // the shared buffers of a neighbor, see BoundaryData::node_send and node_recv
+  void SetNodeSend(const NeighborBlock &nb, Real *buf, std::atomic<int> *flag);
+  void SetNodeRecv(const NeighborBlock &nb, Real *buf, std::atomic<int> *flag);
+  // whether the variable buffers of a neighbor on another rank are exchanged by the
+  // neighborhood collective instead of point-to-point messages
+  bool NeighborCollective(const NeighborBlock &nb) const;
+  // the segments of the collective, see BoundaryData::coll_send and coll_recv
+  void SetCollectiveSend(const NeighborBlock &nb, Real *buf);
+  void SetCollectiveRecv(const NeighborBlock &nb, Real *buf);
+  bool ExternalBuffers() const { return external_buffers_; }
+
   // BoundaryBuffer public functions with shared implementations
-  void SendBoundaryBuffers() override;
+  bool SendBoundaryBuffers() override;
   bool ReceiveBoundaryBuffers() override;
   void ReceiveAndSetBoundariesWithWait() override;
   void SetBoundaries() override;
@@ -269,11 +303,24 @@ class BoundaryVariable : public BoundaryCommunication, public BoundaryBuffer {
 
   MeshBlock *pmy_block_; // ptr to MeshBlock containing this BoundaryVariable
   Mesh *pmy_mesh_;
+  // set by the derived classes whose variable buffers may be placed outside of bd_var_,
+  // in shared memory or in the buffers of the neighborhood collective
+  bool external_buffers_ = false;
+  // rounds of the neighborhood collective received since the last
+  // ResizeBoundaryBuffers() and whether the buffers of the current round are loaded
+  int coll_round_ = 0;
+  bool coll_loaded_ = false;
+
+  // whether the variable buffers of a neighbor are exchanged by persistent MPI requests
+  bool PointToPoint(const NeighborBlock &nb) const;
+  // the buffer the variable buffer of a neighbor is received in
+  Real *RecvBuffer(const NeighborBlock &nb);
 
   void CopyVariableBufferSameProcess(NeighborBlock &nb, int ssize);
   void CopyFluxCorrectionBufferSameProcess(NeighborBlock &nb, int ssize);
 
   void InitBoundaryData(BoundaryData<> &bd, BoundaryQuantity type);
+  void ResizeBoundaryBuffers(BoundaryData<> &bd, BoundaryQuantity type);
   void DestroyBoundaryData(BoundaryData<> &bd);
 
   // private:
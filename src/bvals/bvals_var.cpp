@@ -20,15 +20,21 @@
 
 #include "bvals/bvals_interfaces.hpp"
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 #include "parthenon_mpi.hpp"
 
+#include "bvals/neighbor_exchange.hpp"
+#include "bvals/node_buffers.hpp"
+#include "bvals/progress_thread.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/profiler.hpp"
 
 namespace parthenon {
 
@@ -37,13 +43,11 @@ BoundaryVariable::BoundaryVariable(MeshBlock *pmb)
 
 //----------------------------------------------------------------------------------------
 //! \fn void BoundaryVariable::InitBoundaryData(BoundaryData<> &bd, BoundaryQuantity type)
-//  \brief Initialize BoundaryData structure
+//  \brief Initialize BoundaryData structure; the buffers are allocated by
+//  ResizeBoundaryBuffers() once the neighbors are known
 
 void BoundaryVariable::InitBoundaryData(BoundaryData<> &bd, BoundaryQuantity type) {
   MeshBlock *pmb = pmy_block_;
-  NeighborIndexes *ni = pmb->pbval->ni;
-  int cng = pmb->cnghost;
-  int size = 0;
 
   bd.nbmax = pmb->pbval->maxneighbor_;
   // KGF: what is happening in the next two conditionals??
@@ -64,24 +68,140 @@ void BoundaryVariable::InitBoundaryData(BoundaryData<> &bd, BoundaryQuantity typ
     bd.sflag[n] = BoundaryStatus::waiting;
     bd.send[n] = nullptr;
     bd.recv[n] = nullptr;
+    bd.send_size[n] = 0;
+    bd.recv_size[n] = 0;
 #ifdef MPI_PARALLEL
     bd.req_send[n] = MPI_REQUEST_NULL;
     bd.req_recv[n] = MPI_REQUEST_NULL;
+    bd.send_status[n] = BoundaryStatus::completed;
 #endif
-    // Allocate buffers, calculating the buffer size (variable vs. flux correction)
+    bd.node_send[n] = nullptr;
+    bd.node_recv[n] = nullptr;
+    bd.node_sflag[n] = nullptr;
+    bd.node_rflag[n] = nullptr;
+    bd.coll_send[n] = nullptr;
+    bd.coll_recv[n] = nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BoundaryVariable::ResizeBoundaryBuffers(BoundaryData<> &bd,
+//                                                   BoundaryQuantity type)
+//  \brief Allocates the buffers of the current neighbors, sized for their refinement
+//  level, and frees the others.  Has to be called after SearchAndSetNeighbors() and
+//  before the persistent MPI requests are created.
+
+void BoundaryVariable::ResizeBoundaryBuffers(BoundaryData<> &bd, BoundaryQuantity type) {
+  MeshBlock *pmb = pmy_block_;
+  int cng = pmb->cnghost;
+  int mylevel = pmb->loc.level;
+
+  int ssize[BoundaryData<>::kMaxNeighbor] = {}, rsize[BoundaryData<>::kMaxNeighbor] = {};
+  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+    NeighborBlock &nb = pmb->pbval->neighbor[n];
+    if (nb.bufid >= bd.nbmax) continue;
+    int dlevel = nb.snb.level - mylevel;
     if (type == BoundaryQuantity::cc || type == BoundaryQuantity::fc) {
-      size = this->ComputeVariableBufferSize(ni[n], cng);
+      // the buffers of neighbors on other ranks of this node are in shared memory, the
+      // ones of the neighborhood collective in its buffers
+      if (&bd == &bd_var_ && (NodeShared(nb) || NeighborCollective(nb))) continue;
+      // buffers of neighbors on this rank are loaded directly into their receive buffer
+      if (nb.snb.rank != Globals::my_rank)
+        ssize[nb.bufid] = ComputeVariableBufferSize(nb.ni, cng, dlevel);
+      rsize[nb.bufid] = ComputeVariableBufferSize(nb.ni, cng, -dlevel);
     } else if (type == BoundaryQuantity::cc_flcor || type == BoundaryQuantity::fc_flcor) {
-      size = this->ComputeFluxCorrectionBufferSize(ni[n], cng);
+      // fluxes are corrected by finer neighbors, EMFs also by neighbors on the same level
+      int size = ComputeFluxCorrectionBufferSize(nb.ni, cng);
+      int dmax = (type == BoundaryQuantity::cc_flcor) ? -1 : 0;
+      if (dlevel <= dmax) ssize[nb.bufid] = size;
+      if (-dlevel <= dmax) rsize[nb.bufid] = size;
     } else {
       std::stringstream msg;
-      msg << "### FATAL ERROR in InitBoundaryData" << std::endl
+      msg << "### FATAL ERROR in ResizeBoundaryBuffers" << std::endl
           << "Invalid boundary type is specified." << std::endl;
       ATHENA_ERROR(msg);
     }
-    bd.send[n] = new Real[size];
-    bd.recv[n] = new Real[size];
   }
+
+  // persistent requests refer to the buffers and are freed along with them, the shared
+  // buffers are placed again by NodeBuffers::Setup() and the ones of the collective by
+  // NeighborExchange::Build(), which starts counting rounds again
+  if (&bd == &bd_var_) {
+    coll_round_ = 0;
+    coll_loaded_ = false;
+  }
+  for (int n = 0; n < bd.nbmax; n++) {
+    bd.node_send[n] = nullptr;
+    bd.node_recv[n] = nullptr;
+    bd.node_sflag[n] = nullptr;
+    bd.node_rflag[n] = nullptr;
+    bd.coll_send[n] = nullptr;
+    bd.coll_recv[n] = nullptr;
+    if (ssize[n] != bd.send_size[n]) {
+      delete[] bd.send[n];
+      bd.send[n] = (ssize[n] > 0) ? new Real[ssize[n]] : nullptr;
+      bd.send_size[n] = ssize[n];
+#ifdef MPI_PARALLEL
+      if (bd.req_send[n] != MPI_REQUEST_NULL) MPI_Request_free(&bd.req_send[n]);
+#endif
+    }
+    if (rsize[n] != bd.recv_size[n]) {
+      delete[] bd.recv[n];
+      bd.recv[n] = (rsize[n] > 0) ? new Real[rsize[n]] : nullptr;
+      bd.recv_size[n] = rsize[n];
+#ifdef MPI_PARALLEL
+      if (bd.req_recv[n] != MPI_REQUEST_NULL) MPI_Request_free(&bd.req_recv[n]);
+#endif
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool BoundaryVariable::NodeShared(const NeighborBlock &nb) const
+//  \brief whether the buffers of a neighbor are exchanged in shared memory
+
+bool BoundaryVariable::NodeShared(const NeighborBlock &nb) const {
+  return external_buffers_ && nb.snb.rank != Globals::my_rank &&
+         NodeBuffers::OnNode(nb.snb.rank);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool BoundaryVariable::NeighborCollective(const NeighborBlock &nb) const
+//  \brief whether the buffers of a neighbor are exchanged by the neighborhood collective
+
+bool BoundaryVariable::NeighborCollective(const NeighborBlock &nb) const {
+  return external_buffers_ && nb.snb.rank != Globals::my_rank &&
+         !NodeBuffers::OnNode(nb.snb.rank) && NeighborExchange::Enabled();
+}
+
+bool BoundaryVariable::PointToPoint(const NeighborBlock &nb) const {
+  return nb.snb.rank != Globals::my_rank && !NodeShared(nb) && !NeighborCollective(nb);
+}
+
+Real *BoundaryVariable::RecvBuffer(const NeighborBlock &nb) {
+  if (bd_var_.node_recv[nb.bufid] != nullptr) return bd_var_.node_recv[nb.bufid];
+  if (bd_var_.coll_recv[nb.bufid] != nullptr) return bd_var_.coll_recv[nb.bufid];
+  return bd_var_.recv[nb.bufid];
+}
+
+void BoundaryVariable::SetNodeSend(const NeighborBlock &nb, Real *buf,
+                                   std::atomic<int> *flag) {
+  bd_var_.node_send[nb.bufid] = buf;
+  bd_var_.node_sflag[nb.bufid] = flag;
+}
+
+void BoundaryVariable::SetNodeRecv(const NeighborBlock &nb, Real *buf,
+                                   std::atomic<int> *flag) {
+  bd_var_.node_recv[nb.bufid] = buf;
+  bd_var_.node_rflag[nb.bufid] = flag;
+}
+
+void BoundaryVariable::SetCollectiveSend(const NeighborBlock &nb, Real *buf) {
+  bd_var_.coll_send[nb.bufid] = buf;
+}
+
+void BoundaryVariable::SetCollectiveRecv(const NeighborBlock &nb, Real *buf) {
+  bd_var_.coll_recv[nb.bufid] = buf;
 }
 
 //----------------------------------------------------------------------------------------
@@ -140,34 +260,67 @@ void BoundaryVariable::CopyFluxCorrectionBufferSameProcess(NeighborBlock &nb, in
 // Default / shared implementations of 4x BoundaryBuffer public functions
 
 //----------------------------------------------------------------------------------------
-//! \fn void BoundaryVariable::SendBoundaryBuffers()
-//  \brief Send boundary buffers of variables
+//! \fn bool BoundaryVariable::SendBoundaryBuffers()
+//  \brief Send boundary buffers of variables, false if the shared buffer of a neighbor
+//  on this node is still held by its rank, which a later call sends to
 
-void BoundaryVariable::SendBoundaryBuffers() {
+bool BoundaryVariable::SendBoundaryBuffers() {
   MeshBlock *pmb = pmy_block_;
+  bool sent = true;
   int mylevel = pmb->loc.level;
+  // the buffers are loaded on the host from data written by the kernels of the block
+  pmb->exec_space.fence();
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
     if (bd_var_.sflag[nb.bufid] == BoundaryStatus::completed) continue;
-    int ssize;
+    // on the same process, the buffer is loaded directly into the receive buffer of the
+    // target instead of being copied there afterwards
+    Real *sbuf = bd_var_.send[nb.bufid];
+    BoundaryData<> *ptarget_bdata = nullptr;
+    std::atomic<int> *node_flag = bd_var_.node_sflag[nb.bufid];
+    if (nb.snb.rank == Globals::my_rank) {
+      MeshBlock *ptarget_block = pmy_mesh_->FindMeshBlock(nb.snb.gid);
+      ptarget_bdata = &(ptarget_block->pbval->bvars[bvar_index]->bd_var_);
+      sbuf = ptarget_bdata->recv[nb.targetid];
+    } else if (node_flag != nullptr) {
+      // the same goes for the shared buffer of a neighbor on this node, once its rank
+      // has released it in ClearBoundary().  Until then, the task returns so that the
+      // other tasks of this rank are not held up by the neighbor's rank.
+      if (node_flag->load(std::memory_order_acquire) != 0) {
+        sent = false;
+        continue;
+      }
+      sbuf = bd_var_.node_send[nb.bufid];
+    } else if (bd_var_.coll_send[nb.bufid] != nullptr) {
+      sbuf = bd_var_.coll_send[nb.bufid];
+    }
     if (nb.snb.level == mylevel)
-      ssize = LoadBoundaryBufferSameLevel(bd_var_.send[nb.bufid], nb);
+      LoadBoundaryBufferSameLevel(sbuf, nb);
     else if (nb.snb.level < mylevel)
-      ssize = LoadBoundaryBufferToCoarser(bd_var_.send[nb.bufid], nb);
+      LoadBoundaryBufferToCoarser(sbuf, nb);
     else
-      ssize = LoadBoundaryBufferToFiner(bd_var_.send[nb.bufid], nb);
-    if (nb.snb.rank == Globals::my_rank) {
-      // on the same process
-      CopyVariableBufferSameProcess(nb, ssize);
-    } else {
+      LoadBoundaryBufferToFiner(sbuf, nb);
+    if (ptarget_bdata != nullptr) {
+      ptarget_bdata->flag[nb.targetid] = BoundaryStatus::arrived;
+    } else if (node_flag != nullptr) {
+      node_flag->store(1, std::memory_order_release);
+    } else if (bd_var_.coll_send[nb.bufid] == nullptr) {
 #ifdef MPI_PARALLEL
+      Profiler::ScopedRegion region("MPI_Start");
       MPI_Start(&(bd_var_.req_send[nb.bufid]));
+      ProgressThread::Post(&(bd_var_.req_send[nb.bufid]),
+                           &(bd_var_.send_status[nb.bufid]), BoundaryStatus::completed);
 #endif
     }
 
     bd_var_.sflag[nb.bufid] = BoundaryStatus::completed;
   }
-  return;
+  // the collective is started once every variable of this rank has loaded its buffers
+  if (external_buffers_ && NeighborExchange::Enabled() && !coll_loaded_) {
+    coll_loaded_ = true;
+    NeighborExchange::Loaded();
+  }
+  return sent;
 }
 
 //----------------------------------------------------------------------------------------
@@ -185,12 +338,37 @@ bool BoundaryVariable::ReceiveBoundaryBuffers() {
         bflag = false;
         continue;
       }
+      if (bd_var_.node_rflag[nb.bufid] != nullptr) { // on the same node
+        if (bd_var_.node_rflag[nb.bufid]->load(std::memory_order_acquire) != 1) {
+          bflag = false;
+          continue;
+        }
+        bd_var_.flag[nb.bufid] = BoundaryStatus::arrived;
+        continue;
+      }
+      if (bd_var_.coll_recv[nb.bufid] != nullptr) { // neighborhood collective
+        if (!NeighborExchange::Arrived(coll_round_)) {
+          bflag = false;
+          continue;
+        }
+        bd_var_.flag[nb.bufid] = BoundaryStatus::arrived;
+        continue;
+      }
 #ifdef MPI_PARALLEL
       else { // NOLINT // MPI boundary
-        int test;
-        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &test, MPI_STATUS_IGNORE);
-        MPI_Test(&(bd_var_.req_recv[nb.bufid]), &test, MPI_STATUS_IGNORE);
-        if (!static_cast<bool>(test)) {
+        bool test;
+        {
+          Profiler::ScopedRegion region("MPI_Test");
+          // without the progress thread, polling has to drive the progress of messages
+          if (!ProgressThread::Enabled()) {
+            int probe;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &probe,
+                       MPI_STATUS_IGNORE);
+          }
+          test = ProgressThread::Test(&(bd_var_.req_recv[nb.bufid]),
+                                      &(bd_var_.flag[nb.bufid]), BoundaryStatus::arrived);
+        }
+        if (!test) {
           bflag = false;
           continue;
         }
@@ -211,12 +389,13 @@ void BoundaryVariable::SetBoundaries() {
   int mylevel = pmb->loc.level;
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
+    Real *rbuf = RecvBuffer(nb);
     if (nb.snb.level == mylevel)
-      SetBoundarySameLevel(bd_var_.recv[nb.bufid], nb);
+      SetBoundarySameLevel(rbuf, nb);
     else if (nb.snb.level < mylevel) // only sets the prolongation buffer
-      SetBoundaryFromCoarser(bd_var_.recv[nb.bufid], nb);
+      SetBoundaryFromCoarser(rbuf, nb);
     else
-      SetBoundaryFromFiner(bd_var_.recv[nb.bufid], nb);
+      SetBoundaryFromFiner(rbuf, nb);
     bd_var_.flag[nb.bufid] = BoundaryStatus::completed; // completed
   }
 
@@ -232,16 +411,28 @@ void BoundaryVariable::ReceiveAndSetBoundariesWithWait() {
   int mylevel = pmb->loc.level;
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
+    Real *rbuf = RecvBuffer(nb);
+    if (bd_var_.node_rflag[nb.bufid] != nullptr) {
+      Profiler::ScopedRegion region("NodeBuffers::Wait");
+      while (bd_var_.node_rflag[nb.bufid]->load(std::memory_order_acquire) != 1) {
+        std::this_thread::yield();
+      }
+    } else if (bd_var_.coll_recv[nb.bufid] != nullptr) {
+      NeighborExchange::Wait(coll_round_);
+    }
 #ifdef MPI_PARALLEL
-    if (nb.snb.rank != Globals::my_rank)
-      MPI_Wait(&(bd_var_.req_recv[nb.bufid]), MPI_STATUS_IGNORE);
+    else if (nb.snb.rank != Globals::my_rank) { // NOLINT // MPI boundary
+      Profiler::ScopedRegion region("MPI_Wait");
+      ProgressThread::Wait(&(bd_var_.req_recv[nb.bufid]), &(bd_var_.flag[nb.bufid]),
+                           BoundaryStatus::arrived);
+    }
 #endif
     if (nb.snb.level == mylevel)
-      SetBoundarySameLevel(bd_var_.recv[nb.bufid], nb);
+      SetBoundarySameLevel(rbuf, nb);
     else if (nb.snb.level < mylevel)
-      SetBoundaryFromCoarser(bd_var_.recv[nb.bufid], nb);
+      SetBoundaryFromCoarser(rbuf, nb);
     else
-      SetBoundaryFromFiner(bd_var_.recv[nb.bufid], nb);
+      SetBoundaryFromFiner(rbuf, nb);
     bd_var_.flag[nb.bufid] = BoundaryStatus::completed; // completed
   }
 
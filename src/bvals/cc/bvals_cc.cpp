@@ -21,6 +21,7 @@
 #include "bvals/cc/bvals_cc.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -31,10 +32,12 @@
 #include "parthenon_mpi.hpp"
 
 #include "basic_types.hpp"
+#include "bvals/progress_thread.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 #include "utils/buffer_utils.hpp"
+#include "utils/profiler.hpp"
 
 namespace parthenon {
 
@@ -57,6 +60,7 @@ CellCenteredBoundaryVariable::CellCenteredBoundaryVariable(MeshBlock *pmb,
   }
 
   InitBoundaryData(bd_var_, BoundaryQuantity::cc);
+  external_buffers_ = true;
 #ifdef MPI_PARALLEL
   // KGF: dead code, leaving for now:
   // cc_phys_id_ = pmb->pbval->ReserveTagVariableIDs(1);
@@ -77,26 +81,48 @@ CellCenteredBoundaryVariable::~CellCenteredBoundaryVariable() {
   if (pmy_mesh_->multilevel) DestroyBoundaryData(bd_var_flcor_);
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn bool CellCenteredBoundaryVariable::ReceivedNonZero()
+//  \brief whether the received buffers of the current neighbors hold non-zero values
+
+bool CellCenteredBoundaryVariable::ReceivedNonZero() {
+  MeshBlock *pmb = pmy_block_;
+  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+    NeighborBlock &nb = pmb->pbval->neighbor[n];
+    const Real *buf = RecvBuffer(nb);
+    int size = bd_var_.recv_size[nb.bufid];
+    if (buf != bd_var_.recv[nb.bufid]) {
+      int dlevel = pmb->loc.level - nb.snb.level;
+      size = ComputeVariableBufferSize(nb.ni, pmb->cnghost, dlevel);
+    }
+    for (int m = 0; m < size; m++) {
+      if (buf[m] != 0.0) return true;
+    }
+  }
+  return false;
+}
+
 int CellCenteredBoundaryVariable::ComputeVariableBufferSize(const NeighborIndexes &ni,
-                                                            int cng) {
+                                                            int cng, int dlevel) {
   MeshBlock *pmb = pmy_block_;
   int cng1, cng2, cng3;
   cng1 = cng;
   cng2 = cng * (pmb->block_size.nx2 > 1 ? 1 : 0);
   cng3 = cng * (pmb->block_size.nx3 > 1 ? 1 : 0);
 
-  int size = ((ni.ox1 == 0) ? pmb->block_size.nx1 : NGHOST) *
-             ((ni.ox2 == 0) ? pmb->block_size.nx2 : NGHOST) *
-             ((ni.ox3 == 0) ? pmb->block_size.nx3 : NGHOST);
-  if (pmy_mesh_->multilevel) {
-    int f2c = ((ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2) : NGHOST) *
-              ((ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2) : NGHOST) *
-              ((ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2) : NGHOST);
-    int c2f = ((ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2 + cng1) : cng) *
-              ((ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2 + cng2) : cng) *
-              ((ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2 + cng3) : cng);
-    size = std::max(size, c2f);
-    size = std::max(size, f2c);
+  int size;
+  if (dlevel == 0) { // same
+    size = ((ni.ox1 == 0) ? pmb->block_size.nx1 : NGHOST) *
+           ((ni.ox2 == 0) ? pmb->block_size.nx2 : NGHOST) *
+           ((ni.ox3 == 0) ? pmb->block_size.nx3 : NGHOST);
+  } else if (dlevel < 0) { // to coarser
+    size = ((ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2) : NGHOST) *
+           ((ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2) : NGHOST) *
+           ((ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2) : NGHOST);
+  } else { // to finer
+    size = ((ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2 + cng1) : cng) *
+           ((ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2 + cng2) : cng) *
+           ((ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2 + cng3) : cng);
   }
   size *= nu_ + 1;
   return size;
@@ -158,6 +184,7 @@ int CellCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
   int p = 0;
   pmb->pmr->RestrictCellCenteredValues(var_cc, coarse_buf, nl_, nu_, si, ei, sj, ej, sk,
                                        ek);
+  pmb->exec_space.fence();
   BufferUtility::PackData(coarse_buf, buf, nl_, nu_, si, ei, sj, ej, sk, ek, p);
   return p;
 }
@@ -227,6 +254,7 @@ int CellCenteredBoundaryVariable::LoadBoundaryBufferToFiner(Real *buf,
 
 void CellCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
                                                         const NeighborBlock &nb) {
+  if (!var_allocated) return;
   MeshBlock *pmb = pmy_block_;
   int si, sj, sk, ei, ej, ek;
 
@@ -261,6 +289,7 @@ void CellCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
 
 void CellCenteredBoundaryVariable::SetBoundaryFromCoarser(Real *buf,
                                                           const NeighborBlock &nb) {
+  if (!var_allocated) return;
   MeshBlock *pmb = pmy_block_;
   int si, sj, sk, ei, ej, ek;
   int cng = pmb->cnghost;
@@ -314,6 +343,7 @@ void CellCenteredBoundaryVariable::SetBoundaryFromCoarser(Real *buf,
 
 void CellCenteredBoundaryVariable::SetBoundaryFromFiner(Real *buf,
                                                         const NeighborBlock &nb) {
+  if (!var_allocated) return;
   MeshBlock *pmb = pmy_block_;
   // receive already restricted data
   int si, sj, sk, ei, ej, ek;
@@ -375,41 +405,26 @@ void CellCenteredBoundaryVariable::SetBoundaryFromFiner(Real *buf,
 }
 
 void CellCenteredBoundaryVariable::SetupPersistentMPI() {
+  ResizeBoundaryBuffers(bd_var_, BoundaryQuantity::cc);
+  if (pmy_mesh_->multilevel)
+    ResizeBoundaryBuffers(bd_var_flcor_, BoundaryQuantity::cc_flcor);
+
 #ifdef MPI_PARALLEL
   MeshBlock *pmb = pmy_block_;
   int &mylevel = pmb->loc.level;
 
-  int cng, cng1, cng2, cng3;
-  cng = cng1 = pmb->cnghost;
-  cng2 = (pmy_mesh_->ndim >= 2) ? cng : 0;
-  cng3 = (pmy_mesh_->ndim >= 3) ? cng : 0;
+  int cng = pmb->cnghost;
   int ssize, rsize;
   int tag;
   // Initialize non-polar neighbor communications to other ranks
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
-    if (nb.snb.rank != Globals::my_rank) {
-      if (nb.snb.level == mylevel) { // same
-        ssize = rsize = ((nb.ni.ox1 == 0) ? pmb->block_size.nx1 : NGHOST) *
-                        ((nb.ni.ox2 == 0) ? pmb->block_size.nx2 : NGHOST) *
-                        ((nb.ni.ox3 == 0) ? pmb->block_size.nx3 : NGHOST);
-      } else if (nb.snb.level < mylevel) { // coarser
-        ssize = ((nb.ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2) : NGHOST) *
-                ((nb.ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2) : NGHOST) *
-                ((nb.ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2) : NGHOST);
-        rsize = ((nb.ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2 + cng1) : cng1) *
-                ((nb.ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2 + cng2) : cng2) *
-                ((nb.ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2 + cng3) : cng3);
-      } else { // finer
-        ssize = ((nb.ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2 + cng1) : cng1) *
-                ((nb.ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2 + cng2) : cng2) *
-                ((nb.ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2 + cng3) : cng3);
-        rsize = ((nb.ni.ox1 == 0) ? ((pmb->block_size.nx1 + 1) / 2) : NGHOST) *
-                ((nb.ni.ox2 == 0) ? ((pmb->block_size.nx2 + 1) / 2) : NGHOST) *
-                ((nb.ni.ox3 == 0) ? ((pmb->block_size.nx3 + 1) / 2) : NGHOST);
-      }
-      ssize *= (nu_ + 1);
-      rsize *= (nu_ + 1);
+    // neighbors on this node exchange the variable buffers in shared memory, which is
+    // placed by NodeBuffers::Setup() once all blocks of the node have been set up, and
+    // the ones of the neighborhood collective are placed by NeighborExchange::Build()
+    if (PointToPoint(nb)) {
+      ssize = ComputeVariableBufferSize(nb.ni, cng, nb.snb.level - mylevel);
+      rsize = ComputeVariableBufferSize(nb.ni, cng, mylevel - nb.snb.level);
       // specify the offsets in the view point of the target block: flip ox? signs
 
       // Initialize persistent communication requests attached to specific BoundaryData
@@ -423,29 +438,22 @@ void CellCenteredBoundaryVariable::SetupPersistentMPI() {
         MPI_Request_free(&bd_var_.req_recv[nb.bufid]);
       MPI_Recv_init(bd_var_.recv[nb.bufid], rsize, MPI_ATHENA_REAL, nb.snb.rank, tag,
                     MPI_COMM_WORLD, &(bd_var_.req_recv[nb.bufid]));
-
-      if (pmy_mesh_->multilevel && nb.ni.type == NeighborConnect::face) {
-        int size;
-        if (nb.fid == 0 || nb.fid == 1)
-          size = ((pmb->block_size.nx2 + 1) / 2) * ((pmb->block_size.nx3 + 1) / 2);
-        else if (nb.fid == 2 || nb.fid == 3)
-          size = ((pmb->block_size.nx1 + 1) / 2) * ((pmb->block_size.nx3 + 1) / 2);
-        else // (nb.fid == 4 || nb.fid == 5)
-          size = ((pmb->block_size.nx1 + 1) / 2) * ((pmb->block_size.nx2 + 1) / 2);
-        size *= (nu_ + 1);
-        if (nb.snb.level < mylevel) { // send to coarser
-          tag = pmb->pbval->CreateBvalsMPITag(nb.snb.lid, nb.targetid, cc_flx_phys_id_);
-          if (bd_var_flcor_.req_send[nb.bufid] != MPI_REQUEST_NULL)
-            MPI_Request_free(&bd_var_flcor_.req_send[nb.bufid]);
-          MPI_Send_init(bd_var_flcor_.send[nb.bufid], size, MPI_ATHENA_REAL, nb.snb.rank,
-                        tag, MPI_COMM_WORLD, &(bd_var_flcor_.req_send[nb.bufid]));
-        } else if (nb.snb.level > mylevel) { // receive from finer
-          tag = pmb->pbval->CreateBvalsMPITag(pmb->lid, nb.bufid, cc_flx_phys_id_);
-          if (bd_var_flcor_.req_recv[nb.bufid] != MPI_REQUEST_NULL)
-            MPI_Request_free(&bd_var_flcor_.req_recv[nb.bufid]);
-          MPI_Recv_init(bd_var_flcor_.recv[nb.bufid], size, MPI_ATHENA_REAL, nb.snb.rank,
-                        tag, MPI_COMM_WORLD, &(bd_var_flcor_.req_recv[nb.bufid]));
-        }
+    }
+    if (nb.snb.rank != Globals::my_rank && pmy_mesh_->multilevel &&
+        nb.ni.type == NeighborConnect::face) {
+      int size = ComputeFluxCorrectionBufferSize(nb.ni, cng);
+      if (nb.snb.level < mylevel) { // send to coarser
+        tag = pmb->pbval->CreateBvalsMPITag(nb.snb.lid, nb.targetid, cc_flx_phys_id_);
+        if (bd_var_flcor_.req_send[nb.bufid] != MPI_REQUEST_NULL)
+          MPI_Request_free(&bd_var_flcor_.req_send[nb.bufid]);
+        MPI_Send_init(bd_var_flcor_.send[nb.bufid], size, MPI_ATHENA_REAL, nb.snb.rank,
+                      tag, MPI_COMM_WORLD, &(bd_var_flcor_.req_send[nb.bufid]));
+      } else if (nb.snb.level > mylevel) { // receive from finer
+        tag = pmb->pbval->CreateBvalsMPITag(pmb->lid, nb.bufid, cc_flx_phys_id_);
+        if (bd_var_flcor_.req_recv[nb.bufid] != MPI_REQUEST_NULL)
+          MPI_Request_free(&bd_var_flcor_.req_recv[nb.bufid]);
+        MPI_Recv_init(bd_var_flcor_.recv[nb.bufid], size, MPI_ATHENA_REAL, nb.snb.rank,
+                      tag, MPI_COMM_WORLD, &(bd_var_flcor_.req_recv[nb.bufid]));
       }
     }
   }
@@ -455,15 +463,23 @@ void CellCenteredBoundaryVariable::SetupPersistentMPI() {
 
 void CellCenteredBoundaryVariable::StartReceiving(BoundaryCommSubset phase) {
 #ifdef MPI_PARALLEL
+  Profiler::ScopedRegion region("MPI_Start");
   MeshBlock *pmb = pmy_block_;
   int mylevel = pmb->loc.level;
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
     if (nb.snb.rank != Globals::my_rank) {
-      MPI_Start(&(bd_var_.req_recv[nb.bufid]));
+      if (PointToPoint(nb)) {
+        MPI_Start(&(bd_var_.req_recv[nb.bufid]));
+        ProgressThread::Post(&(bd_var_.req_recv[nb.bufid]), &(bd_var_.flag[nb.bufid]),
+                             BoundaryStatus::arrived);
+      }
       if (phase == BoundaryCommSubset::all && nb.ni.type == NeighborConnect::face &&
-          nb.snb.level > mylevel) // opposite condition in ClearBoundary()
+          nb.snb.level > mylevel) { // opposite condition in ClearBoundary()
         MPI_Start(&(bd_var_flcor_.req_recv[nb.bufid]));
+        ProgressThread::Post(&(bd_var_flcor_.req_recv[nb.bufid]),
+                             &(bd_var_flcor_.flag[nb.bufid]), BoundaryStatus::arrived);
+      }
     }
   }
 #endif
@@ -471,8 +487,17 @@ void CellCenteredBoundaryVariable::StartReceiving(BoundaryCommSubset phase) {
 }
 
 void CellCenteredBoundaryVariable::ClearBoundary(BoundaryCommSubset phase) {
+  // the next round of the neighborhood collective
+  if (coll_loaded_) {
+    coll_round_++;
+    coll_loaded_ = false;
+  }
   for (int n = 0; n < pmy_block_->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmy_block_->pbval->neighbor[n];
+    // a shared buffer that has been set may be loaded by the neighbor again
+    if (bd_var_.node_rflag[nb.bufid] != nullptr &&
+        bd_var_.flag[nb.bufid] == BoundaryStatus::completed)
+      bd_var_.node_rflag[nb.bufid]->store(0, std::memory_order_release);
     bd_var_.flag[nb.bufid] = BoundaryStatus::waiting;
     bd_var_.sflag[nb.bufid] = BoundaryStatus::waiting;
 
@@ -485,10 +510,15 @@ void CellCenteredBoundaryVariable::ClearBoundary(BoundaryCommSubset phase) {
     int mylevel = pmb->loc.level;
     if (nb.snb.rank != Globals::my_rank) {
       // Wait for Isend
-      MPI_Wait(&(bd_var_.req_send[nb.bufid]), MPI_STATUS_IGNORE);
+      Profiler::ScopedRegion region("MPI_Wait");
+      if (PointToPoint(nb))
+        ProgressThread::Wait(&(bd_var_.req_send[nb.bufid]),
+                             &(bd_var_.send_status[nb.bufid]), BoundaryStatus::completed);
       if (phase == BoundaryCommSubset::all && nb.ni.type == NeighborConnect::face &&
           nb.snb.level < mylevel)
-        MPI_Wait(&(bd_var_flcor_.req_send[nb.bufid]), MPI_STATUS_IGNORE);
+        ProgressThread::Wait(&(bd_var_flcor_.req_send[nb.bufid]),
+                             &(bd_var_flcor_.send_status[nb.bufid]),
+                             BoundaryStatus::completed);
     }
 #endif
   }
@@ -27,6 +27,15 @@
 
 namespace parthenon {
 
+// restrict and pack (unpack and apply) the fluxes nl to nu on the face shared with the
+// coarser (finer) neighbor nb, see flux_correction_cc.cpp
+int PackFluxCorrection(MeshBlock *pmb, const ParArrayND<Real> &flux,
+                       const NeighborBlock &nb, const int nl, const int nu, Real *buf,
+                       ParArray1D<Real> &staging);
+void UnpackFluxCorrection(MeshBlock *pmb, const ParArrayND<Real> &flux,
+                          const NeighborBlock &nb, const int nl, const int nu, Real *buf,
+                          ParArray1D<Real> &staging);
+
 //----------------------------------------------------------------------------------------
 //! \class CellCenteredBoundaryVariable
 //  \brief
@@ -40,6 +49,9 @@ class CellCenteredBoundaryVariable : public BoundaryVariable {
   // may want to rebind var_cc to u,u1,u2,w,w1, etc. registers for time integrator logic.
   ParArrayND<Real> var_cc;
   ParArrayND<Real> coarse_buf; // may pass nullptr if mesh refinement is unsupported
+  // false while var_cc stands in for a sparse id that is not allocated on this block;
+  // the received ghost zones are then not set
+  bool var_allocated = true;
 
   // currently, no need to ever switch flux[] ---> keep as reference members (not ptrs)
   // flux[3] w/ 3x empty ParArrayNDs may be passed if mesh refinement is unsupported, but
@@ -51,8 +63,11 @@ class CellCenteredBoundaryVariable : public BoundaryVariable {
   // must correspond to the # of "int *phys_id_" private members, below. Convert to array?
   static constexpr int max_phys_id = 3;
 
+  // whether a neighbor sent non-zero ghost zones, checked for unallocated sparse ids
+  bool ReceivedNonZero();
+
   // BoundaryVariable:
-  int ComputeVariableBufferSize(const NeighborIndexes &ni, int cng) override;
+  int ComputeVariableBufferSize(const NeighborIndexes &ni, int cng, int dlevel) override;
   int ComputeFluxCorrectionBufferSize(const NeighborIndexes &ni, int cng) override;
 
   // BoundaryCommunication:
@@ -81,6 +96,8 @@ class CellCenteredBoundaryVariable : public BoundaryVariable {
 #ifdef MPI_PARALLEL
   int cc_phys_id_, cc_flx_phys_id_;
 #endif
+  // device copy of a flux correction buffer if the device cannot access host memory
+  ParArray1D<Real> flcor_buf_;
 
   void RemapFlux(const int n, const int k, const int jinner, const int jouter,
                  const int i, const Real eps, const ParArrayND<Real> &var,
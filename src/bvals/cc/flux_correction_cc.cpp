@@ -26,127 +26,174 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "parthenon_mpi.hpp"
 
 #include "athena.hpp"
 #include "bvals/cc/bvals_cc.hpp"
+#include "bvals/progress_thread.hpp"
 #include "coordinates/coordinates.hpp"
 #include "globals.hpp"
+#include "kokkos_abstraction.hpp"
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 #include "utils/buffer_utils.hpp"
+#include "utils/profiler.hpp"
 
 namespace parthenon {
 
+namespace {
+// (k, j, i) offsets of one step along the two directions tangential to a face normal to
+// dir, in the order of the buffer (outer direction a, inner direction b)
+KOKKOS_INLINE_FUNCTION
+void TangentialSteps(const int dir, int a[3], int b[3]) {
+  a[0] = (dir != X3DIR), a[1] = (dir == X3DIR), a[2] = 0;
+  b[0] = 0, b[1] = (dir == X1DIR), b[2] = (dir != X1DIR);
+}
+
+// the direction normal to face fid of pmb and the index (fk, fj, fi) of its first face
+int FluxFace(const MeshBlock *pmb, const BoundaryFace fid, int &fk, int &fj, int &fi) {
+  fk = pmb->ks, fj = pmb->js, fi = pmb->is;
+  if (fid == BoundaryFace::inner_x1 || fid == BoundaryFace::outer_x1) {
+    fi += (pmb->ie - pmb->is + 1) * (fid & 1);
+    return X1DIR;
+  } else if (fid == BoundaryFace::inner_x2 || fid == BoundaryFace::outer_x2) {
+    fj += (pmb->je - pmb->js + 1) * (fid & 1);
+    return X2DIR;
+  }
+  fk += (pmb->ke - pmb->ks + 1) * (fid & 1);
+  return X3DIR;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn int PackFluxCorrection(MeshBlock *pmb, const ParArrayND<Real> &flux,
+//                             const NeighborBlock &nb, const int nl, const int nu,
+//                             Real *buf, ParArray1D<Real> &staging)
+//  \brief restricts the fluxes nl to nu on the face shared with the coarser neighbor nb
+//  to the coarse faces, weighted by the face areas, and packs them into buf
+
+int PackFluxCorrection(MeshBlock *pmb, const ParArrayND<Real> &flux,
+                       const NeighborBlock &nb, const int nl, const int nu, Real *buf,
+                       ParArray1D<Real> &staging) {
+  auto &coords = pmb->coords;
+  // face normal to dir at index (fk, fj, fi) and its tangential directions a, b
+  int fk, fj, fi;
+  const int dir = FluxFace(pmb, nb.fid, fk, fj, fi);
+  int sa[3], sb[3];
+  TangentialSteps(dir, sa, sb);
+  const int nx[3] = {pmb->block_size.nx3, pmb->block_size.nx2, pmb->block_size.nx1};
+  const int nxa = sa[0] * nx[0] + sa[1] * nx[1];
+  const int nxb = sb[1] * nx[1] + sb[2] * nx[2];
+  // fine faces (k, j, i) + {0, da} sa + {0, db} sb are restricted to one coarse face
+  const int da = (nxa > 1), db = (nxb > 1);
+  const int nca = da ? nxa / 2 : 1, ncb = db ? nxb / 2 : 1;
+  const int size = (nu - nl + 1) * nca * ncb;
+
+  auto dbuf = BufferUtility::DeviceBuffer(buf, size, staging);
+  pmb->par_for(
+      "SendFluxCorrection", nl, nu, 0, nca - 1, 0, ncb - 1,
+      KOKKOS_LAMBDA(const int nn, const int a, const int b) {
+        int tsa[3], tsb[3];
+        TangentialSteps(dir, tsa, tsb);
+        const int k = fk + 2 * (a * tsa[0] + b * tsb[0]);
+        const int j = fj + 2 * (a * tsa[1] + b * tsb[1]);
+        const int i = fi + 2 * (a * tsa[2] + b * tsb[2]);
+        const int p = ((nn - nl) * nca + a) * ncb + b;
+        if (da == 0 && db == 0) {
+          dbuf(p) = flux(nn, k, j, i);
+          return;
+        }
+        // area weighted average of the fine faces
+        Real tarea = 0.0, tflux = 0.0;
+        for (int ma = 0; ma <= da; ma++) {
+          for (int mb = 0; mb <= db; mb++) {
+            const int kk = k + ma * tsa[0] + mb * tsb[0];
+            const int jj = j + ma * tsa[1] + mb * tsb[1];
+            const int ii = i + ma * tsa[2] + mb * tsb[2];
+            const Real area = coords.Area(dir, kk, jj, ii);
+            tarea += area;
+            tflux += flux(nn, kk, jj, ii) * area;
+          }
+        }
+        dbuf(p) = tflux / tarea;
+      });
+  if (dbuf.data() != buf) pmb->deep_copy(BufferUtility::HostBuffer(buf, size), dbuf);
+  // the buffer is read on the host by the copy or the send that follows
+  pmb->exec_space.fence();
+  return size;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void UnpackFluxCorrection(MeshBlock *pmb, const ParArrayND<Real> &flux,
+//                                const NeighborBlock &nb, const int nl, const int nu,
+//                                Real *buf, ParArray1D<Real> &staging)
+//  \brief overwrites the fluxes nl to nu on the part of the face covered by the finer
+//  neighbor nb with the restricted fluxes in buf
+
+void UnpackFluxCorrection(MeshBlock *pmb, const ParArrayND<Real> &flux,
+                          const NeighborBlock &nb, const int nl, const int nu, Real *buf,
+                          ParArray1D<Real> &staging) {
+  // the face normal to dir at index (fk, fj, fi)
+  int fk, fj, fi;
+  const int dir = FluxFace(pmb, nb.fid, fk, fj, fi);
+  int sa[3], sb[3];
+  TangentialSteps(dir, sa, sb);
+  const int nx[3] = {pmb->block_size.nx3, pmb->block_size.nx2, pmb->block_size.nx1};
+  // the finer neighbor covers half of the face along each tangential direction
+  // with more than one cell, selected by fi1 (inner direction b) and fi2 (outer a)
+  const int nxa = sa[0] * nx[0] + sa[1] * nx[1];
+  const int nxb = sb[1] * nx[1] + sb[2] * nx[2];
+  const int nca = (nxa > 1) ? nxa / 2 : 1, ncb = (nxb > 1) ? nxb / 2 : 1;
+  const int al = (nxa > 1) ? nb.ni.fi2 * nca : 0;
+  const int bl = (nxb > 1) ? nb.ni.fi1 * ncb : 0;
+  const int size = (nu - nl + 1) * nca * ncb;
+
+  auto dbuf = BufferUtility::DeviceBuffer(buf, size, staging);
+  if (dbuf.data() != buf) pmb->deep_copy(dbuf, BufferUtility::HostBuffer(buf, size));
+  pmb->par_for(
+      "ReceiveFluxCorrection", nl, nu, 0, nca - 1, 0, ncb - 1,
+      KOKKOS_LAMBDA(const int nn, const int a, const int b) {
+        int tsa[3], tsb[3];
+        TangentialSteps(dir, tsa, tsb);
+        const int k = fk + (al + a) * tsa[0] + (bl + b) * tsb[0];
+        const int j = fj + (al + a) * tsa[1] + (bl + b) * tsb[1];
+        const int i = fi + (al + a) * tsa[2] + (bl + b) * tsb[2];
+        flux(nn, k, j, i) = dbuf(((nn - nl) * nca + a) * ncb + b);
+      });
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void CellCenteredBoundaryVariable::SendFluxCorrection()
 //  \brief Restrict, pack and send the surface flux to the coarse neighbor(s)
 
 void CellCenteredBoundaryVariable::SendFluxCorrection() {
   MeshBlock *pmb = pmy_block_;
-  auto &coords = pmb->coords;
 
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
     if (nb.ni.type != NeighborConnect::face) break;
     if (bd_var_flcor_.sflag[nb.bufid] == BoundaryStatus::completed) continue;
     if (nb.snb.level == pmb->loc.level - 1) {
-      int p = 0;
-      Real *sbuf = bd_var_flcor_.send[nb.bufid];
-      // x1 direction
-      if (nb.fid == BoundaryFace::inner_x1 || nb.fid == BoundaryFace::outer_x1) {
-        int i = pmb->is + (pmb->ie - pmb->is + 1) * nb.fid;
-        if (pmb->block_size.nx3 > 1) { // 3D
-          for (int nn = nl_; nn <= nu_; nn++) {
-            for (int k = pmb->ks; k <= pmb->ke; k += 2) {
-              for (int j = pmb->js; j <= pmb->je; j += 2) {
-                const Real amm = coords.Area(X1DIR, k, j, i);
-                const Real amp = coords.Area(X1DIR, k, j + 1, i);
-                const Real apm = coords.Area(X1DIR, k + 1, j, i);
-                const Real app = coords.Area(X1DIR, k + 1, j + 1, i);
-                const Real tarea = amm + amp + apm + app;
-                sbuf[p++] =
-                    (x1flux(nn, k, j, i) * amm + x1flux(nn, k, j + 1, i) * amp +
-                     x1flux(nn, k + 1, j, i) * apm + x1flux(nn, k + 1, j + 1, i) * app) /
-                    tarea;
-              }
-            }
-          }
-        } else if (pmb->block_size.nx2 > 1) { // 2D
-          int k = pmb->ks;
-          for (int nn = nl_; nn <= nu_; nn++) {
-            for (int j = pmb->js; j <= pmb->je; j += 2) {
-              const Real am = coords.Area(X1DIR, k, j, i);
-              const Real ap = coords.Area(X1DIR, k, j + 1, i);
-              const Real tarea = am + ap;
-              sbuf[p++] =
-                  (x1flux(nn, k, j, i) * am + x1flux(nn, k, j + 1, i) * ap) / tarea;
-            }
-          }
-        } else { // 1D
-          int k = pmb->ks, j = pmb->js;
-          for (int nn = nl_; nn <= nu_; nn++)
-            sbuf[p++] = x1flux(nn, k, j, i);
-        }
-        // x2 direction
-      } else if (nb.fid == BoundaryFace::inner_x2 || nb.fid == BoundaryFace::outer_x2) {
-        int j = pmb->js + (pmb->je - pmb->js + 1) * (nb.fid & 1);
-        if (pmb->block_size.nx3 > 1) { // 3D
-          for (int nn = nl_; nn <= nu_; nn++) {
-            for (int k = pmb->ks; k <= pmb->ke; k += 2) {
-              for (int i = pmb->is; i <= pmb->ie; i += 2) {
-                const Real area00 = coords.Area(X2DIR, k, j, i);
-                const Real area01 = coords.Area(X2DIR, k, j, i + 1);
-                const Real area10 = coords.Area(X2DIR, k + 1, j, i);
-                const Real area11 = coords.Area(X2DIR, k + 1, j, i + 1);
-                const Real tarea = area00 + area01 + area10 + area11;
-                sbuf[p++] =
-                    (x2flux(nn, k, j, i) * area00 + x2flux(nn, k, j, i + 1) * area01 +
-                     x2flux(nn, k + 1, j, i) * area10 +
-                     x2flux(nn, k + 1, j, i + 1) * area11) /
-                    tarea;
-              }
-            }
-          }
-        } else if (pmb->block_size.nx2 > 1) { // 2D
-          int k = pmb->ks;
-          for (int nn = nl_; nn <= nu_; nn++) {
-            for (int i = pmb->is; i <= pmb->ie; i += 2) {
-              const Real area0 = coords.Area(X2DIR, k, j, i);
-              const Real area1 = coords.Area(X2DIR, k, j, i + 1);
-              const Real tarea = area0 + area1;
-              sbuf[p++] =
-                  (x2flux(nn, k, j, i) * area0 + x2flux(nn, k, j, i + 1) * area1) / tarea;
-            }
-          }
-        }
-        // x3 direction - 3D only
-      } else if (nb.fid == BoundaryFace::inner_x3 || nb.fid == BoundaryFace::outer_x3) {
-        int k = pmb->ks + (pmb->ke - pmb->ks + 1) * (nb.fid & 1);
-        for (int nn = nl_; nn <= nu_; nn++) {
-          for (int j = pmb->js; j <= pmb->je; j += 2) {
-            for (int i = pmb->is; i <= pmb->ie; i += 2) {
-              const Real area00 = coords.Area(X3DIR, k, j, i);
-              const Real area01 = coords.Area(X3DIR, k, j, i + 1);
-              const Real area10 = coords.Area(X3DIR, k, j + 1, i);
-              const Real area11 = coords.Area(X3DIR, k, j + 1, i + 1);
-              const Real tarea = area00 + area01 + area10 + area11;
-              sbuf[p++] =
-                  (x3flux(nn, k, j, i) * area00 + x3flux(nn, k, j, i + 1) * area01 +
-                   x3flux(nn, k, j + 1, i) * area10 +
-                   x3flux(nn, k, j + 1, i + 1) * area11) /
-                  tarea;
-            }
-          }
-        }
-      }
+      int fk, fj, fi;
+      const int dir = FluxFace(pmb, nb.fid, fk, fj, fi);
+      const auto &flux = (dir == X1DIR ? x1flux : (dir == X2DIR ? x2flux : x3flux));
+      const int size =
+          PackFluxCorrection(pmb, flux, nb, nl_, nu_, bd_var_flcor_.send[nb.bufid],
+                             flcor_buf_);
+
       if (nb.snb.rank == Globals::my_rank) { // on the same node
-        CopyFluxCorrectionBufferSameProcess(nb, p);
+        CopyFluxCorrectionBufferSameProcess(nb, size);
       }
 #ifdef MPI_PARALLEL
-      else
+      else { // NOLINT
+        Profiler::ScopedRegion region("MPI_Start");
         MPI_Start(&(bd_var_flcor_.req_send[nb.bufid]));
+        ProgressThread::Post(&(bd_var_flcor_.req_send[nb.bufid]),
+                             &(bd_var_flcor_.send_status[nb.bufid]),
+                             BoundaryStatus::completed);
+      }
 #endif
       bd_var_flcor_.sflag[nb.bufid] = BoundaryStatus::completed;
     }
@@ -161,6 +208,23 @@ void CellCenteredBoundaryVariable::SendFluxCorrection() {
 bool CellCenteredBoundaryVariable::ReceiveFluxCorrection() {
   MeshBlock *pmb = pmy_block_;
   bool bflag = true;
+#ifdef MPI_PARALLEL
+  // poll all outstanding receives from finer neighbors at once; only the receives of
+  // finer neighbors on other ranks are started, all other requests are inactive or null.
+  // The progress thread owns the started requests and sets the flags itself.
+  if (!ProgressThread::Enabled()) {
+    int nout, idx[BoundaryData<>::kMaxNeighbor];
+    {
+      Profiler::ScopedRegion region("MPI_Test");
+      MPI_Testsome(bd_var_flcor_.nbmax, bd_var_flcor_.req_recv, &nout, idx,
+                   MPI_STATUSES_IGNORE);
+    }
+    if (nout != MPI_UNDEFINED) {
+      for (int m = 0; m < nout; m++)
+        bd_var_flcor_.flag[idx[m]] = BoundaryStatus::arrived;
+    }
+  }
+#endif
 
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
@@ -168,78 +232,17 @@ bool CellCenteredBoundaryVariable::ReceiveFluxCorrection() {
     if (nb.snb.level == pmb->loc.level + 1) {
       if (bd_var_flcor_.flag[nb.bufid] == BoundaryStatus::completed) continue;
       if (bd_var_flcor_.flag[nb.bufid] == BoundaryStatus::waiting) {
-        if (nb.snb.rank == Globals::my_rank) { // on the same process
-          bflag = false;
-          continue;
-        }
-#ifdef MPI_PARALLEL
-        else { // NOLINT
-          int test;
-          MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &test,
-                     MPI_STATUS_IGNORE);
-          MPI_Test(&(bd_var_flcor_.req_recv[nb.bufid]), &test, MPI_STATUS_IGNORE);
-          if (!static_cast<bool>(test)) {
-            bflag = false;
-            continue;
-          }
-          bd_var_flcor_.flag[nb.bufid] = BoundaryStatus::arrived;
-        }
-#endif
+        bflag = false;
+        continue;
       }
-      // boundary arrived; apply flux correction
-      int p = 0;
-      Real *rbuf = bd_var_flcor_.recv[nb.bufid];
-      if (nb.fid == BoundaryFace::inner_x1 || nb.fid == BoundaryFace::outer_x1) {
-        int il = pmb->is + (pmb->ie - pmb->is) * nb.fid + nb.fid;
-        int jl = pmb->js, ju = pmb->je, kl = pmb->ks, ku = pmb->ke;
-        if (nb.ni.fi1 == 0)
-          ju -= pmb->block_size.nx2 / 2;
-        else
-          jl += pmb->block_size.nx2 / 2;
-        if (nb.ni.fi2 == 0)
-          ku -= pmb->block_size.nx3 / 2;
-        else
-          kl += pmb->block_size.nx3 / 2;
-        for (int nn = nl_; nn <= nu_; nn++) {
-          for (int k = kl; k <= ku; k++) {
-            for (int j = jl; j <= ju; j++)
-              x1flux(nn, k, j, il) = rbuf[p++];
-          }
-        }
-      } else if (nb.fid == BoundaryFace::inner_x2 || nb.fid == BoundaryFace::outer_x2) {
-        int jl = pmb->js + (pmb->je - pmb->js) * (nb.fid & 1) + (nb.fid & 1);
-        int il = pmb->is, iu = pmb->ie, kl = pmb->ks, ku = pmb->ke;
-        if (nb.ni.fi1 == 0)
-          iu -= pmb->block_size.nx1 / 2;
-        else
-          il += pmb->block_size.nx1 / 2;
-        if (nb.ni.fi2 == 0)
-          ku -= pmb->block_size.nx3 / 2;
-        else
-          kl += pmb->block_size.nx3 / 2;
-        for (int nn = nl_; nn <= nu_; nn++) {
-          for (int k = kl; k <= ku; k++) {
-            for (int i = il; i <= iu; i++)
-              x2flux(nn, k, jl, i) = rbuf[p++];
-          }
-        }
-      } else if (nb.fid == BoundaryFace::inner_x3 || nb.fid == BoundaryFace::outer_x3) {
-        int kl = pmb->ks + (pmb->ke - pmb->ks) * (nb.fid & 1) + (nb.fid & 1);
-        int il = pmb->is, iu = pmb->ie, jl = pmb->js, ju = pmb->je;
-        if (nb.ni.fi1 == 0)
-          iu -= pmb->block_size.nx1 / 2;
-        else
-          il += pmb->block_size.nx1 / 2;
-        if (nb.ni.fi2 == 0)
-          ju -= pmb->block_size.nx2 / 2;
-        else
-          jl += pmb->block_size.nx2 / 2;
-        for (int nn = nl_; nn <= nu_; nn++) {
-          for (int j = jl; j <= ju; j++) {
-            for (int i = il; i <= iu; i++)
-              x3flux(nn, kl, j, i) = rbuf[p++];
-          }
-        }
+      // boundary arrived; overwrite the flux on the part of the face covered by the
+      // finer neighbor, unless the variable has no fluxes of its own
+      if (var_allocated) {
+        int fk, fj, fi;
+        const int dir = FluxFace(pmb, nb.fid, fk, fj, fi);
+        const auto &flux = (dir == X1DIR ? x1flux : (dir == X2DIR ? x2flux : x3flux));
+        UnpackFluxCorrection(pmb, flux, nb, nl_, nu_, bd_var_flcor_.recv[nb.bufid],
+                             flcor_buf_);
       }
       bd_var_flcor_.flag[nb.bufid] = BoundaryStatus::completed;
     }
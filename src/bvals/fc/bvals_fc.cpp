@@ -32,13 +32,62 @@
 #include "parthenon_mpi.hpp"
 
 #include "basic_types.hpp"
+#include "bvals/progress_thread.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
+#include "kokkos_abstraction.hpp"
 #include "utils/buffer_utils.hpp"
 
 namespace parthenon {
 
+//----------------------------------------------------------------------------------------
+//! \fn int PackFaceBuffer(MeshBlock *pmb, const FaceField &var,
+//                          const FaceBufferRanges &r, Real *buf,
+//                          ParArray1D<Real> &staging)
+//  \brief packs all three components into buf with a single kernel
+
+int PackFaceBuffer(MeshBlock *pmb, const FaceField &var, const FaceBufferRanges &r,
+                   Real *buf, ParArray1D<Real> &staging) {
+  const int off[3] = {0, r.Size(0), r.Size(0) + r.Size(1)};
+  const int size = off[2] + r.Size(2);
+  auto dbuf = BufferUtility::DeviceBuffer(buf, size, staging);
+  pmb->par_for(
+      "PackFaceBuffer", 0, size - 1, KOKKOS_LAMBDA(const int p) {
+        int k, j, i;
+        const int c = r.Index(p, off, k, j, i);
+        dbuf(p) = var(c + 1, k, j, i);
+      });
+  if (dbuf.data() != buf) pmb->deep_copy(BufferUtility::HostBuffer(buf, size), dbuf);
+  // the buffer is read on the host by the copy or the send that follows
+  pmb->exec_space.fence();
+  return size;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void UnpackFaceBuffer(MeshBlock *pmb, const FaceField &var,
+//                             const FaceBufferRanges &r, Real *buf,
+//                             ParArray1D<Real> &staging)
+//  \brief unpacks all three components from buf with a single kernel; the x2f (x3f)
+//  faces are copied to the upper face of the cell as well if the block is 1D (1D or 2D)
+
+void UnpackFaceBuffer(MeshBlock *pmb, const FaceField &var, const FaceBufferRanges &r,
+                      Real *buf, ParArray1D<Real> &staging) {
+  const int off[3] = {0, r.Size(0), r.Size(0) + r.Size(1)};
+  const int size = off[2] + r.Size(2);
+  const bool copy_x2 = (pmb->block_size.nx2 == 1), copy_x3 = (pmb->block_size.nx3 == 1);
+  auto dbuf = BufferUtility::DeviceBuffer(buf, size, staging);
+  if (dbuf.data() != buf) pmb->deep_copy(dbuf, BufferUtility::HostBuffer(buf, size));
+  pmb->par_for(
+      "UnpackFaceBuffer", 0, size - 1, KOKKOS_LAMBDA(const int p) {
+        int k, j, i;
+        const int c = r.Index(p, off, k, j, i);
+        var(c + 1, k, j, i) = dbuf(p);
+        if (c == 1 && copy_x2) var.x2f(k, j + 1, i) = dbuf(p);
+        if (c == 2 && copy_x3) var.x3f(k + 1, j, i) = dbuf(p);
+      });
+}
+
 FaceCenteredBoundaryVariable::FaceCenteredBoundaryVariable(MeshBlock *pmb, FaceField *var,
                                                            FaceField &coarse_buf,
                                                            EdgeField &var_flux)
@@ -64,7 +113,7 @@ FaceCenteredBoundaryVariable::~FaceCenteredBoundaryVariable() {
 }
 
 int FaceCenteredBoundaryVariable::ComputeVariableBufferSize(const NeighborIndexes &ni,
-                                                            int cng) {
+                                                            int cng, int dlevel) {
   MeshBlock *pmb = pmy_block_;
   int nx1 = pmb->block_size.nx1;
   int nx2 = pmb->block_size.nx2;
@@ -76,48 +125,43 @@ int FaceCenteredBoundaryVariable::ComputeVariableBufferSize(const NeighborIndexe
   cng2 = cng * f2;
   cng3 = cng * f3;
 
-  int size1 = ((ni.ox1 == 0) ? (nx1 + 1) : NGHOST) * ((ni.ox2 == 0) ? (nx2) : NGHOST) *
-              ((ni.ox3 == 0) ? (nx3) : NGHOST);
-  int size2 = ((ni.ox1 == 0) ? (nx1) : NGHOST) * ((ni.ox2 == 0) ? (nx2 + f2) : NGHOST) *
-              ((ni.ox3 == 0) ? (nx3) : NGHOST);
-  int size3 = ((ni.ox1 == 0) ? (nx1) : NGHOST) * ((ni.ox2 == 0) ? (nx2) : NGHOST) *
-              ((ni.ox3 == 0) ? (nx3 + f3) : NGHOST);
-  int size = size1 + size2 + size3;
-  if (pmy_mesh_->multilevel) {
-    if (ni.type != NeighborConnect::face) {
-      if (ni.ox1 != 0) size1 = size1 / NGHOST * (NGHOST + 1);
-      if (ni.ox2 != 0) size2 = size2 / NGHOST * (NGHOST + 1);
-      if (ni.ox3 != 0) size3 = size3 / NGHOST * (NGHOST + 1);
-    }
-    size = size1 + size2 + size3;
-    int f2c1 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + 1) : NGHOST) *
-               ((ni.ox2 == 0) ? ((nx2 + 1) / 2) : NGHOST) *
-               ((ni.ox3 == 0) ? ((nx3 + 1) / 2) : NGHOST);
-    int f2c2 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2) : NGHOST) *
-               ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + f2) : NGHOST) *
-               ((ni.ox3 == 0) ? ((nx3 + 1) / 2) : NGHOST);
-    int f2c3 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2) : NGHOST) *
-               ((ni.ox2 == 0) ? ((nx2 + 1) / 2) : NGHOST) *
-               ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + f3) : NGHOST);
-    if (ni.type != NeighborConnect::face) {
-      if (ni.ox1 != 0) f2c1 = f2c1 / NGHOST * (NGHOST + 1);
-      if (ni.ox2 != 0) f2c2 = f2c2 / NGHOST * (NGHOST + 1);
-      if (ni.ox3 != 0) f2c3 = f2c3 / NGHOST * (NGHOST + 1);
-    }
-    int fsize = f2c1 + f2c2 + f2c3;
-    int c2f1 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1 + 1) : cng + 1) *
-               ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2) : cng) *
-               ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3) : cng);
-    int c2f2 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1) : cng) *
-               ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2 + f2) : cng + 1) *
-               ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3) : cng);
-    int c2f3 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1) : cng) *
-               ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2) : cng) *
-               ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3 + f3) : cng + 1);
-    int csize = c2f1 + c2f2 + c2f3;
-    size = std::max(size, std::max(csize, fsize));
+  int size1, size2, size3;
+  if (dlevel == 0) { // same
+    size1 = ((ni.ox1 == 0) ? (nx1 + 1) : NGHOST) * ((ni.ox2 == 0) ? (nx2) : NGHOST) *
+            ((ni.ox3 == 0) ? (nx3) : NGHOST);
+    size2 = ((ni.ox1 == 0) ? (nx1) : NGHOST) * ((ni.ox2 == 0) ? (nx2 + f2) : NGHOST) *
+            ((ni.ox3 == 0) ? (nx3) : NGHOST);
+    size3 = ((ni.ox1 == 0) ? (nx1) : NGHOST) * ((ni.ox2 == 0) ? (nx2) : NGHOST) *
+            ((ni.ox3 == 0) ? (nx3 + f3) : NGHOST);
+  } else if (dlevel < 0) { // to coarser
+    size1 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + 1) : NGHOST) *
+            ((ni.ox2 == 0) ? ((nx2 + 1) / 2) : NGHOST) *
+            ((ni.ox3 == 0) ? ((nx3 + 1) / 2) : NGHOST);
+    size2 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2) : NGHOST) *
+            ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + f2) : NGHOST) *
+            ((ni.ox3 == 0) ? ((nx3 + 1) / 2) : NGHOST);
+    size3 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2) : NGHOST) *
+            ((ni.ox2 == 0) ? ((nx2 + 1) / 2) : NGHOST) *
+            ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + f3) : NGHOST);
+  } else { // to finer
+    size1 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1 + 1) : cng + 1) *
+            ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2) : cng) *
+            ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3) : cng);
+    size2 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1) : cng) *
+            ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2 + f2) : cng + 1) *
+            ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3) : cng);
+    size3 = ((ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1) : cng) *
+            ((ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2) : cng) *
+            ((ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3 + f3) : cng + 1);
+    return size1 + size2 + size3;
   }
-  return size;
+  // with mesh refinement, the faces on the edges and corners are exchanged as well
+  if (pmy_mesh_->multilevel && ni.type != NeighborConnect::face) {
+    if (ni.ox1 != 0) size1 = size1 / NGHOST * (NGHOST + 1);
+    if (ni.ox2 != 0) size2 = size2 / NGHOST * (NGHOST + 1);
+    if (ni.ox3 != 0) size3 = size3 / NGHOST * (NGHOST + 1);
+  }
+  return size1 + size2 + size3;
 }
 
 int FaceCenteredBoundaryVariable::ComputeFluxCorrectionBufferSize(
@@ -157,15 +201,16 @@ int FaceCenteredBoundaryVariable::ComputeFluxCorrectionBufferSize(
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn int FaceCenteredBoundaryVariable::LoadBoundaryBufferSameLevel(Real *buf,
-//                                                               const NeighborBlock& nb)
-//  \brief Set face-centered boundary buffers for sending to a block on the same level
-
-int FaceCenteredBoundaryVariable::LoadBoundaryBufferSameLevel(Real *buf,
-                                                              const NeighborBlock &nb) {
-  MeshBlock *pmb = pmy_block_;
+//! \fn FaceBufferRanges FaceBufferRanges::SendSameLevel(const MeshBlock *pmb,
+//                                                 const NeighborBlock &nb,
+//                                                 const bool multilevel)
+//  \brief ranges of the faces sent to a neighbor on the same level
+
+FaceBufferRanges FaceBufferRanges::SendSameLevel(const MeshBlock *pmb,
+                                                 const NeighborBlock &nb,
+                                                 const bool multilevel) {
   int si, sj, sk, ei, ej, ek;
-  int p = 0;
+  FaceBufferRanges r;
 
   // bx1
   if (nb.ni.ox1 == 0)
@@ -190,13 +235,13 @@ int FaceCenteredBoundaryVariable::LoadBoundaryBufferSameLevel(Real *buf,
     sk = pmb->ks, ek = pmb->ks + NGHOST - 1;
 
   // for SMR/AMR, always include the overlapping faces in edge and corner boundaries
-  if (pmy_mesh_->multilevel && nb.ni.type != NeighborConnect::face) {
+  if (multilevel && nb.ni.type != NeighborConnect::face) {
     if (nb.ni.ox1 > 0)
       ei++;
     else if (nb.ni.ox1 < 0)
       si--;
   }
-  BufferUtility::PackData((*var_fc).x1f, buf, si, ei, sj, ej, sk, ek, p);
+  r.Set(0, si, ei, sj, ej, sk, ek);
 
   // bx2
   if (nb.ni.ox1 == 0)
@@ -215,13 +260,13 @@ int FaceCenteredBoundaryVariable::LoadBoundaryBufferSameLevel(Real *buf,
   else
     sj = pmb->js + 1, ej = pmb->js + NGHOST;
 
-  if (pmy_mesh_->multilevel && nb.ni.type != NeighborConnect::face) {
+  if (multilevel && nb.ni.type != NeighborConnect::face) {
     if (nb.ni.ox2 > 0)
       ej++;
     else if (nb.ni.ox2 < 0)
       sj--;
   }
-  BufferUtility::PackData((*var_fc).x2f, buf, si, ei, sj, ej, sk, ek, p);
+  r.Set(1, si, ei, sj, ej, sk, ek);
 
   // bx3
   if (nb.ni.ox2 == 0)
@@ -240,29 +285,38 @@ int FaceCenteredBoundaryVariable::LoadBoundaryBufferSameLevel(Real *buf,
   else
     sk = pmb->ks + 1, ek = pmb->ks + NGHOST;
 
-  if (pmy_mesh_->multilevel && nb.ni.type != NeighborConnect::face) {
+  if (multilevel && nb.ni.type != NeighborConnect::face) {
     if (nb.ni.ox3 > 0)
       ek++;
     else if (nb.ni.ox3 < 0)
       sk--;
   }
-  BufferUtility::PackData((*var_fc).x3f, buf, si, ei, sj, ej, sk, ek, p);
+  r.Set(2, si, ei, sj, ej, sk, ek);
 
-  return p;
+  return r;
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn int FaceCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
-//                                                                const NeighborBlock& nb)
-//  \brief Set face-centered boundary buffers for sending to a block on the coarser level
+//! \fn int FaceCenteredBoundaryVariable::LoadBoundaryBufferSameLevel(Real *buf,
+//                                                               const NeighborBlock& nb)
+//  \brief Set face-centered boundary buffers for sending to a block on the same level
 
-int FaceCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
+int FaceCenteredBoundaryVariable::LoadBoundaryBufferSameLevel(Real *buf,
                                                               const NeighborBlock &nb) {
-  MeshBlock *pmb = pmy_block_;
-  auto &pmr = pmb->pmr;
+  auto r = FaceBufferRanges::SendSameLevel(pmy_block_, nb, pmy_mesh_->multilevel);
+  return PackFaceBuffer(pmy_block_, *var_fc, r, buf, buf_staging_);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn FaceBufferRanges FaceBufferRanges::SendToCoarser(const MeshBlock *pmb,
+//                                                 const NeighborBlock &nb)
+//  \brief ranges of the restricted faces of the coarse buffer sent to a coarser neighbor
+
+FaceBufferRanges FaceBufferRanges::SendToCoarser(const MeshBlock *pmb,
+                                                 const NeighborBlock &nb) {
   int si, sj, sk, ei, ej, ek;
   int cng = NGHOST;
-  int p = 0;
+  FaceBufferRanges r;
 
   // bx1
   if (nb.ni.ox1 == 0)
@@ -293,8 +347,7 @@ int FaceCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
     else if (nb.ni.ox1 < 0)
       si--;
   }
-  pmr->RestrictFieldX1((*var_fc).x1f, coarse_buf.x1f, si, ei, sj, ej, sk, ek);
-  BufferUtility::PackData(coarse_buf.x1f, buf, si, ei, sj, ej, sk, ek, p);
+  r.Set(0, si, ei, sj, ej, sk, ek);
 
   // bx2
   if (nb.ni.ox1 == 0)
@@ -319,12 +372,7 @@ int FaceCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
     else if (nb.ni.ox2 < 0)
       sj--;
   }
-  pmr->RestrictFieldX2((*var_fc).x2f, coarse_buf.x2f, si, ei, sj, ej, sk, ek);
-  if (pmb->block_size.nx2 == 1) { // 1D
-    for (int i = si; i <= ei; i++)
-      coarse_buf.x2f(sk, sj + 1, i) = coarse_buf.x2f(sk, sj, i);
-  }
-  BufferUtility::PackData(coarse_buf.x2f, buf, si, ei, sj, ej, sk, ek, p);
+  r.Set(1, si, ei, sj, ej, sk, ek);
 
   // bx3
   if (nb.ni.ox2 == 0)
@@ -349,16 +397,27 @@ int FaceCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
     else if (nb.ni.ox3 < 0)
       sk--;
   }
-  pmr->RestrictFieldX3((*var_fc).x3f, coarse_buf.x3f, si, ei, sj, ej, sk, ek);
-  if (pmb->block_size.nx3 == 1) { // 1D or 2D
-    for (int j = sj; j <= ej; j++) {
-      for (int i = si; i <= ei; i++)
-        coarse_buf.x3f(sk + 1, j, i) = coarse_buf.x3f(sk, j, i);
-    }
-  }
-  BufferUtility::PackData(coarse_buf.x3f, buf, si, ei, sj, ej, sk, ek, p);
+  r.Set(2, si, ei, sj, ej, sk, ek);
+  return r;
+}
 
-  return p;
+//----------------------------------------------------------------------------------------
+//! \fn int FaceCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
+//                                                                const NeighborBlock& nb)
+//  \brief Set face-centered boundary buffers for sending to a block on the coarser level
+
+int FaceCenteredBoundaryVariable::LoadBoundaryBufferToCoarser(Real *buf,
+                                                              const NeighborBlock &nb) {
+  MeshBlock *pmb = pmy_block_;
+  auto &pmr = pmb->pmr;
+  auto r = FaceBufferRanges::SendToCoarser(pmb, nb);
+  pmr->RestrictFieldX1((*var_fc).x1f, coarse_buf.x1f, r.si[0], r.ei[0], r.sj[0], r.ej[0],
+                       r.sk[0], r.ek[0]);
+  pmr->RestrictFieldX2((*var_fc).x2f, coarse_buf.x2f, r.si[1], r.ei[1], r.sj[1], r.ej[1],
+                       r.sk[1], r.ek[1]);
+  pmr->RestrictFieldX3((*var_fc).x3f, coarse_buf.x3f, r.si[2], r.ei[2], r.sj[2], r.ej[2],
+                       r.sk[2], r.ek[2]);
+  return PackFaceBuffer(pmb, coarse_buf, r, buf, buf_staging_);
 }
 
 //----------------------------------------------------------------------------------------
@@ -521,16 +580,17 @@ int FaceCenteredBoundaryVariable::LoadBoundaryBufferToFiner(Real *buf,
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void FaceCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
-//                                                              const NeighborBlock& nb)
-//  \brief Set face-centered boundary received from a block on the same level
-
-void FaceCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
-                                                        const NeighborBlock &nb) {
-  MeshBlock *pmb = pmy_block_;
+//! \fn FaceBufferRanges FaceBufferRanges::RecvSameLevel(const MeshBlock *pmb,
+//                                                 const NeighborBlock &nb,
+//                                                 const bool multilevel)
+//  \brief ranges of the ghost faces received from a neighbor on the same level
+
+FaceBufferRanges FaceBufferRanges::RecvSameLevel(const MeshBlock *pmb,
+                                                 const NeighborBlock &nb,
+                                                 const bool multilevel) {
   int si, sj, sk, ei, ej, ek;
+  FaceBufferRanges r;
 
-  int p = 0;
   // bx1
   // for uniform grid: face-neighbors take care of the overlapping faces
   if (nb.ni.ox1 == 0)
@@ -555,14 +615,14 @@ void FaceCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
     sk = pmb->ks - NGHOST, ek = pmb->ks - 1;
 
   // for SMR/AMR, always include the overlapping faces in edge and corner boundaries
-  if (pmy_mesh_->multilevel && nb.ni.type != NeighborConnect::face) {
+  if (multilevel && nb.ni.type != NeighborConnect::face) {
     if (nb.ni.ox1 > 0)
       si--;
     else if (nb.ni.ox1 < 0)
       ei++;
   }
 
-  BufferUtility::UnpackData(buf, (*var_fc).x1f, si, ei, sj, ej, sk, ek, p);
+  r.Set(0, si, ei, sj, ej, sk, ek);
 
   // bx2
   if (nb.ni.ox1 == 0)
@@ -582,20 +642,14 @@ void FaceCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
     sj = pmb->js - NGHOST, ej = pmb->js - 1;
 
   // for SMR/AMR, always include the overlapping faces in edge and corner boundaries
-  if (pmy_mesh_->multilevel && nb.ni.type != NeighborConnect::face) {
+  if (multilevel && nb.ni.type != NeighborConnect::face) {
     if (nb.ni.ox2 > 0)
       sj--;
     else if (nb.ni.ox2 < 0)
       ej++;
   }
 
-  BufferUtility::UnpackData(buf, (*var_fc).x2f, si, ei, sj, ej, sk, ek, p);
-
-  if (pmb->block_size.nx2 == 1) { // 1D
-#pragma omp simd
-    for (int i = si; i <= ei; ++i)
-      (*var_fc).x2f(sk, sj + 1, i) = (*var_fc).x2f(sk, sj, i);
-  }
+  r.Set(1, si, ei, sj, ej, sk, ek);
 
   // bx3
   if (nb.ni.ox2 == 0)
@@ -615,23 +669,27 @@ void FaceCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
     sk = pmb->ks - NGHOST, ek = pmb->ks - 1;
 
   // for SMR/AMR, always include the overlapping faces in edge and corner boundaries
-  if (pmy_mesh_->multilevel && nb.ni.type != NeighborConnect::face) {
+  if (multilevel && nb.ni.type != NeighborConnect::face) {
     if (nb.ni.ox3 > 0)
       sk--;
     else if (nb.ni.ox3 < 0)
       ek++;
   }
 
-  BufferUtility::UnpackData(buf, (*var_fc).x3f, si, ei, sj, ej, sk, ek, p);
+  r.Set(2, si, ei, sj, ej, sk, ek);
 
-  if (pmb->block_size.nx3 == 1) { // 1D or 2D
-    for (int j = sj; j <= ej; ++j) {
-#pragma omp simd
-      for (int i = si; i <= ei; ++i)
-        (*var_fc).x3f(sk + 1, j, i) = (*var_fc).x3f(sk, j, i);
-    }
-  }
+  return r;
+}
 
+//----------------------------------------------------------------------------------------
+//! \fn void FaceCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
+//                                                              const NeighborBlock& nb)
+//  \brief Set face-centered boundary received from a block on the same level
+
+void FaceCenteredBoundaryVariable::SetBoundarySameLevel(Real *buf,
+                                                        const NeighborBlock &nb) {
+  auto r = FaceBufferRanges::RecvSameLevel(pmy_block_, nb, pmy_mesh_->multilevel);
+  UnpackFaceBuffer(pmy_block_, *var_fc, r, buf, buf_staging_);
   return;
 }
 
@@ -768,16 +826,14 @@ void FaceCenteredBoundaryVariable::SetBoundaryFromCoarser(Real *buf,
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn void FaceCenteredBoundaryVariable::SetFielBoundaryFromFiner(Real *buf,
-//                                                                const NeighborBlock& nb)
-//  \brief Set face-centered boundary received from a block on the same level
+//! \fn FaceBufferRanges FaceBufferRanges::RecvFromFiner(const MeshBlock *pmb,
+//                                                 const NeighborBlock &nb)
+//  \brief ranges of the ghost faces received, already restricted, from a finer neighbor
 
-void FaceCenteredBoundaryVariable::SetBoundaryFromFiner(Real *buf,
-                                                        const NeighborBlock &nb) {
-  MeshBlock *pmb = pmy_block_;
-  // receive already restricted data
+FaceBufferRanges FaceBufferRanges::RecvFromFiner(const MeshBlock *pmb,
+                                                 const NeighborBlock &nb) {
   int si, sj, sk, ei, ej, ek;
-  int p = 0;
+  FaceBufferRanges r;
 
   // bx1
   if (nb.ni.ox1 == 0) {
@@ -842,7 +898,7 @@ void FaceCenteredBoundaryVariable::SetBoundaryFromFiner(Real *buf,
     sk = pmb->ks - NGHOST, ek = pmb->ks - 1;
   }
 
-  BufferUtility::UnpackData(buf, (*var_fc).x1f, si, ei, sj, ej, sk, ek, p);
+  r.Set(0, si, ei, sj, ej, sk, ek);
 
   // bx2
   if (nb.ni.ox1 == 0) {
@@ -887,13 +943,7 @@ void FaceCenteredBoundaryVariable::SetBoundaryFromFiner(Real *buf,
       ej++;
   }
 
-  BufferUtility::UnpackData(buf, (*var_fc).x2f, si, ei, sj, ej, sk, ek, p);
-
-  if (pmb->block_size.nx2 == 1) { // 1D
-#pragma omp simd
-    for (int i = si; i <= ei; ++i)
-      (*var_fc).x2f(sk, sj + 1, i) = (*var_fc).x2f(sk, sj, i);
-  }
+  r.Set(1, si, ei, sj, ej, sk, ek);
 
   // bx3
   if (nb.ni.ox2 == 0) {
@@ -947,15 +997,20 @@ void FaceCenteredBoundaryVariable::SetBoundaryFromFiner(Real *buf,
       ek++;
   }
 
-  BufferUtility::UnpackData(buf, (*var_fc).x3f, si, ei, sj, ej, sk, ek, p);
+  r.Set(2, si, ei, sj, ej, sk, ek);
+  return r;
+}
 
-  if (pmb->block_size.nx3 == 1) { // 1D or 2D
-    for (int j = sj; j <= ej; ++j) {
-#pragma omp simd
-      for (int i = si; i <= ei; ++i)
-        (*var_fc).x3f(sk + 1, j, i) = (*var_fc).x3f(sk, j, i);
-    }
-  }
+//----------------------------------------------------------------------------------------
+//! \fn void FaceCenteredBoundaryVariable::SetFielBoundaryFromFiner(Real *buf,
+//                                                                const NeighborBlock& nb)
+//  \brief Set face-centered boundary received from a block on the same level
+
+void FaceCenteredBoundaryVariable::SetBoundaryFromFiner(Real *buf,
+                                                        const NeighborBlock &nb) {
+  // receive already restricted data
+  auto r = FaceBufferRanges::RecvFromFiner(pmy_block_, nb);
+  UnpackFaceBuffer(pmy_block_, *var_fc, r, buf, buf_staging_);
   return;
 }
 
@@ -1023,6 +1078,8 @@ void FaceCenteredBoundaryVariable::CountFineEdges() {
 
 void FaceCenteredBoundaryVariable::SetupPersistentMPI() {
   CountFineEdges();
+  ResizeBoundaryBuffers(bd_var_, BoundaryQuantity::fc);
+  ResizeBoundaryBuffers(bd_var_flcor_, BoundaryQuantity::fc_flcor);
 
 #ifdef MPI_PARALLEL
   MeshBlock *pmb = pmy_block_;
@@ -1031,68 +1088,16 @@ void FaceCenteredBoundaryVariable::SetupPersistentMPI() {
   int nx3 = pmb->block_size.nx3;
   int &mylevel = pmb->loc.level;
 
-  const int f2 = (pmy_mesh_->ndim >= 2) ? 1 : 0; // extra cells/faces from being 2d
-  const int f3 = (pmy_mesh_->ndim >= 3) ? 1 : 0; // extra cells/faces from being 3d
-  int cng, cng1, cng2, cng3;
-  cng = cng1 = pmb->cnghost;
-  cng2 = cng * f2;
-  cng3 = cng * f3;
+  int cng = pmb->cnghost;
   int ssize, rsize;
   int tag;
   // Initialize non-polar neighbor communications to other ranks
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
     if (nb.snb.rank != Globals::my_rank) {
-      int size, csize, fsize;
-      int size1 = ((nb.ni.ox1 == 0) ? (nx1 + 1) : NGHOST) *
-                  ((nb.ni.ox2 == 0) ? (nx2) : NGHOST) *
-                  ((nb.ni.ox3 == 0) ? (nx3) : NGHOST);
-      int size2 = ((nb.ni.ox1 == 0) ? (nx1) : NGHOST) *
-                  ((nb.ni.ox2 == 0) ? (nx2 + f2) : NGHOST) *
-                  ((nb.ni.ox3 == 0) ? (nx3) : NGHOST);
-      int size3 = ((nb.ni.ox1 == 0) ? (nx1) : NGHOST) *
-                  ((nb.ni.ox2 == 0) ? (nx2) : NGHOST) *
-                  ((nb.ni.ox3 == 0) ? (nx3 + f3) : NGHOST);
-      size = size1 + size2 + size3;
-      if (pmy_mesh_->multilevel) {
-        if (nb.ni.type != NeighborConnect::face) {
-          if (nb.ni.ox1 != 0) size1 = size1 / NGHOST * (NGHOST + 1);
-          if (nb.ni.ox2 != 0) size2 = size2 / NGHOST * (NGHOST + 1);
-          if (nb.ni.ox3 != 0) size3 = size3 / NGHOST * (NGHOST + 1);
-        }
-        size = size1 + size2 + size3;
-        int f2c1 = ((nb.ni.ox1 == 0) ? ((nx1 + 1) / 2 + 1) : NGHOST) *
-                   ((nb.ni.ox2 == 0) ? ((nx2 + 1) / 2) : NGHOST) *
-                   ((nb.ni.ox3 == 0) ? ((nx3 + 1) / 2) : NGHOST);
-        int f2c2 = ((nb.ni.ox1 == 0) ? ((nx1 + 1) / 2) : NGHOST) *
-                   ((nb.ni.ox2 == 0) ? ((nx2 + 1) / 2 + f2) : NGHOST) *
-                   ((nb.ni.ox3 == 0) ? ((nx3 + 1) / 2) : NGHOST);
-        int f2c3 = ((nb.ni.ox1 == 0) ? ((nx1 + 1) / 2) : NGHOST) *
-                   ((nb.ni.ox2 == 0) ? ((nx2 + 1) / 2) : NGHOST) *
-                   ((nb.ni.ox3 == 0) ? ((nx3 + 1) / 2 + f3) : NGHOST);
-        if (nb.ni.type != NeighborConnect::face) {
-          if (nb.ni.ox1 != 0) f2c1 = f2c1 / NGHOST * (NGHOST + 1);
-          if (nb.ni.ox2 != 0) f2c2 = f2c2 / NGHOST * (NGHOST + 1);
-          if (nb.ni.ox3 != 0) f2c3 = f2c3 / NGHOST * (NGHOST + 1);
-        }
-        fsize = f2c1 + f2c2 + f2c3;
-        int c2f1 = ((nb.ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1 + 1) : cng + 1) *
-                   ((nb.ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2) : cng) *
-                   ((nb.ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3) : cng);
-        int c2f2 = ((nb.ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1) : cng) *
-                   ((nb.ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2 + f2) : cng + 1) *
-                   ((nb.ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3) : cng);
-        int c2f3 = ((nb.ni.ox1 == 0) ? ((nx1 + 1) / 2 + cng1) : cng) *
-                   ((nb.ni.ox2 == 0) ? ((nx2 + 1) / 2 + cng2) : cng) *
-                   ((nb.ni.ox3 == 0) ? ((nx3 + 1) / 2 + cng3 + f3) : cng + 1);
-        csize = c2f1 + c2f2 + c2f3;
-      }                            // end of multilevel
-      if (nb.snb.level == mylevel) // same refinement level
-        ssize = size, rsize = size;
-      else if (nb.snb.level < mylevel) // coarser
-        ssize = fsize, rsize = csize;
-      else // finer
-        ssize = csize, rsize = fsize;
+      int size;
+      ssize = ComputeVariableBufferSize(nb.ni, cng, nb.snb.level - mylevel);
+      rsize = ComputeVariableBufferSize(nb.ni, cng, mylevel - nb.snb.level);
 
       // face-centered field: bd_var_
       tag = pmb->pbval->CreateBvalsMPITag(nb.snb.lid, nb.targetid, fc_phys_id_);
@@ -1192,19 +1197,13 @@ void FaceCenteredBoundaryVariable::StartReceiving(BoundaryCommSubset phase) {
   if (phase == BoundaryCommSubset::all) recv_flx_same_lvl_ = true;
 #ifdef MPI_PARALLEL
   MeshBlock *pmb = pmy_block_;
-  int mylevel = pmb->loc.level;
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
     if (nb.snb.rank != Globals::my_rank && phase != BoundaryCommSubset::gr_amr) {
+      // the EMF correction is not implemented yet, so its receives are not started
       MPI_Start(&(bd_var_.req_recv[nb.bufid]));
-      if (phase == BoundaryCommSubset::all &&
-          (nb.ni.type == NeighborConnect::face || nb.ni.type == NeighborConnect::edge)) {
-        if ((nb.snb.level > mylevel) ||
-            ((nb.snb.level == mylevel) &&
-             ((nb.ni.type == NeighborConnect::face) ||
-              ((nb.ni.type == NeighborConnect::edge) && (edge_flag_[nb.eid])))))
-          MPI_Start(&(bd_var_flcor_.req_recv[nb.bufid]));
-      }
+      ProgressThread::Post(&(bd_var_.req_recv[nb.bufid]), &(bd_var_.flag[nb.bufid]),
+                           BoundaryStatus::arrived);
     }
   }
 #endif
@@ -1228,16 +1227,21 @@ void FaceCenteredBoundaryVariable::ClearBoundary(BoundaryCommSubset phase) {
     int mylevel = pmb->loc.level;
     if (nb.snb.rank != Globals::my_rank && phase != BoundaryCommSubset::gr_amr) {
       // Wait for Isend
-      MPI_Wait(&(bd_var_.req_send[nb.bufid]), MPI_STATUS_IGNORE);
+      ProgressThread::Wait(&(bd_var_.req_send[nb.bufid]),
+                           &(bd_var_.send_status[nb.bufid]), BoundaryStatus::completed);
 
       if (phase == BoundaryCommSubset::all) {
         if (nb.ni.type == NeighborConnect::face || nb.ni.type == NeighborConnect::edge) {
           if (nb.snb.level < mylevel)
-            MPI_Wait(&(bd_var_flcor_.req_send[nb.bufid]), MPI_STATUS_IGNORE);
+            ProgressThread::Wait(&(bd_var_flcor_.req_send[nb.bufid]),
+                                 &(bd_var_flcor_.send_status[nb.bufid]),
+                                 BoundaryStatus::completed);
           else if ((nb.snb.level == mylevel) &&
                    ((nb.ni.type == NeighborConnect::face) ||
                     ((nb.ni.type == NeighborConnect::edge) && (edge_flag_[nb.eid]))))
-            MPI_Wait(&(bd_var_flcor_.req_send[nb.bufid]), MPI_STATUS_IGNORE);
+            ProgressThread::Wait(&(bd_var_flcor_.req_send[nb.bufid]),
+                                 &(bd_var_flcor_.send_status[nb.bufid]),
+                                 BoundaryStatus::completed);
         }
       }
     }
@@ -25,6 +25,50 @@
 #include "bvals/bvals.hpp"
 
 namespace parthenon {
+//----------------------------------------------------------------------------------------
+//! \struct FaceBufferRanges
+//  \brief index ranges of the x1f, x2f and x3f components exchanged with one neighbor,
+//  which follow each other in the same buffer
+
+struct FaceBufferRanges {
+  int si[3], ei[3], sj[3], ej[3], sk[3], ek[3];
+
+  // the faces of pmb exchanged with neighbor nb, see the FaceCenteredBoundaryVariable
+  // members using them
+  static FaceBufferRanges SendSameLevel(const MeshBlock *pmb, const NeighborBlock &nb,
+                                        const bool multilevel);
+  static FaceBufferRanges RecvSameLevel(const MeshBlock *pmb, const NeighborBlock &nb,
+                                        const bool multilevel);
+  static FaceBufferRanges SendToCoarser(const MeshBlock *pmb, const NeighborBlock &nb);
+  static FaceBufferRanges RecvFromFiner(const MeshBlock *pmb, const NeighborBlock &nb);
+
+  void Set(const int c, const int il, const int iu, const int jl, const int ju,
+           const int kl, const int ku) {
+    si[c] = il, ei[c] = iu, sj[c] = jl, ej[c] = ju, sk[c] = kl, ek[c] = ku;
+  }
+  int Size(const int c) const {
+    return (ei[c] - si[c] + 1) * (ej[c] - sj[c] + 1) * (ek[c] - sk[c] + 1);
+  }
+  // (k, j, i) and component of buffer element p, offsets of the components in off[]
+  KOKKOS_INLINE_FUNCTION
+  int Index(const int p, const int off[3], int &k, int &j, int &i) const {
+    const int c = (p >= off[1]) + (p >= off[2]);
+    const int ni = ei[c] - si[c] + 1, nj = ej[c] - sj[c] + 1;
+    int m = p - off[c];
+    i = si[c] + m % ni;
+    m /= ni;
+    j = sj[c] + m % nj;
+    k = sk[c] + m / nj;
+    return c;
+  }
+};
+
+// pack (unpack) the faces in the ranges r of var into (from) the host buffer buf
+int PackFaceBuffer(MeshBlock *pmb, const FaceField &var, const FaceBufferRanges &r,
+                   Real *buf, ParArray1D<Real> &staging);
+void UnpackFaceBuffer(MeshBlock *pmb, const FaceField &var, const FaceBufferRanges &r,
+                      Real *buf, ParArray1D<Real> &staging);
+
 //----------------------------------------------------------------------------------------
 //! \class FaceCenteredBoundaryVariable
 //  \brief
@@ -47,7 +91,7 @@ class FaceCenteredBoundaryVariable : public BoundaryVariable {
   static constexpr int max_phys_id = 5;
 
   // BoundaryVariable:
-  int ComputeVariableBufferSize(const NeighborIndexes &ni, int cng) override;
+  int ComputeVariableBufferSize(const NeighborIndexes &ni, int cng, int dlevel) override;
   int ComputeFluxCorrectionBufferSize(const NeighborIndexes &ni, int cng) override;
 
   // BoundaryCommunication:
@@ -70,6 +114,8 @@ class FaceCenteredBoundaryVariable : public BoundaryVariable {
 #ifdef MPI_PARALLEL
   int fc_phys_id_, fc_flx_phys_id_;
 #endif
+  // device copy of a communication buffer if the device cannot access host memory
+  ParArray1D<Real> buf_staging_;
 
   // BoundaryBuffer:
   int LoadBoundaryBufferSameLevel(Real *buf, const NeighborBlock &nb) override;
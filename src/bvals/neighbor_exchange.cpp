@@ -0,0 +1,232 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file neighbor_exchange.cpp
+//  \brief graph communicator, buffers and rounds of the neighborhood collective
+
+#include "bvals/neighbor_exchange.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "parthenon_mpi.hpp"
+
+#include "athena.hpp"
+#include "bvals/bvals.hpp"
+#include "bvals/progress_thread.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/profiler.hpp"
+
+namespace parthenon {
+namespace NeighborExchange {
+
+namespace {
+bool enabled = false;
+
+#ifdef MPI_PARALLEL
+MPI_Comm graph_comm = MPI_COMM_NULL;
+MPI_Request request = MPI_REQUEST_NULL;
+std::atomic<BoundaryStatus> status(BoundaryStatus::arrived); // for the progress thread
+std::vector<Real> send_buf, recv_buf;
+// per neighbor rank, in the order of the sources and destinations of graph_comm
+std::vector<int> send_counts, send_displs, recv_counts, recv_displs;
+
+std::mutex mutex;
+int nexpected = 0; // calls of Loaded() per round
+int nloaded = 0;   // calls of Loaded() in the current round
+int nstarted = 0, ncompleted = 0;
+
+// a variable buffer within the send or receive buffer of a neighbor rank
+struct Segment {
+  std::array<int, 3> key; // lid, bvar_index and bufid of the receiving block
+  int size;
+  BoundaryVariable *bvar;
+  const NeighborBlock *nb;
+};
+using Segments = std::map<int, std::vector<Segment>>; // by neighbor rank
+
+// places the segments of each neighbor rank one after the other in buf
+template <typename F>
+void Place(Segments *segments, std::vector<Real> *buf, std::vector<int> *counts,
+           std::vector<int> *displs, const F &set) {
+  counts->clear();
+  displs->clear();
+  int offset = 0;
+  for (auto &r : *segments) {
+    std::sort(r.second.begin(), r.second.end(),
+              [](const Segment &a, const Segment &b) { return a.key < b.key; });
+    displs->push_back(offset);
+    for (auto &s : r.second)
+      offset += s.size;
+    counts->push_back(offset - displs->back());
+  }
+  buf->assign(offset, 0.0);
+  offset = 0;
+  for (auto &r : *segments) {
+    for (auto &s : r.second) {
+      set(s, buf->data() + offset);
+      offset += s.size;
+    }
+  }
+}
+
+void Complete() {
+  Profiler::ScopedRegion region("MPI_Wait");
+  ProgressThread::Wait(&request, &status, BoundaryStatus::arrived);
+  ncompleted++;
+}
+#endif
+} // namespace
+
+void Initialize(const std::string &engine) {
+  if (engine != "point_to_point" && engine != "neighborhood") {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [NeighborExchange::Initialize]" << std::endl
+        << "Unknown exchange engine '" << engine
+        << "', use 'point_to_point' or 'neighborhood'" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+#ifdef MPI_PARALLEL
+  enabled = (engine == "neighborhood");
+#else
+  // without MPI, all neighbors are on this rank
+  enabled = false;
+#endif
+}
+
+void Finalize() {
+#ifdef MPI_PARALLEL
+  if (!enabled) return;
+  if (ncompleted < nstarted) Complete();
+  if (graph_comm != MPI_COMM_NULL) MPI_Comm_free(&graph_comm);
+  send_buf.clear();
+  recv_buf.clear();
+  enabled = false;
+#endif
+}
+
+bool Enabled() { return enabled; }
+
+//----------------------------------------------------------------------------------------
+//! \fn void NeighborExchange::Build(Mesh *pm)
+//  \brief creates the graph communicator of the neighbor ranks of the current blocks and
+//  places their buffers in the send and receive buffers of the collective
+
+void Build(Mesh *pm) {
+#ifdef MPI_PARALLEL
+  if (!enabled) return;
+  std::lock_guard<std::mutex> lock(mutex);
+  // the last round of the previous mesh has been received by all blocks
+  if (ncompleted < nstarted) Complete();
+  nexpected = nloaded = nstarted = ncompleted = 0;
+
+  // the neighbor relation is symmetric, so are the sources and destinations
+  Segments sends, recvs;
+  for (MeshBlock *pmb = pm->pblock; pmb != nullptr; pmb = pmb->next) {
+    const int mylevel = pmb->loc.level;
+    for (auto &bvar : pmb->pbval->bvars) {
+      if (bvar->ExternalBuffers()) nexpected++;
+      const int index = static_cast<int>(bvar->bvar_index);
+      for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+        const NeighborBlock &nb = pmb->pbval->neighbor[n];
+        if (!bvar->NeighborCollective(nb)) continue;
+        const int dlevel = nb.snb.level - mylevel;
+        sends[nb.snb.rank].push_back(
+            {{nb.snb.lid, index, nb.targetid},
+             bvar->ComputeVariableBufferSize(nb.ni, pmb->cnghost, dlevel), bvar.get(),
+             &nb});
+        recvs[nb.snb.rank].push_back(
+            {{pmb->lid, index, nb.bufid},
+             bvar->ComputeVariableBufferSize(nb.ni, pmb->cnghost, -dlevel), bvar.get(),
+             &nb});
+      }
+    }
+  }
+  Place(&sends, &send_buf, &send_counts, &send_displs, [](const Segment &s, Real *buf) {
+    s.bvar->SetCollectiveSend(*s.nb, buf);
+  });
+  Place(&recvs, &recv_buf, &recv_counts, &recv_displs, [](const Segment &s, Real *buf) {
+    s.bvar->SetCollectiveRecv(*s.nb, buf);
+  });
+
+  std::vector<int> ranks;
+  for (auto &r : sends)
+    ranks.push_back(r.first);
+  if (graph_comm != MPI_COMM_NULL) MPI_Comm_free(&graph_comm);
+  MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD, ranks.size(), ranks.data(),
+                                 MPI_UNWEIGHTED, ranks.size(), ranks.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &graph_comm);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void NeighborExchange::Loaded()
+//  \brief counts the boundary variables that have loaded their buffers and starts the
+//  collective once all of them have
+
+void Loaded() {
+#ifdef MPI_PARALLEL
+  std::lock_guard<std::mutex> lock(mutex);
+  if (++nloaded < nexpected) return;
+  nloaded = 0;
+  // the blocks of this rank have received the previous round before loading this one
+  if (ncompleted < nstarted) Complete();
+  Profiler::ScopedRegion region("MPI_Ineighbor_alltoallv");
+  MPI_Ineighbor_alltoallv(send_buf.data(), send_counts.data(), send_displs.data(),
+                          MPI_ATHENA_REAL, recv_buf.data(), recv_counts.data(),
+                          recv_displs.data(), MPI_ATHENA_REAL, graph_comm, &request);
+  ProgressThread::Post(&request, &status, BoundaryStatus::arrived);
+  nstarted++;
+#endif
+}
+
+bool Arrived(int round) {
+#ifdef MPI_PARALLEL
+  std::lock_guard<std::mutex> lock(mutex);
+  if (round < ncompleted) return true;
+  if (round >= nstarted) return false;
+  bool test;
+  {
+    Profiler::ScopedRegion region("MPI_Test");
+    test = ProgressThread::Test(&request, &status, BoundaryStatus::arrived);
+  }
+  if (test) ncompleted++;
+  return round < ncompleted;
+#else
+  return true;
+#endif
+}
+
+void Wait(int round) {
+#ifdef MPI_PARALLEL
+  std::lock_guard<std::mutex> lock(mutex);
+  if (round < ncompleted) return;
+  if (round >= nstarted) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [NeighborExchange::Wait]" << std::endl
+        << "Round " << round << " has not been started, " << nloaded << " of "
+        << nexpected << " boundary variables have loaded their buffers" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  Complete();
+#endif
+}
+
+} // namespace NeighborExchange
+} // namespace parthenon
@@ -0,0 +1,60 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef BVALS_NEIGHBOR_EXCHANGE_HPP_
+#define BVALS_NEIGHBOR_EXCHANGE_HPP_
+//! \file neighbor_exchange.hpp
+//  \brief ghost zone exchange of all blocks of a rank in one MPI neighborhood collective
+//
+// With <parthenon/mpi> exchange = neighborhood, the variable buffers of the cell centered
+// variables of neighbors on other ranks are not exchanged by persistent point-to-point
+// requests but by one MPI_Ineighbor_alltoallv per round on a distributed graph
+// communicator of the ranks that hold neighbors of this rank.  The buffers of all blocks
+// are segments of one send and one receive buffer per rank, in an order that sender and
+// receiver derive independently from the neighbor lists: by local id of the receiving
+// block, boundary variable and buffer id of the receiver.  The collective is started by
+// the last boundary variable of the rank that loads its buffers in SendBoundaryBuffers(),
+// so all cell centered variables with ghost zones have to be sent in every round.
+// Neighbors whose buffers are in shared memory (see node_buffers.hpp), flux corrections
+// and face centered variables are not part of the collective.
+//
+// The graph and the buffers are built by Build() in Mesh::Initialize(), which all ranks
+// call at the start and after every load balancing, once the neighbors are known.
+
+#include <string>
+
+namespace parthenon {
+
+class Mesh;
+
+namespace NeighborExchange {
+
+// engine: "point_to_point" or "neighborhood", has to be called after MPI_Init()
+void Initialize(const std::string &engine);
+// frees the graph communicator, has to be called after the last exchange and before
+// MPI_Finalize()
+void Finalize();
+bool Enabled();
+// builds the graph communicator and the buffers of the current blocks, collective over
+// all ranks
+void Build(Mesh *pm);
+// called once per round by each cell centered boundary variable of this rank after it
+// has loaded its buffers, the last call starts the collective
+void Loaded();
+// whether the collective of the given round (counted from the last Build()) completed
+bool Arrived(int round);
+void Wait(int round);
+
+} // namespace NeighborExchange
+} // namespace parthenon
+
+#endif // BVALS_NEIGHBOR_EXCHANGE_HPP_
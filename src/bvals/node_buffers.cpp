@@ -0,0 +1,204 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file node_buffers.cpp
+//  \brief window, directory and placement of the ghost zone buffers in shared memory
+
+#include "bvals/node_buffers.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+#include "parthenon_mpi.hpp"
+
+#include "athena.hpp"
+#include "bvals/bvals.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+
+namespace parthenon {
+namespace NodeBuffers {
+
+namespace {
+bool enabled = false;
+
+#ifdef MPI_PARALLEL
+MPI_Comm node_comm = MPI_COMM_NULL;
+MPI_Win win = MPI_WIN_NULL;
+std::vector<int> node_rank; // rank in node_comm of each rank, MPI_UNDEFINED elsewhere
+
+// precedes each buffer in the window
+struct Header {
+  std::atomic<int> flag;
+  int size; // of the buffer in Reals, checked by the sender
+};
+// one cache line, which also keeps the buffers aligned
+constexpr std::size_t kHeaderBytes = 64;
+static_assert(sizeof(Header) <= kHeaderBytes, "Header does not fit in kHeaderBytes");
+// the flags are shared between processes
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "std::atomic<int> is not always lock free");
+
+constexpr int kMaxNeighbor = BoundaryData<>::kMaxNeighbor;
+
+std::size_t Align(std::size_t bytes) {
+  return (bytes + kHeaderBytes - 1) / kHeaderBytes * kHeaderBytes;
+}
+
+// calls f(pmb, bvar, nb) for the buffers of the blocks of this rank in shared memory
+template <typename F>
+void ForEachShared(Mesh *pm, const F &f) {
+  for (MeshBlock *pmb = pm->pblock; pmb != nullptr; pmb = pmb->next) {
+    for (auto &bvar : pmb->pbval->bvars) {
+      for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+        NeighborBlock &nb = pmb->pbval->neighbor[n];
+        if (bvar->NodeShared(nb)) f(pmb, bvar.get(), nb);
+      }
+    }
+  }
+}
+
+void FreeWindow() {
+  if (win == MPI_WIN_NULL) return;
+  MPI_Win_unlock_all(win);
+  MPI_Win_free(&win);
+}
+#endif
+} // namespace
+
+void Initialize(bool enable) {
+#ifdef MPI_PARALLEL
+  enabled = enable;
+  if (!enabled) return;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, Globals::my_rank,
+                      MPI_INFO_NULL, &node_comm);
+  MPI_Group world_group, node_group;
+  MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+  MPI_Comm_group(node_comm, &node_group);
+  std::vector<int> ranks(Globals::nranks);
+  std::iota(ranks.begin(), ranks.end(), 0);
+  node_rank.resize(Globals::nranks);
+  MPI_Group_translate_ranks(world_group, Globals::nranks, ranks.data(), node_group,
+                            node_rank.data());
+  MPI_Group_free(&world_group);
+  MPI_Group_free(&node_group);
+#else
+  // without MPI, all neighbors are on this rank
+  enabled = false;
+#endif
+}
+
+void Finalize() {
+#ifdef MPI_PARALLEL
+  if (!enabled) return;
+  FreeWindow();
+  MPI_Comm_free(&node_comm);
+  enabled = false;
+#endif
+}
+
+bool Enabled() { return enabled; }
+
+bool OnNode(int rank) {
+#ifdef MPI_PARALLEL
+  return enabled && rank != Globals::my_rank && node_rank[rank] != MPI_UNDEFINED;
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void NodeBuffers::Setup(Mesh *pm)
+//  \brief allocates the window for the current blocks, places their receive buffers in
+//  it and points their senders at the receive buffers of their neighbors
+
+void Setup(Mesh *pm) {
+#ifdef MPI_PARALLEL
+  if (!enabled) return;
+
+  // the directory holds the offset of each buffer by lid, bvar_index and bufid
+  std::int64_t nblocks = 0, nbvars = 0;
+  for (MeshBlock *pmb = pm->pblock; pmb != nullptr; pmb = pmb->next) {
+    nblocks = std::max<std::int64_t>(nblocks, pmb->lid + 1);
+    nbvars = std::max<std::int64_t>(nbvars, pmb->pbval->bvars.size());
+  }
+  const std::size_t ndir = 2 + nblocks * nbvars * kMaxNeighbor;
+  std::size_t bytes = Align(ndir * sizeof(std::int64_t));
+  ForEachShared(pm, [&](MeshBlock *pmb, BoundaryVariable *bvar, NeighborBlock &nb) {
+    const int dlevel = pmb->loc.level - nb.snb.level;
+    int size = bvar->ComputeVariableBufferSize(nb.ni, pmb->cnghost, dlevel);
+    bytes += kHeaderBytes + Align(size * sizeof(Real));
+  });
+
+  // the buffers of the previous mesh are no longer in use on any rank of the node
+  FreeWindow();
+  char *base;
+  MPI_Win_allocate_shared(bytes, 1, MPI_INFO_NULL, node_comm, &base, &win);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+
+  auto dir = reinterpret_cast<std::int64_t *>(base);
+  dir[0] = nblocks;
+  dir[1] = nbvars;
+  std::fill(dir + 2, dir + ndir, -1);
+  std::size_t offset = Align(ndir * sizeof(std::int64_t));
+  ForEachShared(pm, [&](MeshBlock *pmb, BoundaryVariable *bvar, NeighborBlock &nb) {
+    const int dlevel = pmb->loc.level - nb.snb.level;
+    int size = bvar->ComputeVariableBufferSize(nb.ni, pmb->cnghost, dlevel);
+    auto header = new (base + offset) Header;
+    header->flag.store(0, std::memory_order_relaxed);
+    header->size = size;
+    bvar->SetNodeRecv(nb, reinterpret_cast<Real *>(base + offset + kHeaderBytes),
+                      &header->flag);
+    dir[2 + (pmb->lid * nbvars + bvar->bvar_index) * kMaxNeighbor + nb.bufid] = offset;
+    offset += kHeaderBytes + Align(size * sizeof(Real));
+  });
+
+  // all directories are written before they are read
+  MPI_Win_sync(win);
+  MPI_Barrier(node_comm);
+  MPI_Win_sync(win);
+
+  ForEachShared(pm, [&](MeshBlock *pmb, BoundaryVariable *bvar, NeighborBlock &nb) {
+    MPI_Aint segment_size;
+    int disp_unit;
+    char *target;
+    MPI_Win_shared_query(win, node_rank[nb.snb.rank], &segment_size, &disp_unit,
+                         &target);
+    auto tdir = reinterpret_cast<const std::int64_t *>(target);
+    std::int64_t toffset = -1;
+    if (nb.snb.lid < tdir[0] && static_cast<std::int64_t>(bvar->bvar_index) < tdir[1])
+      toffset = tdir[2 + (nb.snb.lid * tdir[1] + bvar->bvar_index) * kMaxNeighbor +
+                     nb.targetid];
+    const int dlevel = nb.snb.level - pmb->loc.level;
+    int size = bvar->ComputeVariableBufferSize(nb.ni, pmb->cnghost, dlevel);
+    auto header = reinterpret_cast<Header *>(target + toffset);
+    if (toffset < 0 || header->size != size) {
+      std::stringstream msg;
+      msg << "### FATAL ERROR in function [NodeBuffers::Setup]" << std::endl
+          << "Rank " << nb.snb.rank << " has no shared buffer of " << size
+          << " values for block " << nb.snb.gid << " and variable " << bvar->bvar_index
+          << std::endl;
+      ATHENA_ERROR(msg);
+    }
+    bvar->SetNodeSend(nb, reinterpret_cast<Real *>(target + toffset + kHeaderBytes),
+                      &header->flag);
+  });
+#endif
+}
+
+} // namespace NodeBuffers
+} // namespace parthenon
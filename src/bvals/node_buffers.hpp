@@ -0,0 +1,53 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef BVALS_NODE_BUFFERS_HPP_
+#define BVALS_NODE_BUFFERS_HPP_
+//! \file node_buffers.hpp
+//  \brief ghost zone buffers in shared memory for neighbors on other ranks of the node
+//
+// With <parthenon/mpi> shared_memory = true, the ranks of a node (as found by
+// MPI_Comm_split_type(MPI_COMM_TYPE_SHARED)) place the receive buffers of the cell
+// centered variables of their neighbors on the other ranks of the node in one
+// MPI_Win_allocate_shared window instead of posting persistent MPI requests for them.
+// The sending block loads its ghost zones straight into the receive buffer of the
+// neighbor and sets a flag next to it, just like for neighbors on the same rank, which
+// saves the send buffer and the copy through MPI.  Flux corrections and face centered
+// variables are still exchanged by MPI messages.
+//
+// The window is allocated by Setup() after the persistent MPI requests of all blocks are
+// set up, i.e. in Mesh::Initialize(), which all ranks of a node call at the same time.
+// Each rank's segment starts with a directory of the offsets of its buffers by local
+// block id, boundary variable and buffer id, from which the senders find their targets.
+
+namespace parthenon {
+
+class Mesh;
+
+namespace NodeBuffers {
+
+// finds the ranks of this node, has to be called after MPI_Init()
+void Initialize(bool enabled);
+// frees the window, has to be called after the MeshBlocks are gone and before
+// MPI_Finalize()
+void Finalize();
+bool Enabled();
+// whether rank is another rank of this node whose buffers are in shared memory
+bool OnNode(int rank);
+// places the shared buffers of the blocks of this rank and finds the ones of their
+// neighbors, collective over the ranks of the node
+void Setup(Mesh *pm);
+
+} // namespace NodeBuffers
+} // namespace parthenon
+
+#endif // BVALS_NODE_BUFFERS_HPP_
@@ -0,0 +1,192 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file progress_thread.cpp
+//  \brief request list and loop of the progress thread
+
+#include "bvals/progress_thread.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "parthenon_mpi.hpp"
+
+namespace parthenon {
+namespace ProgressThread {
+
+namespace {
+bool enabled = false;
+
+struct Entry {
+  Request *req;
+  std::atomic<BoundaryStatus> *flag;
+  BoundaryStatus done;
+};
+
+std::thread thread;
+std::mutex mutex;
+std::condition_variable posted_cv;
+std::vector<Entry> posted; // handed over since the last pass of the thread
+bool stop = false;
+
+// passes without a completed request before the thread sleeps between passes, and the
+// longest sleep in microseconds
+constexpr int kSpinPasses = 64;
+constexpr int kMaxSleep = 100;
+
+// the sleep after idle passes without a completed request, doubling up to kMaxSleep
+std::chrono::microseconds Backoff(const int idle) {
+  const int shift = std::min(idle - kSpinPasses, 7);
+  return std::chrono::microseconds(std::min(1 << shift, kMaxSleep));
+}
+
+// the indices of the completed requests in idx, completed requests are reset like
+// MPI_Testsome does
+int TestSome(std::vector<Request> &reqs, std::vector<int> &idx) {
+  idx.resize(reqs.size());
+#ifdef MPI_PARALLEL
+  int nout;
+  MPI_Testsome(reqs.size(), reqs.data(), &nout, idx.data(), MPI_STATUSES_IGNORE);
+  return (nout == MPI_UNDEFINED ? 0 : nout);
+#else
+  int nout = 0;
+  for (int n = 0; n < static_cast<int>(reqs.size()); n++) {
+    auto &c = reqs[n].complete;
+    if (c != nullptr && !c->load(std::memory_order_acquire)) continue;
+    c = nullptr;
+    idx[nout++] = n;
+  }
+  return nout;
+#endif
+}
+
+bool TestOne(Request *req) {
+#ifdef MPI_PARALLEL
+  int test;
+  MPI_Test(req, &test, MPI_STATUS_IGNORE);
+  return static_cast<bool>(test);
+#else
+  if (req->complete != nullptr && !req->complete->load(std::memory_order_acquire))
+    return false;
+  req->complete = nullptr;
+  return true;
+#endif
+}
+
+void Run() {
+  // the thread tests its own copies of the requests
+  std::vector<Entry> entries;
+  std::vector<Request> reqs;
+  std::vector<int> idx;
+  int idle = 0; // passes since the last completed or posted request
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    auto woken = [] { return stop || !posted.empty(); };
+    if (entries.empty()) {
+      posted_cv.wait(lock, woken);
+    } else if (idle > kSpinPasses) {
+      // the messages in flight take a while, a new request wakes the thread up
+      posted_cv.wait_for(lock, Backoff(idle), woken);
+    }
+    if (stop) break;
+    if (!posted.empty()) idle = 0;
+    for (auto &e : posted) {
+      entries.push_back(e);
+      reqs.push_back(*e.req);
+    }
+    posted.clear();
+    lock.unlock();
+
+    const int nout = TestSome(reqs, idx);
+    if (nout == 0) {
+      if (++idle <= kSpinPasses) std::this_thread::yield();
+    } else {
+      idle = 0;
+      for (int m = 0; m < nout; m++) {
+        Entry &e = entries[idx[m]];
+        *e.req = reqs[idx[m]];
+        e.flag->store(e.done, std::memory_order_release);
+        e.flag = nullptr;
+      }
+      int n = 0;
+      for (int m = 0; m < static_cast<int>(entries.size()); m++) {
+        if (entries[m].flag == nullptr) continue;
+        entries[n] = entries[m];
+        reqs[n++] = reqs[m];
+      }
+      entries.resize(n);
+      reqs.resize(n);
+    }
+    lock.lock();
+  }
+}
+} // namespace
+
+void Initialize(bool enable) {
+  enabled = enable;
+  if (!enabled) return;
+  stop = false;
+  thread = std::thread(Run);
+}
+
+void Finalize() {
+  if (!enabled) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  posted_cv.notify_one();
+  thread.join();
+  posted.clear();
+  enabled = false;
+}
+
+bool Enabled() { return enabled; }
+
+void Post(Request *req, std::atomic<BoundaryStatus> *flag, BoundaryStatus done) {
+  if (!enabled) return;
+  flag->store(BoundaryStatus::waiting, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    posted.push_back({req, flag, done});
+  }
+  posted_cv.notify_one();
+}
+
+bool Test(Request *req, const std::atomic<BoundaryStatus> *flag, BoundaryStatus done) {
+  if (enabled) return flag->load(std::memory_order_acquire) == done;
+  return TestOne(req);
+}
+
+void Wait(Request *req, const std::atomic<BoundaryStatus> *flag, BoundaryStatus done) {
+  if (!enabled) {
+#ifdef MPI_PARALLEL
+    MPI_Wait(req, MPI_STATUS_IGNORE);
+#else
+    while (!TestOne(req)) {
+      std::this_thread::yield();
+    }
+#endif
+    return;
+  }
+  while (flag->load(std::memory_order_acquire) != done) {
+    std::this_thread::yield();
+  }
+}
+
+} // namespace ProgressThread
+} // namespace parthenon
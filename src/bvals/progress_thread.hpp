@@ -0,0 +1,72 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef BVALS_PROGRESS_THREAD_HPP_
+#define BVALS_PROGRESS_THREAD_HPP_
+//! \file progress_thread.hpp
+//  \brief a thread that drives the progress of the started MPI requests
+//
+// Without it, messages only progress while a task polls for them in
+// ReceiveBoundaryBuffers() or ReceiveFluxCorrection(), so large messages stall while the
+// blocks are computing.  With <parthenon/mpi> progress_thread = true, the requests of
+// the boundary buffers, flux corrections, the neighborhood collective and the AMR
+// redistribution are handed to a thread once they are started.  The thread calls
+// MPI_Testsome on all of them and stores the given BoundaryStatus in the flag of each
+// request that completes, so the tasks only read flags instead of calling into MPI.
+//
+// Test() and Wait() check the flag with the thread and call MPI_Test and MPI_Wait
+// without it, so the callers do not have to distinguish both cases.
+//
+// The thread spins while requests complete and backs off to short sleeps while the
+// messages are in flight, so it only takes a core of its own under communication.
+//
+// Without MPI, the thread completes stand-in requests instead, so that it can be tested
+// without MPI.
+
+#include <atomic>
+
+#include "parthenon_mpi.hpp"
+
+#include "bvals/bvals_interfaces.hpp"
+
+namespace parthenon {
+namespace ProgressThread {
+
+// starts the thread, has to be called after MPI_Init()
+void Initialize(bool enabled);
+// stops the thread, has to be called after the last request has completed and before
+// MPI_Finalize()
+void Finalize();
+bool Enabled();
+
+#ifdef MPI_PARALLEL
+using Request = MPI_Request;
+#else
+// a request that completes once *complete is true, or right away if complete is null
+struct Request {
+  const std::atomic<bool> *complete = nullptr;
+};
+#endif
+
+// hands a started request over to the thread, which writes the completed request back
+// to *req and then stores done in *flag.  The caller must not use *req until then.
+// Does nothing without the thread.
+void Post(Request *req, std::atomic<BoundaryStatus> *flag, BoundaryStatus done);
+// whether the request has completed
+bool Test(Request *req, const std::atomic<BoundaryStatus> *flag, BoundaryStatus done);
+// waits for the request to complete
+void Wait(Request *req, const std::atomic<BoundaryStatus> *flag, BoundaryStatus done);
+
+} // namespace ProgressThread
+} // namespace parthenon
+
+#endif // BVALS_PROGRESS_THREAD_HPP_
@@ -0,0 +1,36 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef COORDINATES_COORDINATE_TRAITS_HPP_
+#define COORDINATES_COORDINATE_TRAITS_HPP_
+//! \file coordinate_traits.hpp
+//  \brief compile-time properties of the coordinate classes
+//
+// Kernels test these traits to evaluate the geometric factors once per block instead of
+// once per cell.  The defaults make no assumptions; a coordinate class for which a
+// property holds specializes CoordinateTraits next to its definition.
+
+namespace parthenon {
+
+template <typename Coords>
+struct CoordinateTraits {
+  // Dx(dir) does not depend on the cell index
+  static constexpr bool uniform_spacing = false;
+  // Area(dir) does not depend on the cell index
+  static constexpr bool constant_area = false;
+  // Volume() does not depend on the cell index
+  static constexpr bool constant_volume = false;
+};
+
+} // namespace parthenon
+
+#endif // COORDINATES_COORDINATE_TRAITS_HPP_
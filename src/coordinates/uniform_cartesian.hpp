@@ -18,6 +18,7 @@
 
 #include "athena.hpp"
 #include "basic_types.hpp"
+#include "coordinates/coordinate_traits.hpp"
 
 #include <Kokkos_Macros.hpp>
 
@@ -163,6 +164,13 @@ class UniformCartesian {
   const std::array<Real, 3> &Dx_() const { return dx_; }
 };
 
+template <>
+struct CoordinateTraits<UniformCartesian> {
+  static constexpr bool uniform_spacing = true;
+  static constexpr bool constant_area = true;
+  static constexpr bool constant_volume = true;
+};
+
 } // namespace parthenon
 
 #endif // COORDINATES_UNIFORM_CARTESIAN_HPP_
@@ -13,6 +13,7 @@
 //========================================================================================
 
 #include <algorithm>
+#include <cassert>
 #include <iomanip>
 #include <limits>
 
@@ -22,6 +23,8 @@
 #include "outputs/outputs.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_mpi.hpp"
+#include "utils/array_pool.hpp"
+#include "utils/profiler.hpp"
 #include "utils/utils.hpp"
 
 namespace parthenon {
@@ -31,8 +34,13 @@ DriverStatus EvolutionDriver::Execute() {
   SetGlobalTimeStep();
   pouts->MakeOutputs(pmesh, pinput, &tm);
   pmesh->mbcnt = 0;
+  // sparse ids allocated on demand are released once they fall to this magnitude
+  const Real sparse_threshold =
+      pinput->GetOrAddReal("parthenon/sparse", "deallocation_threshold", 0.0);
   while (tm.KeepGoing()) {
     if (Globals::my_rank == 0) OutputCycleDiagnostics();
+    // the time per cycle, including remeshing and outputs
+    Profiler::ScopedRegion cycle("EvolutionDriver::Cycle");
 
     TaskListStatus status = Step();
     if (status != TaskListStatus::complete) {
@@ -41,6 +49,11 @@ DriverStatus EvolutionDriver::Execute() {
     }
     // pmesh->UserWorkInLoop();
 
+    for (MeshBlock *pmb = pmesh->pblock; pmb != nullptr; pmb = pmb->next)
+      pmb->real_containers.Get().DeallocateSparseBelow(sparse_threshold);
+    // the sparse ids that are not allocated share one array of zeros
+    assert(ArrayPool::SharedZerosIntact() && "an unallocated sparse id was written");
+
     tm.ncycle++;
     tm.time += tm.dt;
     pmesh->mbcnt += pmesh->nbtotal;
@@ -112,16 +125,29 @@ void EvolutionDriver::SetGlobalTimeStep() {
   MeshBlock *pmb = pmesh->pblock;
 
   Real dt_max = 2.0 * tm.dt;
-  tm.dt = std::numeric_limits<Real>::max();
-  while (pmb != nullptr) {
-    tm.dt = std::min(tm.dt, pmb->NewDt());
-    pmb = pmb->next;
+  bool reduced = false;
+  if (dt_reduction_started_) {
+#ifdef MPI_PARALLEL
+    MPI_Wait(&dt_request_, MPI_STATUS_IGNORE);
+#endif
+    dt_reduction_started_ = false;
+    // the new blocks of a changed mesh have estimated their time steps since
+    reduced = !pmesh->modified;
   }
-  tm.dt = std::min(dt_max, tm.dt);
+  if (reduced) {
+    tm.dt = std::min(dt_max, dt_reduced_);
+  } else {
+    tm.dt = std::numeric_limits<Real>::max();
+    while (pmb != nullptr) {
+      tm.dt = std::min(tm.dt, pmb->NewDt());
+      pmb = pmb->next;
+    }
+    tm.dt = std::min(dt_max, tm.dt);
 
 #ifdef MPI_PARALLEL
-  MPI_Allreduce(MPI_IN_PLACE, &tm.dt, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &tm.dt, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
 #endif
+  }
 
   if (tm.time < tm.tlim &&
       (tm.tlim - tm.time) < tm.dt) // timestep would take us past desired endpoint
@@ -130,6 +156,32 @@ void EvolutionDriver::SetGlobalTimeStep() {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+// \!fn void EvolutionDriver::StartTimeStepReduction()
+// \brief starts the reduction of the new time steps of the blocks of this rank over all
+// ranks, which SetGlobalTimeStep() completes and uses unless the mesh has changed
+
+void EvolutionDriver::StartTimeStepReduction() {
+  dt_reduced_ = std::numeric_limits<Real>::max();
+  for (MeshBlock *pmb = pmesh->pblock; pmb != nullptr; pmb = pmb->next)
+    dt_reduced_ = std::min(dt_reduced_, pmb->NewDt());
+#ifdef MPI_PARALLEL
+  MPI_Iallreduce(MPI_IN_PLACE, &dt_reduced_, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD,
+                 &dt_request_);
+#endif
+  dt_reduction_started_ = true;
+}
+
+bool EvolutionDriver::TimeStepReduced() {
+#ifdef MPI_PARALLEL
+  int test;
+  MPI_Test(&dt_request_, &test, MPI_STATUS_IGNORE);
+  return static_cast<bool>(test);
+#else
+  return true;
+#endif
+}
+
 void EvolutionDriver::OutputCycleDiagnostics() {
   const int dt_precision = std::numeric_limits<Real>::max_digits10 - 1;
   const int ratio_precision = 3;
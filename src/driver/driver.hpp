@@ -14,6 +14,7 @@
 #ifndef DRIVER_DRIVER_HPP_
 #define DRIVER_DRIVER_HPP_
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -24,6 +25,7 @@
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs/outputs.hpp"
+#include "parthenon_mpi.hpp"
 #include "task_list/tasks.hpp"
 
 namespace parthenon {
@@ -59,13 +61,19 @@ class EvolutionDriver : public Driver {
     Real tstop = pinput->GetReal("parthenon/time", "tlim");
     int nmax = pinput->GetOrAddInteger("parthenon/time", "nlim", -1);
     int nout = pinput->GetOrAddInteger("parthenon/time", "ncycle_out", 1);
-    // TODO(jcd): the 0 below should be the current cycle number, not necessarily 0
-    tm = SimTime(start_time, tstop, nmax, 0, nout);
+    // restart files store the cycle number at which they were written
+    int ncycle = pinput->GetOrAddInteger("parthenon/time", "ncycle", 0);
+    tm = SimTime(start_time, tstop, nmax, ncycle, nout);
     pouts = std::make_unique<Outputs>(pmesh, pinput, &tm);
   }
   DriverStatus Execute() override;
   void SetGlobalTimeStep();
   void OutputCycleDiagnostics();
+  // reduce the new time steps of the blocks over all ranks from a task, once all blocks
+  // of this rank have estimated theirs, so that SetGlobalTimeStep() does not have to
+  // unless the mesh has changed since
+  void StartTimeStepReduction();
+  bool TimeStepReduced();
 
   virtual TaskListStatus Step() = 0;
   SimTime tm;
@@ -73,22 +81,44 @@ class EvolutionDriver : public Driver {
  private:
   void InitializeBlockTimeSteps();
   void Report(DriverStatus status);
+
+  bool dt_reduction_started_ = false;
+  Real dt_reduced_;
+#ifdef MPI_PARALLEL
+  MPI_Request dt_request_ = MPI_REQUEST_NULL;
+#endif
 };
 
 namespace DriverUtils {
 
+// the blocks of this rank in the order their task lists are executed
+inline std::vector<MeshBlock *> OrderedBlocks(Mesh *pmesh) {
+  std::vector<MeshBlock *> blocks;
+  for (MeshBlock *pmb = pmesh->pblock; pmb != nullptr; pmb = pmb->next)
+    blocks.push_back(pmb);
+  // blocks with neighbors on other ranks go first, so that the interior blocks do not
+  // delay the messages the other ranks wait for
+  if (TaskList::Prioritized()) {
+    std::stable_partition(blocks.begin(), blocks.end(), [](MeshBlock *pmb) {
+      for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+        if (pmb->pbval->neighbor[n].snb.rank != Globals::my_rank) return true;
+      }
+      return false;
+    });
+  }
+  return blocks;
+}
+
 template <typename T, class... Args>
 TaskListStatus ConstructAndExecuteBlockTasks(T *driver, Args... args) {
 #ifdef OPENMP_PARALLEL
   int nthreads = driver->pmesh->GetNumMeshThreads();
 #endif
   int nmb = driver->pmesh->GetNumMeshBlocksThisRank(Globals::my_rank);
+  std::vector<MeshBlock *> blocks = OrderedBlocks(driver->pmesh);
   std::vector<TaskList> task_lists;
-  MeshBlock *pmb = driver->pmesh->pblock;
-  while (pmb != nullptr) {
+  for (MeshBlock *pmb : blocks)
     task_lists.push_back(driver->MakeTaskList(pmb, std::forward<Args>(args)...));
-    pmb = pmb->next;
-  }
   int complete_cnt = 0;
   while (complete_cnt != nmb) {
     // TODO(pgrete): need to let Kokkos::PartitionManager handle this
@@ -104,6 +134,21 @@ TaskListStatus ConstructAndExecuteBlockTasks(T *driver, Args... args) {
   return TaskListStatus::complete;
 }
 
+// executes the task lists of the blocks and one list of the rank, which comes last, as
+// one TaskRegion.  The driver adds the tasks of the rank with AddRankTasks(), e.g.
+// kernels over all blocks of the rank or reductions, as collective tasks that wait for
+// named tasks of the blocks.
+template <typename T, class... Args>
+TaskListStatus ConstructAndExecuteTaskRegion(T *driver, Args... args) {
+  std::vector<MeshBlock *> blocks = OrderedBlocks(driver->pmesh);
+  const int nblocks = blocks.size();
+  TaskRegion region(nblocks + 1);
+  for (int i = 0; i < nblocks; i++)
+    region[i] = driver->MakeTaskList(blocks[i], args...);
+  driver->AddRankTasks(&region, args...);
+  return region.Execute();
+}
+
 } // namespace DriverUtils
 
 } // namespace parthenon
@@ -57,12 +57,18 @@ MultiStageDriver::MultiStageDriver(ParameterInput *pin, Mesh *pm)
   stage_name[nstages] = stage_name[0];
 }
 
+// Each stage is one TaskRegion, which completes before the next one starts.  The stages
+// cannot overlap yet: a block that starts the next stage sends into the same boundary
+// buffers, flags, MPI requests and tags, and shared memory slots that a slower neighbor
+// still reads for the current stage.  Overlapping them needs these doubled by the
+// parity of the stage.  Neighbors stay within one stage of each other, since a block's
+// sends of a stage follow its receives of the previous one, so two sets are enough.
 TaskListStatus MultiStageBlockTaskDriver::Step() {
-  using DriverUtils::ConstructAndExecuteBlockTasks;
+  using DriverUtils::ConstructAndExecuteTaskRegion;
   TaskListStatus status;
   integrator->dt = tm.dt;
   for (int stage = 1; stage <= integrator->nstages; stage++) {
-    status = ConstructAndExecuteBlockTasks<>(this, stage);
+    status = ConstructAndExecuteTaskRegion<>(this, stage);
     if (status != TaskListStatus::complete) break;
   }
   return status;
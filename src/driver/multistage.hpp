@@ -49,6 +49,9 @@ class MultiStageBlockTaskDriver : public MultiStageDriver {
   // function, which defines the application specific list of tasks and
   // there dependencies that must be executed.
   virtual TaskList MakeTaskList(MeshBlock *pmb, int stage) = 0;
+  // Adds the tasks of the rank to the last list of the region of a stage, which holds
+  // the task lists of the blocks in the other lists, see ConstructAndExecuteTaskRegion.
+  virtual void AddRankTasks(TaskRegion *region, int stage) {}
 };
 
 } // namespace parthenon
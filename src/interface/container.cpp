@@ -13,13 +13,19 @@
 
 #include "interface/container.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
+#include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "bvals/cc/bvals_cc.hpp"
+#include "kokkos_abstraction.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/array_pool.hpp"
 
 namespace parthenon {
 
@@ -65,6 +71,12 @@ void Container<T>::Add(const std::string label, const Metadata &metadata,
   // branch on kind of variable
   if (metadata.IsSet(Metadata::Sparse)) {
     // add a sparse variable
+    if (metadata.IsSet(Metadata::OnDemand) && pmy_block != nullptr &&
+        pmy_block->pmy_mesh->multilevel) {
+      throw std::invalid_argument("Sparse variable " + label +
+                                  " is allocated on demand, which is not supported with "
+                                  "mesh refinement");
+    }
     if (sparseMap_.find(label) == sparseMap_.end()) {
       auto sv = std::make_shared<SparseVariable<T>>(label, metadata, arrDims);
       sparseMap_[label] = sv;
@@ -88,14 +100,13 @@ void Container<T>::Add(const std::string label, const Metadata &metadata,
       std::cerr << "Currently one one-copy face fields are supported" << std::endl;
       std::exit(1);
     }
-    if (metadata.IsSet(Metadata::FillGhost)) {
-      std::cerr << "Ghost zones not yet supported for face fields" << std::endl;
-      std::exit(1);
-    }
     // add a face variable
     auto pfv = std::make_shared<FaceVariable<T>>(label, arrDims, metadata);
     faceVector_.push_back(pfv);
     faceMap_[label] = pfv;
+    if (metadata.IsSet(Metadata::FillGhost)) {
+      pfv->allocateComms(pmy_block);
+    }
   } else {
     auto sv = std::make_shared<CellVariable<T>>(label, arrDims, metadata);
     varVector_.push_back(sv);
@@ -106,6 +117,64 @@ void Container<T>::Add(const std::string label, const Metadata &metadata,
   }
 }
 
+template <typename T>
+bool Container<T>::contiguous_ = false;
+
+template <typename T>
+void Container<T>::AllocateContiguous() {
+  if (!contiguous_) return;
+  // variables that own their fluxes first, then the other Independent ones
+  auto order = [](const std::shared_ptr<CellVariable<T>> &v) {
+    if (v->flux[X1DIR].Get().data() != nullptr && !v->IsSet(Metadata::SharedComms))
+      return 0;
+    return (v->IsSet(Metadata::Independent) ? 1 : 2);
+  };
+  std::map<std::array<int, 3>, CellVariableVector<T>> shapes;
+  for (auto &v : varVector_) {
+    // OneCopy variables of another container were placed with it
+    if (!v->IsAllocated() || v->StorageOffset() >= 0) continue;
+    shapes[{v->GetDim(3), v->GetDim(2), v->GetDim(1)}].push_back(v);
+  }
+  if (shapes.empty()) return;
+
+  for (auto &shape : shapes) {
+    auto &vars = shape.second;
+    std::stable_sort(vars.begin(), vars.end(),
+                     [&](const std::shared_ptr<CellVariable<T>> &a,
+                         const std::shared_ptr<CellVariable<T>> &b) {
+                       return order(a) < order(b);
+                     });
+    int nslabs = 0, nfluxes = 0;
+    for (auto &v : vars) {
+      const int n = v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
+      nslabs += n;
+      if (order(v) == 0) nfluxes += n;
+    }
+    const auto &n = shape.first;
+    ParArray4D<T> storage[4];
+    storage[0] = ArrayPool::Get<T>("ContiguousStorage", 1, 1, nslabs, n[0], n[1], n[2])
+                     .template Get<4>();
+    const bool has_flux[4] = {false, nfluxes > 0, nfluxes > 0 && n[1] > 1,
+                              nfluxes > 0 && n[0] > 1};
+    for (int d = X1DIR; d <= X3DIR; d++) {
+      if (!has_flux[d]) continue;
+      storage[d] = ArrayPool::Get<T>("ContiguousStorage.flux" + std::to_string(d), 1, 1,
+                                     nfluxes, n[0], n[1], n[2])
+                       .template Get<4>();
+    }
+    int offset = 0;
+    for (auto &v : vars) {
+      v->SetStorage(storage, offset);
+      offset += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
+    }
+  }
+  // the cached packs refer to the separate arrays
+  varPackMap_.clear();
+  varInterleavedPackMap_.clear();
+  varFluxPackMap_.clear();
+  varVectorDirMap_.clear();
+}
+
 // Constructor for getting sub-containers
 // the variables returned are all shallow copies of the src container.
 // Optionally extract only some of the sparse ids of src variable.
@@ -214,6 +283,77 @@ Container<T> Container<T>::SparseSlice(int id) {
   return c;
 }
 
+template <typename T>
+void Container<T>::AllocateSparse(const std::string &label, const int sparse_id) {
+  // all containers of the block see the same ids, so that the stages agree
+  if (pmy_block != nullptr)
+    pmy_block->real_containers.SetSparseAllocation(label, sparse_id, true);
+  SetSparseAllocation_(label, sparse_id, true, nullptr);
+}
+
+template <typename T>
+void Container<T>::DeallocateSparse(const std::string &label, const int sparse_id) {
+  if (pmy_block != nullptr)
+    pmy_block->real_containers.SetSparseAllocation(label, sparse_id, false);
+  SetSparseAllocation_(label, sparse_id, false, nullptr);
+}
+
+template <typename T>
+void Container<T>::DeallocateSparseBelow(const T threshold) {
+  std::vector<std::pair<std::string, int>> below;
+  for (auto &sv : sparseVector_) {
+    if (!sv->IsSet(Metadata::OnDemand)) continue;
+    for (auto &v : sv->GetVector()) {
+      if (!v->IsAllocated()) continue;
+      const T *data = v->data.Get().data();
+      T vmax = 0;
+      Kokkos::parallel_reduce(
+          "DeallocateSparseBelow",
+          Kokkos::RangePolicy<>(DevExecSpace(), 0, v->data.GetSize()),
+          KOKKOS_LAMBDA(const int n, T &lmax) {
+            const T a = (data[n] < 0 ? -data[n] : data[n]);
+            if (a > lmax) lmax = a;
+          },
+          Kokkos::Max<T>(vmax));
+      if (vmax <= threshold)
+        below.push_back(std::make_pair(sv->label(), v->metadata().GetSparseId()));
+    }
+  }
+  for (auto &id : below)
+    DeallocateSparse(id.first, id.second);
+}
+
+template <typename T>
+void Container<T>::SetSparseAllocation_(const std::string &label, const int sparse_id,
+                                        const bool allocate, Container<T> *base) {
+  auto sv = sparseMap_.find(label);
+  if (sv == sparseMap_.end()) return;
+  auto &vmap = sv->second->GetMap();
+  auto v = vmap.find(sparse_id);
+  if (v == vmap.end() || !v->second->IsSet(Metadata::OnDemand)) return;
+
+  if (allocate) {
+    const CellVariable<T> *comms_src = nullptr;
+    if (base != nullptr) {
+      auto bsv = base->sparseMap_.find(label);
+      if (bsv != base->sparseMap_.end()) {
+        auto &bmap = bsv->second->GetMap();
+        auto bv = bmap.find(sparse_id);
+        if (bv != bmap.end()) comms_src = bv->second.get();
+      }
+    }
+    v->second->Allocate(comms_src);
+  } else {
+    v->second->Deallocate();
+  }
+  // the variable may be shared with other containers, so the cached packs are
+  // dropped even if it was already (de)allocated through one of them
+  varPackMap_.clear();
+  varInterleavedPackMap_.clear();
+  varFluxPackMap_.clear();
+  varVectorDirMap_.clear();
+}
+
 /// Queries related to variable packs
 /// TODO(JMM): Make sure this is thread-safe
 /// TODO(JMM): Should the vector of names be sorted to enforce uniqueness?
@@ -317,9 +457,42 @@ VariablePack<T> Container<T>::PackVariablesHelper_(const std::vector<std::string
   // return std::get<0>(kvpair->second);
 }
 template <typename T>
+InterleavedPack<T>
+Container<T>::PackVariablesInterleavedHelper_(const std::vector<std::string> &names,
+                                              const vpack_types::VarList<T> &vars,
+                                              PackIndexMap &vmap) {
+  // only the allocation of the copy is cached, the values are gathered on every call so
+  // that the pack never returns values the variables no longer hold
+  const DevExecSpace exec_space =
+      (pmy_block != nullptr ? pmy_block->exec_space : DevExecSpace());
+  auto kvpair = varInterleavedPackMap_.find(names);
+  if (kvpair != varInterleavedPackMap_.end()) {
+    vmap = (kvpair->second).map;
+    (kvpair->second).pack.Gather(exec_space);
+    return (kvpair->second).pack;
+  }
+  auto pack = MakePack<T, PackLayout::variable_innermost>(vars, &vmap);
+  InterleavedPackIndxPair<T> value;
+  value.pack = pack;
+  value.map = vmap;
+  varInterleavedPackMap_[names] = value;
+  pack.Gather(exec_space);
+  return pack;
+}
+template <typename T>
 VariablePack<T> Container<T>::PackVariables(const std::vector<std::string> &names,
                                             const std::vector<int> &sparse_ids,
                                             PackIndexMap &vmap) {
+  // explicitly requested sparse ids are allocated, like in Get(label, sparse_id)
+  for (auto &name : names) {
+    auto sv = sparseMap_.find(name);
+    if (sv == sparseMap_.end()) continue;
+    for (int id : sparse_ids) {
+      auto v = sv->second->GetMap().find(id);
+      if (v != sv->second->GetMap().end() && !v->second->IsAllocated())
+        AllocateSparse(name, id);
+    }
+  }
   std::vector<std::string> expanded_names;
   vpack_types::VarList<T> vars = MakeList_(names, expanded_names, sparse_ids);
   return PackVariablesHelper_(expanded_names, vars, vmap);
@@ -363,6 +536,48 @@ VariablePack<T> Container<T>::PackVariables() {
   PackIndexMap vmap;
   return PackVariables(vmap);
 }
+template <typename T>
+InterleavedPack<T>
+Container<T>::PackVariablesInterleaved(const std::vector<std::string> &names,
+                                       PackIndexMap &vmap) {
+  std::vector<std::string> expanded_names;
+  vpack_types::VarList<T> vars = MakeList_(names, expanded_names, {});
+  return PackVariablesInterleavedHelper_(expanded_names, vars, vmap);
+}
+template <typename T>
+InterleavedPack<T>
+Container<T>::PackVariablesInterleaved(const std::vector<MetadataFlag> &flags,
+                                       PackIndexMap &vmap) {
+  std::vector<std::string> vnams;
+  vpack_types::VarList<T> vars = MakeList_(flags, vnams);
+  return PackVariablesInterleavedHelper_(vnams, vars, vmap);
+}
+template <typename T>
+ParArray1D<int>
+Container<T>::PackVectorDirections(const std::vector<MetadataFlag> &flags) {
+  std::vector<std::string> vnams;
+  vpack_types::VarList<T> vars = MakeList_(flags, vnams);
+  auto kvpair = varVectorDirMap_.find(vnams);
+  if (kvpair != varVectorDirMap_.end()) return kvpair->second;
+
+  PackIndexMap vmap;
+  auto q = PackVariablesHelper_(vnams, vars, vmap);
+  ParArray1D<int> vector_dir("vector_dir", q.GetDim(4));
+  auto vector_dir_h = Kokkos::create_mirror_view(vector_dir);
+  for (int n = 0; n < q.GetDim(4); n++)
+    vector_dir_h(n) = 0;
+  for (auto &pvar : vars) {
+    if (!pvar->IsSet(Metadata::Vector)) continue;
+    auto idx = vmap.find(pvar->label());
+    if (idx == vmap.end()) continue;
+    // the component is the fastest index of the outer dimensions of a variable
+    for (int n = idx->second.first; n <= idx->second.second; n++)
+      vector_dir_h(n) = (n - idx->second.first) % pvar->GetDim(4) + 1;
+  }
+  Kokkos::deep_copy(vector_dir, vector_dir_h);
+  varVectorDirMap_[vnams] = vector_dir;
+  return vector_dir;
+}
 
 // From a given container, extract all variables and all fields in sparse variables
 // into a single linked list of variables. The sparse fields are then named
@@ -467,14 +682,15 @@ bool Container<T>::ReceiveFluxCorrection() {
 }
 
 template <typename T>
-void Container<T>::SendBoundaryBuffers() {
+bool Container<T>::SendBoundaryBuffers() {
   // sends the boundary
+  bool sent = true;
   debug = 0;
   //  std::cout << "_________SEND from stage:"<<s->name()<<std::endl;
   for (auto &v : varVector_) {
     if (v->IsSet(Metadata::FillGhost)) {
       v->resetBoundary();
-      v->vbvar->SendBoundaryBuffers();
+      sent = v->vbvar->SendBoundaryBuffers() && sent;
     }
   }
   for (auto &sv : sparseVector_) {
@@ -482,12 +698,18 @@ void Container<T>::SendBoundaryBuffers() {
       CellVariableVector<T> vvec = sv->GetVector();
       for (auto &v : vvec) {
         v->resetBoundary();
-        v->vbvar->SendBoundaryBuffers();
+        sent = v->vbvar->SendBoundaryBuffers() && sent;
       }
     }
   }
 
-  return;
+  for (auto &v : faceVector_) {
+    if (v->IsSet(Metadata::FillGhost)) {
+      sent = v->vbvar->SendBoundaryBuffers() && sent;
+    }
+  }
+
+  return sent;
 }
 
 template <typename T>
@@ -508,6 +730,12 @@ void Container<T>::SetupPersistentMPI() {
       }
     }
   }
+  for (auto &v : faceVector_) {
+    if (v->IsSet(Metadata::FillGhost)) {
+      v->vbvar->SetupPersistentMPI();
+    }
+  }
+
   return;
 }
 
@@ -543,6 +771,13 @@ bool Container<T>::ReceiveBoundaryBuffers() {
     }
   }
 
+  for (auto &v : faceVector_) {
+    if (v->IsSet(Metadata::FillGhost) && !v->mpiStatus) {
+      v->mpiStatus = v->vbvar->ReceiveBoundaryBuffers();
+      ret = (ret & v->mpiStatus);
+    }
+  }
+
   return ret;
 }
 
@@ -563,11 +798,18 @@ void Container<T>::ReceiveAndSetBoundariesWithWait() {
         if (!v->mpiStatus) {
           v->resetBoundary();
           v->vbvar->ReceiveAndSetBoundariesWithWait();
+          SetReceivedSparse_(sv->label(), v);
           v->mpiStatus = true;
         }
       }
     }
   }
+  for (auto &v : faceVector_) {
+    if ((!v->mpiStatus) && v->IsSet(Metadata::FillGhost)) {
+      v->vbvar->ReceiveAndSetBoundariesWithWait();
+      v->mpiStatus = true;
+    }
+  }
 }
 // This really belongs in Container.cpp. However if I put it in there,
 // the meshblock file refuses to compile.  Don't know what's going on
@@ -590,9 +832,26 @@ void Container<T>::SetBoundaries() {
       for (auto &v : vvec) {
         v->resetBoundary();
         v->vbvar->SetBoundaries();
+        SetReceivedSparse_(sv->label(), v);
       }
     }
   }
+  for (auto &v : faceVector_) {
+    if (v->IsSet(Metadata::FillGhost)) {
+      v->vbvar->SetBoundaries();
+    }
+  }
+}
+
+// an unallocated sparse id that received non-zero ghost zones is allocated on this block
+// and the ghost zones are set again
+template <typename T>
+void Container<T>::SetReceivedSparse_(const std::string &label,
+                                      std::shared_ptr<CellVariable<T>> &v) {
+  if (v->IsAllocated() || !v->vbvar->ReceivedNonZero()) return;
+  AllocateSparse(label, v->metadata().GetSparseId());
+  v->resetBoundary();
+  v->vbvar->SetBoundaries();
 }
 
 template <typename T>
@@ -606,7 +865,7 @@ void Container<T>::ResetBoundaryCellVariables() {
     if (sv->IsSet(Metadata::FillGhost)) {
       CellVariableVector<T> vvec = sv->GetVector();
       for (auto &v : vvec) {
-        v->vbvar->var_cc = v->data;
+        v->resetBoundary();
       }
     }
   }
@@ -634,6 +893,12 @@ void Container<T>::StartReceiving(BoundaryCommSubset phase) {
       }
     }
   }
+  for (auto &v : faceVector_) {
+    if (v->IsSet(Metadata::FillGhost)) {
+      v->vbvar->StartReceiving(phase);
+      v->mpiStatus = false;
+    }
+  }
 }
 
 template <typename T>
@@ -654,6 +919,11 @@ void Container<T>::ClearBoundary(BoundaryCommSubset phase) {
       }
     }
   }
+  for (auto &v : faceVector_) {
+    if (v->IsSet(Metadata::FillGhost)) {
+      v->vbvar->ClearBoundary(phase);
+    }
+  }
 }
 
 template <typename T>
@@ -39,6 +39,8 @@ namespace parthenon {
 ///
 
 class MeshBlock;
+template <typename T>
+class ContainerCollection;
 
 template <typename T>
 class Container {
@@ -125,6 +127,18 @@ class Container {
   ///
   void Add(const std::vector<std::string> labelVector, const Metadata &metadata);
 
+  ///
+  /// Move the allocated non-sparse cell variables of the container that are not in a
+  /// contiguous storage yet, and the fluxes they own, into one contiguous 4D allocation
+  /// per cell shape.  The variables that own fluxes come first and the other
+  /// Independent variables next, so that packs of them are plain 4D views of the
+  /// storage.  Does nothing unless enabled with SetContiguous(true), i.e. the input
+  /// parameter <parthenon/memory> contiguous = true.
+  ///
+  void AllocateContiguous();
+  static void SetContiguous(const bool contiguous) { contiguous_ = contiguous; }
+  static bool Contiguous() { return contiguous_; }
+
   void Add(std::shared_ptr<CellVariable<T>> var) {
     varVector_.push_back(var);
     varMap_[var->label()] = var;
@@ -182,10 +196,27 @@ class Container {
     return GetSparseVariable(label).GetVector();
   }
 
+  /// Sparse ids that are allocated on demand are allocated by this call, since the
+  /// returned variable may be written.
   CellVariable<T> &Get(const std::string &label, const int sparse_id) {
-    return GetSparseVariable(label).Get(sparse_id);
+    CellVariable<T> &v = GetSparseVariable(label).Get(sparse_id);
+    if (!v.IsAllocated()) AllocateSparse(label, sparse_id);
+    return v;
   }
 
+  ///
+  /// Allocate (deallocate) a sparse id with the Metadata::OnDemand flag in all containers
+  /// of the MeshBlock.  Deallocated ids read as zeros and are left out of the packs.
+  ///
+  /// @param label the name of the sparse variable
+  /// @param sparse_id the sparse id
+  ///
+  void AllocateSparse(const std::string &label, const int sparse_id);
+  void DeallocateSparse(const std::string &label, const int sparse_id);
+  /// Deallocate the sparse ids with the Metadata::OnDemand flag whose absolute values
+  /// are all at most threshold
+  void DeallocateSparseBelow(const T threshold);
+
   std::vector<int> &GetSparseIndexMap(const std::string &label) {
     return GetSparseVariable(label).GetIndexMap();
   }
@@ -252,6 +283,17 @@ class Container {
   VariablePack<T> PackVariables(const std::vector<MetadataFlag> &flags);
   VariablePack<T> PackVariables(PackIndexMap &vmap);
   VariablePack<T> PackVariables();
+  /// Packs in the variable_innermost layout hold a copy of the values of the variables,
+  /// which is gathered each time the pack is returned, also from the cache.  Between
+  /// calls the copy is only refreshed by InterleavedPack::Gather(), and values written
+  /// to it only reach the variables through InterleavedPack::Scatter().
+  InterleavedPack<T> PackVariablesInterleaved(const std::vector<std::string> &names,
+                                              PackIndexMap &vmap);
+  InterleavedPack<T> PackVariablesInterleaved(const std::vector<MetadataFlag> &flags,
+                                              PackIndexMap &vmap);
+  /// The direction (X1DIR, X2DIR or X3DIR) of the Vector component held by each entry of
+  /// PackVariables(flags), 0 for the other entries.  Cached like the pack itself.
+  ParArray1D<int> PackVectorDirections(const std::vector<MetadataFlag> &flags);
 
   /// Remove a variable from the container or throw exception if not
   /// found.
@@ -268,7 +310,7 @@ class Container {
   void ResetBoundaryCellVariables();
   void SetupPersistentMPI();
   void SetBoundaries();
-  void SendBoundaryBuffers();
+  bool SendBoundaryBuffers();
   void ReceiveAndSetBoundariesWithWait();
   bool ReceiveBoundaryBuffers();
   void StartReceiving(BoundaryCommSubset phase);
@@ -288,7 +330,7 @@ class Container {
     return TaskStatus::complete;
   }
   static TaskStatus SendBoundaryBuffersTask(Container<T> &rc) {
-    rc.SendBoundaryBuffers();
+    if (!rc.SendBoundaryBuffers()) return TaskStatus::incomplete;
     return TaskStatus::complete;
   }
   static TaskStatus ReceiveBoundaryBuffersTask(Container<T> &rc) {
@@ -331,7 +373,10 @@ class Container {
   }
 
  private:
+  friend class ContainerCollection<T>;
+
   int debug = 0;
+  static bool contiguous_;
 
   CellVariableVector<T> varVector_ = {}; ///< the saved variable array
   FaceVector<T> faceVector_ = {};        ///< the saved face arrays
@@ -342,7 +387,16 @@ class Container {
   MapToSparse<T> sparseMap_ = {};
 
   MapToVariablePack<T> varPackMap_ = {};
+  MapToInterleavedPack<T> varInterleavedPackMap_ = {};
   MapToVariableFluxPack<T> varFluxPackMap_ = {};
+  std::map<std::vector<std::string>, ParArray1D<int>> varVectorDirMap_ = {};
+
+  // allocates or deallocates a sparse id in this container only; the fluxes of variables
+  // with SharedComms are taken from the same id in base
+  void SetSparseAllocation_(const std::string &label, const int sparse_id,
+                            const bool allocate, Container<T> *base);
+
+  void SetReceivedSparse_(const std::string &label, std::shared_ptr<CellVariable<T>> &v);
 
   void calcArrDims_(std::array<int, 6> &arrDims, const std::vector<int> &dims,
                     const Metadata &metadata);
@@ -365,6 +419,9 @@ class Container {
   VariablePack<T> PackVariablesHelper_(const std::vector<std::string> &names,
                                        const vpack_types::VarList<T> &vars,
                                        PackIndexMap &vmap);
+  InterleavedPack<T> PackVariablesInterleavedHelper_(
+      const std::vector<std::string> &names, const vpack_types::VarList<T> &vars,
+      PackIndexMap &vmap);
 };
 
 } // namespace parthenon
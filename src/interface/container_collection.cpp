@@ -58,6 +58,7 @@ void ContainerCollection<T>::Add(const std::string &name, Container<T> &src) {
     }
   }
 
+  c->AllocateContiguous();
   containers_[name] = c;
 }
 
@@ -40,6 +40,17 @@ class ContainerCollection {
     return *(it->second);
   }
 
+  // allocates or deallocates a sparse id in all containers, the base container first
+  void SetSparseAllocation(const std::string &label, const int sparse_id,
+                           const bool allocate) {
+    auto &base = containers_["base"];
+    base->SetSparseAllocation_(label, sparse_id, allocate, nullptr);
+    for (auto &c : containers_) {
+      if (c.second != base)
+        c.second->SetSparseAllocation_(label, sparse_id, allocate, base.get());
+    }
+  }
+
   void PurgeNonBase() {
     auto c = containers_.begin();
     while (c != containers_.end()) {
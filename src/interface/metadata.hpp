@@ -61,6 +61,8 @@
   PARTHENON_INTERNAL_FOR_FLAG(Graphics)                                                  \
   /** is specified per-sparse index */                                                   \
   PARTHENON_INTERNAL_FOR_FLAG(Sparse)                                                    \
+  /** sparse ids are only allocated on the blocks on which they are non-zero */          \
+  PARTHENON_INTERNAL_FOR_FLAG(OnDemand)                                                  \
   /** is an independent, evolved variable */                                             \
   PARTHENON_INTERNAL_FOR_FLAG(Independent)                                               \
   /** is a derived quantity (ignored) */                                                 \
@@ -201,6 +203,7 @@ class Metadata {
   }
 
   int GetSparseId() const { return sparse_id_; }
+  void SetSparseId(const int sparse_id) { sparse_id_ = sparse_id; }
 
   const std::vector<int> &Shape() const { return shape_; }
 
@@ -28,7 +28,9 @@ void SparseVariable<T>::Add(int varIndex) {
     }
     // create the variable and add to map
     std::string my_name = label_ + "_" + std::to_string(varIndex);
-    auto v = std::make_shared<CellVariable<T>>(my_name, dims_, metadata_);
+    Metadata m = metadata_;
+    m.SetSparseId(varIndex);
+    auto v = std::make_shared<CellVariable<T>>(my_name, dims_, m);
     varArray_.push_back(v);
     indexMap_.push_back(varIndex);
     varMap_[varIndex] = v;
@@ -26,85 +26,59 @@ namespace parthenon {
 
 namespace Update {
 
-TaskStatus FluxDivergence(Container<Real> &in, Container<Real> &dudt_cont) {
-  MeshBlock *pmb = in.pmy_block;
-  int is = pmb->is;
-  int js = pmb->js;
-  int ks = pmb->ks;
-  int ie = pmb->ie;
-  int je = pmb->je;
-  int ke = pmb->ke;
-
-  auto vin = in.PackVariablesAndFluxes({Metadata::Independent});
-  auto dudt = dudt_cont.PackVariables({Metadata::Independent});
+namespace detail {
 
-  auto &coords = pmb->coords;
-  int ndim = pmb->pmy_mesh->ndim;
+template <typename Pack>
+void UpdateContainer(MeshBlock *pmb, Pack vin, Pack dudt, const Real dt, Pack vout) {
   pmb->par_for(
-      "flux divergence", 0, vin.GetDim(4) - 1, ks, ke, js, je, is, ie,
+      "UpdateContainer", 0, vin.GetDim(4) - 1, 0, vin.GetDim(3) - 1, 0, vin.GetDim(2) - 1,
+      0, vin.GetDim(1) - 1,
       KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
-        dudt(l, k, j, i) = 0.0;
-        dudt(l, k, j, i) +=
-            (coords.Area(X1DIR, k, j, i + 1) * vin.flux(X1DIR, l, k, j, i + 1) -
-             coords.Area(X1DIR, k, j, i) * vin.flux(X1DIR, l, k, j, i));
-        if (ndim >= 2) {
-          dudt(l, k, j, i) +=
-              (coords.Area(X2DIR, k, j + 1, i) * vin.flux(X2DIR, l, k, j + 1, i) -
-               coords.Area(X2DIR, k, j, i) * vin.flux(X2DIR, l, k, j, i));
-        }
-        if (ndim == 3) {
-          dudt(l, k, j, i) +=
-              (coords.Area(X3DIR, k + 1, j, i) * vin.flux(X3DIR, l, k + 1, j, i) -
-               coords.Area(X3DIR, k, j, i) * vin.flux(X3DIR, l, k, j, i));
-        }
-        dudt(l, k, j, i) /= -coords.Volume(k, j, i);
+        vout(l, k, j, i) = vin(l, k, j, i) + dt * dudt(l, k, j, i);
       });
+}
 
-  return TaskStatus::complete;
+template <typename Pack>
+void AverageContainers(MeshBlock *pmb, Pack v1, Pack v2, const Real wgt1) {
+  pmb->par_for(
+      "AverageContainers", 0, v1.GetDim(4) - 1, pmb->ks, pmb->ke, pmb->js, pmb->je,
+      pmb->is, pmb->ie,
+      KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+        v1(l, k, j, i) = wgt1 * v1(l, k, j, i) + (1 - wgt1) * v2(l, k, j, i);
+      });
+}
+
+} // namespace detail
+
+TaskStatus FluxDivergence(Container<Real> &in, Container<Real> &dudt_cont) {
+  return FluxDivergence(in, dudt_cont, in.pmy_block->coords);
 }
 
 void UpdateContainer(Container<Real> &in, Container<Real> &dudt_cont, const Real dt,
                      Container<Real> &out) {
   MeshBlock *pmb = in.pmy_block;
-  int is = pmb->is;
-  int js = pmb->js;
-  int ks = pmb->ks;
-  int ie = pmb->ie;
-  int je = pmb->je;
-  int ke = pmb->ke;
-
   auto vin = in.PackVariables({Metadata::Independent});
   auto vout = out.PackVariables({Metadata::Independent});
   auto dudt = dudt_cont.PackVariables({Metadata::Independent});
 
-  pmb->par_for(
-      "UpdateContainer", 0, vin.GetDim(4) - 1, 0, vin.GetDim(3) - 1, 0, vin.GetDim(2) - 1,
-      0, vin.GetDim(1) - 1,
-      KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
-        vout(l, k, j, i) = vin(l, k, j, i) + dt * dudt(l, k, j, i);
-      });
-  return;
+  if (vin.IsContiguous() && dudt.IsContiguous() && vout.IsContiguous()) {
+    detail::UpdateContainer(pmb, vin.Contiguous(), dudt.Contiguous(), dt,
+                            vout.Contiguous());
+  } else {
+    detail::UpdateContainer(pmb, vin, dudt, dt, vout);
+  }
 }
 
 void AverageContainers(Container<Real> &c1, Container<Real> &c2, const Real wgt1) {
   MeshBlock *pmb = c1.pmy_block;
-  int is = pmb->is;
-  int js = pmb->js;
-  int ks = pmb->ks;
-  int ie = pmb->ie;
-  int je = pmb->je;
-  int ke = pmb->ke;
-
   auto v1 = c1.PackVariables({Metadata::Independent});
   auto v2 = c2.PackVariables({Metadata::Independent});
 
-  pmb->par_for(
-      "AverageContainers", 0, v1.GetDim(4) - 1, ks, ke, js, je, is, ie,
-      KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
-        v1(l, k, j, i) = wgt1 * v1(l, k, j, i) + (1 - wgt1) * v2(l, k, j, i);
-      });
-
-  return;
+  if (v1.IsContiguous() && v2.IsContiguous()) {
+    detail::AverageContainers(pmb, v1.Contiguous(), v2.Contiguous(), wgt1);
+  } else {
+    detail::AverageContainers(pmb, v1, v2, wgt1);
+  }
 }
 
 Real EstimateTimestep(Container<Real> &rc) {
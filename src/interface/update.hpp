@@ -13,7 +13,10 @@
 #ifndef INTERFACE_UPDATE_HPP_
 #define INTERFACE_UPDATE_HPP_
 
+#include <type_traits>
+
 #include "athena.hpp"
+#include "coordinates/coordinate_traits.hpp"
 #include "interface/container.hpp"
 #include "mesh/mesh.hpp"
 
@@ -21,7 +24,87 @@ namespace parthenon {
 
 namespace Update {
 
+namespace detail {
+
+// the geometric factors are the same for all cells
+template <typename Coords, typename FluxPack, typename Pack>
+void FluxDivergence(std::true_type, MeshBlock *pmb, const Coords &coords, const int ndim,
+                    FluxPack vin, Pack dudt) {
+  const Real a1 = coords.Area(X1DIR) / coords.Volume();
+  const Real a2 = coords.Area(X2DIR) / coords.Volume();
+  const Real a3 = coords.Area(X3DIR) / coords.Volume();
+  pmb->par_for(
+      "flux divergence", 0, vin.GetDim(4) - 1, pmb->ks, pmb->ke, pmb->js, pmb->je,
+      pmb->is, pmb->ie,
+      KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+        Real div = a1 * (vin.flux(X1DIR, l, k, j, i + 1) - vin.flux(X1DIR, l, k, j, i));
+        if (ndim >= 2)
+          div += a2 * (vin.flux(X2DIR, l, k, j + 1, i) - vin.flux(X2DIR, l, k, j, i));
+        if (ndim == 3)
+          div += a3 * (vin.flux(X3DIR, l, k + 1, j, i) - vin.flux(X3DIR, l, k, j, i));
+        dudt(l, k, j, i) = -div;
+      });
+}
+
+// the areas and volumes are looked up per cell
+template <typename Coords, typename FluxPack, typename Pack>
+void FluxDivergence(std::false_type, MeshBlock *pmb, const Coords &coords,
+                    const int ndim, FluxPack vin, Pack dudt) {
+  pmb->par_for(
+      "flux divergence", 0, vin.GetDim(4) - 1, pmb->ks, pmb->ke, pmb->js, pmb->je,
+      pmb->is, pmb->ie,
+      KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+        dudt(l, k, j, i) = 0.0;
+        dudt(l, k, j, i) +=
+            (coords.Area(X1DIR, k, j, i + 1) * vin.flux(X1DIR, l, k, j, i + 1) -
+             coords.Area(X1DIR, k, j, i) * vin.flux(X1DIR, l, k, j, i));
+        if (ndim >= 2) {
+          dudt(l, k, j, i) +=
+              (coords.Area(X2DIR, k, j + 1, i) * vin.flux(X2DIR, l, k, j + 1, i) -
+               coords.Area(X2DIR, k, j, i) * vin.flux(X2DIR, l, k, j, i));
+        }
+        if (ndim == 3) {
+          dudt(l, k, j, i) +=
+              (coords.Area(X3DIR, k + 1, j, i) * vin.flux(X3DIR, l, k + 1, j, i) -
+               coords.Area(X3DIR, k, j, i) * vin.flux(X3DIR, l, k, j, i));
+        }
+        dudt(l, k, j, i) /= -coords.Volume(k, j, i);
+      });
+}
+
+} // namespace detail
+
 TaskStatus FluxDivergence(Container<Real> &in, Container<Real> &dudt_cont);
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Update::FluxDivergence(Container<Real> &in,
+//        Container<Real> &dudt_cont, const Coords &coords)
+//  \brief divergence of the fluxes of in with the geometry of coords, the kernel is
+//  chosen at compile time from CoordinateTraits<Coords>
+
+template <typename Coords>
+TaskStatus FluxDivergence(Container<Real> &in, Container<Real> &dudt_cont,
+                          const Coords &coords) {
+  MeshBlock *pmb = in.pmy_block;
+  const auto &bs = pmb->block_size;
+  const int ndim = (bs.nx3 > 1 ? 3 : (bs.nx2 > 1 ? 2 : 1));
+
+  auto vin = in.PackVariablesAndFluxes({Metadata::Independent});
+  auto dudt = dudt_cont.PackVariables({Metadata::Independent});
+
+  using traits = CoordinateTraits<Coords>;
+  using constant_geometry =
+      std::integral_constant<bool, traits::constant_area && traits::constant_volume>;
+  // packs of contiguous variables are indexed without the view of views
+  if (vin.IsContiguous() && dudt.IsContiguous()) {
+    detail::FluxDivergence(constant_geometry(), pmb, coords, ndim, vin.Contiguous(),
+                           dudt.Contiguous());
+  } else {
+    detail::FluxDivergence(constant_geometry(), pmb, coords, ndim, vin, dudt);
+  }
+  return TaskStatus::complete;
+}
+
 void UpdateContainer(Container<Real> &in, Container<Real> &dudt_cont, const Real dt,
                      Container<Real> &out);
 void AverageContainers(Container<Real> &c1, Container<Real> &c2, const Real wgt1);
@@ -16,8 +16,10 @@
 #include <iostream>
 
 #include "bvals/cc/bvals_cc.hpp"
+#include "bvals/fc/bvals_fc.hpp"
 #include "mesh/mesh.hpp"
 #include "parthenon_arrays.hpp"
+#include "utils/array_pool.hpp"
 
 namespace parthenon {
 
@@ -59,6 +61,7 @@ std::shared_ptr<CellVariable<T>> CellVariable<T>::AllocateCopy(const bool allocC
 
   // make the new CellVariable
   auto cv = std::make_shared<CellVariable<T>>(label(), dims, m);
+  if (is_allocated_) cv->Allocate();
 
   if (IsSet(Metadata::FillGhost)) {
     if (allocComms) {
@@ -71,6 +74,8 @@ std::shared_ptr<CellVariable<T>> CellVariable<T>::AllocateCopy(const bool allocC
       // fluxes, etc are always a copy
       for (int i = 1; i <= 3; i++) {
         cv->flux[i] = flux[i];
+        cv->storage_[i] = storage_[i];
+        cv->storage_offset_[i] = storage_offset_[i];
       }
 
       // These members are pointers,
@@ -87,22 +92,13 @@ template <typename T>
 void CellVariable<T>::allocateComms(MeshBlock *pmb) {
   // set up fluxes
   std::string base_name = label();
-  if (IsSet(Metadata::Independent)) {
-    flux[X1DIR] = ParArrayND<T>(base_name + ".fluxX1", GetDim(6), GetDim(5), GetDim(4),
-                                GetDim(3), GetDim(2), GetDim(1));
-    if (GetDim(2) > 1)
-      flux[X2DIR] = ParArrayND<T>(base_name + ".fluxX2", GetDim(6), GetDim(5), GetDim(4),
-                                  GetDim(3), GetDim(2), GetDim(1));
-    if (GetDim(3) > 1)
-      flux[X3DIR] = ParArrayND<T>(base_name + ".fluxX3", GetDim(6), GetDim(5), GetDim(4),
-                                  GetDim(3), GetDim(2), GetDim(1));
-  }
+  if (is_allocated_) allocateFluxes_();
 
   if (!pmb) return;
 
   if (pmb->pmy_mesh->multilevel)
-    coarse_s = ParArrayND<T>(base_name + ".coarse", GetDim(6), GetDim(5), GetDim(4),
-                             pmb->ncc3, pmb->ncc2, pmb->ncc1);
+    coarse_s = ArrayPool::Get<T>(base_name + ".coarse", GetDim(6), GetDim(5), GetDim(4),
+                                 pmb->ncc3, pmb->ncc2, pmb->ncc1);
 
   // Create the boundary object
   vbvar = std::make_shared<CellCenteredBoundaryVariable>(pmb, data, coarse_s, flux);
@@ -115,6 +111,100 @@ void CellVariable<T>::allocateComms(MeshBlock *pmb) {
   mpiStatus = false;
 }
 
+template <typename T>
+void CellVariable<T>::allocateFluxes_() {
+  if (!IsSet(Metadata::Independent)) return;
+  flux[X1DIR] = ArrayPool::Get<T>(label() + ".fluxX1", GetDim(6), GetDim(5), GetDim(4),
+                                  GetDim(3), GetDim(2), GetDim(1));
+  if (GetDim(2) > 1)
+    flux[X2DIR] = ArrayPool::Get<T>(label() + ".fluxX2", GetDim(6), GetDim(5), GetDim(4),
+                                    GetDim(3), GetDim(2), GetDim(1));
+  if (GetDim(3) > 1)
+    flux[X3DIR] = ArrayPool::Get<T>(label() + ".fluxX3", GetDim(6), GetDim(5), GetDim(4),
+                                    GetDim(3), GetDim(2), GetDim(1));
+}
+
+template <typename T>
+void CellVariable<T>::Allocate(const CellVariable<T> *comms_src) {
+  if (is_allocated_) return;
+  data = ArrayPool::Get<T>(label(), GetDim(6), GetDim(5), GetDim(4), GetDim(3), GetDim(2),
+                           GetDim(1));
+  is_allocated_ = true;
+  if (comms_src != nullptr && IsSet(Metadata::SharedComms)) {
+    for (int i = 1; i <= 3; i++)
+      flux[i] = comms_src->flux[i];
+  } else if (vbvar != nullptr) {
+    allocateFluxes_();
+  }
+}
+
+template <typename T>
+void CellVariable<T>::Deallocate() {
+  if (!is_allocated_) return;
+  data = ArrayPool::SharedZeros<T>(GetDim(6), GetDim(5), GetDim(4), GetDim(3), GetDim(2),
+                                   GetDim(1));
+  for (int i = 1; i <= 3; i++)
+    flux[i] = ParArrayND<T>();
+  for (int i = 0; i < 4; i++) {
+    storage_[i] = ParArray4D<T>();
+    storage_offset_[i] = -1;
+  }
+  is_allocated_ = false;
+}
+
+template <typename T>
+void CellVariable<T>::SetStorage(const ParArray4D<T> storage[4], const int offset) {
+  const std::size_t start =
+      static_cast<std::size_t>(offset) * GetDim(3) * GetDim(2) * GetDim(1);
+  auto place = [&](ParArrayND<T> &arr, const ParArray4D<T> &slabs) {
+    ParArrayND<T> placed(device_view_t<T>(slabs.data() + start, GetDim(6), GetDim(5),
+                                          GetDim(4), GetDim(3), GetDim(2), GetDim(1)));
+    Kokkos::deep_copy(placed.Get(), arr.Get());
+    // the boundary variable may have been set up with the separate arrays
+    if (vbvar != nullptr) {
+      for (auto ref : {&vbvar->var_cc, &vbvar->x1flux, &vbvar->x2flux, &vbvar->x3flux}) {
+        if (ref->Get().data() == arr.Get().data()) *ref = placed;
+      }
+    }
+    arr = placed;
+  };
+
+  place(data, storage[0]);
+  storage_[0] = storage[0];
+  storage_offset_[0] = offset;
+  for (int i = 1; i <= 3; i++) {
+    // shared fluxes stay in the storage of the container they were taken from
+    if (storage[i].size() == 0 || flux[i].Get().data() == nullptr ||
+        IsSet(Metadata::SharedComms))
+      continue;
+    place(flux[i], storage[i]);
+    storage_[i] = storage[i];
+    storage_offset_[i] = offset;
+  }
+}
+
+/// allocate communication space based on info in MeshBlock
+template <typename T>
+void FaceVariable<T>::allocateComms(MeshBlock *pmb) {
+  if (!pmb) return;
+
+  if (pmb->pmy_mesh->multilevel)
+    coarse_s = FaceArray<T>(label() + ".coarse", dims_[5], dims_[4], dims_[3], pmb->ncc3,
+                            pmb->ncc2, pmb->ncc1);
+
+  // Create the boundary object; the edge fluxes are only needed by the EMF correction,
+  // which is not implemented yet
+  EdgeField emf;
+  vbvar = std::make_shared<FaceCenteredBoundaryVariable>(pmb, &data, coarse_s, emf);
+
+  // enroll FaceCenteredBoundaryVariable object
+  vbvar->bvar_index = pmb->pbval->bvars.size();
+  pmb->pbval->bvars.push_back(vbvar);
+  pmb->pbval->bvars_main_int.push_back(vbvar);
+
+  mpiStatus = false;
+}
+
 // TODO(jcd): clean these next two info routines up
 template <typename T>
 std::string FaceVariable<T>::info() {
@@ -36,8 +36,10 @@
 #include "athena.hpp"
 #include "basic_types.hpp"
 #include "bvals/cc/bvals_cc.hpp"
+#include "bvals/fc/bvals_fc.hpp"
 #include "interface/metadata.hpp"
 #include "parthenon_arrays.hpp"
+#include "utils/array_pool.hpp"
 
 namespace parthenon {
 
@@ -47,10 +49,19 @@ template <typename T>
 class CellVariable {
  public:
   /// Initialize a 6D variable
+  /// Sparse ids that are allocated on demand start out as shared zeros
   CellVariable<T>(const std::string label, const std::array<int, 6> dims,
                   const Metadata &metadata)
-      : data(label, dims[5], dims[4], dims[3], dims[2], dims[1], dims[0]),
-        mpiStatus(false), m_(metadata) {}
+      : mpiStatus(false), m_(metadata), label_(label),
+        is_allocated_(!(metadata.IsSet(Metadata::Sparse) &&
+                        metadata.IsSet(Metadata::OnDemand))) {
+    if (is_allocated_)
+      data = ArrayPool::Get<T>(label, dims[5], dims[4], dims[3], dims[2], dims[1],
+                               dims[0]);
+    else
+      data = ArrayPool::SharedZeros<T>(dims[5], dims[4], dims[3], dims[2], dims[1],
+                                       dims[0]);
+  }
 
   // make a new CellVariable based on an existing one
   std::shared_ptr<CellVariable<T>> AllocateCopy(const bool allocComms = false,
@@ -67,7 +78,7 @@ class CellVariable {
   auto GetDim(const int i) const { return data.GetDim(i); }
 
   ///< retrieve label for variable
-  const std::string label() const { return data.label(); }
+  const std::string label() const { return label_; }
 
   ///< retrieve metadata for variable
   Metadata metadata() const { return m_; }
@@ -81,10 +92,32 @@ class CellVariable {
   void allocateComms(MeshBlock *pmb);
 
   /// Repoint vbvar's var_cc array at the current variable
-  void resetBoundary() { vbvar->var_cc = data; }
+  void resetBoundary() {
+    vbvar->var_cc = data;
+    vbvar->var_allocated = is_allocated_;
+  }
+
+  /// Whether the variable has storage of its own, i.e. is not an unallocated sparse id.
+  /// Unallocated variables read as zeros and must not be written.
+  bool IsAllocated() const { return is_allocated_; }
+  /// allocate the data (and the fluxes if there are boundary communications); the
+  /// fluxes of a variable with SharedComms are taken from comms_src
+  void Allocate(const CellVariable<T> *comms_src = nullptr);
+  /// release the data and fluxes and read as zeros again
+  void Deallocate();
 
   bool IsSet(const MetadataFlag bit) const { return m_.IsSet(bit); }
 
+  /// The storage shared with other variables of the container that holds data (dir 0)
+  /// or flux[dir] in the slabs [StorageOffset(dir), StorageOffset(dir) + nslabs) of its
+  /// first index, nslabs = GetDim(6) * GetDim(5) * GetDim(4), see
+  /// Container::AllocateContiguous().  Empty if the array is allocated separately.
+  const ParArray4D<T> &Storage(const int dir = 0) const { return storage_[dir]; }
+  int StorageOffset(const int dir = 0) const { return storage_offset_[dir]; }
+  /// move data and the fluxes that are not shared with another container into the slabs
+  /// starting at offset of the given storage, keeping their contents
+  void SetStorage(const ParArray4D<T> storage[4], const int offset);
+
   ParArrayND<T> data;
   ParArrayND<T> flux[4];  // used for boundary calculation
   ParArrayND<T> coarse_s; // used for sending coarse boundary calculation
@@ -94,6 +127,13 @@ class CellVariable {
 
  private:
   Metadata m_;
+  std::string label_;
+  bool is_allocated_;
+  // keeps the contiguous storage alive, data and flux do not own their memory then
+  ParArray4D<T> storage_[4];
+  int storage_offset_[4] = {-1, -1, -1, -1};
+
+  void allocateFluxes_();
 };
 
 ///
@@ -115,7 +155,8 @@ class FaceVariable {
 
   /// Create an alias for the variable by making a shallow slice with max dim
   FaceVariable(std::string label, FaceVariable<T> &src)
-      : data(src.data), dims_(src.dims_), m_(src.m_), label_(label) {}
+      : data(src.data), coarse_s(src.coarse_s), vbvar(src.vbvar), mpiStatus(false),
+        dims_(src.dims_), m_(src.m_), label_(label) {}
 
   // KOKKOS_FUNCTION FaceVariable() = default;
   // KOKKOS_FUNCTION FaceVariable(const FaceVariable<T>& v) = default;
@@ -130,6 +171,9 @@ class FaceVariable {
   /// return information string
   std::string info();
 
+  /// allocate communication space based on info in MeshBlock
+  void allocateComms(MeshBlock *pmb);
+
   // TODO(JMM): should this be 0,1,2?
   // Should we return the reference? Or something else?
   KOKKOS_FORCEINLINE_FUNCTION
@@ -154,6 +198,10 @@ class FaceVariable {
   bool IsSet(const MetadataFlag bit) const { return m_.IsSet(bit); }
 
   FaceArray<T> data;
+  FaceArray<T> coarse_s; // used for sending coarse boundary calculation
+  // used in case of face boundary communication
+  std::shared_ptr<FaceCenteredBoundaryVariable> vbvar;
+  bool mpiStatus = false;
 
  private:
   std::array<int, 6> dims_;
@@ -23,6 +23,8 @@
 
 #include "interface/metadata.hpp"
 #include "interface/variable.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/error_checking.hpp"
 
 namespace parthenon {
 
@@ -39,21 +41,48 @@ using StringPair = std::pair<std::vector<std::string>, std::vector<std::string>>
 } // namespace vpack_types
 
 using PackIndexMap = std::map<std::string, vpack_types::IndexPair>;
+// sparse ids that are not allocated on a block are left out of its packs and appear in
+// the PackIndexMap with the empty interval (kNotAllocated, kNotAllocated - 1)
+constexpr int kNotAllocated = -1;
+// the outer view is rank 1, so that indexing a pack does not go through the index
+// arithmetic of a 6D ParArrayND
 template <typename T>
-using ViewOfParArrays = ParArrayND<ParArray3D<T>>;
+using ViewOfParArrays = ParArray1D<ParArray3D<T>>;
+
+// The order of the indices of the values of a pack in memory.  variable_outermost is
+// the layout of the variables themselves, v(n, k, j, i).  A variable_innermost pack holds
+// a copy of the values with the variable index fastest, v(k, j, i, n), which streams
+// better in kernels that read all variables of a cell at once.  A variable_contiguous
+// pack has the variable_outermost layout, but its variables are consecutive slabs of the
+// contiguous storage of their container (see Container::AllocateContiguous()), which it
+// indexes through one 4D view instead of the view of views.  The layout is a template
+// parameter, so that indexing a pack does not branch on it.
+enum class PackLayout { variable_outermost, variable_innermost, variable_contiguous };
 
 // Try to keep these Variable*Pack classes as lightweight as possible.
 // They go to the device.
-template <typename T>
+// A variable_outermost pack of consecutive slabs also holds the 4D view of the slabs,
+// and Contiguous() gives the variable_contiguous pack of them.  Kernels choose between
+// the two once, on the host, e.g.
+//   if (v.IsContiguous()) Kernel(v.Contiguous()); else Kernel(v);
+template <typename T, PackLayout L = PackLayout::variable_outermost>
 class VariablePack {
  public:
   VariablePack() = default;
-  VariablePack(const ViewOfParArrays<T> view, const std::array<int, 4> dims)
-      : v_(view), dims_(dims) {}
+  // slabs are the contiguous values of a variable_outermost or variable_contiguous pack,
+  // if any, and the interleaved copy of a variable_innermost pack, extents
+  // (dims[2], dims[1], dims[0], dims[3])
+  VariablePack(const ViewOfParArrays<T> view, const std::array<int, 4> dims,
+               const ParArray4D<T> slabs = ParArray4D<T>())
+      : v_(view), dims_(dims), c_(slabs) {}
+  // the array of the variable, also for a variable_innermost pack
   KOKKOS_FORCEINLINE_FUNCTION
   ParArray3D<T> &operator()(const int n) const { return v_(n); }
   KOKKOS_FORCEINLINE_FUNCTION
   T &operator()(const int n, const int k, const int j, const int i) const {
+    // L is a constant, so only one of the branches is compiled into a kernel
+    if (L == PackLayout::variable_innermost) return c_(k, j, i, n);
+    if (L == PackLayout::variable_contiguous) return c_(n, k, j, i);
     return v_(n)(k, j, i);
   }
   KOKKOS_FORCEINLINE_FUNCTION
@@ -61,21 +90,74 @@ class VariablePack {
     assert(i > 0 && i < 5);
     return dims_[i - 1];
   }
+  // whether the variables are consecutive slabs of one contiguous storage
+  bool IsContiguous() const {
+    return L != PackLayout::variable_innermost && c_.size() > 0;
+  }
+  // the variable_contiguous pack of the same variables, requires IsContiguous()
+  VariablePack<T, PackLayout::variable_contiguous> Contiguous() const {
+    PARTHENON_REQUIRE(IsContiguous(), "the variables of the pack are not contiguous");
+    return VariablePack<T, PackLayout::variable_contiguous>(v_, dims_, c_);
+  }
+  KOKKOS_FORCEINLINE_FUNCTION
+  static constexpr PackLayout GetLayout() { return L; }
+
+  // copy the values of the variables to (from) the interleaved copy of a
+  // variable_innermost pack, on the execution space of their block
+  void Gather(const DevExecSpace &exec_space) const;
+  void Scatter(const DevExecSpace &exec_space) const;
 
  protected:
   ViewOfParArrays<T> v_;
   std::array<int, 4> dims_;
+  ParArray4D<T> c_;
 };
 
 template <typename T>
-class VariableFluxPack : public VariablePack<T> {
+using InterleavedPack = VariablePack<T, PackLayout::variable_innermost>;
+
+template <typename T, PackLayout L>
+void VariablePack<T, L>::Gather(const DevExecSpace &exec_space) const {
+  if (L != PackLayout::variable_innermost || dims_[3] == 0) return;
+  auto v = v_;
+  auto c = c_;
+  par_for(
+      "VariablePack::Gather", exec_space, 0, dims_[2] - 1, 0, dims_[1] - 1, 0,
+      dims_[0] - 1, 0, dims_[3] - 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i, const int n) {
+        c(k, j, i, n) = v(n)(k, j, i);
+      });
+}
+
+template <typename T, PackLayout L>
+void VariablePack<T, L>::Scatter(const DevExecSpace &exec_space) const {
+  if (L != PackLayout::variable_innermost || dims_[3] == 0) return;
+  auto v = v_;
+  auto c = c_;
+  par_for(
+      "VariablePack::Scatter", exec_space, 0, dims_[3] - 1, 0, dims_[2] - 1, 0,
+      dims_[1] - 1, 0, dims_[0] - 1,
+      KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+        v(n)(k, j, i) = c(k, j, i, n);
+      });
+}
+
+// the fluxes are variable_outermost, through the view of views, or variable_contiguous
+// along with the variables
+template <typename T, PackLayout L = PackLayout::variable_outermost>
+class VariableFluxPack : public VariablePack<T, L> {
+  static_assert(L != PackLayout::variable_innermost,
+                "flux packs do not interleave the variables");
+
  public:
   VariableFluxPack() = default;
   VariableFluxPack(const ViewOfParArrays<T> view, const ViewOfParArrays<T> f0,
                    const ViewOfParArrays<T> f1, const ViewOfParArrays<T> f2,
-                   const std::array<int, 4> dims, const int nflux)
-      : VariablePack<T>(view, dims), f_({f0, f1, f2}), nflux_(nflux),
-        ndim_((dims[2] > 1 ? 3 : (dims[1] > 1 ? 2 : 1))) {}
+                   const std::array<int, 4> dims, const int nflux,
+                   const ParArray4D<T> slabs = ParArray4D<T>(),
+                   const std::array<ParArray4D<T>, 3> flux_slabs = {})
+      : VariablePack<T, L>(view, dims, slabs), f_({f0, f1, f2}), fc_(flux_slabs),
+        nflux_(nflux), ndim_((dims[2] > 1 ? 3 : (dims[1] > 1 ? 2 : 1))) {}
 
   KOKKOS_FORCEINLINE_FUNCTION
   ViewOfParArrays<T> &flux(const int dir) const {
@@ -86,17 +168,57 @@ class VariableFluxPack : public VariablePack<T> {
   KOKKOS_FORCEINLINE_FUNCTION
   T &flux(const int dir, const int n, const int k, const int j, const int i) const {
     assert(dir > 0 && dir <= ndim_);
+    if (L == PackLayout::variable_contiguous) return fc_[dir - 1](n, k, j, i);
     return f_[dir - 1](n)(k, j, i);
   }
 
   KOKKOS_FORCEINLINE_FUNCTION
   int GetNdim() const { return ndim_; }
 
+  // whether the variables and their fluxes are consecutive slabs of contiguous storage
+  bool IsContiguous() const {
+    return VariablePack<T, L>::IsContiguous() && fc_[0].size() > 0;
+  }
+  // the variable_contiguous pack of the same variables and fluxes, requires
+  // IsContiguous()
+  VariableFluxPack<T, PackLayout::variable_contiguous> Contiguous() const {
+    PARTHENON_REQUIRE(IsContiguous(), "the variables of the pack are not contiguous");
+    return VariableFluxPack<T, PackLayout::variable_contiguous>(
+        this->v_, f_[0], f_[1], f_[2], this->dims_, nflux_, this->c_, fc_);
+  }
+
  private:
   std::array<ViewOfParArrays<T>, 3> f_;
+  std::array<ParArray4D<T>, 3> fc_;
   int nflux_, ndim_;
 };
 
+//----------------------------------------------------------------------------------------
+//! \fn ParArray4D<T> ContiguousSlabs(const vpack_types::VarList<T> &vars, const int dir)
+//  \brief the 4D view of the data (dir 0) or flux[dir] of the allocated variables if they
+//  are consecutive slabs of one contiguous storage, otherwise an empty view
+
+template <typename T>
+ParArray4D<T> ContiguousSlabs(const vpack_types::VarList<T> &vars, const int dir) {
+  ParArray4D<T> storage;
+  int start = -1, end = -1;
+  for (const auto &v : vars) {
+    if (!v->IsAllocated()) continue;
+    const auto &s = v->Storage(dir);
+    if (s.size() == 0) return ParArray4D<T>();
+    if (start < 0) {
+      storage = s;
+      start = end = v->StorageOffset(dir);
+    } else if (s.data() != storage.data() || v->StorageOffset(dir) != end) {
+      return ParArray4D<T>();
+    }
+    end += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
+  }
+  if (start < 0) return ParArray4D<T>();
+  return Kokkos::subview(storage, std::make_pair(start, end), Kokkos::ALL(),
+                         Kokkos::ALL(), Kokkos::ALL());
+}
+
 // Using std::map, not std::unordered_map because the key
 // would require a custom hashing function. Note this is slower: O(log(N))
 // instead of O(1).
@@ -114,8 +236,13 @@ using PackIndxPair = PackAndIndexMap<VariablePack<T>>;
 template <typename T>
 using FluxPackIndxPair = PackAndIndexMap<VariableFluxPack<T>>;
 template <typename T>
+using InterleavedPackIndxPair = PackAndIndexMap<InterleavedPack<T>>;
+template <typename T>
 using MapToVariablePack = std::map<std::vector<std::string>, PackIndxPair<T>>;
 template <typename T>
+using MapToInterleavedPack =
+    std::map<std::vector<std::string>, InterleavedPackIndxPair<T>>;
+template <typename T>
 using MapToVariableFluxPack = std::map<vpack_types::StringPair, FluxPackIndxPair<T>>;
 
 template <typename T>
@@ -126,11 +253,11 @@ VariableFluxPack<T> MakeFluxPack(const vpack_types::VarList<T> &vars,
   // count up the size
   int vsize = 0;
   for (const auto &v : vars) {
-    vsize += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
+    if (v->IsAllocated()) vsize += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
   }
   int fsize = 0;
   for (const auto &v : flux_vars) {
-    fsize += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
+    if (v->IsAllocated()) fsize += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
   }
 
   auto fvar = vars.front()->data;
@@ -142,13 +269,19 @@ VariableFluxPack<T> MakeFluxPack(const vpack_types::VarList<T> &vars,
   ViewOfParArrays<T> f1("MakeFluxPack::f1", fsize);
   ViewOfParArrays<T> f2("MakeFluxPack::f2", fsize);
   ViewOfParArrays<T> f3("MakeFluxPack::f3", fsize);
-  auto host_view = cv.GetHostMirror();
-  auto host_f1 = f1.GetHostMirror();
-  auto host_f2 = f2.GetHostMirror();
-  auto host_f3 = f3.GetHostMirror();
+  auto host_view = Kokkos::create_mirror_view(cv);
+  auto host_f1 = Kokkos::create_mirror_view(f1);
+  auto host_f2 = Kokkos::create_mirror_view(f2);
+  auto host_f3 = Kokkos::create_mirror_view(f3);
   // add variables to host view
   int vindex = 0;
   for (const auto &v : vars) {
+    if (!v->IsAllocated()) {
+      if (vmap != nullptr)
+        vmap->insert(std::pair<std::string, IndexPair>(
+            v->label(), IndexPair(kNotAllocated, kNotAllocated - 1)));
+      continue;
+    }
     int vstart = vindex;
     for (int k = 0; k < v->GetDim(6); k++) {
       for (int j = 0; j < v->GetDim(5); j++) {
@@ -165,6 +298,12 @@ VariableFluxPack<T> MakeFluxPack(const vpack_types::VarList<T> &vars,
   // add fluxes to host view
   vindex = 0;
   for (const auto &v : flux_vars) {
+    if (!v->IsAllocated()) {
+      if (vmap != nullptr)
+        vmap->insert(std::pair<std::string, IndexPair>(
+            v->label(), IndexPair(kNotAllocated, kNotAllocated - 1)));
+      continue;
+    }
     int vstart = vindex;
     for (int k = 0; k < v->GetDim(6); k++) {
       for (int j = 0; j < v->GetDim(5); j++) {
@@ -181,26 +320,37 @@ VariableFluxPack<T> MakeFluxPack(const vpack_types::VarList<T> &vars,
           std::pair<std::string, IndexPair>(v->label(), IndexPair(vstart, vindex - 1)));
     }
   }
-  cv.DeepCopy(host_view);
-  f1.DeepCopy(host_f1);
-  f2.DeepCopy(host_f2);
-  f3.DeepCopy(host_f3);
-  return VariableFluxPack<T>(cv, f1, f2, f3, cv_size, fsize);
+  Kokkos::deep_copy(cv, host_view);
+  Kokkos::deep_copy(f1, host_f1);
+  Kokkos::deep_copy(f2, host_f2);
+  Kokkos::deep_copy(f3, host_f3);
+  std::array<ParArray4D<T>, 3> flux_slabs;
+  for (int d = 0; d < ndim; d++) {
+    flux_slabs[d] = ContiguousSlabs(flux_vars, d + 1);
+    if (flux_slabs[d].size() == 0) {
+      flux_slabs = {};
+      break;
+    }
+  }
+  return VariableFluxPack<T>(cv, f1, f2, f3, cv_size, fsize, ContiguousSlabs(vars, 0),
+                             flux_slabs);
 }
 
-template <typename T>
-VariablePack<T> MakePack(const vpack_types::VarList<T> &vars,
-                         PackIndexMap *vmap = nullptr) {
+template <typename T, PackLayout L = PackLayout::variable_outermost>
+VariablePack<T, L> MakePack(const vpack_types::VarList<T> &vars,
+                            PackIndexMap *vmap = nullptr) {
+  static_assert(L != PackLayout::variable_contiguous,
+                "the contiguous pack of a variable_outermost pack is its Contiguous()");
   using vpack_types::IndexPair;
   // count up the size
   int vsize = 0;
   for (const auto &v : vars) {
-    vsize += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
+    if (v->IsAllocated()) vsize += v->GetDim(6) * v->GetDim(5) * v->GetDim(4);
   }
 
   // make the outer view
   ViewOfParArrays<T> cv("MakePack::cv", vsize);
-  auto host_view = cv.GetHostMirror();
+  auto host_view = Kokkos::create_mirror_view(cv);
   int vindex = 0;
   int sparse_start;
   std::string sparse_name = "";
@@ -216,6 +366,12 @@ VariablePack<T> MakePack(const vpack_types::VarList<T> &vars,
           sparse_name, IndexPair(sparse_start, vindex - 1)));
       sparse_name = "";
     }
+    if (!v->IsAllocated()) {
+      if (vmap != nullptr)
+        vmap->insert(std::pair<std::string, IndexPair>(
+            v->label(), IndexPair(kNotAllocated, kNotAllocated - 1)));
+      continue;
+    }
     int vstart = vindex;
     for (int k = 0; k < v->GetDim(6); k++) {
       for (int j = 0; j < v->GetDim(5); j++) {
@@ -234,10 +390,22 @@ VariablePack<T> MakePack(const vpack_types::VarList<T> &vars,
                                                    IndexPair(sparse_start, vindex - 1)));
   }
 
-  cv.DeepCopy(host_view);
-  auto fvar = vars.front()->data;
-  std::array<int, 4> cv_size = {fvar.GetDim(1), fvar.GetDim(2), fvar.GetDim(3), vsize};
-  return VariablePack<T>(cv, cv_size);
+  Kokkos::deep_copy(cv, host_view);
+  // an empty list gives an empty pack
+  std::array<int, 4> cv_size = {0, 0, 0, vsize};
+  if (!vars.empty()) {
+    auto fvar = vars.front()->data;
+    cv_size = {fvar.GetDim(1), fvar.GetDim(2), fvar.GetDim(3), vsize};
+  }
+  if (L == PackLayout::variable_innermost) {
+    // the values are copied in by Gather()
+    ParArray4D<T> interleaved;
+    if (vsize > 0)
+      interleaved = ParArray4D<T>("MakePack::interleaved", cv_size[2], cv_size[1],
+                                  cv_size[0], vsize);
+    return VariablePack<T, L>(cv, cv_size, interleaved);
+  }
+  return VariablePack<T, L>(cv, cv_size, ContiguousSlabs(vars, 0));
 }
 
 } // namespace parthenon
@@ -20,10 +20,16 @@
 #ifndef KOKKOS_ABSTRACTION_HPP_
 #define KOKKOS_ABSTRACTION_HPP_
 
+#include <cstddef>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include <Kokkos_Core.hpp>
 
+#include "utils/loop_tuner.hpp"
+#include "utils/profiler.hpp"
+
 namespace parthenon {
 
 #ifdef KOKKOS_ENABLE_CUDA_UVM
@@ -87,6 +93,11 @@ static struct LoopPatternTPTVR {
 } loop_pattern_tptvr_tag;
 static struct LoopPatternTPTTRTVR {
 } loop_pattern_tpttrtvr_tag;
+// tiles of k x j x i cells, e.g. par_for(LoopPatternTiled{2, 8, 0}, ...) for a kernel
+// that prefers its own tiles.  An extent of 0 takes the one of LoopTuner::TileSize().
+static struct LoopPatternTiled {
+  int k = 0, j = 0, i = 0;
+} loop_pattern_tiled_tag;
 static struct LoopPatternUndefined {
 } loop_pattern_undefined_tag;
 
@@ -98,14 +109,8 @@ static struct InnerLoopPatternTVR {
 static struct InnerLoopPatternSimdFor {
 } inner_loop_pattern_simdfor_tag;
 
-// TODO(pgrete) I don't like this and would prefer to make the default a
-// parameter that is read from the parameter file rather than a compile time
-// constant. Any suggestions on how to do this elegantly? One could use
-// parthenon::Globals but then this unit here would get a dependcy on the global
-// part whereas right now it's completely encapuslated.
-// Alternatively, I could think of putting all this in the parthenon::wrapper
-// namespace so that the default variable can live there.
-// Again, I'm open for suggestions.
+// The compile time default of the 3D and 4D par_for below.  The pattern of each kernel
+// can be chosen (or tuned) at runtime instead, see utils/loop_tuner.hpp.
 #ifdef MANUAL1D_LOOP
 #define DEFAULT_LOOP_PATTERN loop_pattern_flatrange_tag
 #elif defined SIMDFOR_LOOP
@@ -118,10 +123,20 @@ static struct InnerLoopPatternSimdFor {
 #define DEFAULT_LOOP_PATTERN loop_pattern_tptvr_tag
 #elif defined TPTTRTVR_LOOP
 #define DEFAULT_LOOP_PATTERN loop_pattern_tpttrtvr_tag
+#elif defined TILED_LOOP
+#define DEFAULT_LOOP_PATTERN loop_pattern_tiled_tag
 #else
 #define DEFAULT_LOOP_PATTERN loop_pattern_undefined_tag
 #endif
 
+// the default pattern of the 3D to 5D par_reduce, which are only implemented with
+// flattened or MDRange loops
+#ifdef MANUAL1D_LOOP
+#define DEFAULT_REDUCE_PATTERN loop_pattern_flatrange_tag
+#else
+#define DEFAULT_REDUCE_PATTERN loop_pattern_mdrange_tag
+#endif
+
 #define DEFAULT_OUTER_LOOP_PATTERN outer_loop_pattern_teams_tag
 
 #ifdef TVR_INNER_LOOP
@@ -138,6 +153,7 @@ inline void par_for(const std::string &name, DevExecSpace exec_space, const int
                     const int &iu, const Function &function) {
   // using loop_pattern_mdrange_tag instead of DEFAULT_LOOP_PATTERN for now
   // as the other wrappers are not implemented yet for 1D loops
+  Profiler::ScopedRegion region(name, true);
   par_for(loop_pattern_mdrange_tag, name, exec_space, il, iu, function);
 }
 
@@ -148,15 +164,57 @@ inline void par_for(const std::string &name, DevExecSpace exec_space, const int
                     const Function &function) {
   // using loop_pattern_mdrange_tag instead of DEFAULT_LOOP_PATTERN for now
   // as the other wrappers are not implemented yet for 2D loops
+  Profiler::ScopedRegion region(name, true);
   par_for(loop_pattern_mdrange_tag, name, exec_space, jl, ju, il, iu, function);
 }
 
+// calls par_for with the loop pattern and tile selected at runtime, args are the bounds
+// and the function of the 3D or 4D par_for
+template <typename... Args>
+inline void par_for_pattern(const LoopTuner::Choice &choice, const std::string &name,
+                            DevExecSpace exec_space, const Args &... args) {
+  switch (choice.pattern) {
+  case LoopPattern::flatrange:
+    par_for(loop_pattern_flatrange_tag, name, exec_space, args...);
+    break;
+  case LoopPattern::mdrange:
+    par_for(loop_pattern_mdrange_tag, name, exec_space, args...);
+    break;
+  case LoopPattern::tpttr:
+    par_for(loop_pattern_tpttr_tag, name, exec_space, args...);
+    break;
+  case LoopPattern::tptvr:
+    par_for(loop_pattern_tptvr_tag, name, exec_space, args...);
+    break;
+  case LoopPattern::tpttrtvr:
+    par_for(loop_pattern_tpttrtvr_tag, name, exec_space, args...);
+    break;
+  case LoopPattern::simdfor:
+    par_for(loop_pattern_simdfor_tag, name, exec_space, args...);
+    break;
+  case LoopPattern::tiled:
+    par_for(LoopPatternTiled{choice.tile[0], choice.tile[1], choice.tile[2]}, name,
+            exec_space, args...);
+    break;
+  default:
+    par_for(DEFAULT_LOOP_PATTERN, name, exec_space, args...);
+    break;
+  }
+}
+
 // 3D default loop pattern
 template <typename Function>
 inline void par_for(const std::string &name, DevExecSpace exec_space, const int &kl,
                     const int &ku, const int &jl, const int &ju, const int &il,
                     const int &iu, const Function &function) {
-  par_for(DEFAULT_LOOP_PATTERN, name, exec_space, kl, ku, jl, ju, il, iu, function);
+  Profiler::ScopedRegion region(name, true);
+  if (!LoopTuner::Enabled()) {
+    par_for(DEFAULT_LOOP_PATTERN, name, exec_space, kl, ku, jl, ju, il, iu, function);
+    return;
+  }
+  static thread_local LoopTuner::detail::SiteCache cache;
+  LoopTuner::ScopedTrial trial(name, {1, ku - kl + 1, ju - jl + 1, iu - il + 1}, cache);
+  par_for_pattern(trial.choice(), name, exec_space, kl, ku, jl, ju, il, iu, function);
 }
 
 // 4D default loop pattern
@@ -165,8 +223,17 @@ inline void par_for(const std::string &name, DevExecSpace exec_space, const int
                     const int &nu, const int &kl, const int &ku, const int &jl,
                     const int &ju, const int &il, const int &iu,
                     const Function &function) {
-  par_for(DEFAULT_LOOP_PATTERN, name, exec_space, nl, nu, kl, ku, jl, ju, il, iu,
-          function);
+  Profiler::ScopedRegion region(name, true);
+  if (!LoopTuner::Enabled()) {
+    par_for(DEFAULT_LOOP_PATTERN, name, exec_space, nl, nu, kl, ku, jl, ju, il, iu,
+            function);
+    return;
+  }
+  static thread_local LoopTuner::detail::SiteCache cache;
+  LoopTuner::ScopedTrial trial(
+      name, {nu - nl + 1, ku - kl + 1, ju - jl + 1, iu - il + 1}, cache);
+  par_for_pattern(trial.choice(), name, exec_space, nl, nu, kl, ku, jl, ju, il, iu,
+                  function);
 }
 
 // 2D Outer loop default pattern
@@ -175,6 +242,7 @@ inline void par_for_outer(const std::string &name, DevExecSpace exec_space,
                           size_t scratch_size_in_bytes, const int scratch_level,
                           const int kl, const int ku, const int jl, const int ju,
                           const Function &function) {
+  Profiler::ScopedRegion region(name, true);
   par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, name, exec_space, scratch_size_in_bytes,
                 scratch_level, kl, ku, jl, ju, function);
 }
@@ -185,6 +253,7 @@ inline void par_for_outer(const std::string &name, DevExecSpace exec_space,
                           size_t scratch_size_in_bytes, const int scratch_level,
                           const int nl, const int nu, const int kl, const int ku,
                           const int jl, const int ju, const Function &function) {
+  Profiler::ScopedRegion region(name, true);
   par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, name, exec_space, scratch_size_in_bytes,
                 scratch_level, nl, nu, kl, ku, jl, ju, function);
 }
@@ -325,6 +394,50 @@ inline void par_for(LoopPatternSimdFor, const std::string &name, DevExecSpace ex
   Kokkos::Profiling::popRegion();
 }
 
+// extent of the tiles of a loop of extent n: the one of the tag, the default one of the
+// loop tuner or the whole loop, in this order, and at least 1
+inline int TileExtent(int tag, int tuner, int n) {
+  const int t = (tag > 0 ? tag : (tuner > 0 ? tuner : n));
+  const int e = (t < n ? t : n);
+  return (e > 1 ? e : 1);
+}
+
+// 3D loop over tiles using Kokkos 1D Range, with SIMD FOR loops within each tile.  The
+// tiles keep the neighboring j and k rows of a stencil in cache on CPUs.
+template <typename Function>
+inline void par_for(LoopPatternTiled tile, const std::string &name,
+                    DevExecSpace exec_space, const int &kl, const int &ku, const int &jl,
+                    const int &ju, const int &il, const int &iu,
+                    const Function &function) {
+  // like the ranges of the other patterns, an empty range runs no iterations
+  if (ku < kl || ju < jl || iu < il) return;
+  Kokkos::Profiling::pushRegion(name);
+  const auto &tuner = LoopTuner::TileSize();
+  const int Tk = TileExtent(tile.k, tuner[0], ku - kl + 1);
+  const int Tj = TileExtent(tile.j, tuner[1], ju - jl + 1);
+  const int Ti = TileExtent(tile.i, tuner[2], iu - il + 1);
+  const int Mk = (ku - kl + Tk) / Tk;
+  const int Mj = (ju - jl + Tj) / Tj;
+  const int Mi = (iu - il + Ti) / Ti;
+  const int MjMi = Mj * Mi;
+  Kokkos::parallel_for(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Mk * MjMi),
+      KOKKOS_LAMBDA(const int &idx) {
+        const int tk = idx / MjMi;
+        const int tj = (idx - tk * MjMi) / Mi;
+        const int ti = idx - tk * MjMi - tj * Mi;
+        const int kb = kl + tk * Tk, ke = (kb + Tk - 1 < ku ? kb + Tk - 1 : ku);
+        const int jb = jl + tj * Tj, je = (jb + Tj - 1 < ju ? jb + Tj - 1 : ju);
+        const int ib = il + ti * Ti, ie = (ib + Ti - 1 < iu ? ib + Ti - 1 : iu);
+        for (int k = kb; k <= ke; k++)
+          for (int j = jb; j <= je; j++)
+#pragma omp simd
+            for (int i = ib; i <= ie; i++)
+              function(k, j, i);
+      });
+  Kokkos::Profiling::popRegion();
+}
+
 // 4D loop using Kokkos 1D Range
 template <typename Function>
 inline void par_for(LoopPatternFlatRange, const std::string &name,
@@ -450,6 +563,43 @@ inline void par_for(LoopPatternSimdFor, const std::string &name, DevExecSpace ex
   Kokkos::Profiling::popRegion();
 }
 
+// 4D loop over n and the tiles of k, j and i using Kokkos 1D Range, with SIMD FOR loops
+// within each tile
+template <typename Function>
+inline void par_for(LoopPatternTiled tile, const std::string &name,
+                    DevExecSpace exec_space, const int nl, const int nu, const int kl,
+                    const int ku, const int jl, const int ju, const int il, const int iu,
+                    const Function &function) {
+  if (nu < nl || ku < kl || ju < jl || iu < il) return;
+  Kokkos::Profiling::pushRegion(name);
+  const auto &tuner = LoopTuner::TileSize();
+  const int Tk = TileExtent(tile.k, tuner[0], ku - kl + 1);
+  const int Tj = TileExtent(tile.j, tuner[1], ju - jl + 1);
+  const int Ti = TileExtent(tile.i, tuner[2], iu - il + 1);
+  const int Mk = (ku - kl + Tk) / Tk;
+  const int Mj = (ju - jl + Tj) / Tj;
+  const int Mi = (iu - il + Ti) / Ti;
+  const int MjMi = Mj * Mi;
+  const int MkMjMi = Mk * MjMi;
+  Kokkos::parallel_for(
+      name, Kokkos::RangePolicy<>(exec_space, 0, (nu - nl + 1) * MkMjMi),
+      KOKKOS_LAMBDA(const int &idx) {
+        const int n = idx / MkMjMi + nl;
+        const int tk = (idx - (n - nl) * MkMjMi) / MjMi;
+        const int tj = (idx - (n - nl) * MkMjMi - tk * MjMi) / Mi;
+        const int ti = idx - (n - nl) * MkMjMi - tk * MjMi - tj * Mi;
+        const int kb = kl + tk * Tk, ke = (kb + Tk - 1 < ku ? kb + Tk - 1 : ku);
+        const int jb = jl + tj * Tj, je = (jb + Tj - 1 < ju ? jb + Tj - 1 : ju);
+        const int ib = il + ti * Ti, ie = (ib + Ti - 1 < iu ? ib + Ti - 1 : iu);
+        for (int k = kb; k <= ke; k++)
+          for (int j = jb; j <= je; j++)
+#pragma omp simd
+            for (int i = ib; i <= ie; i++)
+              function(n, k, j, i);
+      });
+  Kokkos::Profiling::popRegion();
+}
+
 // 2D  outer parallel loop using Kokkos Teams
 template <typename Function>
 inline void par_for_outer(OuterLoopPatternTeams, const std::string &name,
@@ -519,6 +669,567 @@ KOKKOS_INLINE_FUNCTION void par_for_inner(InnerLoopPatternSimdFor, team_mbr_t te
   }
 }
 
+//----------------------------------------------------------------------------------------
+// Reductions and scans
+//
+// par_reduce(name, exec_space, [ml, mu, nl, nu, kl, ku, jl, ju,] il, iu, function,
+// reductions...) carries out one or more reductions over the index range in one kernel.
+// A reduction is either a Kokkos reducer, e.g. Kokkos::Min<Real>(min_dt), or a scalar,
+// which is summed.  The function gets one reference per reduction after the indices:
+//
+//   par_reduce(
+//       "SumAndMax", exec_space, kl, ku, jl, ju, il, iu,
+//       KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lsum, Real &lmax) {
+//         lsum += q(k, j, i);
+//         lmax = (q(k, j, i) > lmax ? q(k, j, i) : lmax);
+//       },
+//       sum, Kokkos::Max<Real>(max));
+//
+// The results are set when par_reduce returns and overwrite the previous values of the
+// arguments, which do not seed the reduction.  Several reductions at once have to reduce
+// into host scalars.
+//
+// par_scan(name, exec_space, [ml, mu, ...,] il, iu, function, total) is an exclusive or
+// inclusive scan, depending on the function, over the loop indices in lexicographic
+// order, i.e. with the last index varying fastest:
+//
+//   par_scan(
+//       "Offsets", exec_space, 0, n - 1,
+//       KOKKOS_LAMBDA(const int i, int &update, const bool final) {
+//         if (final) offset(i) = update;
+//         update += count(i);
+//       },
+//       total);
+
+namespace detail {
+template <typename...>
+struct void_type {
+  using type = void;
+};
+
+// Kokkos reducers define themselves as member type reducer
+template <typename T, typename = void>
+struct IsReducer : std::false_type {};
+template <typename T>
+struct IsReducer<T, typename void_type<typename T::reducer>::type> : std::true_type {};
+
+// excludes the overloads of par_reduce of lower dimensions, which would take a loop
+// bound as function
+template <typename Function>
+using EnableIfFunction =
+    typename std::enable_if<!std::is_integral<Function>::value>::type;
+
+template <typename R>
+inline typename std::enable_if<IsReducer<R>::value, R>::type AsReducer(const R &r) {
+  return r;
+}
+template <typename T>
+inline typename std::enable_if<!IsReducer<T>::value, Kokkos::Sum<T>>::type
+AsReducer(T &value) {
+  return Kokkos::Sum<T>(value);
+}
+
+// the values of several reductions
+template <typename... Ts>
+struct ReduceValues {};
+template <typename T, typename... Ts>
+struct ReduceValues<T, Ts...> {
+  T first;
+  ReduceValues<Ts...> rest;
+};
+
+template <std::size_t N>
+struct ReduceGet {
+  template <typename T, typename... Ts>
+  KOKKOS_INLINE_FUNCTION static auto Get(ReduceValues<T, Ts...> &v)
+      -> decltype(ReduceGet<N - 1>::Get(v.rest)) {
+    return ReduceGet<N - 1>::Get(v.rest);
+  }
+};
+template <>
+struct ReduceGet<0> {
+  template <typename T, typename... Ts>
+  KOKKOS_INLINE_FUNCTION static T &Get(ReduceValues<T, Ts...> &v) {
+    return v.first;
+  }
+};
+
+// the reducers of several reductions, applied to ReduceValues
+template <typename... Rs>
+struct ReducerList {
+  using value_type = ReduceValues<>;
+  KOKKOS_INLINE_FUNCTION void init(value_type &) const {}
+  KOKKOS_INLINE_FUNCTION void join(value_type &, const value_type &) const {}
+  KOKKOS_INLINE_FUNCTION void join(volatile value_type &,
+                                   const volatile value_type &) const {}
+  void Store(const value_type &) const {}
+};
+template <typename R, typename... Rs>
+struct ReducerList<R, Rs...> {
+  using value_type = ReduceValues<typename R::value_type, typename Rs::value_type...>;
+  explicit ReducerList(const R &r, const Rs &... rs) : first(r), rest(rs...) {}
+  KOKKOS_INLINE_FUNCTION void init(value_type &v) const {
+    first.init(v.first);
+    rest.init(v.rest);
+  }
+  KOKKOS_INLINE_FUNCTION void join(value_type &dst, const value_type &src) const {
+    first.join(dst.first, src.first);
+    rest.join(dst.rest, src.rest);
+  }
+  KOKKOS_INLINE_FUNCTION void join(volatile value_type &dst,
+                                   const volatile value_type &src) const {
+    first.join(dst.first, src.first);
+    rest.join(dst.rest, src.rest);
+  }
+  // copies the results to the scalars of the reducers
+  void Store(const value_type &v) const {
+    first.reference() = v.first;
+    rest.Store(v.rest);
+  }
+  R first;
+  ReducerList<Rs...> rest;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class MultiReducer
+//  \brief Kokkos reducer that carries out several reductions at once
+
+template <typename... Rs>
+class MultiReducer {
+ public:
+  using reducer = MultiReducer;
+  using value_type = typename ReducerList<Rs...>::value_type;
+  using result_view_type =
+      Kokkos::View<value_type, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+
+  MultiReducer(value_type &result, const Rs &... rs) : list_(rs...), result_(&result) {}
+
+  KOKKOS_INLINE_FUNCTION void init(value_type &v) const { list_.init(v); }
+  KOKKOS_INLINE_FUNCTION void join(value_type &dst, const value_type &src) const {
+    list_.join(dst, src);
+  }
+  KOKKOS_INLINE_FUNCTION void join(volatile value_type &dst,
+                                   const volatile value_type &src) const {
+    list_.join(dst, src);
+  }
+  KOKKOS_INLINE_FUNCTION value_type &reference() const { return *result_.data(); }
+  KOKKOS_INLINE_FUNCTION result_view_type view() const { return result_; }
+  KOKKOS_INLINE_FUNCTION bool references_scalar() const { return true; }
+
+  void Store() const { list_.Store(*result_.data()); }
+
+ private:
+  ReducerList<Rs...> list_;
+  result_view_type result_;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class Reduction
+//  \brief the reducer of the reductions of one par_reduce and their value type
+
+template <typename... Rs>
+class Reduction {
+ public:
+  using value_type = typename MultiReducer<Rs...>::value_type;
+  explicit Reduction(const Rs &... rs) : reducer_(result_, rs...) {}
+  Reduction(const Reduction &) = delete;
+  Reduction &operator=(const Reduction &) = delete;
+  const MultiReducer<Rs...> &reducer() const { return reducer_; }
+  // has to be called after the kernel
+  void Finalize() const { reducer_.Store(); }
+
+ private:
+  value_type result_;
+  MultiReducer<Rs...> reducer_;
+};
+template <typename R>
+class Reduction<R> {
+ public:
+  using value_type = typename R::value_type;
+  explicit Reduction(const R &r) : reducer_(r) {}
+  const R &reducer() const { return reducer_; }
+  void Finalize() const {}
+
+ private:
+  R reducer_;
+};
+
+template <typename... Args>
+using ReductionOf = Reduction<decltype(AsReducer(std::declval<Args &>()))...>;
+
+// calls function(indices..., values...) with one value per reduction
+template <typename Value>
+struct ReduceArgs {
+  template <typename Function, typename... Idx>
+  KOKKOS_INLINE_FUNCTION static void Call(const Function &function, Value &v,
+                                          const Idx... idx) {
+    function(idx..., v);
+  }
+};
+template <typename... Ts>
+struct ReduceArgs<ReduceValues<Ts...>> {
+  template <typename Function, typename... Idx>
+  KOKKOS_INLINE_FUNCTION static void Call(const Function &function,
+                                          ReduceValues<Ts...> &v, const Idx... idx) {
+    Expand(function, v, std::make_index_sequence<sizeof...(Ts)>(), idx...);
+  }
+  template <typename Function, std::size_t... Is, typename... Idx>
+  KOKKOS_INLINE_FUNCTION static void Expand(const Function &function,
+                                            ReduceValues<Ts...> &v,
+                                            std::index_sequence<Is...>,
+                                            const Idx... idx) {
+    function(idx..., ReduceGet<Is>::Get(v)...);
+  }
+};
+} // namespace detail
+
+// 1D reduction using MDRange loops
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
+           const int &il, const int &iu, const Function &function, Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  Kokkos::parallel_reduce(
+      name, Kokkos::RangePolicy<>(exec_space, il, iu + 1),
+      KOKKOS_LAMBDA(const int i, value_type &v) {
+        detail::ReduceArgs<value_type>::Call(function, v, i);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 2D reduction using MDRange loops
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
+           const int &jl, const int &ju, const int &il, const int &iu,
+           const Function &function, Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  Kokkos::parallel_reduce(
+      name,
+      Kokkos::MDRangePolicy<Kokkos::Rank<2>>(exec_space, {jl, il}, {ju + 1, iu + 1}),
+      KOKKOS_LAMBDA(const int j, const int i, value_type &v) {
+        detail::ReduceArgs<value_type>::Call(function, v, j, i);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 3D reduction using MDRange loops
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
+           const int &kl, const int &ku, const int &jl, const int &ju, const int &il,
+           const int &iu, const Function &function, Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  Kokkos::parallel_reduce(
+      name,
+      Kokkos::MDRangePolicy<Kokkos::Rank<3>>(exec_space, {kl, jl, il},
+                                             {ku + 1, ju + 1, iu + 1}),
+      KOKKOS_LAMBDA(const int k, const int j, const int i, value_type &v) {
+        detail::ReduceArgs<value_type>::Call(function, v, k, j, i);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 4D reduction using MDRange loops
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
+           const int &nl, const int &nu, const int &kl, const int &ku, const int &jl,
+           const int &ju, const int &il, const int &iu, const Function &function,
+           Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  Kokkos::parallel_reduce(
+      name,
+      Kokkos::MDRangePolicy<Kokkos::Rank<4>>(exec_space, {nl, kl, jl, il},
+                                             {nu + 1, ku + 1, ju + 1, iu + 1}),
+      KOKKOS_LAMBDA(const int n, const int k, const int j, const int i, value_type &v) {
+        detail::ReduceArgs<value_type>::Call(function, v, n, k, j, i);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 5D reduction using MDRange loops
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
+           const int &ml, const int &mu, const int &nl, const int &nu, const int &kl,
+           const int &ku, const int &jl, const int &ju, const int &il, const int &iu,
+           const Function &function, Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  Kokkos::parallel_reduce(
+      name,
+      Kokkos::MDRangePolicy<Kokkos::Rank<5>>(exec_space, {ml, nl, kl, jl, il},
+                                             {mu + 1, nu + 1, ku + 1, ju + 1, iu + 1}),
+      KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i,
+                    value_type &v) {
+        detail::ReduceArgs<value_type>::Call(function, v, m, n, k, j, i);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 3D reduction using Kokkos 1D Range
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternFlatRange, const std::string &name, DevExecSpace exec_space,
+           const int &kl, const int &ku, const int &jl, const int &ju, const int &il,
+           const int &iu, const Function &function, Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  const int Nk = ku - kl + 1;
+  const int Nj = ju - jl + 1;
+  const int Ni = iu - il + 1;
+  const int NjNi = Nj * Ni;
+  Kokkos::parallel_reduce(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Nk * NjNi),
+      KOKKOS_LAMBDA(const int &idx, value_type &v) {
+        const int k = idx / NjNi;
+        const int j = (idx - k * NjNi) / Ni;
+        const int i = idx - k * NjNi - j * Ni;
+        detail::ReduceArgs<value_type>::Call(function, v, k + kl, j + jl, i + il);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 4D reduction using Kokkos 1D Range
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternFlatRange, const std::string &name, DevExecSpace exec_space,
+           const int &nl, const int &nu, const int &kl, const int &ku, const int &jl,
+           const int &ju, const int &il, const int &iu, const Function &function,
+           Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  const int Nn = nu - nl + 1;
+  const int Nk = ku - kl + 1;
+  const int Nj = ju - jl + 1;
+  const int Ni = iu - il + 1;
+  const int NjNi = Nj * Ni;
+  const int NkNjNi = Nk * NjNi;
+  Kokkos::parallel_reduce(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Nn * NkNjNi),
+      KOKKOS_LAMBDA(const int &idx, value_type &v) {
+        const int n = idx / NkNjNi;
+        const int k = (idx - n * NkNjNi) / NjNi;
+        const int j = (idx - n * NkNjNi - k * NjNi) / Ni;
+        const int i = idx - n * NkNjNi - k * NjNi - j * Ni;
+        detail::ReduceArgs<value_type>::Call(function, v, n + nl, k + kl, j + jl,
+                                             i + il);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 5D reduction using Kokkos 1D Range
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(LoopPatternFlatRange, const std::string &name, DevExecSpace exec_space,
+           const int &ml, const int &mu, const int &nl, const int &nu, const int &kl,
+           const int &ku, const int &jl, const int &ju, const int &il, const int &iu,
+           const Function &function, Args &&... args) {
+  static_assert(sizeof...(Args) > 0, "par_reduce needs at least one reduction");
+  detail::ReductionOf<Args...> reduction(detail::AsReducer(args)...);
+  using value_type = typename detail::ReductionOf<Args...>::value_type;
+  const int Nm = mu - ml + 1;
+  const int Nn = nu - nl + 1;
+  const int Nk = ku - kl + 1;
+  const int Nj = ju - jl + 1;
+  const int Ni = iu - il + 1;
+  const int NjNi = Nj * Ni;
+  const int NkNjNi = Nk * NjNi;
+  const int NnNkNjNi = Nn * NkNjNi;
+  Kokkos::parallel_reduce(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Nm * NnNkNjNi),
+      KOKKOS_LAMBDA(const int &idx, value_type &v) {
+        const int m = idx / NnNkNjNi;
+        const int n = (idx - m * NnNkNjNi) / NkNjNi;
+        const int k = (idx - m * NnNkNjNi - n * NkNjNi) / NjNi;
+        const int j = (idx - m * NnNkNjNi - n * NkNjNi - k * NjNi) / Ni;
+        const int i = idx - m * NnNkNjNi - n * NkNjNi - k * NjNi - j * Ni;
+        detail::ReduceArgs<value_type>::Call(function, v, m + ml, n + nl, k + kl, j + jl,
+                                             i + il);
+      },
+      reduction.reducer());
+  reduction.Finalize();
+}
+
+// 1D default reduction pattern
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(const std::string &name, DevExecSpace exec_space, const int &il,
+           const int &iu, const Function &function, Args &&... args) {
+  Profiler::ScopedRegion region(name, true);
+  par_reduce(loop_pattern_mdrange_tag, name, exec_space, il, iu, function,
+             std::forward<Args>(args)...);
+}
+
+// 2D default reduction pattern
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(const std::string &name, DevExecSpace exec_space, const int &jl,
+           const int &ju, const int &il, const int &iu, const Function &function,
+           Args &&... args) {
+  Profiler::ScopedRegion region(name, true);
+  par_reduce(loop_pattern_mdrange_tag, name, exec_space, jl, ju, il, iu, function,
+             std::forward<Args>(args)...);
+}
+
+// 3D default reduction pattern
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(const std::string &name, DevExecSpace exec_space, const int &kl,
+           const int &ku, const int &jl, const int &ju, const int &il, const int &iu,
+           const Function &function, Args &&... args) {
+  Profiler::ScopedRegion region(name, true);
+  par_reduce(DEFAULT_REDUCE_PATTERN, name, exec_space, kl, ku, jl, ju, il, iu, function,
+             std::forward<Args>(args)...);
+}
+
+// 4D default reduction pattern
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(const std::string &name, DevExecSpace exec_space, const int &nl,
+           const int &nu, const int &kl, const int &ku, const int &jl, const int &ju,
+           const int &il, const int &iu, const Function &function, Args &&... args) {
+  Profiler::ScopedRegion region(name, true);
+  par_reduce(DEFAULT_REDUCE_PATTERN, name, exec_space, nl, nu, kl, ku, jl, ju, il, iu,
+             function, std::forward<Args>(args)...);
+}
+
+// 5D default reduction pattern
+template <typename Function, typename... Args>
+inline detail::EnableIfFunction<Function>
+par_reduce(const std::string &name, DevExecSpace exec_space, const int &ml,
+           const int &mu, const int &nl, const int &nu, const int &kl, const int &ku,
+           const int &jl, const int &ju, const int &il, const int &iu,
+           const Function &function, Args &&... args) {
+  Profiler::ScopedRegion region(name, true);
+  par_reduce(DEFAULT_REDUCE_PATTERN, name, exec_space, ml, mu, nl, nu, kl, ku, jl, ju,
+             il, iu, function, std::forward<Args>(args)...);
+}
+
+// 1D scan
+template <typename Function, typename T>
+inline void par_scan(const std::string &name, DevExecSpace exec_space, const int &il,
+                     const int &iu, const Function &function, T &total) {
+  Profiler::ScopedRegion region(name, true);
+  Kokkos::parallel_scan(
+      name, Kokkos::RangePolicy<>(exec_space, il, iu + 1),
+      KOKKOS_LAMBDA(const int i, T &update, const bool final) {
+        function(i, update, final);
+      },
+      total);
+}
+
+// 2D scan over the flattened index
+template <typename Function, typename T>
+inline void par_scan(const std::string &name, DevExecSpace exec_space, const int &jl,
+                     const int &ju, const int &il, const int &iu,
+                     const Function &function, T &total) {
+  Profiler::ScopedRegion region(name, true);
+  const int Nj = ju - jl + 1;
+  const int Ni = iu - il + 1;
+  Kokkos::parallel_scan(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Nj * Ni),
+      KOKKOS_LAMBDA(const int idx, T &update, const bool final) {
+        const int j = idx / Ni;
+        const int i = idx - j * Ni;
+        function(j + jl, i + il, update, final);
+      },
+      total);
+}
+
+// 3D scan over the flattened index
+template <typename Function, typename T>
+inline void par_scan(const std::string &name, DevExecSpace exec_space, const int &kl,
+                     const int &ku, const int &jl, const int &ju, const int &il,
+                     const int &iu, const Function &function, T &total) {
+  Profiler::ScopedRegion region(name, true);
+  const int Nk = ku - kl + 1;
+  const int Nj = ju - jl + 1;
+  const int Ni = iu - il + 1;
+  const int NjNi = Nj * Ni;
+  Kokkos::parallel_scan(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Nk * NjNi),
+      KOKKOS_LAMBDA(const int idx, T &update, const bool final) {
+        const int k = idx / NjNi;
+        const int j = (idx - k * NjNi) / Ni;
+        const int i = idx - k * NjNi - j * Ni;
+        function(k + kl, j + jl, i + il, update, final);
+      },
+      total);
+}
+
+// 4D scan over the flattened index
+template <typename Function, typename T>
+inline void par_scan(const std::string &name, DevExecSpace exec_space, const int &nl,
+                     const int &nu, const int &kl, const int &ku, const int &jl,
+                     const int &ju, const int &il, const int &iu,
+                     const Function &function, T &total) {
+  Profiler::ScopedRegion region(name, true);
+  const int Nn = nu - nl + 1;
+  const int Nk = ku - kl + 1;
+  const int Nj = ju - jl + 1;
+  const int Ni = iu - il + 1;
+  const int NjNi = Nj * Ni;
+  const int NkNjNi = Nk * NjNi;
+  Kokkos::parallel_scan(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Nn * NkNjNi),
+      KOKKOS_LAMBDA(const int idx, T &update, const bool final) {
+        const int n = idx / NkNjNi;
+        const int k = (idx - n * NkNjNi) / NjNi;
+        const int j = (idx - n * NkNjNi - k * NjNi) / Ni;
+        const int i = idx - n * NkNjNi - k * NjNi - j * Ni;
+        function(n + nl, k + kl, j + jl, i + il, update, final);
+      },
+      total);
+}
+
+// 5D scan over the flattened index
+template <typename Function, typename T>
+inline void par_scan(const std::string &name, DevExecSpace exec_space, const int &ml,
+                     const int &mu, const int &nl, const int &nu, const int &kl,
+                     const int &ku, const int &jl, const int &ju, const int &il,
+                     const int &iu, const Function &function, T &total) {
+  Profiler::ScopedRegion region(name, true);
+  const int Nm = mu - ml + 1;
+  const int Nn = nu - nl + 1;
+  const int Nk = ku - kl + 1;
+  const int Nj = ju - jl + 1;
+  const int Ni = iu - il + 1;
+  const int NjNi = Nj * Ni;
+  const int NkNjNi = Nk * NjNi;
+  const int NnNkNjNi = Nn * NkNjNi;
+  Kokkos::parallel_scan(
+      name, Kokkos::RangePolicy<>(exec_space, 0, Nm * NnNkNjNi),
+      KOKKOS_LAMBDA(const int idx, T &update, const bool final) {
+        const int m = idx / NnNkNjNi;
+        const int n = (idx - m * NnNkNjNi) / NkNjNi;
+        const int k = (idx - m * NnNkNjNi - n * NkNjNi) / NjNi;
+        const int j = (idx - m * NnNkNjNi - n * NkNjNi - k * NjNi) / Ni;
+        const int i = idx - m * NnNkNjNi - n * NkNjNi - k * NjNi - j * Ni;
+        function(m + ml, n + nl, k + kl, j + jl, i + il, update, final);
+      },
+      total);
+}
+
 // reused from kokoks/core/perf_test/PerfTest_ExecSpacePartitioning.cpp
 // commit a0d011fb30022362c61b3bb000ae3de6906cb6a7
 template <class ExecSpace>
@@ -18,6 +18,7 @@
 //  \brief implementation of Mesh::AdaptiveMeshRefinement() and related utilities
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <iostream>
 #include <sstream>
@@ -26,6 +27,7 @@
 
 #include "athena.hpp"
 #include "bvals/boundary_conditions.hpp"
+#include "bvals/progress_thread.hpp"
 #include "globals.hpp"
 #include "interface/update.hpp"
 #include "mesh/mesh.hpp"
@@ -486,10 +488,13 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
   bssame++;
 
   MPI_Request *req_send, *req_recv;
+  // completion flags of the requests for the progress thread
+  std::atomic<BoundaryStatus> *status_send, *status_recv;
   // Step 5. allocate and start receiving buffers
   if (nrecv != 0) {
     recvbuf = new Real *[nrecv];
     req_recv = new MPI_Request[nrecv];
+    status_recv = new std::atomic<BoundaryStatus>[nrecv];
     int rb_idx = 0; // recv buffer index
     for (int n = nbs; n <= nbe; n++) {
       int on = newtoold[n];
@@ -505,6 +510,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
           int tag = CreateAMRMPITag(n - nbs, ox1, ox2, ox3);
           MPI_Irecv(recvbuf[rb_idx], bsf2c, MPI_ATHENA_REAL, ranklist[on + l], tag,
                     MPI_COMM_WORLD, &(req_recv[rb_idx]));
+          ProgressThread::Post(&(req_recv[rb_idx]), &(status_recv[rb_idx]),
+                               BoundaryStatus::arrived);
           rb_idx++;
         }
       } else { // same level or c2f
@@ -519,6 +526,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
         int tag = CreateAMRMPITag(n - nbs, 0, 0, 0);
         MPI_Irecv(recvbuf[rb_idx], size, MPI_ATHENA_REAL, ranklist[on], tag,
                   MPI_COMM_WORLD, &(req_recv[rb_idx]));
+        ProgressThread::Post(&(req_recv[rb_idx]), &(status_recv[rb_idx]),
+                             BoundaryStatus::arrived);
         rb_idx++;
       }
     }
@@ -527,6 +536,7 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
   if (nsend != 0) {
     sendbuf = new Real *[nsend];
     req_send = new MPI_Request[nsend];
+    status_send = new std::atomic<BoundaryStatus>[nsend];
     int sb_idx = 0; // send buffer index
     for (int n = onbs; n <= onbe; n++) {
       int nn = oldtonew[n];
@@ -540,6 +550,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
         int tag = CreateAMRMPITag(nn - nslist[newrank[nn]], 0, 0, 0);
         MPI_Isend(sendbuf[sb_idx], bssame, MPI_ATHENA_REAL, newrank[nn], tag,
                   MPI_COMM_WORLD, &(req_send[sb_idx]));
+        ProgressThread::Post(&(req_send[sb_idx]), &(status_send[sb_idx]),
+                             BoundaryStatus::completed);
         sb_idx++;
       } else if (nloc.level > oloc.level) { // c2f
         // c2f must communicate to multiple leaf blocks (unlike f2c, same2same)
@@ -550,6 +562,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
           int tag = CreateAMRMPITag(nn + l - nslist[newrank[nn + l]], 0, 0, 0);
           MPI_Isend(sendbuf[sb_idx], bsc2f, MPI_ATHENA_REAL, newrank[nn + l], tag,
                     MPI_COMM_WORLD, &(req_send[sb_idx]));
+          ProgressThread::Post(&(req_send[sb_idx]), &(status_send[sb_idx]),
+                               BoundaryStatus::completed);
           sb_idx++;
         }      // end loop over nleaf (unique to c2f branch in this step 6)
       } else { // f2c: restrict + pack + send
@@ -561,6 +575,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
         int tag = CreateAMRMPITag(nn - nslist[newrank[nn]], ox1, ox2, ox3);
         MPI_Isend(sendbuf[sb_idx], bsf2c, MPI_ATHENA_REAL, newrank[nn], tag,
                   MPI_COMM_WORLD, &(req_send[sb_idx]));
+        ProgressThread::Post(&(req_send[sb_idx]), &(status_send[sb_idx]),
+                             BoundaryStatus::completed);
         sb_idx++;
       }
     }
@@ -652,19 +668,22 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
       MeshBlock *pb = FindMeshBlock(n);
       if (oloc.level == nloc.level) { // same
         if (ranklist[on] == Globals::my_rank) continue;
-        MPI_Wait(&(req_recv[rb_idx]), MPI_STATUS_IGNORE);
+        ProgressThread::Wait(&(req_recv[rb_idx]), &(status_recv[rb_idx]),
+                             BoundaryStatus::arrived);
         FinishRecvSameLevel(pb, recvbuf[rb_idx]);
         rb_idx++;
       } else if (oloc.level > nloc.level) { // f2c
         for (int l = 0; l < nleaf; l++) {
           if (ranklist[on + l] == Globals::my_rank) continue;
-          MPI_Wait(&(req_recv[rb_idx]), MPI_STATUS_IGNORE);
+          ProgressThread::Wait(&(req_recv[rb_idx]), &(status_recv[rb_idx]),
+                               BoundaryStatus::arrived);
           FinishRecvFineToCoarseAMR(pb, recvbuf[rb_idx], loclist[on + l]);
           rb_idx++;
         }
       } else { // c2f
         if (ranklist[on] == Globals::my_rank) continue;
-        MPI_Wait(&(req_recv[rb_idx]), MPI_STATUS_IGNORE);
+        ProgressThread::Wait(&(req_recv[rb_idx]), &(status_recv[rb_idx]),
+                             BoundaryStatus::arrived);
         FinishRecvCoarseToFineAMR(pb, recvbuf[rb_idx]);
         rb_idx++;
       }
@@ -680,17 +699,25 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
   delete[] oldtonew;
 #ifdef MPI_PARALLEL
   if (nsend != 0) {
-    MPI_Waitall(nsend, req_send, MPI_STATUSES_IGNORE);
+    if (ProgressThread::Enabled()) {
+      for (int n = 0; n < nsend; n++)
+        ProgressThread::Wait(&(req_send[n]), &(status_send[n]),
+                             BoundaryStatus::completed);
+    } else {
+      MPI_Waitall(nsend, req_send, MPI_STATUSES_IGNORE);
+    }
     for (int n = 0; n < nsend; n++)
       delete[] sendbuf[n];
     delete[] sendbuf;
     delete[] req_send;
+    delete[] status_send;
   }
   if (nrecv != 0) {
     for (int n = 0; n < nrecv; n++)
       delete[] recvbuf[n];
     delete[] recvbuf;
     delete[] req_recv;
+    delete[] status_recv;
   }
 #endif
 
@@ -1004,6 +1031,19 @@ void Mesh::FinishRecvSameLevel(MeshBlock *pb, Real *recvbuf) {
 
   for (auto &pvar_cc : pb->vars_cc_) {
     int nu = pvar_cc->GetDim(4) - 1;
+    if (!pvar_cc->IsAllocated()) {
+      // a sparse id that is zero on the sending block stays unallocated
+      const int size = (nu + 1) * (pb->ke - pb->ks + 1) * (pb->je - pb->js + 1) *
+                       (pb->ie - pb->is + 1);
+      if (std::all_of(recvbuf + p, recvbuf + p + size,
+                      [](const Real x) { return x == 0.0; })) {
+        p += size;
+        continue;
+      }
+      const std::string &label = pvar_cc->label();
+      pb->real_containers.Get().AllocateSparse(label.substr(0, label.find_last_of('_')),
+                                               pvar_cc->metadata().GetSparseId());
+    }
     auto &var_cc = pvar_cc->data;
     BufferUtility::UnpackData(recvbuf, var_cc, 0, nu, pb->is, pb->ie, pb->js, pb->je,
                               pb->ks, pb->ke, p);
@@ -29,6 +29,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "parthenon_mpi.hpp"
@@ -36,11 +37,14 @@
 #include "athena.hpp"
 #include "bvals/boundary_conditions.hpp"
 #include "bvals/bvals.hpp"
+#include "bvals/neighbor_exchange.hpp"
+#include "bvals/node_buffers.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/mesh_refinement.hpp"
 #include "mesh/meshblock_tree.hpp"
 #include "outputs/io_wrapper.hpp"
+#include "outputs/restart.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_arrays.hpp"
 #include "utils/buffer_utils.hpp"
@@ -482,10 +486,11 @@ Mesh::Mesh(ParameterInput *pin, Properties_t &properties, Packages_t &packages,
 
 //----------------------------------------------------------------------------------------
 // Mesh constructor for restarts. Load the restart file
-#if 0
+
 Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
            Packages_t &packages, int mesh_test)
     : // public members:
+      modified(true),
       // aggregate initialization of RegionSize struct:
       // (will be overwritten by memcpy from restart file, in this case)
       mesh_size{pin->GetReal("parthenon/mesh", "x1min"),
@@ -500,44 +505,36 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
                 pin->GetInteger("parthenon/mesh", "nx1"),
                 pin->GetInteger("parthenon/mesh", "nx2"),
                 pin->GetInteger("parthenon/mesh", "nx3")},
-      mesh_bcs{GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ix1_bc", "none")),
-               GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ox1_bc", "none")),
-               GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ix2_bc", "none")),
-               GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ox2_bc", "none")),
-               GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ix3_bc", "none")),
-               GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ox3_bc", "none"))},
+      mesh_bcs{
+          GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ix1_bc", "reflecting")),
+          GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ox1_bc", "reflecting")),
+          GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ix2_bc", "reflecting")),
+          GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ox2_bc", "reflecting")),
+          GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ix3_bc", "reflecting")),
+          GetBoundaryFlag(pin->GetOrAddString("parthenon/mesh", "ox3_bc", "reflecting"))},
       ndim((mesh_size.nx3 > 1) ? 3 : ((mesh_size.nx2 > 1) ? 2 : 1)),
-      adaptive(pin->GetOrAddString("parthenon/mesh", "refinement", "none")
-                                                        == "adaptive" ? true : false),
-      multilevel(
-          (adaptive ||
-           pin->GetOrAddString("parthenon/mesh", "refinement", "none") == "static")
-              ? true
-              : false),
-      start_time(pin->GetOrAddReal("parthenon/time", "start_time", 0.0)),
-      time(start_time),
-      tlim(pin->GetReal("parthenon/time", "tlim")), dt(std::numeric_limits<Real>::max()),
-      dt_hyperbolic(dt), dt_parabolic(dt), dt_user(dt),
-      nlim(pin->GetOrAddInteger("parthenon/time", "nlim", -1)), ncycle(),
-      ncycle_out(pin->GetOrAddInteger("parthenon/time", "ncycle_out", 1)),
-      dt_diagnostics(pin->GetOrAddInteger("parthenon/time", "dt_diagnostics", -1)),
-      nbnew(),
-      nbdel(), step_since_lb(), gflag(), pblock(nullptr), properties(properties),
+      adaptive(pin->GetOrAddString("parthenon/mesh", "refinement", "none") == "adaptive"
+                   ? true
+                   : false),
+      multilevel((adaptive ||
+                  pin->GetOrAddString("parthenon/mesh", "refinement", "none") == "static")
+                     ? true
+                     : false),
+      nbnew(), nbdel(), step_since_lb(), gflag(), pblock(nullptr), properties(properties),
       packages(packages),
       // private members:
       next_phys_id_(),
       num_mesh_threads_(pin->GetOrAddInteger("parthenon/mesh", "num_threads", 1)),
-      tree(this), use_uniform_meshgen_fn_{true, true, true}, nreal_user_mesh_data_(),
-      nint_user_mesh_data_(), nuser_history_output_(), lb_flag_(true), lb_automatic_(),
-      lb_manual_(), MeshGenerator_{UniformMeshGeneratorX1, UniformMeshGeneratorX2,
-                                   UniformMeshGeneratorX3},
+      tree(this), use_uniform_meshgen_fn_{true, true, true, true},
+      nuser_history_output_(), lb_flag_(true), lb_automatic_(),
+      lb_manual_(), MeshGenerator_{nullptr, UniformMeshGeneratorX1,
+                                   UniformMeshGeneratorX2, UniformMeshGeneratorX3},
       BoundaryFunction_{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}, AMRFlag_{},
-      UserSourceTerm_{}, UserTimeStep_{}, FieldDiffusivity_{} {
+      UserSourceTerm_{}, UserTimeStep_{} {
   std::stringstream msg;
   RegionSize block_size;
   BoundaryFlag block_bcs[6];
   MeshBlock *pfirst{};
-  IOWrapperSizeT *offset{};
   IOWrapperSizeT datasize, listsize, headeroffset;
 
   // mesh test
@@ -562,10 +559,10 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
   // read the restart file
   // the file is already open and the pointer is set to after <par_end>
   IOWrapperSizeT headersize =
-      sizeof(int) * 3 + sizeof(Real) * 2 + sizeof(RegionSize) + sizeof(IOWrapperSizeT);
-  char *headerdata = new char[headersize];
+      sizeof(int) * 2 + sizeof(RegionSize) + sizeof(IOWrapperSizeT);
+  std::vector<char> headerdata(headersize);
   if (Globals::my_rank == 0) { // the master process reads the header data
-    if (resfile.Read(headerdata, 1, headersize) != headersize) {
+    if (resfile.Read(headerdata.data(), 1, headersize) != headersize) {
       msg << "### FATAL ERROR in Mesh constructor" << std::endl
           << "The restart file is broken." << std::endl;
       ATHENA_ERROR(msg);
@@ -573,7 +570,7 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
   }
 #ifdef MPI_PARALLEL
   // then broadcast the header data
-  MPI_Bcast(headerdata, headersize, MPI_BYTE, 0, MPI_COMM_WORLD);
+  MPI_Bcast(headerdata.data(), headersize, MPI_BYTE, 0, MPI_COMM_WORLD);
 #endif
   IOWrapperSizeT hdos = 0;
   std::memcpy(&nbtotal, &(headerdata[hdos]), sizeof(int));
@@ -583,28 +580,27 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
   current_level = root_level;
   std::memcpy(&mesh_size, &(headerdata[hdos]), sizeof(RegionSize));
   hdos += sizeof(RegionSize);
-  std::memcpy(&time, &(headerdata[hdos]), sizeof(Real));
-  hdos += sizeof(Real);
-  std::memcpy(&dt, &(headerdata[hdos]), sizeof(Real));
-  hdos += sizeof(Real);
-  std::memcpy(&ncycle, &(headerdata[hdos]), sizeof(int));
-  hdos += sizeof(int);
   std::memcpy(&datasize, &(headerdata[hdos]), sizeof(IOWrapperSizeT));
-  hdos += sizeof(IOWrapperSizeT); // (this updated value is never used)
-
-  delete[] headerdata;
 
   // initialize
   loclist = new LogicalLocation[nbtotal];
-  offset = new IOWrapperSizeT[nbtotal];
   costlist = new double[nbtotal];
   ranklist = new int[nbtotal];
   nslist = new int[Globals::nranks];
   nblist = new int[Globals::nranks];
 
+  block_size.x1rat = mesh_size.x1rat;
+  block_size.x2rat = mesh_size.x2rat;
+  block_size.x3rat = mesh_size.x3rat;
   block_size.nx1 = pin->GetOrAddInteger("parthenon/meshblock", "nx1", mesh_size.nx1);
-  block_size.nx2 = pin->GetOrAddInteger("parthenon/meshblock", "nx2", mesh_size.nx2);
-  block_size.nx3 = pin->GetOrAddInteger("parthenon/meshblock", "nx3", mesh_size.nx3);
+  if (ndim >= 2)
+    block_size.nx2 = pin->GetOrAddInteger("parthenon/meshblock", "nx2", mesh_size.nx2);
+  else
+    block_size.nx2 = mesh_size.nx2;
+  if (ndim >= 3)
+    block_size.nx3 = pin->GetOrAddInteger("parthenon/meshblock", "nx3", mesh_size.nx3);
+  else
+    block_size.nx3 = mesh_size.nx3;
 
   // calculate the number of the blocks
   nrbx1 = mesh_size.nx1 / block_size.nx1;
@@ -650,46 +646,13 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
 
   InitUserMeshData(pin);
 
-  // read user Mesh data
-  IOWrapperSizeT udsize = 0;
-  for (int n = 0; n < nint_user_mesh_data_; n++)
-    udsize += iuser_mesh_data[n].GetSizeInBytes();
-  for (int n = 0; n < nreal_user_mesh_data_; n++)
-    udsize += ruser_mesh_data[n].GetSizeInBytes();
-  if (udsize != 0) {
-    char *userdata = new char[udsize];
-    if (Globals::my_rank == 0) { // only the master process reads the ID list
-      if (resfile.Read(userdata, 1, udsize) != udsize) {
-        msg << "### FATAL ERROR in Mesh constructor" << std::endl
-            << "The restart file is broken." << std::endl;
-        ATHENA_ERROR(msg);
-      }
-    }
-#ifdef MPI_PARALLEL
-    // then broadcast the ID list
-    MPI_Bcast(userdata, udsize, MPI_BYTE, 0, MPI_COMM_WORLD);
-#endif
-
-    IOWrapperSizeT udoffset = 0;
-    for (int n = 0; n < nint_user_mesh_data_; n++) {
-      std::memcpy(iuser_mesh_data[n].data(), &(userdata[udoffset]),
-                  iuser_mesh_data[n].GetSizeInBytes());
-      udoffset += iuser_mesh_data[n].GetSizeInBytes();
-    }
-    for (int n = 0; n < nreal_user_mesh_data_; n++) {
-      std::memcpy(ruser_mesh_data[n].data(), &(userdata[udoffset]),
-                  ruser_mesh_data[n].GetSizeInBytes());
-      udoffset += ruser_mesh_data[n].GetSizeInBytes();
-    }
-    delete[] userdata;
-  }
-
-  // read the ID list
-  listsize = sizeof(LogicalLocation) + sizeof(Real);
+  // read the block index
+  listsize = sizeof(LogicalLocation) + sizeof(double) + sizeof(IOWrapperSizeT);
   // allocate the idlist buffer
-  char *idlist = new char[listsize * nbtotal];
+  std::vector<char> idlist(listsize * nbtotal);
   if (Globals::my_rank == 0) { // only the master process reads the ID list
-    if (resfile.Read(idlist, listsize, nbtotal) != static_cast<unsigned int>(nbtotal)) {
+    if (resfile.Read(idlist.data(), listsize, nbtotal) !=
+        static_cast<unsigned int>(nbtotal)) {
       msg << "### FATAL ERROR in Mesh constructor" << std::endl
           << "The restart file is broken." << std::endl;
       ATHENA_ERROR(msg);
@@ -697,21 +660,24 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
   }
 #ifdef MPI_PARALLEL
   // then broadcast the ID list
-  MPI_Bcast(idlist, listsize * nbtotal, MPI_BYTE, 0, MPI_COMM_WORLD);
+  MPI_Bcast(idlist.data(), listsize * nbtotal, MPI_BYTE, 0, MPI_COMM_WORLD);
 #endif
 
-  int os = 0;
+  std::vector<IOWrapperSizeT> block_offsets(nbtotal + 1);
+  IOWrapperSizeT os = 0;
   for (int i = 0; i < nbtotal; i++) {
     std::memcpy(&(loclist[i]), &(idlist[os]), sizeof(LogicalLocation));
     os += sizeof(LogicalLocation);
     std::memcpy(&(costlist[i]), &(idlist[os]), sizeof(double));
     os += sizeof(double);
+    std::memcpy(&(block_offsets[i]), &(idlist[os]), sizeof(IOWrapperSizeT));
+    os += sizeof(IOWrapperSizeT);
     if (loclist[i].level > current_level) current_level = loclist[i].level;
   }
-  delete[] idlist;
+  block_offsets[nbtotal] = datasize;
 
   // calculate the header offset and seek
-  headeroffset += headersize + udsize + listsize * nbtotal;
+  headeroffset += headersize + listsize * nbtotal;
   if (Globals::my_rank != 0) resfile.Seek(headeroffset);
 
   // rebuild the Block Tree
@@ -739,7 +705,6 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
       std::cout << "### Warning in Mesh constructor" << std::endl
                 << "Too few mesh blocks: nbtotal (" << nbtotal << ") < nranks ("
                 << Globals::nranks << ")" << std::endl;
-      delete[] offset;
       return;
     }
   }
@@ -761,57 +726,47 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper &resfile, Properties_t &properties,
   // Output MeshBlock list and quit (mesh test only); do not create meshes
   if (mesh_test > 0) {
     if (Globals::my_rank == 0) OutputMeshStructure(ndim);
-    delete[] offset;
     return;
   }
 
-  // allocate data buffer
+  // map (or read) only the part of the file holding the MeshBlocks that the load balance
+  // assigns to this rank, which need not match the rank count the file was written with
   int nb = nblist[Globals::my_rank];
   int nbs = nslist[Globals::my_rank];
   int nbe = nbs + nb - 1;
-  char *mbdata = new char[datasize * nb];
-  // load MeshBlocks (parallel)
-  if (resfile.Read_at_all(mbdata, datasize, nb, headeroffset + nbs * datasize) !=
-      static_cast<unsigned int>(nb)) {
-    msg << "### FATAL ERROR in Mesh constructor" << std::endl
-        << "The restart file is broken or input parameters are inconsistent."
-        << std::endl;
-    ATHENA_ERROR(msg);
-  }
+  bool use_mmap =
+      pin->GetOrAddBoolean("parthenon/restart", "mmap", true) && RestartReader::CanMap();
+  RestartReader reader(resfile, headeroffset, std::move(block_offsets));
+  reader.ReadBlocks(nbs, nb, use_mmap);
+
   for (int i = nbs; i <= nbe; i++) {
-    // Match fixed-width integer precision of IOWrapperSizeT datasize
-    std::uint64_t buff_os = datasize * (i - nbs);
     SetBlockSizeAndBoundaries(loclist[i], block_size, block_bcs);
     // create a block and add into the link list
     if (i == nbs) {
-      pblock = new MeshBlock(i, i - nbs, this, pin, properties, packages, loclist[i],
-                             block_size, block_bcs, costlist[i], mbdata + buff_os, gflag);
+      pblock = new MeshBlock(i, i - nbs, loclist[i], block_size, block_bcs, this, pin,
+                             properties, packages, gflag);
       pfirst = pblock;
     } else {
-      pblock->next =
-          new MeshBlock(i, i - nbs, this, pin, properties, packages, loclist[i],
-                        block_size, block_bcs, costlist[i], mbdata + buff_os, gflag);
+      pblock->next = new MeshBlock(i, i - nbs, loclist[i], block_size, block_bcs, this,
+                                   pin, properties, packages, gflag);
       pblock->next->prev = pblock;
       pblock = pblock->next;
     }
+    // check consistency before touching the data of the block
+    if (reader.BlockSize(i) != pblock->GetBlockSizeInBytes()) {
+      msg << "### FATAL ERROR in Mesh constructor" << std::endl
+          << "The restart file is broken or input parameters are inconsistent."
+          << std::endl;
+      ATHENA_ERROR(msg);
+    }
+    pblock->cost_ = costlist[i];
+    reader.LoadBlock(i, pblock->vars_cc_);
     pblock->pbval->SearchAndSetNeighbors(tree, ranklist, nslist);
   }
   pblock = pfirst;
-  delete[] mbdata;
-  // check consistency
-  if (datasize != pblock->GetBlockSizeInBytes()) {
-    msg << "### FATAL ERROR in Mesh constructor" << std::endl
-        << "The restart file is broken or input parameters are inconsistent."
-        << std::endl;
-    ATHENA_ERROR(msg);
-  }
 
   ResetLoadBalanceVariables();
-
-  // clean up
-  delete[] offset;
 }
-#endif
 
 //----------------------------------------------------------------------------------------
 // destructor
@@ -1001,7 +956,20 @@ void Mesh::OutputMeshStructure(int ndim) {
 //  \brief Enroll a user-defined boundary function
 
 void Mesh::EnrollUserBoundaryFunction(BoundaryFace dir, BValFunc my_bc) {
-  throw std::runtime_error("Mesh::EnrollUserBoundaryFunction is not implemented");
+  std::stringstream msg;
+  if (dir < 0 || dir > 5) {
+    msg << "### FATAL ERROR in EnrollBoundaryCondition function" << std::endl
+        << "dirName = " << dir << " not valid" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  if (mesh_bcs[dir] != BoundaryFlag::user) {
+    msg << "### FATAL ERROR in EnrollUserBoundaryFunction" << std::endl
+        << "The boundary condition flag must be set to the string 'user' in the "
+        << " <mesh> block in the input file to use user-enrolled BCs" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  BoundaryFunction_[static_cast<int>(dir)] = my_bc;
+  return;
 }
 
 // DEPRECATED(felker): provide trivial overloads for old-style BoundaryFace enum argument
@@ -1164,6 +1132,10 @@ void Mesh::Initialize(int res_flag, ParameterInput *pin) {
       pmb->pbval->SetupPersistentMPI();
       pmb->real_containers.Get().SetupPersistentMPI();
     }
+    // buffers of neighbors on other ranks of this node go to shared memory
+    NodeBuffers::Setup(this);
+    // and the ones of the other neighbor ranks to the neighborhood collective if enabled
+    NeighborExchange::Build(this);
     call++; // 1
 
 #pragma omp parallel num_threads(nthreads)
@@ -1177,6 +1149,8 @@ void Mesh::Initialize(int res_flag, ParameterInput *pin) {
               // send conserved variables
 #pragma omp for
       for (int i = 0; i < nmb; ++i) {
+        // the shared buffers of the neighbors on this node are free before the first
+        // exchange, so all buffers are sent at once
         pmb_array[i]->real_containers.Get().SendBoundaryBuffers();
       }
       call++; // 3
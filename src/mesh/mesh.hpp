@@ -26,6 +26,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "athena.hpp"
@@ -188,6 +189,44 @@ class MeshBlock {
                              nu, kl, ku, jl, ju, function);
   }
 
+  // 1D default reduction pattern
+  template <typename Function, typename... Args>
+  inline detail::EnableIfFunction<Function>
+  par_reduce(const std::string &name, const int &il, const int &iu,
+             const Function &function, Args &&... args) {
+    parthenon::par_reduce(name, exec_space, il, iu, function,
+                          std::forward<Args>(args)...);
+  }
+
+  // 2D default reduction pattern
+  template <typename Function, typename... Args>
+  inline detail::EnableIfFunction<Function>
+  par_reduce(const std::string &name, const int &jl, const int &ju, const int &il,
+             const int &iu, const Function &function, Args &&... args) {
+    parthenon::par_reduce(name, exec_space, jl, ju, il, iu, function,
+                          std::forward<Args>(args)...);
+  }
+
+  // 3D default reduction pattern
+  template <typename Function, typename... Args>
+  inline detail::EnableIfFunction<Function>
+  par_reduce(const std::string &name, const int &kl, const int &ku, const int &jl,
+             const int &ju, const int &il, const int &iu, const Function &function,
+             Args &&... args) {
+    parthenon::par_reduce(name, exec_space, kl, ku, jl, ju, il, iu, function,
+                          std::forward<Args>(args)...);
+  }
+
+  // 4D default reduction pattern
+  template <typename Function, typename... Args>
+  inline detail::EnableIfFunction<Function>
+  par_reduce(const std::string &name, const int &nl, const int &nu, const int &kl,
+             const int &ku, const int &jl, const int &ju, const int &il, const int &iu,
+             const Function &function, Args &&... args) {
+    parthenon::par_reduce(name, exec_space, nl, nu, kl, ku, jl, ju, il, iu, function,
+                          std::forward<Args>(args)...);
+  }
+
   std::size_t GetBlockSizeInBytes();
   int GetNumberOfMeshBlockCells() {
     return block_size.nx1 * block_size.nx2 * block_size.nx3;
@@ -259,6 +298,9 @@ class Mesh {
   // accessors
   int GetNumMeshBlocksThisRank(int my_rank) { return nblist[my_rank]; }
   int GetNumMeshThreads() const { return num_mesh_threads_; }
+  BValFunc GetUserBoundaryFunction(BoundaryFace face) const {
+    return BoundaryFunction_[face];
+  }
   std::int64_t GetTotalCells() {
     return static_cast<std::int64_t>(nbtotal) * pblock->block_size.nx1 *
            pblock->block_size.nx2 * pblock->block_size.nx3;
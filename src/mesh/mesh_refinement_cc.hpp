@@ -0,0 +1,447 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef MESH_MESH_REFINEMENT_CC_HPP_
+#define MESH_MESH_REFINEMENT_CC_HPP_
+//! \file mesh_refinement_cc.hpp
+//  \brief restriction and prolongation kernels of cell centered variables
+//
+// The kernels are templated on the coordinate class and pick the variant for the
+// geometry at compile time from its CoordinateTraits.  MeshRefinement calls them with
+// Coordinates_t, the unit tests also with coordinates that do not specialize the traits.
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "athena.hpp"
+#include "coordinates/coordinate_traits.hpp"
+#include "mesh/mesh.hpp"
+#include "parthenon_arrays.hpp"
+
+namespace parthenon {
+
+namespace CellCenteredRefinement {
+
+namespace detail {
+
+// The kernels index fine and coarse as (n, k, j, i).  They are called with the rank 4
+// views of the innermost dimensions of the ParArrayNDs, whose index arithmetic is that
+// of 4 instead of 6 dimensions.
+
+// volume weighted average of the fine cells
+template <typename Coords, typename Fine, typename Coarse>
+void Restrict(std::false_type, MeshBlock *pmb, const Coords &coords,
+              const Fine &fine, const Coarse &coarse, int sn, int en, int csi, int cei,
+              int csj, int cej, int csk, int cek) {
+  const int cks = pmb->cks;
+  const int cjs = pmb->cjs;
+  const int cis = pmb->cis;
+  const int ks = pmb->ks;
+  const int js = pmb->js;
+  const int is = pmb->is;
+  if (pmb->block_size.nx3 > 1) { // 3D
+    pmb->par_for(
+        "RestrictCellCenteredValues3d", sn, en, csk, cek, csj, cej, csi, cei,
+        KOKKOS_LAMBDA(const int n, const int ck, const int cj, const int ci) {
+          int k = (ck - cks) * 2 + ks;
+          int j = (cj - cjs) * 2 + js;
+          int i = (ci - cis) * 2 + is;
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          const Real vol000 = coords.Volume(k, j, i);
+          const Real vol001 = coords.Volume(k, j, i + 1);
+          const Real vol010 = coords.Volume(k, j + 1, i);
+          const Real vol011 = coords.Volume(k, j + 1, i + 1);
+          const Real vol100 = coords.Volume(k + 1, j, i);
+          const Real vol101 = coords.Volume(k + 1, j, i + 1);
+          const Real vol110 = coords.Volume(k + 1, j + 1, i);
+          const Real vol111 = coords.Volume(k + 1, j + 1, i + 1);
+          Real tvol = ((vol000 + vol010) + (vol001 + vol011)) +
+                      ((vol100 + vol110) + (vol101 + vol111));
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          coarse(n, ck, cj, ci) =
+              (((fine(n, k, j, i) * vol000 + fine(n, k, j + 1, i) * vol010) +
+                (fine(n, k, j, i + 1) * vol001 + fine(n, k, j + 1, i + 1) * vol011)) +
+               ((fine(n, k + 1, j, i) * vol100 + fine(n, k + 1, j + 1, i) * vol110) +
+                (fine(n, k + 1, j, i + 1) * vol101 +
+                 fine(n, k + 1, j + 1, i + 1) * vol111))) /
+              tvol;
+        });
+  } else if (pmb->block_size.nx2 > 1) { // 2D
+    int k = ks, ck = cks;
+    pmb->par_for(
+        "RestrictCellCenteredValues2d", sn, en, csj, cej, csi, cei,
+        KOKKOS_LAMBDA(const int n, const int cj, const int ci) {
+          int j = (cj - cjs) * 2 + js;
+          int i = (ci - cis) * 2 + is;
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          const Real vol00 = coords.Volume(k, j, i);
+          const Real vol10 = coords.Volume(k, j + 1, i);
+          const Real vol01 = coords.Volume(k, j, i + 1);
+          const Real vol11 = coords.Volume(k, j + 1, i + 1);
+          Real tvol = (vol00 + vol10) + (vol01 + vol11);
+
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          coarse(n, 0, cj, ci) =
+              ((fine(n, 0, j, i) * vol00 + fine(n, 0, j + 1, i) * vol10) +
+               (fine(n, 0, j, i + 1) * vol01 + fine(n, 0, j + 1, i + 1) * vol11)) /
+              tvol;
+        });
+  } else { // 1D
+    int j = js, cj = cjs, k = ks, ck = cks;
+    pmb->par_for(
+        "RestrictCellCenteredValues1d", sn, en, csi, cei,
+        KOKKOS_LAMBDA(const int n, const int ci) {
+          int i = (ci - cis) * 2 + is;
+          const Real vol0 = coords.Volume(k, j, i);
+          const Real vol1 = coords.Volume(k, j, i + 1);
+          Real tvol = vol0 + vol1;
+          coarse(n, ck, cj, ci) =
+              (fine(n, k, j, i) * vol0 + fine(n, k, j, i + 1) * vol1) / tvol;
+        });
+  }
+}
+
+// all fine cells have the same weight
+template <typename Coords, typename Fine, typename Coarse>
+void Restrict(std::true_type, MeshBlock *pmb, const Coords &coords,
+              const Fine &fine, const Coarse &coarse, int sn, int en, int csi, int cei,
+              int csj, int cej, int csk, int cek) {
+  const int cks = pmb->cks;
+  const int cjs = pmb->cjs;
+  const int cis = pmb->cis;
+  const int ks = pmb->ks;
+  const int js = pmb->js;
+  const int is = pmb->is;
+  if (pmb->block_size.nx3 > 1) { // 3D
+    pmb->par_for(
+        "RestrictCellCenteredMean3d", sn, en, csk, cek, csj, cej, csi, cei,
+        KOKKOS_LAMBDA(const int n, const int ck, const int cj, const int ci) {
+          int k = (ck - cks) * 2 + ks;
+          int j = (cj - cjs) * 2 + js;
+          int i = (ci - cis) * 2 + is;
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          coarse(n, ck, cj, ci) =
+              0.125 * (((fine(n, k, j, i) + fine(n, k, j + 1, i)) +
+                        (fine(n, k, j, i + 1) + fine(n, k, j + 1, i + 1))) +
+                       ((fine(n, k + 1, j, i) + fine(n, k + 1, j + 1, i)) +
+                        (fine(n, k + 1, j, i + 1) + fine(n, k + 1, j + 1, i + 1))));
+        });
+  } else if (pmb->block_size.nx2 > 1) { // 2D
+    pmb->par_for(
+        "RestrictCellCenteredMean2d", sn, en, csj, cej, csi, cei,
+        KOKKOS_LAMBDA(const int n, const int cj, const int ci) {
+          int j = (cj - cjs) * 2 + js;
+          int i = (ci - cis) * 2 + is;
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          coarse(n, 0, cj, ci) =
+              0.25 * ((fine(n, 0, j, i) + fine(n, 0, j + 1, i)) +
+                      (fine(n, 0, j, i + 1) + fine(n, 0, j + 1, i + 1)));
+        });
+  } else { // 1D
+    int j = js, cj = cjs, k = ks, ck = cks;
+    pmb->par_for(
+        "RestrictCellCenteredMean1d", sn, en, csi, cei,
+        KOKKOS_LAMBDA(const int n, const int ci) {
+          int i = (ci - cis) * 2 + is;
+          coarse(n, ck, cj, ci) = 0.5 * (fine(n, k, j, i) + fine(n, k, j, i + 1));
+        });
+  }
+}
+
+// linear interpolation with the minmod limited gradients
+template <typename Coords, typename Coarse, typename Fine>
+void Prolongate(std::false_type, MeshBlock *pmb, const Coords &coords,
+                const Coords &coarse_coords, const Coarse &coarse, const Fine &fine,
+                int sn, int en, int si, int ei, int sj, int ej, int sk, int ek) {
+  const int cks = pmb->cks;
+  const int cjs = pmb->cjs;
+  const int cis = pmb->cis;
+  const int ks = pmb->ks;
+  const int js = pmb->js;
+  const int is = pmb->is;
+  if (pmb->block_size.nx3 > 1) {
+    pmb->par_for(
+        "ProlongateCellCenteredValues3d", sn, en, sk, ek, sj, ej, si, ei,
+        KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          // x3 direction
+          int fk = (k - cks) * 2 + ks;
+          const Real x3m = coarse_coords.x3v(k - 1);
+          const Real x3c = coarse_coords.x3v(k);
+          const Real x3p = coarse_coords.x3v(k + 1);
+          Real dx3m = x3c - x3m;
+          Real dx3p = x3p - x3c;
+          const Real fx3m = coords.x3v(fk);
+          const Real fx3p = coords.x3v(fk + 1);
+          Real dx3fm = x3c - fx3m;
+          Real dx3fp = fx3p - x3c;
+
+          // x2 direction
+          int fj = (j - cjs) * 2 + js;
+          const Real x2m = coarse_coords.x2v(j - 1);
+          const Real x2c = coarse_coords.x2v(j);
+          const Real x2p = coarse_coords.x2v(j + 1);
+          Real dx2m = x2c - x2m;
+          Real dx2p = x2p - x2c;
+          const Real fx2m = coords.x2v(fj);
+          const Real fx2p = coords.x2v(fj + 1);
+          Real dx2fm = x2c - fx2m;
+          Real dx2fp = fx2p - x2c;
+
+          // x1 direction
+          int fi = (i - cis) * 2 + is;
+          const Real x1m = coarse_coords.x1v(i - 1);
+          const Real x1c = coarse_coords.x1v(i);
+          const Real x1p = coarse_coords.x1v(i + 1);
+          Real dx1m = x1c - x1m;
+          Real dx1p = x1p - x1c;
+          const Real fx1m = coords.x1v(fi);
+          const Real fx1p = coords.x1v(fi + 1);
+          Real dx1fm = x1c - fx1m;
+          Real dx1fp = fx1p - x1c;
+
+          Real ccval = coarse(n, k, j, i);
+
+          // calculate 3D gradients using the minmod limiter
+          Real gx1m = (ccval - coarse(n, k, j, i - 1)) / dx1m;
+          Real gx1p = (coarse(n, k, j, i + 1) - ccval) / dx1p;
+          Real gx1c =
+              0.5 * (SIGN(gx1m) + SIGN(gx1p)) * std::min(std::abs(gx1m), std::abs(gx1p));
+          Real gx2m = (ccval - coarse(n, k, j - 1, i)) / dx2m;
+          Real gx2p = (coarse(n, k, j + 1, i) - ccval) / dx2p;
+          Real gx2c =
+              0.5 * (SIGN(gx2m) + SIGN(gx2p)) * std::min(std::abs(gx2m), std::abs(gx2p));
+          Real gx3m = (ccval - coarse(n, k - 1, j, i)) / dx3m;
+          Real gx3p = (coarse(n, k + 1, j, i) - ccval) / dx3p;
+          Real gx3c =
+              0.5 * (SIGN(gx3m) + SIGN(gx3p)) * std::min(std::abs(gx3m), std::abs(gx3p));
+
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          // interpolate onto the finer grid
+          fine(n, fk, fj, fi) = ccval - (gx1c * dx1fm + gx2c * dx2fm + gx3c * dx3fm);
+          fine(n, fk, fj, fi + 1) = ccval + (gx1c * dx1fp - gx2c * dx2fm - gx3c * dx3fm);
+          fine(n, fk, fj + 1, fi) = ccval - (gx1c * dx1fm - gx2c * dx2fp + gx3c * dx3fm);
+          fine(n, fk, fj + 1, fi + 1) =
+              ccval + (gx1c * dx1fp + gx2c * dx2fp - gx3c * dx3fm);
+          fine(n, fk + 1, fj, fi) = ccval - (gx1c * dx1fm + gx2c * dx2fm - gx3c * dx3fp);
+          fine(n, fk + 1, fj, fi + 1) =
+              ccval + (gx1c * dx1fp - gx2c * dx2fm + gx3c * dx3fp);
+          fine(n, fk + 1, fj + 1, fi) =
+              ccval - (gx1c * dx1fm - gx2c * dx2fp - gx3c * dx3fp);
+          fine(n, fk + 1, fj + 1, fi + 1) =
+              ccval + (gx1c * dx1fp + gx2c * dx2fp + gx3c * dx3fp);
+        });
+  } else if (pmb->block_size.nx2 > 1) {
+    int k = cks, fk = ks;
+    pmb->par_for(
+        "ProlongateCellCenteredValues2d", sn, en, sj, ej, si, ei,
+        KOKKOS_LAMBDA(const int n, const int j, const int i) {
+          // x2 direction
+          int fj = (j - cjs) * 2 + js;
+          const Real x2m = coarse_coords.x2v(j - 1);
+          const Real x2c = coarse_coords.x2v(j);
+          const Real x2p = coarse_coords.x2v(j + 1);
+          Real dx2m = x2c - x2m;
+          Real dx2p = x2p - x2c;
+          const Real fx2m = coords.x2v(fj);
+          const Real fx2p = coords.x2v(fj + 1);
+          Real dx2fm = x2c - fx2m;
+          Real dx2fp = fx2p - x2c;
+
+          // x1 direction
+          int fi = (i - cis) * 2 + is;
+          const Real x1m = coarse_coords.x1v(i - 1);
+          const Real x1c = coarse_coords.x1v(i);
+          const Real x1p = coarse_coords.x1v(i + 1);
+          Real dx1m = x1c - x1m;
+          Real dx1p = x1p - x1c;
+          const Real fx1m = coords.x1v(fi);
+          const Real fx1p = coords.x1v(fi + 1);
+          Real dx1fm = x1c - fx1m;
+          Real dx1fp = fx1p - x1c;
+
+          Real ccval = coarse(n, k, j, i);
+
+          // calculate 2D gradients using the minmod limiter
+          Real gx1m = (ccval - coarse(n, k, j, i - 1)) / dx1m;
+          Real gx1p = (coarse(n, k, j, i + 1) - ccval) / dx1p;
+          Real gx1c =
+              0.5 * (SIGN(gx1m) + SIGN(gx1p)) * std::min(std::abs(gx1m), std::abs(gx1p));
+          Real gx2m = (ccval - coarse(n, k, j - 1, i)) / dx2m;
+          Real gx2p = (coarse(n, k, j + 1, i) - ccval) / dx2p;
+          Real gx2c =
+              0.5 * (SIGN(gx2m) + SIGN(gx2p)) * std::min(std::abs(gx2m), std::abs(gx2p));
+
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          // interpolate onto the finer grid
+          fine(n, fk, fj, fi) = ccval - (gx1c * dx1fm + gx2c * dx2fm);
+          fine(n, fk, fj, fi + 1) = ccval + (gx1c * dx1fp - gx2c * dx2fm);
+          fine(n, fk, fj + 1, fi) = ccval - (gx1c * dx1fm - gx2c * dx2fp);
+          fine(n, fk, fj + 1, fi + 1) = ccval + (gx1c * dx1fp + gx2c * dx2fp);
+        });
+  } else { // 1D
+    int k = cks, fk = ks, j = cjs, fj = js;
+    pmb->par_for(
+        "ProlongateCellCenteredValues1d", sn, en, si, ei,
+        KOKKOS_LAMBDA(const int n, const int i) {
+          int fi = (i - cis) * 2 + is;
+          const Real x1m = coarse_coords.x1v(i - 1);
+          const Real x1c = coarse_coords.x1v(i);
+          const Real x1p = coarse_coords.x1v(i + 1);
+          Real dx1m = x1c - x1m;
+          Real dx1p = x1p - x1c;
+          const Real fx1m = coords.x1v(fi);
+          const Real fx1p = coords.x1v(fi + 1);
+          Real dx1fm = x1c - fx1m;
+          Real dx1fp = fx1p - x1c;
+
+          Real ccval = coarse(n, k, j, i);
+
+          // calculate 1D gradient using the min-mod limiter
+          Real gx1m = (ccval - coarse(n, k, j, i - 1)) / dx1m;
+          Real gx1p = (coarse(n, k, j, i + 1) - ccval) / dx1p;
+          Real gx1c =
+              0.5 * (SIGN(gx1m) + SIGN(gx1p)) * std::min(std::abs(gx1m), std::abs(gx1p));
+
+          // interpolate on to the finer grid
+          fine(n, fk, fj, fi) = ccval - gx1c * dx1fm;
+          fine(n, fk, fj, fi + 1) = ccval + gx1c * dx1fp;
+        });
+  }
+}
+
+// The fine cell centers are a quarter of a coarse cell away from the coarse cell center
+// and the slopes are differences of neighboring coarse cells, so the interpolation does
+// not need the coordinates at all.
+template <typename Coords, typename Coarse, typename Fine>
+void Prolongate(std::true_type, MeshBlock *pmb, const Coords &coords,
+                const Coords &coarse_coords, const Coarse &coarse, const Fine &fine,
+                int sn, int en, int si, int ei, int sj, int ej, int sk, int ek) {
+  const int cks = pmb->cks;
+  const int cjs = pmb->cjs;
+  const int cis = pmb->cis;
+  const int ks = pmb->ks;
+  const int js = pmb->js;
+  const int is = pmb->is;
+  if (pmb->block_size.nx3 > 1) {
+    pmb->par_for(
+        "ProlongateCellCenteredUniform3d", sn, en, sk, ek, sj, ej, si, ei,
+        KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          int fk = (k - cks) * 2 + ks;
+          int fj = (j - cjs) * 2 + js;
+          int fi = (i - cis) * 2 + is;
+          Real ccval = coarse(n, k, j, i);
+
+          // quarter of the limited differences using the minmod limiter
+          Real dm = ccval - coarse(n, k, j, i - 1);
+          Real dp = coarse(n, k, j, i + 1) - ccval;
+          Real d1 = 0.125 * (SIGN(dm) + SIGN(dp)) * std::min(std::abs(dm), std::abs(dp));
+          dm = ccval - coarse(n, k, j - 1, i);
+          dp = coarse(n, k, j + 1, i) - ccval;
+          Real d2 = 0.125 * (SIGN(dm) + SIGN(dp)) * std::min(std::abs(dm), std::abs(dp));
+          dm = ccval - coarse(n, k - 1, j, i);
+          dp = coarse(n, k + 1, j, i) - ccval;
+          Real d3 = 0.125 * (SIGN(dm) + SIGN(dp)) * std::min(std::abs(dm), std::abs(dp));
+
+          // KGF: add the off-centered quantities first to preserve FP symmetry
+          fine(n, fk, fj, fi) = ccval - (d1 + d2 + d3);
+          fine(n, fk, fj, fi + 1) = ccval + (d1 - d2 - d3);
+          fine(n, fk, fj + 1, fi) = ccval - (d1 - d2 + d3);
+          fine(n, fk, fj + 1, fi + 1) = ccval + (d1 + d2 - d3);
+          fine(n, fk + 1, fj, fi) = ccval - (d1 + d2 - d3);
+          fine(n, fk + 1, fj, fi + 1) = ccval + (d1 - d2 + d3);
+          fine(n, fk + 1, fj + 1, fi) = ccval - (d1 - d2 - d3);
+          fine(n, fk + 1, fj + 1, fi + 1) = ccval + (d1 + d2 + d3);
+        });
+  } else if (pmb->block_size.nx2 > 1) {
+    int k = cks, fk = ks;
+    pmb->par_for(
+        "ProlongateCellCenteredUniform2d", sn, en, sj, ej, si, ei,
+        KOKKOS_LAMBDA(const int n, const int j, const int i) {
+          int fj = (j - cjs) * 2 + js;
+          int fi = (i - cis) * 2 + is;
+          Real ccval = coarse(n, k, j, i);
+
+          Real dm = ccval - coarse(n, k, j, i - 1);
+          Real dp = coarse(n, k, j, i + 1) - ccval;
+          Real d1 = 0.125 * (SIGN(dm) + SIGN(dp)) * std::min(std::abs(dm), std::abs(dp));
+          dm = ccval - coarse(n, k, j - 1, i);
+          dp = coarse(n, k, j + 1, i) - ccval;
+          Real d2 = 0.125 * (SIGN(dm) + SIGN(dp)) * std::min(std::abs(dm), std::abs(dp));
+
+          fine(n, fk, fj, fi) = ccval - (d1 + d2);
+          fine(n, fk, fj, fi + 1) = ccval + (d1 - d2);
+          fine(n, fk, fj + 1, fi) = ccval - (d1 - d2);
+          fine(n, fk, fj + 1, fi + 1) = ccval + (d1 + d2);
+        });
+  } else { // 1D
+    int k = cks, fk = ks, j = cjs, fj = js;
+    pmb->par_for(
+        "ProlongateCellCenteredUniform1d", sn, en, si, ei,
+        KOKKOS_LAMBDA(const int n, const int i) {
+          int fi = (i - cis) * 2 + is;
+          Real ccval = coarse(n, k, j, i);
+
+          Real dm = ccval - coarse(n, k, j, i - 1);
+          Real dp = coarse(n, k, j, i + 1) - ccval;
+          Real d1 = 0.125 * (SIGN(dm) + SIGN(dp)) * std::min(std::abs(dm), std::abs(dp));
+
+          fine(n, fk, fj, fi) = ccval - d1;
+          fine(n, fk, fj, fi + 1) = ccval + d1;
+        });
+  }
+}
+
+} // namespace detail
+
+//----------------------------------------------------------------------------------------
+//! \fn void CellCenteredRefinement::Restrict(MeshBlock *pmb, const Coords &coords,
+//        const ParArrayND<Real> &fine, ParArrayND<Real> &coarse, int sn, int en,
+//        int csi, int cei, int csj, int cej, int csk, int cek)
+//  \brief restrict the cell centered values of pmb with the cell volumes of coords
+
+template <typename Coords>
+void Restrict(MeshBlock *pmb, const Coords &coords, const ParArrayND<Real> &fine,
+              ParArrayND<Real> &coarse, int sn, int en, int csi, int cei, int csj,
+              int cej, int csk, int cek) {
+  using constant_volume =
+      std::integral_constant<bool, CoordinateTraits<Coords>::constant_volume>;
+  detail::Restrict(constant_volume(), pmb, coords, fine.Get<4>(), coarse.Get<4>(), sn,
+                   en, csi, cei, csj, cej, csk, cek);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CellCenteredRefinement::Prolongate(MeshBlock *pmb, const Coords &coords,
+//        const Coords &coarse_coords, const ParArrayND<Real> &coarse,
+//        ParArrayND<Real> &fine, int sn, int en, int si, int ei, int sj, int ej, int sk,
+//        int ek)
+//  \brief prolongate the cell centered values of pmb from coarse_coords onto coords
+
+template <typename Coords>
+void Prolongate(MeshBlock *pmb, const Coords &coords, const Coords &coarse_coords,
+                const ParArrayND<Real> &coarse, ParArrayND<Real> &fine, int sn, int en,
+                int si, int ei, int sj, int ej, int sk, int ek) {
+  using uniform_spacing =
+      std::integral_constant<bool, CoordinateTraits<Coords>::uniform_spacing>;
+  detail::Prolongate(uniform_spacing(), pmb, coords, coarse_coords, coarse.Get<4>(),
+                     fine.Get<4>(), sn, en, si, ei, sj, ej, sk, ek);
+}
+
+} // namespace CellCenteredRefinement
+
+} // namespace parthenon
+
+#endif // MESH_MESH_REFINEMENT_CC_HPP_
@@ -42,13 +42,19 @@
 #include "parameter_input.hpp"
 #include "parthenon_arrays.hpp"
 #include "utils/buffer_utils.hpp"
+#include "utils/exec_space_pool.hpp"
 
 namespace parthenon {
 
 //----------------------------------------------------------------------------------------
 // MeshBlock constructor: constructs coordinate, boundary condition, field
 //                        and mesh refinement objects.
-MeshBlock::MeshBlock(const int n_side, const int ndim) {
+MeshBlock::MeshBlock(const int n_side, const int ndim)
+    : pmy_mesh(nullptr), gid(0), lid(0), prev(nullptr), next(nullptr) {
+  block_size.nx1 = n_side;
+  block_size.nx2 = (ndim >= 2 ? n_side : 1);
+  block_size.nx3 = (ndim >= 3 ? n_side : 1);
+
   // initialize grid indices
   is = NGHOST;
   ie = is + n_side - 1;
@@ -76,16 +82,25 @@ MeshBlock::MeshBlock(const int n_side, const int ndim) {
     ncells3 = 1;
     ncc3 = 1;
   }
+
+  // indices of the coarse buffers, as with mesh refinement
+  cnghost = (NGHOST + 1) / 2 + 1;
+  cis = NGHOST;
+  cie = cis + n_side / 2 - 1;
+  cjs = cje = cks = cke = 0;
+  if (ndim >= 2) cjs = NGHOST, cje = cjs + n_side / 2 - 1;
+  if (ndim >= 3) cks = NGHOST, cke = cks + n_side / 2 - 1;
 }
 
 MeshBlock::MeshBlock(int igid, int ilid, LogicalLocation iloc, RegionSize input_block,
                      BoundaryFlag *input_bcs, Mesh *pm, ParameterInput *pin,
                      Properties_t &properties, Packages_t &packages, int igflag,
                      bool ref_flag)
-    : exec_space(DevExecSpace()), pmy_mesh(pm), loc(iloc), block_size(input_block),
-      gid(igid), lid(ilid), gflag(igflag), properties(properties), packages(packages),
-      prev(nullptr), next(nullptr), new_block_dt_{}, new_block_dt_hyperbolic_{},
-      new_block_dt_parabolic_{}, new_block_dt_user_{}, cost_(1.0) {
+    : exec_space(ExecSpacePool::Get(igid)), pmy_mesh(pm), loc(iloc),
+      block_size(input_block), gid(igid), lid(ilid), gflag(igflag),
+      properties(properties), packages(packages), prev(nullptr), next(nullptr),
+      new_block_dt_{}, new_block_dt_hyperbolic_{}, new_block_dt_parabolic_{},
+      new_block_dt_user_{}, cost_(1.0) {
   // initialize grid indices
   is = NGHOST;
   ie = is + block_size.nx1 - 1;
@@ -166,6 +181,9 @@ MeshBlock::MeshBlock(int igid, int ilid, LogicalLocation iloc, RegionSize input_
     }
   }
 
+  // the cell variables share one allocation if requested
+  real_container.AllocateContiguous();
+
   // TODO(jdolence): Should these loops be moved to Variable creation
   ContainerIterator<Real> ci(real_container, {Metadata::Independent});
   int nindependent = ci.vars.size();
@@ -179,6 +197,10 @@ MeshBlock::MeshBlock(int igid, int ilid, LogicalLocation iloc, RegionSize input_
     for (int n = 0; n < nindependent; n++) {
       pmr->AddToRefinement(ci.vars[n]->data, ci.vars[n]->coarse_s);
     }
+    for (auto &pfv : real_container.GetFaceVector()) {
+      if (pfv->IsSet(Metadata::FillGhost))
+        pmr->AddToRefinement(&pfv->data, &pfv->coarse_s);
+    }
   }
 
   // Create user mesh data
@@ -289,7 +311,11 @@ MeshBlock::~MeshBlock() {
 //  \brief Calculate the block data size required for restart.
 
 std::size_t MeshBlock::GetBlockSizeInBytes() {
-  throw std::runtime_error("MeshBlock::GetBlockSizeInBytes not yet implemented.");
+  // every registered cell centered variable is dumped including its ghost zones
+  std::size_t size = 0;
+  for (auto &pvar : vars_cc_)
+    size += pvar->data.GetSize() * sizeof(Real);
+  return size;
 }
 
 //----------------------------------------------------------------------------------------
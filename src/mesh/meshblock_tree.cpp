@@ -38,18 +38,21 @@ namespace parthenon {
 Mesh *pmesh_;
 MeshBlockTree *MeshBlockTree::proot_;
 int MeshBlockTree::nleaf_;
+RootGridInfo MeshBlockTree::grid_;
 
 //----------------------------------------------------------------------------------------
 //! \fn MeshBlockTree::MeshBlockTree()
 //  \brief constructor for the logical root
 
-MeshBlockTree::MeshBlockTree(Mesh *pmesh) : pleaf_(nullptr), gid_(-1) {
+MeshBlockTree::MeshBlockTree(Mesh *pmesh)
+    : pleaf_(nullptr), gid_(-1), pindex_(new NodeIndex) {
   pmesh_ = pmesh;
   proot_ = this;
   loc_.lx1 = 0;
   loc_.lx2 = 0;
   loc_.lx3 = 0;
   loc_.level = 0;
+  (*pindex_)[loc_] = this;
 }
 
 //----------------------------------------------------------------------------------------
@@ -57,11 +60,12 @@ MeshBlockTree::MeshBlockTree(Mesh *pmesh) : pleaf_(nullptr), gid_(-1) {
 //  \brief constructor for a leaf
 
 MeshBlockTree::MeshBlockTree(MeshBlockTree *parent, int ox1, int ox2, int ox3)
-    : pleaf_(nullptr), gid_(parent->gid_) {
+    : pleaf_(nullptr), gid_(parent->gid_), pindex_(parent->pindex_) {
   loc_.lx1 = (parent->loc_.lx1 << 1) + ox1;
   loc_.lx2 = (parent->loc_.lx2 << 1) + ox2;
   loc_.lx3 = (parent->loc_.lx3 << 1) + ox3;
   loc_.level = parent->loc_.level + 1;
+  (*pindex_)[loc_] = this;
 }
 
 //----------------------------------------------------------------------------------------
@@ -74,32 +78,56 @@ MeshBlockTree::~MeshBlockTree() {
       delete pleaf_[i];
     delete[] pleaf_;
   }
+  // the whole tree goes away with the root, otherwise only this node
+  if (loc_.level == 0)
+    delete pindex_;
+  else
+    pindex_->erase(loc_);
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlockTree::CreateRootGrid()
-//  \brief create the root grid; the root grid can be incomplete (less than 8 leaves)
+//  \brief create the root grid of the Mesh the tree was constructed with
 
 void MeshBlockTree::CreateRootGrid() {
-  if (loc_.level == 0) {
-    nleaf_ = 2;
-    if (pmesh_->ndim >= 2) nleaf_ = 4;
-    if (pmesh_->ndim >= 3) nleaf_ = 8;
-  }
-  if (loc_.level == pmesh_->root_level) return;
+  RootGridInfo grid;
+  grid.ndim = pmesh_->ndim;
+  grid.root_level = pmesh_->root_level;
+  grid.nrbx1 = pmesh_->nrbx1;
+  grid.nrbx2 = pmesh_->nrbx2;
+  grid.nrbx3 = pmesh_->nrbx3;
+  for (int f = 0; f < 6; f++)
+    grid.periodic[f] = (pmesh_->mesh_bcs[f] == BoundaryFlag::periodic);
+  CreateRootGrid(grid);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::CreateRootGrid(const RootGridInfo &grid)
+//  \brief create the root grid; the root grid can be incomplete (less than 8 leaves)
+
+void MeshBlockTree::CreateRootGrid(const RootGridInfo &grid) {
+  grid_ = grid;
+  nleaf_ = 2;
+  if (grid_.ndim >= 2) nleaf_ = 4;
+  if (grid_.ndim >= 3) nleaf_ = 8;
+  BuildRootGrid();
+}
+
+void MeshBlockTree::BuildRootGrid() {
+  if (loc_.level == grid_.root_level) return;
 
   pleaf_ = new MeshBlockTree *[nleaf_];
   for (int n = 0; n < nleaf_; n++)
     pleaf_[n] = nullptr;
 
-  std::int64_t levfac = 1LL << (pmesh_->root_level - loc_.level - 1);
+  std::int64_t levfac = 1LL << (grid_.root_level - loc_.level - 1);
   for (int n = 0; n < nleaf_; n++) {
     int i = n & 1, j = (n >> 1) & 1, k = (n >> 2) & 1;
-    if ((loc_.lx3 * 2 + k) * levfac < pmesh_->nrbx3 &&
-        (loc_.lx2 * 2 + j) * levfac < pmesh_->nrbx2 &&
-        (loc_.lx1 * 2 + i) * levfac < pmesh_->nrbx1) {
+    if ((loc_.lx3 * 2 + k) * levfac < grid_.nrbx3 &&
+        (loc_.lx2 * 2 + j) * levfac < grid_.nrbx2 &&
+        (loc_.lx1 * 2 + i) * levfac < grid_.nrbx1) {
       pleaf_[n] = new MeshBlockTree(this, i, j, k);
-      pleaf_[n]->CreateRootGrid();
+      pleaf_[n]->BuildRootGrid();
     }
   }
   return;
@@ -111,6 +139,8 @@ void MeshBlockTree::CreateRootGrid() {
 
 void MeshBlockTree::AddMeshBlock(LogicalLocation rloc, int &nnew) {
   if (loc_.level == rloc.level) return; // done
+  // the block already exists, so does the path leading to it
+  if (loc_.level == 0 && pindex_->count(rloc) > 0) return;
 
   if (pleaf_ == nullptr) // leaf -> create the finer level
     Refine(nnew);
@@ -175,26 +205,26 @@ void MeshBlockTree::Refine(int &nnew) {
   LogicalLocation nloc;
   nloc.level = loc_.level;
 
-  oxmin = -1, oxmax = 1, nxmax = (pmesh_->nrbx1 << (loc_.level - pmesh_->root_level));
-  if (pmesh_->ndim >= 2)
-    oymin = -1, oymax = 1, nymax = (pmesh_->nrbx2 << (loc_.level - pmesh_->root_level));
+  oxmin = -1, oxmax = 1, nxmax = (grid_.nrbx1 << (loc_.level - grid_.root_level));
+  if (grid_.ndim >= 2)
+    oymin = -1, oymax = 1, nymax = (grid_.nrbx2 << (loc_.level - grid_.root_level));
   else
     oymin = 0, oymax = 0, nymax = 1;
-  if (pmesh_->ndim >= 3) // 3D
-    ozmin = -1, ozmax = 1, nzmax = (pmesh_->nrbx3 << (loc_.level - pmesh_->root_level));
+  if (grid_.ndim >= 3) // 3D
+    ozmin = -1, ozmax = 1, nzmax = (grid_.nrbx3 << (loc_.level - grid_.root_level));
   else
     ozmin = 0, ozmax = 0, nzmax = 1;
 
   for (oz = ozmin; oz <= ozmax; oz++) {
     nloc.lx3 = loc_.lx3 + oz;
     if (nloc.lx3 < 0) {
-      if (pmesh_->mesh_bcs[BoundaryFace::inner_x3] != BoundaryFlag::periodic)
+      if (!grid_.periodic[BoundaryFace::inner_x3])
         continue;
       else
         nloc.lx3 = nzmax - 1;
     }
     if (nloc.lx3 >= nzmax) {
-      if (pmesh_->mesh_bcs[BoundaryFace::outer_x3] != BoundaryFlag::periodic)
+      if (!grid_.periodic[BoundaryFace::outer_x3])
         continue;
       else
         nloc.lx3 = 0;
@@ -202,14 +232,14 @@ void MeshBlockTree::Refine(int &nnew) {
     for (oy = oymin; oy <= oymax; oy++) {
       nloc.lx2 = loc_.lx2 + oy;
       if (nloc.lx2 < 0) {
-        if (pmesh_->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic) {
+        if (grid_.periodic[BoundaryFace::inner_x2]) {
           nloc.lx2 = nymax - 1;
         } else {
           continue;
         }
       }
       if (nloc.lx2 >= nymax) {
-        if (pmesh_->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::periodic) {
+        if (grid_.periodic[BoundaryFace::outer_x2]) {
           nloc.lx2 = 0;
         } else {
           continue;
@@ -219,13 +249,13 @@ void MeshBlockTree::Refine(int &nnew) {
         if (ox == 0 && oy == 0 && oz == 0) continue;
         nloc.lx1 = loc_.lx1 + ox;
         if (nloc.lx1 < 0) {
-          if (pmesh_->mesh_bcs[BoundaryFace::inner_x1] != BoundaryFlag::periodic)
+          if (!grid_.periodic[BoundaryFace::inner_x1])
             continue;
           else
             nloc.lx1 = nxmax - 1;
         }
         if (nloc.lx1 >= nxmax) {
-          if (pmesh_->mesh_bcs[BoundaryFace::outer_x1] != BoundaryFlag::periodic)
+          if (!grid_.periodic[BoundaryFace::outer_x1])
             continue;
           else
             nloc.lx1 = 0;
@@ -247,8 +277,8 @@ void MeshBlockTree::Refine(int &nnew) {
 
 void MeshBlockTree::Derefine(int &ndel) {
   int s2 = 0, e2 = 0, s3 = 0, e3 = 0;
-  if (pmesh_->ndim >= 2) s2 = -1, e2 = 1;
-  if (pmesh_->ndim >= 3) s3 = -1, e3 = 1;
+  if (grid_.ndim >= 2) s2 = -1, e2 = 1;
+  if (grid_.ndim >= 3) s3 = -1, e3 = 1;
   for (int ox3 = s3; ox3 <= e3; ox3++) {
     for (int ox2 = s2; ox2 <= e2; ox2++) {
       for (int ox1 = -1; ox1 <= 1; ox1++) {
@@ -262,7 +292,7 @@ void MeshBlockTree::Derefine(int &ndel) {
               lis = lie = 0;
             else
               lis = 0, lie = 1;
-            if (pmesh_->ndim >= 2) {
+            if (grid_.ndim >= 2) {
               if (ox2 == -1)
                 ljs = lje = 1;
               else if (ox2 == 1)
@@ -272,7 +302,7 @@ void MeshBlockTree::Derefine(int &ndel) {
             } else {
               ljs = lje = 0;
             }
-            if (pmesh_->ndim >= 3) {
+            if (grid_.ndim >= 3) {
               if (ox3 == -1)
                 lks = lke = 1;
               else if (ox3 == 1)
@@ -353,11 +383,10 @@ void MeshBlockTree::GetMeshBlockList(LogicalLocation *list, int *pglist, int &co
 
 MeshBlockTree *MeshBlockTree::FindNeighbor(LogicalLocation myloc, int ox1, int ox2,
                                            int ox3, bool amrflag) {
-  std::stringstream msg;
   std::int64_t lx, ly, lz;
   int ll;
   int ox, oy, oz;
-  MeshBlockTree *bt = proot_;
+  MeshBlockTree *bt;
   lx = myloc.lx1, ly = myloc.lx2, lz = myloc.lx3, ll = myloc.level;
 
   lx += ox1;
@@ -365,70 +394,63 @@ MeshBlockTree *MeshBlockTree::FindNeighbor(LogicalLocation myloc, int ox1, int o
   lz += ox3;
   // periodic and polar boundaries
   if (lx < 0) {
-    if (pmesh_->mesh_bcs[BoundaryFace::inner_x1] == BoundaryFlag::periodic)
-      lx = (pmesh_->nrbx1 << (ll - pmesh_->root_level)) - 1;
+    if (grid_.periodic[BoundaryFace::inner_x1])
+      lx = (grid_.nrbx1 << (ll - grid_.root_level)) - 1;
     else
       return nullptr;
   }
-  if (lx >= pmesh_->nrbx1 << (ll - pmesh_->root_level)) {
-    if (pmesh_->mesh_bcs[BoundaryFace::outer_x1] == BoundaryFlag::periodic)
+  if (lx >= grid_.nrbx1 << (ll - grid_.root_level)) {
+    if (grid_.periodic[BoundaryFace::outer_x1])
       lx = 0;
     else
       return nullptr;
   }
   if (ly < 0) {
-    if (pmesh_->mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::periodic) {
-      ly = (pmesh_->nrbx2 << (ll - pmesh_->root_level)) - 1;
+    if (grid_.periodic[BoundaryFace::inner_x2]) {
+      ly = (grid_.nrbx2 << (ll - grid_.root_level)) - 1;
     } else {
       return nullptr;
     }
   }
-  if (ly >= pmesh_->nrbx2 << (ll - pmesh_->root_level)) {
-    if (pmesh_->mesh_bcs[BoundaryFace::outer_x2] == BoundaryFlag::periodic) {
+  if (ly >= grid_.nrbx2 << (ll - grid_.root_level)) {
+    if (grid_.periodic[BoundaryFace::outer_x2]) {
       ly = 0;
     } else {
       return nullptr;
     }
   }
-  std::int64_t num_x3 = pmesh_->nrbx3 << (ll - pmesh_->root_level);
+  std::int64_t num_x3 = grid_.nrbx3 << (ll - grid_.root_level);
   if (lz < 0) {
-    if (pmesh_->mesh_bcs[BoundaryFace::inner_x3] == BoundaryFlag::periodic)
+    if (grid_.periodic[BoundaryFace::inner_x3])
       lz = num_x3 - 1;
     else
       return nullptr;
   }
   if (lz >= num_x3) {
-    if (pmesh_->mesh_bcs[BoundaryFace::outer_x3] == BoundaryFlag::periodic)
+    if (grid_.periodic[BoundaryFace::outer_x3])
       lz = 0;
     else
       return nullptr;
   }
   if (ll < 1) return proot_; // single grid; return root
 
-  for (int level = 0; level < ll; level++) {
-    if (bt->pleaf_ == nullptr) { // leaf
-      if (level == ll - 1) {
-        return bt;
-      } else {
-        msg << "### FATAL ERROR in FindNeighbor" << std::endl
-            << "Neighbor search failed. The Block Tree is broken." << std::endl;
-        ATHENA_ERROR(msg);
-        return nullptr;
-      }
-    }
-    // find a leaf in the next level
-    int sh = ll - level - 1;
-    ox = ((lx >> sh) & 1LL) == 1LL;
-    oy = ((ly >> sh) & 1LL) == 1LL;
-    oz = ((lz >> sh) & 1LL) == 1LL;
-    bt = bt->GetLeaf(ox, oy, oz);
-    if (bt == nullptr) {
+  // the neighbor is either a node on the same level or a coarser leaf one level up
+  LogicalLocation nloc;
+  nloc.lx1 = lx, nloc.lx2 = ly, nloc.lx3 = lz, nloc.level = ll;
+  auto it = pindex_->find(nloc);
+  if (it == pindex_->end()) {
+    nloc.lx1 = lx >> 1, nloc.lx2 = ly >> 1, nloc.lx3 = lz >> 1, nloc.level = ll - 1;
+    it = pindex_->find(nloc);
+    if (it == pindex_->end() || it->second->pleaf_ != nullptr) {
+      std::stringstream msg;
       msg << "### FATAL ERROR in FindNeighbor" << std::endl
           << "Neighbor search failed. The Block Tree is broken." << std::endl;
       ATHENA_ERROR(msg);
       return nullptr;
     }
+    return it->second;
   }
+  bt = it->second;
   if (bt->pleaf_ == nullptr) // leaf on the same level
     return bt;
   // one level finer: check if it is a leaf
@@ -439,6 +461,7 @@ MeshBlockTree *MeshBlockTree::FindNeighbor(LogicalLocation myloc, int ox1, int o
   MeshBlockTree *btleaf = bt->GetLeaf(ox, oy, oz);
   if (btleaf->pleaf_ == nullptr) return bt; // return this block
   if (!amrflag) {
+    std::stringstream msg;
     msg << "### FATAL ERROR in FindNeighbor" << std::endl
         << "Neighbor search failed. The Block Tree is broken." << std::endl;
     ATHENA_ERROR(msg);
@@ -451,15 +474,9 @@ MeshBlockTree *MeshBlockTree::FindNeighbor(LogicalLocation myloc, int ox1, int o
 //  \brief find MeshBlock with LogicalLocation tloc and return a pointer
 
 MeshBlockTree *MeshBlockTree::FindMeshBlock(LogicalLocation tloc) {
-  if (tloc.level == loc_.level) return this;
-  // get leaf indexes
-  int sh = tloc.level - loc_.level - 1;
-  int mx = (((tloc.lx1 >> sh) & 1LL) == 1LL);
-  int my = (((tloc.lx2 >> sh) & 1LL) == 1LL);
-  int mz = (((tloc.lx3 >> sh) & 1LL) == 1LL);
-  int n = mx + (my << 1) + (mz << 2);
-  if (pleaf_[n] == nullptr) return nullptr;
-  return pleaf_[n]->FindMeshBlock(tloc);
+  auto it = pindex_->find(tloc);
+  if (it == pindex_->end()) return nullptr;
+  return it->second;
 }
 
 } // namespace parthenon
@@ -20,16 +20,73 @@
 //  \brief defines the LogicalLocation structure and MeshBlockTree class
 //======================================================================================
 
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
 #include "athena.hpp"
 #include "bvals/bvals.hpp"
 
 namespace parthenon {
 
 class Mesh;
+class MeshBlockTree;
+
+//--------------------------------------------------------------------------------------
+//! \fn std::uint64_t MortonCode(const LogicalLocation &loc)
+//  \brief interleaves the lowest 21 bits of lx1, lx2 and lx3 into a Z-order index
+
+inline std::uint64_t MortonCode(const LogicalLocation &loc) {
+  auto spread = [](std::int64_t v) {
+    std::uint64_t x = static_cast<std::uint64_t>(v) & 0x1fffffULL;
+    x = (x | (x << 32)) & 0x001f00000000ffffULL;
+    x = (x | (x << 16)) & 0x001f0000ff0000ffULL;
+    x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x << 2)) & 0x1249249249249249ULL;
+    return x;
+  };
+  return spread(loc.lx1) | (spread(loc.lx2) << 1) | (spread(loc.lx3) << 2);
+}
+
+// Hashes a LogicalLocation by its Morton code, so that blocks close in space also end up
+// close in the hash table.  Bits beyond the Morton code (more than 21 levels below a
+// single root block) and the level are mixed in, equality still compares all fields.
+struct LogicalLocationHash {
+  std::size_t operator()(const LogicalLocation &loc) const {
+    std::uint64_t h = MortonCode(loc);
+    h ^= static_cast<std::uint64_t>((loc.lx1 >> 21) ^ (loc.lx2 >> 21) * 3 ^
+                                    (loc.lx3 >> 21) * 5) *
+         0xff51afd7ed558ccdULL;
+    h ^= static_cast<std::uint64_t>(loc.level) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<std::size_t>(h);
+  }
+};
+
+struct LogicalLocationEqual {
+  bool operator()(const LogicalLocation &a, const LogicalLocation &b) const {
+    return a.level == b.level && a.lx1 == b.lx1 && a.lx2 == b.lx2 && a.lx3 == b.lx3;
+  }
+};
+
+//--------------------------------------------------------------------------------------
+//! \struct RootGridInfo
+//  \brief the properties of the root grid the tree needs, taken from the Mesh
+
+struct RootGridInfo {
+  int ndim, root_level;
+  std::int64_t nrbx1, nrbx2, nrbx3;
+  bool periodic[6]; // indexed by BoundaryFace
+};
 
 //--------------------------------------------------------------------------------------
 //! \class MeshBlockTree
 //  \brief Objects are nodes in an AMR MeshBlock tree structure
+//
+// Besides the pointer tree, which provides the Z-ordered traversal used to assign gids,
+// all nodes are indexed in a hash table keyed by their LogicalLocation (a linear
+// octree), so that locating a node or a neighbor takes constant expected time instead
+// of a descent from the root.
 
 class MeshBlockTree {
   friend class Mesh;
@@ -45,9 +102,13 @@ class MeshBlockTree {
   MeshBlockTree *GetLeaf(int ox1, int ox2, int ox3) {
     return pleaf_[(ox1 + (ox2 << 1) + (ox3 << 2))];
   }
+  bool IsLeaf() const { return pleaf_ == nullptr; }
+  int GetGid() const { return gid_; }
+  const LogicalLocation &GetLocation() const { return loc_; }
 
   // functions
   void CreateRootGrid();
+  void CreateRootGrid(const RootGridInfo &grid);
   void AddMeshBlock(LogicalLocation rloc, int &nnew);
   void AddMeshBlockWithoutRefine(LogicalLocation rloc);
   void Refine(int &nnew);
@@ -59,13 +120,20 @@ class MeshBlockTree {
                               bool amrflag = false);
 
  private:
+  using NodeIndex = std::unordered_map<LogicalLocation, MeshBlockTree *,
+                                       LogicalLocationHash, LogicalLocationEqual>;
+  void BuildRootGrid();
+
   // data
   MeshBlockTree **pleaf_;
   int gid_;
   LogicalLocation loc_;
+  // all nodes of the tree, owned by the root
+  NodeIndex *pindex_;
 
   static MeshBlockTree *proot_;
   static int nleaf_;
+  static RootGridInfo grid_;
 };
 
 } // namespace parthenon
@@ -38,6 +38,7 @@ namespace parthenon {
 
 int IOWrapper::Open(const char *fname, FileMode rw) {
   std::stringstream msg;
+  fname_ = fname;
 
   if (rw == FileMode::read) {
 #ifdef MPI_PARALLEL
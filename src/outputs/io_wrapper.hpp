@@ -20,6 +20,7 @@
 //  \brief defines a set of small wrapper functions for MPI versus Serial Output.
 
 #include <cstdio>
+#include <string>
 
 #include "parthenon_mpi.hpp"
 
@@ -59,9 +60,12 @@ class IOWrapper {
   int Close();
   int Seek(IOWrapperSizeT offset);
   IOWrapperSizeT GetPosition();
+  // name of the file passed to the last call of Open()
+  const std::string &GetFileName() const { return fname_; }
 
  private:
   IOWrapperFile fh_;
+  std::string fname_;
 #ifdef MPI_PARALLEL
   MPI_Comm comm_;
 #endif
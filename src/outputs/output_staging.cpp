@@ -0,0 +1,100 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file output_staging.cpp
+//  \brief stages the variables written by all outputs of a cycle in host memory
+
+#include <string>
+#include <type_traits>
+
+#include "globals.hpp"
+#include "interface/variable.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "parthenon_arrays.hpp"
+
+namespace parthenon {
+
+namespace {
+// whether the host mirror of a variable is the variable itself, e.g. on CPUs, so that
+// staging it does not need a copy
+constexpr bool kAliasHost =
+    std::is_same<typename host_view_t<Real>::memory_space,
+                 typename device_view_t<Real>::memory_space>::value;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void OutputStaging::BeginOutputs(Mesh *pm)
+//  \brief invalidates all staged copies and drops buffers of MeshBlocks that have left
+
+void OutputStaging::BeginOutputs(Mesh *pm) {
+  auto nblist = pm->GetNbList();
+  int nbs = 0;
+  for (int i = 0; i < Globals::my_rank; i++)
+    nbs += nblist[i];
+  BeginOutputs(nbs, nbs + nblist[Globals::my_rank] - 1);
+}
+
+void OutputStaging::BeginOutputs(int gids, int gide) {
+  round_++;
+  // aliases keep no buffers worth reusing, and must not hold on to the arrays of
+  // MeshBlocks that have been destroyed since
+  if (kAliasHost) {
+    staged_.clear();
+    return;
+  }
+  // after refinement or load balancing the gids owned by this rank may differ; buffers
+  // of gids still owned are kept since their shapes rarely change
+  for (auto it = staged_.begin(); it != staged_.end();) {
+    if (it->first.first < gids || it->first.first > gide) {
+      it = staged_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn const ParArrayHost<Real> &OutputStaging::Get(MeshBlock *pmb,
+//                                                   const CellVariable<Real> &var)
+//  \brief returns the host copy of a variable, copying it only on first use this round.
+//  If the variable is in host memory, it is returned itself instead of a copy.
+
+const ParArrayHost<Real> &OutputStaging::Get(MeshBlock *pmb,
+                                             const CellVariable<Real> &var) {
+  auto &staged = staged_[std::make_pair(pmb->gid, var.label())];
+  if (staged.round == round_) return staged.data;
+
+  if (kAliasHost) {
+    // the kernels of the block may still be writing the variable
+    pmb->exec_space.fence();
+    staged.data = ParArrayHost<Real>(Kokkos::create_mirror_view(var.data.Get()));
+    staged.round = round_;
+    return staged.data;
+  }
+
+  // reuse the buffer unless the shape of the variable changed
+  bool same_shape = true;
+  for (int d = 1; d <= 6 && same_shape; d++)
+    same_shape = (staged.data.GetDim(d) == var.GetDim(d));
+  if (!same_shape) {
+    staged.data = ParArrayHost<Real>(var.label(), var.GetDim(6), var.GetDim(5),
+                                     var.GetDim(4), var.GetDim(3), var.GetDim(2),
+                                     var.GetDim(1));
+  }
+  staged.data.DeepCopy(var.data);
+  staged.round = round_;
+  ncopies_++;
+  return staged.data;
+}
+
+} // namespace parthenon
@@ -30,7 +30,7 @@
 // Required parameters that must be specified in an <output[n]> block are:
 //   - variable     = cons,prim,D,d,E,e,m,m1,m2,m3,v,v1=vx,v2=vy,v3=vz,p,
 //                    bcc,bcc1,bcc2,bcc3,b,b1,b2,b3,phi,uov
-//   - file_type    = rst,tab,vtk,hst,hdf5
+//   - file_type    = rst,tab,vtk,vtu,hst,hdf5
 //   - dt           = problem time between outputs
 //
 // EXAMPLE of an <output[n]> block for a VTK dump:
@@ -93,6 +93,7 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -111,7 +112,7 @@ namespace parthenon {
 OutputType::OutputType(OutputParameters oparams)
     : output_params(oparams),
       pnext_type(), // Terminate this node in singly linked list with nullptr
-      num_vars_(),
+      pstaging_(std::make_shared<OutputStaging>()), num_vars_(),
       // nested doubly linked list of OutputData:
       pfirst_data_(), // Initialize head node to nullptr
       plast_data_() { // Initialize tail node to nullptr
@@ -120,7 +121,8 @@ OutputType::OutputType(OutputParameters oparams)
 //----------------------------------------------------------------------------------------
 // Outputs constructor
 
-Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
+Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm)
+    : pstaging_(std::make_shared<OutputStaging>()) {
   pfirst_type_ = nullptr;
   std::stringstream msg;
   InputBlock *pib = pin->pfirst_block;
@@ -240,6 +242,10 @@ Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
         pnew_type = new FormattedTableOutput(op);
       } else if (op.file_type.compare("vtk") == 0) {
         pnew_type = new VTKOutput(op);
+      } else if (op.file_type.compare("vtu") == 0) {
+        op.single_precision_output =
+            pin->GetOrAddBoolean(op.block_name, "single_precision_output", true);
+        pnew_type = new VTKXMLOutput(op);
       } else if (op.file_type.compare("rst") == 0) {
         pnew_type = new RestartOutput(op);
         num_rst_outputs++;
@@ -259,6 +265,8 @@ Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
         ATHENA_ERROR(msg);
       }
 
+      pnew_type->SetStaging(pstaging_);
+
       // Append type as tail node in singly linked list
       if (pfirst_type_ == nullptr) {
         pfirst_type_ = pnew_type;
@@ -415,6 +423,8 @@ void OutputType::ClearOutputData() {
 
 void Outputs::MakeOutputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
   bool first = true;
+  // variables are copied to the host once and shared by all outputs due now
+  pstaging_->BeginOutputs(pm);
   OutputType *ptype = pfirst_type_;
   while (ptype != nullptr) {
     if ((tm == nullptr) ||
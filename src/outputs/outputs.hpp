@@ -19,7 +19,10 @@
 //! \file outputs.hpp
 //  \brief provides classes to handle ALL types of data output
 
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "basic_types.hpp"
@@ -29,10 +32,16 @@
 namespace parthenon {
 
 // forward declarations
+template <typename T>
+class CellVariable;
 class Mesh;
+class MeshBlock;
 class ParameterInput;
 class Coordinates;
 
+// returns 1 on a big endian machine, defined in vtk.cpp
+int IsBigEndian();
+
 //----------------------------------------------------------------------------------------
 //! \struct OutputParameters
 //  \brief  container for parameters read from <output> block in the input file
@@ -51,6 +60,7 @@ struct OutputParameters {
   bool output_slicex1, output_slicex2, output_slicex3;
   bool output_sumx1, output_sumx2, output_sumx3;
   bool include_ghost_zones, cartesian_vector;
+  bool single_precision_output; // convert Real to float in VTK XML outputs
   int islice, jslice, kslice;
   Real x1_slice, x2_slice, x3_slice;
   // TODO(felker): some of the parameters in this class are not initialized in constructor
@@ -58,7 +68,8 @@ struct OutputParameters {
       : block_number(0), next_time(0.0), dt(-1.0), file_number(0), output_slicex1(false),
         output_slicex2(false), output_slicex3(false), output_sumx1(false),
         output_sumx2(false), output_sumx3(false), include_ghost_zones(false),
-        cartesian_vector(false), islice(0), jslice(0), kslice(0) {}
+        cartesian_vector(false), single_precision_output(true), islice(0), jslice(0),
+        kslice(0) {}
 };
 
 //----------------------------------------------------------------------------------------
@@ -75,6 +86,36 @@ struct OutputData {
   OutputData() : pnext(nullptr), pprev(nullptr) {}
 };
 
+//----------------------------------------------------------------------------------------
+//! \class OutputStaging
+//  \brief host copies of the variables written by the outputs due in one call of
+//  Outputs::MakeOutputs().  A variable of a MeshBlock is copied to the host at most once
+//  per call, however many output types write it, and the host buffers are kept and
+//  reused in later calls.  Variables in host memory are not copied at all.
+
+class OutputStaging {
+ public:
+  // starts a new round of outputs; staged copies of earlier rounds become stale and
+  // buffers of MeshBlocks no longer on this rank are released
+  void BeginOutputs(Mesh *pm);
+  // the same for a rank that owns the MeshBlocks with gids gids to gide
+  void BeginOutputs(int gids, int gide);
+  // host copy of the current data of variable var of MeshBlock pmb
+  const ParArrayHost<Real> &Get(MeshBlock *pmb, const CellVariable<Real> &var);
+  // number of device to host copies made since construction, 0 if the variables are in
+  // host memory
+  std::size_t NumCopies() const { return ncopies_; }
+
+ private:
+  struct StagedVariable {
+    ParArrayHost<Real> data;
+    int round = -1; // round of outputs the data was copied in
+  };
+  std::map<std::pair<int, std::string>, StagedVariable> staged_; // keyed by (gid, label)
+  int round_ = 0;
+  std::size_t ncopies_ = 0;
+};
+
 //----------------------------------------------------------------------------------------
 //  \brief abstract base class for different output types (modes/formats). Each OutputType
 //  is designed to be a node in a singly linked list created & stored in the Outputs class
@@ -115,8 +156,11 @@ class OutputType {
   virtual void WriteContainer(SimTime &tm, Mesh *pm, ParameterInput *pin, bool flag) {
     return;
   }
+  // share the host copies of variables with the other output types
+  void SetStaging(std::shared_ptr<OutputStaging> pstaging) { pstaging_ = pstaging; }
 
  protected:
+  std::shared_ptr<OutputStaging> pstaging_; // host copies of the variables to write
   int num_vars_; // number of variables in output
   // nested doubly linked list of OutputData nodes (of the same OutputType):
   OutputData *pfirst_data_; // ptr to head OutputData node in doubly linked list
@@ -154,6 +198,24 @@ class VTKOutput : public OutputType {
   void WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm) override;
 };
 
+//----------------------------------------------------------------------------------------
+//! \class VTKXMLOutput
+//  \brief derived OutputType class for VTK XML dumps, one .vtu file per rank plus a
+//  .vtm index file
+
+class VTKXMLOutput : public OutputType {
+ public:
+  explicit VTKXMLOutput(OutputParameters oparams) : OutputType(oparams) {}
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm) override;
+
+ private:
+  template <typename T>
+  void WriteRankFile(Mesh *pm, SimTime *tm);
+  void WriteIndexFile(Mesh *pm);
+  std::string BaseFileName() const;
+  std::string RankFileName(const int rank) const;
+};
+
 //----------------------------------------------------------------------------------------
 //! \class RestartOutput
 //  \brief derived OutputType class for restart dumps
@@ -202,6 +264,7 @@ class Outputs {
  private:
   OutputType *pfirst_type_; // ptr to head OutputType node in singly linked list
   // (not storing a reference to the tail node)
+  std::shared_ptr<OutputStaging> pstaging_; // shared by all OutputTypes
   std::vector<std::string> SetOutputVariables(ParameterInput *pin,
                                               std::string block_name);
 };
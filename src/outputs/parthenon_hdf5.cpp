@@ -538,12 +538,14 @@ void PHDF5Output::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm) {
           // skip, not interested in this variable
           continue;
         }
+        // host copy shared with the other outputs written this cycle
+        auto &h = pstaging_->Get(pmb, *v);
         hsize_t index = pmb->lid * varSize * vlen;
         if (vlen == 1) {
           for (int k = out_ks; k <= out_ke; k++) {
             for (int j = out_js; j <= out_je; j++) {
               for (int i = out_is; i <= out_ie; i++, index++) {
-                tmpData[index] = (*v)(k, j, i);
+                tmpData[index] = h(k, j, i);
               }
             }
           }
@@ -552,7 +554,7 @@ void PHDF5Output::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm) {
             for (int j = out_js; j <= out_je; j++) {
               for (int i = out_is; i <= out_ie; i++) {
                 for (int l = 0; l < vlen; l++, index++) {
-                  tmpData[index] = (*v)(l, k, j, i);
+                  tmpData[index] = h(l, k, j, i);
                 }
               }
             }
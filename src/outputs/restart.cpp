@@ -15,8 +15,15 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 //! \file restart.cpp
-//  \brief writes restart files
+//  \brief writes restart files and reads the MeshBlock data back on restart
 
+#include "outputs/restart.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
@@ -25,6 +32,8 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -32,6 +41,7 @@
 #include "outputs/outputs.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_arrays.hpp"
+#include "parthenon_mpi.hpp"
 
 namespace parthenon {
 
@@ -40,7 +50,241 @@ namespace parthenon {
 //  \brief Cycles over all MeshBlocks and writes data to a single restart file.
 
 void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm) {
-  throw std::runtime_error(std::string(__func__) + " is not implemented");
+  // create single output filename: "file_basename"+"."+"file_id"+"."+XXXXX+".rst",
+  // where XXXXX = 5-digit file_number
+  std::string fname;
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", output_params.file_number);
+  fname.assign(output_params.file_basename);
+  fname.append(".");
+  fname.append(output_params.file_id);
+  fname.append(".");
+  fname.append(number);
+  fname.append(".rst");
+
+  // increment counters now so values for *next* dump are stored in restart file
+  output_params.file_number++;
+  output_params.next_time += output_params.dt;
+  pin->SetInteger(output_params.block_name, "file_number", output_params.file_number);
+  pin->SetReal(output_params.block_name, "next_time", output_params.next_time);
+  // the restarted run picks up the time and cycle from the parameter dump
+  if (tm != nullptr) {
+    pin->SetReal("parthenon/time", "start_time", tm->time);
+    pin->SetInteger("parthenon/time", "ncycle", tm->ncycle);
+  }
+
+  IOWrapper resfile;
+  resfile.Open(fname.c_str(), IOWrapper::FileMode::write);
+
+  // prepare the input parameters
+  std::stringstream ost;
+  pin->ParameterDump(ost);
+  std::string sbuf = ost.str();
+
+  // sizes of all MeshBlocks, which determine their offsets in the block index
+  int nbtotal = pm->nbtotal;
+  int mynb = pm->nblist[Globals::my_rank];
+  int mynbs = pm->nslist[Globals::my_rank];
+  std::vector<IOWrapperSizeT> blocksize(nbtotal);
+  for (MeshBlock *pmb = pm->pblock; pmb != nullptr; pmb = pmb->next)
+    blocksize[pmb->gid] = pmb->GetBlockSizeInBytes();
+#ifdef MPI_PARALLEL
+  MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, blocksize.data(), pm->nblist,
+                 pm->nslist, MPI_UINT64_T, MPI_COMM_WORLD);
+#endif
+  std::vector<IOWrapperSizeT> offset(nbtotal + 1, 0);
+  for (int i = 0; i < nbtotal; i++)
+    offset[i + 1] = offset[i] + blocksize[i];
+  IOWrapperSizeT datasize = offset[nbtotal];
+
+  IOWrapperSizeT listsize =
+      sizeof(LogicalLocation) + sizeof(double) + sizeof(IOWrapperSizeT);
+  IOWrapperSizeT headersize =
+      sizeof(int) * 2 + sizeof(RegionSize) + sizeof(IOWrapperSizeT);
+  IOWrapperSizeT headeroffset = sbuf.size() + headersize + listsize * nbtotal;
+
+  // output the input parameters, header and block index; the master process writes them
+  if (Globals::my_rank == 0) {
+    resfile.Write(sbuf.c_str(), sizeof(char), sbuf.size());
+
+    std::vector<char> headerdata(headersize);
+    IOWrapperSizeT hdos = 0;
+    std::memcpy(&(headerdata[hdos]), &nbtotal, sizeof(int));
+    hdos += sizeof(int);
+    std::memcpy(&(headerdata[hdos]), &(pm->root_level), sizeof(int));
+    hdos += sizeof(int);
+    std::memcpy(&(headerdata[hdos]), &(pm->mesh_size), sizeof(RegionSize));
+    hdos += sizeof(RegionSize);
+    std::memcpy(&(headerdata[hdos]), &datasize, sizeof(IOWrapperSizeT));
+    resfile.Write(headerdata.data(), 1, headersize);
+
+    std::vector<char> idlist(listsize * nbtotal);
+    IOWrapperSizeT os = 0;
+    for (int i = 0; i < nbtotal; i++) {
+      std::memcpy(&(idlist[os]), &(pm->loclist[i]), sizeof(LogicalLocation));
+      os += sizeof(LogicalLocation);
+      std::memcpy(&(idlist[os]), &(pm->costlist[i]), sizeof(double));
+      os += sizeof(double);
+      std::memcpy(&(idlist[os]), &(offset[i]), sizeof(IOWrapperSizeT));
+      os += sizeof(IOWrapperSizeT);
+    }
+    resfile.Write(idlist.data(), listsize, nbtotal);
+  }
+
+  // gather the registered variables of all MeshBlocks of this rank into one buffer
+  IOWrapperSizeT mysize = offset[mynbs + mynb] - offset[mynbs];
+  std::vector<char> data(mysize);
+  char *pdata = data.data();
+  for (MeshBlock *pmb = pm->pblock; pmb != nullptr; pmb = pmb->next) {
+    for (auto &pvar : pmb->vars_cc_) {
+      auto &h = pstaging_->Get(pmb, *pvar);
+      std::size_t nbytes = pvar->data.GetSize() * sizeof(Real);
+      std::memcpy(pdata, h.Get().data(), nbytes);
+      pdata += nbytes;
+    }
+  }
+
+  // now write restart data in parallel
+  resfile.Write_at_all(data.data(), 1, mysize, headeroffset + offset[mynbs]);
+  resfile.Close();
+}
+
+//----------------------------------------------------------------------------------------
+// RestartReader constructor
+
+RestartReader::RestartReader(IOWrapper &resfile, IOWrapperSizeT data_offset,
+                             std::vector<IOWrapperSizeT> block_offsets)
+    : resfile_(resfile), data_offset_(data_offset),
+      block_offsets_(std::move(block_offsets)), nbs_(0), nb_(0), map_(nullptr),
+      map_length_(0), map_shift_(0) {}
+
+RestartReader::~RestartReader() { Unmap(); }
+
+void RestartReader::Unmap() {
+  if (map_ != nullptr) munmap(map_, map_length_);
+  map_ = nullptr;
+  map_length_ = 0;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool RestartReader::CanMap()
+//  \brief true if all ranks live on a single node
+
+bool RestartReader::CanMap() {
+#ifdef MPI_PARALLEL
+  MPI_Comm shmcomm;
+  int nlocal;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shmcomm);
+  MPI_Comm_size(shmcomm, &nlocal);
+  MPI_Comm_free(&shmcomm);
+  return (nlocal == Globals::nranks);
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartReader::ReadBlocks(int nbs, int nb, bool use_mmap)
+//  \brief makes the data of MeshBlocks [nbs, nbs + nb) available to LoadBlock()
+
+void RestartReader::ReadBlocks(int nbs, int nb, bool use_mmap) {
+  std::stringstream msg;
+  Unmap();
+  buffer_.clear();
+  nbs_ = nbs;
+  nb_ = nb;
+
+  // blocks are stored in gid order, so the MeshBlocks of a rank form a single range
+  IOWrapperSizeT start = data_offset_ + block_offsets_[nbs];
+  std::size_t length = block_offsets_[nbs + nb] - block_offsets_[nbs];
+
+  if (use_mmap) {
+    // mmap offsets have to be page aligned, so map from the page holding the first byte
+    IOWrapperSizeT pagesize = sysconf(_SC_PAGESIZE);
+    IOWrapperSizeT aligned = (start / pagesize) * pagesize;
+    int fd = open(resfile_.GetFileName().c_str(), O_RDONLY);
+    if (fd >= 0 && length > 0) {
+      map_shift_ = start - aligned;
+      map_length_ = length + map_shift_;
+      map_ = mmap(nullptr, map_length_, PROT_READ, MAP_PRIVATE, fd, aligned);
+      if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        map_length_ = 0;
+      } else {
+        // pages are faulted in on first access; blocks are copied in order
+        madvise(map_, map_length_, MADV_SEQUENTIAL);
+      }
+    }
+    if (fd >= 0) close(fd); // the mapping stays valid after closing the descriptor
+    int mapped = (map_ != nullptr || length == 0);
+#ifdef MPI_PARALLEL
+    // the fallback below is a collective read, so all ranks have to take it if any does
+    MPI_Allreduce(MPI_IN_PLACE, &mapped, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+#endif
+    if (mapped) return;
+    // fall back to reading through the IOWrapper below
+    Unmap();
+  }
+
+  buffer_.resize(length);
+  if (resfile_.Read_at_all(buffer_.data(), 1, length, start) != length) {
+    msg << "### FATAL ERROR in function [RestartReader::ReadBlocks]" << std::endl
+        << "The restart file is broken or input parameters are inconsistent."
+        << std::endl;
+    ATHENA_ERROR(msg);
+  }
+}
+
+const char *RestartReader::BlockData(int gid) const {
+  std::size_t os = block_offsets_[gid] - block_offsets_[nbs_];
+  if (map_ != nullptr) return static_cast<const char *>(map_) + map_shift_ + os;
+  return buffer_.data() + os;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartReader::LoadBlock(int gid, const std::vector<...> &vars)
+//  \brief copies the restart data of MeshBlock gid straight into the variables
+
+void RestartReader::LoadBlock(
+    int gid, const std::vector<std::shared_ptr<CellVariable<Real>>> &vars) {
+  using host_data_t = Kokkos::View<Real ******, LayoutWrapper, Kokkos::HostSpace,
+                                   Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+  std::stringstream msg;
+  if (gid < nbs_ || gid >= nbs_ + nb_) {
+    msg << "### FATAL ERROR in function [RestartReader::LoadBlock]" << std::endl
+        << "MeshBlock " << gid << " was not read from the restart file." << std::endl;
+    ATHENA_ERROR(msg);
+  }
+
+  // wrap the mapped (or buffered) bytes in unmanaged views and deep copy them into the
+  // variables, so there is no intermediate copy on the host
+  char *pdata = const_cast<char *>(BlockData(gid));
+  std::size_t blocksize = BlockSize(gid);
+  std::size_t os = 0;
+  for (auto &pvar : vars) {
+    auto &d = pvar->data;
+    std::size_t nbytes = d.GetSize() * sizeof(Real);
+    if (os + nbytes > blocksize) {
+      msg << "### FATAL ERROR in function [RestartReader::LoadBlock]" << std::endl
+          << "Variable " << pvar->label() << " does not fit in the restart data."
+          << std::endl;
+      ATHENA_ERROR(msg);
+    }
+    host_data_t src(reinterpret_cast<Real *>(pdata + os), d.GetDim(6), d.GetDim(5),
+                    d.GetDim(4), d.GetDim(3), d.GetDim(2), d.GetDim(1));
+    if (!pvar->IsAllocated()) {
+      // a sparse id that was zero on the block when it was written stays unallocated
+      const Real *first = src.data();
+      if (std::all_of(first, first + d.GetSize(),
+                      [](const Real x) { return x == 0.0; })) {
+        os += nbytes;
+        continue;
+      }
+      pvar->Allocate();
+    }
+    Kokkos::deep_copy(d.Get(), src);
+    os += nbytes;
+  }
 }
 
 } // namespace parthenon
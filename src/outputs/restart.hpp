@@ -0,0 +1,76 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef OUTPUTS_RESTART_HPP_
+#define OUTPUTS_RESTART_HPP_
+//! \file restart.hpp
+//  \brief provides access to the MeshBlock data section of restart files
+//
+// A restart file consists of the parameter dump (terminated by <par_end>), a header
+// (nbtotal, root_level, mesh_size, datasize), the block index holding the
+// (LogicalLocation, cost, offset) of every MeshBlock, and finally the data of all
+// MeshBlocks ordered by gid, datasize bytes in total.  The offsets are relative to the
+// start of the data section, so the data of MeshBlock gid ends where the one of gid+1
+// begins.  The data of a MeshBlock is the full (ghost zones included) array of each
+// registered CellVariable in registration order.
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "interface/variable.hpp"
+#include "outputs/io_wrapper.hpp"
+
+namespace parthenon {
+
+class RestartReader {
+ public:
+  // data_offset is the position of the data section in the file, block_offsets the
+  // offsets of the MeshBlocks from the block index followed by the size of the section
+  RestartReader(IOWrapper &resfile, IOWrapperSizeT data_offset,
+                std::vector<IOWrapperSizeT> block_offsets);
+  ~RestartReader();
+  RestartReader(const RestartReader &) = delete;
+  RestartReader &operator=(const RestartReader &) = delete;
+
+  // Makes the data of MeshBlocks [nbs, nbs + nb) available.  Only the byte range of
+  // these MeshBlocks is accessed: with use_mmap it is mapped lazily so that pages are
+  // touched on first use, otherwise it is read collectively through the IOWrapper.
+  void ReadBlocks(int nbs, int nb, bool use_mmap);
+  // copies the data of MeshBlock gid into vars, which must match the written layout
+  void LoadBlock(int gid, const std::vector<std::shared_ptr<CellVariable<Real>>> &vars);
+  IOWrapperSizeT BlockSize(int gid) const {
+    return block_offsets_[gid + 1] - block_offsets_[gid];
+  }
+  bool IsMapped() const { return map_ != nullptr; }
+
+  // mapping is only used when all ranks share the node holding the page cache
+  static bool CanMap();
+
+ private:
+  const char *BlockData(int gid) const;
+  void Unmap();
+
+  IOWrapper &resfile_;
+  IOWrapperSizeT data_offset_;
+  std::vector<IOWrapperSizeT> block_offsets_;
+  int nbs_, nb_;
+  // mapped region and the distance of the first owned MeshBlock from its start
+  void *map_;
+  std::size_t map_length_, map_shift_;
+  std::vector<char> buffer_;
+};
+
+} // namespace parthenon
+
+#endif // OUTPUTS_RESTART_HPP_
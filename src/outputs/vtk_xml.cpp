@@ -0,0 +1,359 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file vtk_xml.cpp
+//  \brief writes output data in VTK XML format.
+//  Each rank writes a single UnstructuredGrid (.vtu) file holding one Piece per
+//  MeshBlock, with all heavy data stored as raw binary in an appended section in the
+//  native byte order of the host.  Rank 0 additionally writes a MultiBlock (.vtm) index
+//  file referencing the per-rank files.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "coordinates/coordinates.hpp"
+#include "globals.hpp"
+#include "interface/container_iterator.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "parameter_input.hpp"
+#include "parthenon_arrays.hpp"
+
+namespace parthenon {
+
+namespace {
+// VTK cell type ids for axis aligned cells, see vtkCellType.h
+constexpr std::uint8_t VTK_LINE = 3;
+constexpr std::uint8_t VTK_PIXEL = 8;
+constexpr std::uint8_t VTK_VOXEL = 11;
+
+// every appended array is prefixed by its size in bytes (header_type="UInt64")
+using vtk_header_t = std::uint64_t;
+
+template <typename T>
+const char *VTKTypeName();
+template <>
+const char *VTKTypeName<float>() {
+  return "Float32";
+}
+template <>
+const char *VTKTypeName<double>() {
+  return "Float64";
+}
+
+std::string ByteOrder() { return (IsBigEndian() ? "BigEndian" : "LittleEndian"); }
+
+// writes one appended block (size header followed by the raw bytes)
+template <typename T>
+void WriteAppended(const std::vector<T> &buf, FILE *pfile) {
+  vtk_header_t nbytes = buf.size() * sizeof(T);
+  std::fwrite(&nbytes, sizeof(vtk_header_t), 1, pfile);
+  std::fwrite(buf.data(), sizeof(T), buf.size(), pfile);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void VTKXMLOutput:::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm)
+//  \brief Writes OutputData in VTK XML format, one .vtu file per rank plus a .vtm index
+
+void VTKXMLOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm) {
+  if (output_params.single_precision_output) {
+    WriteRankFile<float>(pm, tm);
+  } else {
+    WriteRankFile<Real>(pm, tm);
+  }
+  if (Globals::my_rank == 0) WriteIndexFile(pm);
+
+  // increment counters
+  output_params.file_number++;
+  output_params.next_time += output_params.dt;
+  pin->SetInteger(output_params.block_name, "file_number", output_params.file_number);
+  pin->SetReal(output_params.block_name, "next_time", output_params.next_time);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string VTKXMLOutput::BaseFileName()
+//  \brief "file_basename"+"."+"file_id"+"."+XXXXX, where XXXXX = 5-digit file_number
+
+std::string VTKXMLOutput::BaseFileName() const {
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", output_params.file_number);
+  std::string fname(output_params.file_basename);
+  fname.append(".");
+  fname.append(output_params.file_id);
+  fname.append(".");
+  fname.append(number);
+  return fname;
+}
+
+std::string VTKXMLOutput::RankFileName(const int rank) const {
+  return BaseFileName() + ".rank" + std::to_string(rank) + ".vtu";
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void VTKXMLOutput::WriteIndexFile(Mesh *pm)
+//  \brief writes the .vtm file listing the .vtu file of every rank owning MeshBlocks
+
+void VTKXMLOutput::WriteIndexFile(Mesh *pm) {
+  std::string fname = BaseFileName() + ".vtm";
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [VTKXMLOutput::WriteIndexFile]" << std::endl
+        << "Output file '" << fname << "' could not be opened" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+
+  // the .vtu files are referenced relative to the index file, so strip any path
+  auto nblist = pm->GetNbList();
+  std::fprintf(pfile, "<?xml version=\"1.0\"?>\n");
+  std::fprintf(pfile,
+               "<VTKFile type=\"vtkMultiBlockDataSet\" version=\"1.0\" "
+               "byte_order=\"%s\" header_type=\"UInt64\">\n",
+               ByteOrder().c_str());
+  std::fprintf(pfile, "  <vtkMultiBlockDataSet>\n");
+  int index = 0;
+  for (int rank = 0; rank < Globals::nranks; rank++) {
+    if (nblist[rank] == 0) continue;
+    std::string rname = RankFileName(rank);
+    auto pos = rname.find_last_of('/');
+    if (pos != std::string::npos) rname.erase(0, pos + 1);
+    std::fprintf(pfile, "    <DataSet index=\"%d\" name=\"rank%d\" file=\"%s\"/>\n",
+                 index++, rank, rname.c_str());
+  }
+  std::fprintf(pfile, "  </vtkMultiBlockDataSet>\n");
+  std::fprintf(pfile, "</VTKFile>\n");
+  std::fclose(pfile);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void VTKXMLOutput::WriteRankFile(Mesh *pm, SimTime *tm)
+//  \brief writes all MeshBlocks of this rank into a single .vtu file.  Values are
+//  written with type T (float or Real) in the native byte order of the host.
+
+template <typename T>
+void VTKXMLOutput::WriteRankFile(Mesh *pm, SimTime *tm) {
+  MeshBlock *pmb = pm->pblock;
+  if (pmb == nullptr) return;
+
+  // set start/end array indices depending on whether ghost zones are included.  All
+  // MeshBlocks have the same shape, so the first one defines the layout of every Piece.
+  out_is = pmb->is;
+  out_ie = pmb->ie;
+  out_js = pmb->js;
+  out_je = pmb->je;
+  out_ks = pmb->ks;
+  out_ke = pmb->ke;
+  if (output_params.include_ghost_zones) {
+    out_is -= NGHOST;
+    out_ie += NGHOST;
+    if (out_js != out_je) {
+      out_js -= NGHOST;
+      out_je += NGHOST;
+    }
+    if (out_ks != out_ke) {
+      out_ks -= NGHOST;
+      out_ke += NGHOST;
+    }
+  }
+  const int ncells1 = out_ie - out_is + 1;
+  const int ncells2 = out_je - out_js + 1;
+  const int ncells3 = out_ke - out_ks + 1;
+  const int ncells = ncells1 * ncells2 * ncells3;
+
+  // collapsed directions only carry a single layer of points
+  const int ndim = pm->ndim;
+  const int np1 = ncells1 + 1;
+  const int np2 = (ndim > 1 ? ncells2 + 1 : 1);
+  const int np3 = (ndim > 2 ? ncells3 + 1 : 1);
+  const int npoints = np1 * np2 * np3;
+  const int nvert = (1 << ndim);
+  const std::uint8_t cell_type =
+      (ndim == 3 ? VTK_VOXEL : (ndim == 2 ? VTK_PIXEL : VTK_LINE));
+
+  // topology is identical for every Piece, so build it once
+  std::vector<std::int32_t> connectivity(static_cast<std::size_t>(ncells) * nvert);
+  std::vector<std::int32_t> offsets(ncells);
+  std::vector<std::uint8_t> types(ncells, cell_type);
+  const int dk = (ndim > 2 ? 1 : 0), dj = (ndim > 1 ? 1 : 0);
+  std::size_t n = 0;
+  for (int k = 0; k < ncells3; k++) {
+    for (int j = 0; j < ncells2; j++) {
+      for (int i = 0; i < ncells1; i++) {
+        // VTK_VOXEL/VTK_PIXEL order vertices with x varying fastest, then y, then z
+        for (int kk = 0; kk <= dk; kk++) {
+          for (int jj = 0; jj <= dj; jj++) {
+            for (int ii = 0; ii <= 1; ii++) {
+              connectivity[n++] = ((k + kk) * np2 + (j + jj)) * np1 + i + ii;
+            }
+          }
+        }
+        const int c = (k * ncells2 + j) * ncells1 + i;
+        offsets[c] = (c + 1) * nvert;
+      }
+    }
+  }
+
+  // gather the list of output variables and their number of components, which are all
+  // indices beyond the three spatial ones
+  auto ciX = ContainerIterator<Real>(pmb->real_containers.Get(), output_params.variables);
+  std::vector<std::string> names;
+  std::vector<int> ncomps;
+  for (auto &v : ciX.vars) {
+    names.push_back(v->label());
+    ncomps.push_back(v->GetDim(4) * v->GetDim(5) * v->GetDim(6));
+  }
+
+  // byte offsets of each appended array within a Piece (they repeat for every Piece)
+  const std::size_t hdr = sizeof(vtk_header_t);
+  const std::size_t points_bytes = hdr + 3 * sizeof(T) * npoints;
+  const std::size_t conn_bytes = hdr + sizeof(std::int32_t) * connectivity.size();
+  const std::size_t offs_bytes = hdr + sizeof(std::int32_t) * offsets.size();
+  const std::size_t type_bytes = hdr + sizeof(std::uint8_t) * types.size();
+  std::vector<std::size_t> var_bytes;
+  for (auto nc : ncomps) {
+    var_bytes.push_back(hdr + sizeof(T) * ncells * nc);
+  }
+
+  // open file for output
+  std::string fname = RankFileName(Globals::my_rank);
+  FILE *pfile;
+  if ((pfile = std::fopen(fname.c_str(), "wb")) == nullptr) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [VTKXMLOutput::WriteOutputFile]" << std::endl
+        << "Output file '" << fname << "' could not be opened" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+
+  // XML header describing every Piece and where its arrays live in the appended data
+  const char *tname = VTKTypeName<T>();
+  std::fprintf(pfile, "<?xml version=\"1.0\"?>\n");
+  std::fprintf(pfile,
+               "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" "
+               "header_type=\"UInt64\">\n",
+               ByteOrder().c_str());
+  std::fprintf(pfile, "  <UnstructuredGrid>\n");
+  if (tm != nullptr) {
+    std::fprintf(pfile, "    <FieldData>\n");
+    std::fprintf(pfile,
+                 "      <DataArray type=\"Float64\" Name=\"TimeValue\" "
+                 "NumberOfTuples=\"1\" format=\"ascii\">%.17e</DataArray>\n",
+                 static_cast<double>(tm->time));
+    std::fprintf(pfile,
+                 "      <DataArray type=\"Int32\" Name=\"Cycle\" "
+                 "NumberOfTuples=\"1\" format=\"ascii\">%d</DataArray>\n",
+                 tm->ncycle);
+    std::fprintf(pfile, "    </FieldData>\n");
+  }
+  std::size_t offset = 0;
+  for (MeshBlock *pb = pmb; pb != nullptr; pb = pb->next) {
+    std::fprintf(pfile, "    <Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n",
+                 npoints, ncells);
+    std::fprintf(pfile, "      <Points>\n");
+    std::fprintf(pfile,
+                 "        <DataArray type=\"%s\" NumberOfComponents=\"3\" "
+                 "format=\"appended\" offset=\"%zu\"/>\n",
+                 tname, offset);
+    offset += points_bytes;
+    std::fprintf(pfile, "      </Points>\n");
+    std::fprintf(pfile, "      <Cells>\n");
+    std::fprintf(pfile,
+                 "        <DataArray type=\"Int32\" Name=\"connectivity\" "
+                 "format=\"appended\" offset=\"%zu\"/>\n",
+                 offset);
+    offset += conn_bytes;
+    std::fprintf(pfile,
+                 "        <DataArray type=\"Int32\" Name=\"offsets\" "
+                 "format=\"appended\" offset=\"%zu\"/>\n",
+                 offset);
+    offset += offs_bytes;
+    std::fprintf(pfile,
+                 "        <DataArray type=\"UInt8\" Name=\"types\" "
+                 "format=\"appended\" offset=\"%zu\"/>\n",
+                 offset);
+    offset += type_bytes;
+    std::fprintf(pfile, "      </Cells>\n");
+    std::fprintf(pfile, "      <CellData>\n");
+    for (std::size_t iv = 0; iv < names.size(); iv++) {
+      std::fprintf(pfile,
+                   "        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"%d\" "
+                   "format=\"appended\" offset=\"%zu\"/>\n",
+                   tname, names[iv].c_str(), ncomps[iv], offset);
+      offset += var_bytes[iv];
+    }
+    std::fprintf(pfile, "      </CellData>\n");
+    std::fprintf(pfile, "    </Piece>\n");
+  }
+  std::fprintf(pfile, "  </UnstructuredGrid>\n");
+  std::fprintf(pfile, "  <AppendedData encoding=\"raw\">\n_");
+
+  // Appended data.  Buffers are sized once and reused for every MeshBlock.
+  int maxcomp = 3;
+  for (auto nc : ncomps)
+    maxcomp = std::max(maxcomp, nc);
+  std::vector<T> points(static_cast<std::size_t>(npoints) * 3);
+  std::vector<T> buf;
+  buf.reserve(static_cast<std::size_t>(std::max(ncells, npoints)) * maxcomp);
+  for (MeshBlock *pb = pmb; pb != nullptr; pb = pb->next) {
+    auto &coords = pb->coords;
+    n = 0;
+    for (int k = 0; k < np3; k++) {
+      T x3 = static_cast<T>(ndim > 2 ? coords.x3f(out_ks + k) : coords.x3v(out_ks));
+      for (int j = 0; j < np2; j++) {
+        T x2 = static_cast<T>(ndim > 1 ? coords.x2f(out_js + j) : coords.x2v(out_js));
+        for (int i = 0; i < np1; i++) {
+          points[n++] = static_cast<T>(coords.x1f(out_is + i));
+          points[n++] = x2;
+          points[n++] = x3;
+        }
+      }
+    }
+    WriteAppended(points, pfile);
+    WriteAppended(connectivity, pfile);
+    WriteAppended(offsets, pfile);
+    WriteAppended(types, pfile);
+
+    // variables are interleaved component-fastest as required by VTK, with the
+    // components in the order of the flattened indices 6, 5 and 4
+    auto ci = ContainerIterator<Real>(pb->real_containers.Get(), output_params.variables);
+    for (auto &v : ci.vars) {
+      auto &h = pstaging_->Get(pb, *v);
+      const int n4 = v->GetDim(4), n5 = v->GetDim(5), n6 = v->GetDim(6);
+      buf.resize(static_cast<std::size_t>(ncells) * n4 * n5 * n6);
+      n = 0;
+      for (int k = out_ks; k <= out_ke; k++) {
+        for (int j = out_js; j <= out_je; j++) {
+          for (int i = out_is; i <= out_ie; i++) {
+            for (int l6 = 0; l6 < n6; l6++) {
+              for (int l5 = 0; l5 < n5; l5++) {
+                for (int l4 = 0; l4 < n4; l4++) {
+                  buf[n++] = static_cast<T>(h(l6, l5, l4, k, j, i));
+                }
+              }
+            }
+          }
+        }
+      }
+      WriteAppended(buf, pfile);
+    }
+  }
+  std::fprintf(pfile, "\n  </AppendedData>\n");
+  std::fprintf(pfile, "</VTKFile>\n");
+  std::fclose(pfile);
+}
+
+} // namespace parthenon
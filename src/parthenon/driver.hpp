@@ -42,9 +42,13 @@ using ::parthenon::MeshBlock;
 using ::parthenon::MultiStageBlockTaskDriver;
 using ::parthenon::Outputs;
 using ::parthenon::ParameterInput;
+using ::parthenon::SimpleTask;
 using ::parthenon::TaskID;
 using ::parthenon::TaskList;
+using ::parthenon::TaskRegion;
 using ::parthenon::DriverUtils::ConstructAndExecuteBlockTasks;
+using ::parthenon::DriverUtils::ConstructAndExecuteTaskRegion;
+namespace TaskPriority = ::parthenon::TaskPriority;
 } // namespace prelude
 } // namespace driver
 } // namespace parthenon
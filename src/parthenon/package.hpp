@@ -44,6 +44,8 @@ using ::parthenon::MeshBlock;
 using ::parthenon::Metadata;
 using ::parthenon::PackIndexMap;
 using ::parthenon::par_for;
+using ::parthenon::par_reduce;
+using ::parthenon::par_scan;
 using ::parthenon::ParameterInput;
 using ::parthenon::Params;
 using ::parthenon::ParthenonManager;
@@ -235,6 +235,9 @@ class ParArrayNDGeneric {
   KOKKOS_INLINE_FUNCTION
   auto Get() const { return d6d_; }
   // call me as Get<D>();
+  // The result is a rank D view of the innermost D dimensions, e.g. a ParArray3D for
+  // D = 3, which is free to create and indexes without the 6D index arithmetic.
+  // Kernels over data of known rank should capture it instead of the ParArrayND.
   template <std::size_t N = 6>
   KOKKOS_INLINE_FUNCTION auto
   Get(const std::integral_constant<int, N> &ic = std::integral_constant<int, N>{}) const {
@@ -17,9 +17,18 @@
 
 #include <Kokkos_Core.hpp>
 
+#include "bvals/neighbor_exchange.hpp"
+#include "bvals/node_buffers.hpp"
+#include "bvals/progress_thread.hpp"
 #include "driver/driver.hpp"
+#include "interface/container.hpp"
 #include "interface/update.hpp"
+#include "outputs/io_wrapper.hpp"
 #include "refinement/refinement.hpp"
+#include "utils/array_pool.hpp"
+#include "utils/exec_space_pool.hpp"
+#include "utils/loop_tuner.hpp"
+#include "utils/profiler.hpp"
 
 namespace parthenon {
 
@@ -81,12 +90,70 @@ ParthenonStatus ParthenonManager::ParthenonInit(int argc, char *argv[]) {
   SignalHandler::SignalHandlerInit();
   if (Globals::my_rank == 0 && arg.wtlim > 0) SignalHandler::SetWallTimeAlarm(arg.wtlim);
 
-  // Populate the ParameterInput object
-  if (arg.input_filename != nullptr) {
+  // Populate the ParameterInput object; on restart the parameters stored in the restart
+  // file are read first and an input file, if given, overrides them
+  IOWrapper restartfile;
+  if (Restart()) {
+    restartfile.Open(arg.restart_filename, IOWrapper::FileMode::read);
+    pinput = std::make_unique<ParameterInput>();
+    pinput->LoadFromFile(restartfile);
+    if (arg.input_filename != nullptr) {
+      IOWrapper infile;
+      infile.Open(arg.input_filename, IOWrapper::FileMode::read);
+      pinput->LoadFromFile(infile);
+      infile.Close();
+    }
+  } else if (arg.input_filename != nullptr) {
     pinput = std::make_unique<ParameterInput>(arg.input_filename);
   }
   pinput->ModifyFromCmdline(argc, argv);
 
+  // timing regions are only collected when requested
+  Profiler::Initialize(pinput->GetOrAddBoolean("parthenon/profiling", "enable", false),
+                       pinput->GetOrAddBoolean("parthenon/profiling", "fence_kernels",
+                                               false));
+
+  // block-sized arrays are recycled across remeshes when requested
+  ArrayPool::Initialize(pinput->GetOrAddBoolean("parthenon/memory", "pool", false));
+  // the cell variables of a container share one allocation when requested
+  Container<Real>::SetContiguous(
+      pinput->GetOrAddBoolean("parthenon/memory", "contiguous", false));
+
+  // ghost zones of neighbors on other ranks of this node are exchanged in shared memory
+  // when requested
+  NodeBuffers::Initialize(
+      pinput->GetOrAddBoolean("parthenon/mpi", "shared_memory", false));
+  // the ghost zones of the remaining neighbors on other ranks are exchanged by
+  // point-to-point messages or one neighborhood collective per round
+  NeighborExchange::Initialize(
+      pinput->GetOrAddString("parthenon/mpi", "exchange", "point_to_point"));
+  // a thread completes the started requests so that the tasks only check flags, without
+  // MPI there are no requests to complete
+#ifdef MPI_PARALLEL
+  ProgressThread::Initialize(
+      pinput->GetOrAddBoolean("parthenon/mpi", "progress_thread", false));
+#endif
+
+  // ready tasks run by priority and critical path, blocks at rank boundaries first
+  TaskList::SetPrioritized(
+      pinput->GetOrAddBoolean("parthenon/tasks", "prioritize", true));
+
+  // the kernels of different blocks can run concurrently on separate instances
+  ExecSpacePool::Initialize(
+      pinput->GetOrAddInteger("parthenon/execution", "nspaces", 1));
+
+  // the loop patterns of the default par_for are fixed or tuned when requested, the
+  // default tile is set first so that the tuner does not try it twice
+  LoopTuner::SetTileSize(pinput->GetOrAddInteger("parthenon/loop_tuning", "tile_k", 4),
+                         pinput->GetOrAddInteger("parthenon/loop_tuning", "tile_j", 8),
+                         pinput->GetOrAddInteger("parthenon/loop_tuning", "tile_i", 0));
+  LoopTuner::Initialize(
+      pinput->GetOrAddBoolean("parthenon/loop_tuning", "enable", false),
+      pinput->GetOrAddInteger("parthenon/loop_tuning", "trials", 2),
+      pinput->GetOrAddString("parthenon/loop_tuning", "file", "loop_tuning.txt"),
+      pinput->GetOrAddString("parthenon/loop_tuning", "pattern", "default"),
+      pinput->GetOrAddString("parthenon/loop_tuning", "override", ""));
+
   // read in/set up application specific properties
   auto properties = ProcessProperties(pinput);
   // set up all the packages in the application
@@ -94,12 +161,13 @@ ParthenonStatus ParthenonManager::ParthenonInit(int argc, char *argv[]) {
   // always add the Refinement package
   packages["ParthenonRefinement"] = Refinement::Initialize(pinput.get());
 
-  // TODO(jdolence): Deal with restarts
-  // if (arg.res_flag == 0) {
-  pmesh = std::make_unique<Mesh>(pinput.get(), properties, packages, arg.mesh_flag);
-  //} else {
-  //  pmesh = std::make_unique<Mesh>(pinput.get(), )
-  //}
+  if (Restart()) {
+    pmesh = std::make_unique<Mesh>(pinput.get(), restartfile, properties, packages,
+                                   arg.mesh_flag);
+    restartfile.Close();
+  } else {
+    pmesh = std::make_unique<Mesh>(pinput.get(), properties, packages, arg.mesh_flag);
+  }
 
   // add root_level to all max_level
   for (auto const &ph : packages) {
@@ -154,7 +222,19 @@ void ParthenonManager::PostDriver(DriverStatus driver_status) {
 }
 
 ParthenonStatus ParthenonManager::ParthenonFinalize() {
+  // the summary is reduced over all ranks, so it has to be written before MPI_Finalize
+  if (pinput != nullptr) {
+    Profiler::Finalize(
+        pinput->GetOrAddString("parthenon/profiling", "file", "profile.json"));
+  }
   pmesh.reset();
+  NodeBuffers::Finalize();
+  NeighborExchange::Finalize();
+  ProgressThread::Finalize();
+  ExecSpacePool::Finalize();
+  // the pools hold Kokkos views and report over all ranks
+  ArrayPool::Finalize();
+  LoopTuner::Finalize();
   Kokkos::finalize();
 #ifdef MPI_PARALLEL
   MPI_Finalize();
@@ -15,14 +15,19 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 //! \file tasks.cpp
-//  \brief implementation of the TaskID class
+//  \brief implementation of the TaskID class, of the task ordering of TaskList and of
+//  the execution of TaskRegion
 
 #include "task_list/tasks.hpp"
 
 #include <algorithm>
 #include <bitset>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace parthenon {
 
@@ -151,4 +156,73 @@ std::string TaskID::to_string() {
   return bs;
 }
 
+bool TaskList::prioritized_ = true;
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskList::Schedule()
+//  \brief orders the tasks by priority and then by critical path, so that DoAvailable()
+//  runs the ready tasks that hold up the most other tasks first.  Tasks with the same
+//  priority and critical path keep the order they were added in.
+
+void TaskList::Schedule() {
+  scheduled_ = true;
+  if (!prioritized_) return;
+
+  std::vector<BaseTask *> tasks;
+  for (auto &task : task_list_)
+    tasks.push_back(task.get());
+  // the dependency graph is acyclic since tasks can only depend on tasks added earlier
+  const int ntasks = tasks.size();
+  std::vector<int> path(ntasks, 0);
+  std::function<int(int)> length = [&](int n) {
+    if (path[n] > 0) return path[n];
+    int longest = 0;
+    for (int m = 0; m < ntasks; m++) {
+      if (m != n && tasks[m]->GetDependency().CheckDependencies(tasks[n]->GetID()))
+        longest = std::max(longest, length(m));
+    }
+    return path[n] = longest + 1;
+  };
+  for (int n = 0; n < ntasks; n++)
+    tasks[n]->SetCriticalPath(length(n));
+
+  // std::list::sort is stable
+  task_list_.sort(
+      [](const std::unique_ptr<BaseTask> &a, const std::unique_ptr<BaseTask> &b) {
+        if (a->GetPriority() != b->GetPriority())
+          return a->GetPriority() > b->GetPriority();
+        return a->GetCriticalPath() > b->GetCriticalPath();
+      });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskListStatus TaskRegion::Execute()
+//  \brief runs the available tasks of all lists in turn until all lists are complete
+
+TaskListStatus TaskRegion::Execute() {
+  // the collective tasks count the named tasks of all lists, including the ones that
+  // are named after they have been added
+  counts_->expected.clear();
+  counts_->completed.clear();
+  for (auto &list : lists_) {
+    for (auto &task : list.task_list_)
+      counts_->expected[task->GetName()]++;
+    list.regional_ = counts_;
+  }
+  int complete_cnt = 0;
+  for (auto &list : lists_) {
+    if (list.IsComplete()) complete_cnt++;
+  }
+  while (complete_cnt != Size()) {
+    for (auto &list : lists_) {
+      if (!list.IsComplete()) {
+        if (list.DoAvailable() == TaskListStatus::complete) complete_cnt++;
+      }
+    }
+  }
+  for (auto &list : lists_)
+    list.regional_.reset();
+  return TaskListStatus::complete;
+}
+
 } // namespace parthenon
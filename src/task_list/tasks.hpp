@@ -18,13 +18,16 @@
 #include <functional>
 #include <iostream>
 #include <list>
+#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "basic_types.hpp"
+#include "utils/profiler.hpp"
 
 namespace parthenon {
 
@@ -33,6 +36,14 @@ struct Integrator;
 
 enum class TaskListStatus { running, stuck, complete, nothing_to_do };
 
+// user priorities of tasks, see TaskList::SetTaskPriority()
+namespace TaskPriority {
+constexpr int normal = 0;
+// tasks that start communication, e.g. Container::SendBoundaryBuffersTask, so that the
+// other ranks do not wait for them
+constexpr int communication = 1;
+} // namespace TaskPriority
+
 using SimpleTaskFunc = std::function<TaskStatus()>;
 using BlockTaskFunc = std::function<TaskStatus(MeshBlock *)>;
 using BlockStageTaskFunc = std::function<TaskStatus(MeshBlock *, int)>;
@@ -73,10 +84,20 @@ class BaseTask {
   TaskID GetDependency() { return dep_; }
   void SetComplete() { complete_ = true; }
   bool IsComplete() { return complete_; }
+  // name of the timing region of the task
+  const std::string &GetName() { return name_; }
+  void SetName(const std::string &name) { name_ = name; }
+  int GetPriority() { return priority_; }
+  void SetPriority(int priority) { priority_ = priority; }
+  // number of tasks on the longest chain of dependent tasks starting at this one
+  int GetCriticalPath() { return critical_path_; }
+  void SetCriticalPath(int length) { critical_path_ = length; }
 
  protected:
   TaskID myid_, dep_;
   bool lb_time, complete_ = false;
+  std::string name_;
+  int priority_ = TaskPriority::normal, critical_path_ = 1;
 };
 
 class SimpleTask : public BaseTask {
@@ -144,12 +165,20 @@ class BlockStageNamesIntegratorTask : public BaseTask {
   Integrator *int_;
 };
 
+// number of tasks of each name in the lists of a TaskRegion and how many of them have
+// completed, shared by the lists and the collective tasks of the region
+struct RegionalCounts {
+  std::map<std::string, int> expected, completed;
+  bool Complete(const std::string &name) { return completed[name] >= expected[name]; }
+};
+
 class TaskList {
  public:
   bool IsComplete() { return task_list_.empty(); }
   int Size() { return task_list_.size(); }
   void Reset() {
     tasks_added_ = 0;
+    scheduled_ = false;
     task_list_.clear();
     dependencies_.clear();
     tasks_completed_.clear();
@@ -174,34 +203,84 @@ class TaskList {
     }
   }
   TaskListStatus DoAvailable() {
-    for (auto &task : task_list_) {
-      auto dep = task->GetDependency();
-      if (tasks_completed_.CheckDependencies(dep)) {
+    if (!scheduled_) Schedule();
+    // each task runs at most once per call; after a task completes, the scan starts over
+    // so that the tasks it made ready run before ready tasks of lower priority
+    std::vector<bool> tried(task_list_.size(), false);
+    auto task = task_list_.begin();
+    int n = 0;
+    while (task != task_list_.end()) {
+      auto dep = (*task)->GetDependency();
+      bool restart = false;
+      if (!tried[n] && tasks_completed_.CheckDependencies(dep)) {
         /*std::cerr << "Task dependency met:" << std::endl
                   << dep.to_string() << std::endl
                   << tasks_completed_.to_string() << std::endl
-                  << task->GetID().to_string() << std::endl << std::endl;*/
-        TaskStatus status = (*task)();
+                  << (*task)->GetID().to_string() << std::endl << std::endl;*/
+        tried[n] = true;
+        TaskStatus status;
+        {
+          Profiler::ScopedRegion region((*task)->GetName());
+          status = (**task)();
+        }
         if (status == TaskStatus::complete) {
-          task->SetComplete();
-          MarkTaskComplete(task->GetID());
+          (*task)->SetComplete();
+          MarkTaskComplete((*task)->GetID());
+          if (regional_) regional_->completed[(*task)->GetName()]++;
           /*std::cerr << "Task complete:" << std::endl
-                    << task->GetID().to_string() << std::endl
+                    << (*task)->GetID().to_string() << std::endl
                     << tasks_completed_.to_string() << std::endl << std::endl;*/
+          restart = true;
         }
       }
+      if (restart) {
+        task = task_list_.begin(), n = 0;
+      } else {
+        ++task, ++n;
+      }
     }
     ClearComplete();
     if (IsComplete()) return TaskListStatus::complete;
     return TaskListStatus::running;
   }
   template <typename T, class... Args>
-  TaskID AddTask(Args... args) {
+  std::enable_if_t<std::is_constructible<T, TaskID, Args...>::value, TaskID>
+  AddTask(Args... args) {
     TaskID id(tasks_added_ + 1);
     task_list_.push_back(std::make_unique<T>(id, std::forward<Args>(args)...));
     tasks_added_++;
+    scheduled_ = false;
+    // tasks are added in the same order for every block and cycle, so unnamed tasks are
+    // profiled under their position in the list
+    if (Profiler::Enabled()) {
+      task_list_.back()->SetName("Task " + std::to_string(tasks_added_));
+    }
     return id;
   }
+  // adds a task whose timing region is called name, e.g. after the function it calls
+  template <typename T, class... Args>
+  TaskID AddTask(const std::string &name, Args... args) {
+    TaskID id = AddTask<T>(std::forward<Args>(args)...);
+    task_list_.back()->SetName(name);
+    return id;
+  }
+  // names the timing region of a task that has already been added
+  void SetTaskName(const TaskID &id, const std::string &name) {
+    for (auto &task : task_list_) {
+      if (task->GetID() == id) task->SetName(name);
+    }
+  }
+  // ready tasks with a higher priority run first, regardless of the critical path
+  void SetTaskPriority(const TaskID &id, int priority) {
+    for (auto &task : task_list_) {
+      if (task->GetID() == id) task->SetPriority(priority);
+    }
+    scheduled_ = false;
+  }
+  // whether the tasks are ordered by priority and critical path (<parthenon/tasks>
+  // prioritize) or run in the order they were added
+  static bool Prioritized() { return prioritized_; }
+  static void SetPrioritized(bool prioritized) { prioritized_ = prioritized; }
   void Print() {
     int i = 0;
     std::cout << "TaskList::Print():" << std::endl;
@@ -217,6 +296,62 @@ class TaskList {
   int tasks_added_ = 0;
   std::vector<TaskList *> dependencies_;
   TaskID tasks_completed_;
+  bool scheduled_ = false;
+  static bool prioritized_;
+  std::shared_ptr<RegionalCounts> regional_; // set while executed by a TaskRegion
+
+  void Schedule();
+
+  friend class TaskRegion;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class CollectiveTask
+//  \brief a task of type T that, once its dependencies in its own list are complete,
+//  waits until all tasks of the given name in the lists of its TaskRegion have completed
+
+template <typename T>
+class CollectiveTask : public T {
+ public:
+  template <class... Args>
+  CollectiveTask(TaskID id, std::shared_ptr<RegionalCounts> counts,
+                 const std::string &name, Args... args)
+      : T(id, std::forward<Args>(args)...), counts_(counts), name_(name) {}
+  TaskStatus operator()() {
+    if (!counts_->Complete(name_)) return TaskStatus::incomplete;
+    return T::operator()();
+  }
+
+ private:
+  std::shared_ptr<RegionalCounts> counts_;
+  std::string name_;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class TaskRegion
+//  \brief task lists that are executed together, e.g. one per block and one for the rank.
+//  The lists only synchronize through collective tasks, which depend on a task named
+//  with SetTaskName() in all lists of the region, so each list runs ahead until it
+//  reaches a collective task instead of waiting for all lists at a barrier.
+
+class TaskRegion {
+ public:
+  explicit TaskRegion(int size)
+      : lists_(size), counts_(std::make_shared<RegionalCounts>()) {}
+  TaskList &operator[](int i) { return lists_[i]; }
+  int Size() { return lists_.size(); }
+  // adds a task of type T to list i that runs once the tasks named name have completed
+  // in all lists of the region and its dependency dep in list i has completed
+  template <typename T, class... Args>
+  TaskID AddCollectiveTask(int i, const std::string &name, Args... args) {
+    return lists_[i].AddTask<CollectiveTask<T>>(counts_, name,
+                                                std::forward<Args>(args)...);
+  }
+  TaskListStatus Execute();
+
+ private:
+  std::vector<TaskList> lists_;
+  std::shared_ptr<RegionalCounts> counts_;
 };
 
 } // namespace parthenon
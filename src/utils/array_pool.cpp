@@ -0,0 +1,106 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file array_pool.cpp
+//  \brief statistics and release of the array pools
+
+#include "utils/array_pool.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "globals.hpp"
+#include "parthenon_mpi.hpp"
+
+namespace parthenon {
+namespace ArrayPool {
+
+namespace detail {
+bool enabled = false;
+std::mutex mutex;
+Stats stats;
+
+namespace {
+std::vector<PoolBase *> &Pools() {
+  static std::vector<PoolBase *> pools;
+  return pools;
+}
+} // namespace
+
+PoolBase::PoolBase() { Pools().push_back(this); }
+} // namespace detail
+
+void Initialize(bool enabled) { detail::enabled = enabled; }
+
+Stats GetStats() {
+  std::lock_guard<std::mutex> lock(detail::mutex);
+  return detail::stats;
+}
+
+std::size_t BytesInUse() {
+  std::lock_guard<std::mutex> lock(detail::mutex);
+  std::size_t bytes = 0;
+  for (auto pool : detail::Pools())
+    bytes += pool->BytesInUse();
+  return bytes;
+}
+
+void Release() {
+  std::lock_guard<std::mutex> lock(detail::mutex);
+  for (auto pool : detail::Pools())
+    detail::stats.bytes -= pool->Release();
+}
+
+bool SharedZerosIntact() {
+  std::lock_guard<std::mutex> lock(detail::mutex);
+  for (auto pool : detail::Pools()) {
+    if (pool->SharedNonZeros() > 0) return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ArrayPool::Finalize()
+//  \brief reports the hit rate and the peak storage of the pools and frees them
+
+void Finalize() {
+  // arrays pooled while pooling was enabled and the shared zeros are freed in any case
+  Stats stats = GetStats();
+  Release();
+  if (!Enabled()) return;
+
+  // requests, hits, peak storage (sum and maximum over ranks)
+  double sum[3] = {static_cast<double>(stats.requests), static_cast<double>(stats.hits),
+                   static_cast<double>(stats.peak_bytes)};
+  double peak_max = sum[2];
+#ifdef MPI_PARALLEL
+  MPI_Reduce(Globals::my_rank == 0 ? MPI_IN_PLACE : sum, sum, 3, MPI_DOUBLE, MPI_SUM, 0,
+             MPI_COMM_WORLD);
+  MPI_Reduce(Globals::my_rank == 0 ? MPI_IN_PLACE : &peak_max, &peak_max, 1, MPI_DOUBLE,
+             MPI_MAX, 0, MPI_COMM_WORLD);
+#endif
+  if (Globals::my_rank != 0) return;
+
+  const double mb = 1024.0 * 1024.0;
+  std::stringstream msg;
+  msg << std::fixed << std::setprecision(1) << "Array pool: "
+      << static_cast<std::uint64_t>(sum[0]) << " requests, "
+      << (sum[0] > 0 ? 100.0 * sum[1] / sum[0] : 0.0) << "% reused" << std::endl
+      << "Array pool high-water mark: " << sum[2] / mb << " MiB total, "
+      << peak_max / mb << " MiB max per rank" << std::endl;
+  std::cout << std::endl << msg.str();
+}
+
+} // namespace ArrayPool
+} // namespace parthenon
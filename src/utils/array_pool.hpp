@@ -0,0 +1,205 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_ARRAY_POOL_HPP_
+#define UTILS_ARRAY_POOL_HPP_
+//! \file array_pool.hpp
+//  \brief recycles the storage of block-sized ParArrayNDs across remeshes
+//
+// Arrays requested through ArrayPool::Get() stay in the pool after their last user has
+// released them and are handed out again for the next request with the same label and
+// extents, which is what happens to the variables, fluxes and coarse buffers of the
+// MeshBlocks destroyed and created by a remesh.  A pooled array is in use as long as a
+// copy of it exists outside of the pool, i.e. while Kokkos::View::use_count() > 1.
+// Recycled arrays are zeroed like newly allocated ones.  Pooling is enabled with the
+// input parameter <parthenon/memory> pool = true; otherwise Get() simply allocates.
+//
+// SharedZeros() returns one array of zeros per extents that is shared by all of its
+// users, e.g. the sparse ids that are not allocated on a block.  It must not be written:
+// the writers of variables check CellVariable::IsAllocated() first, and
+// SharedZerosIntact() tells whether any entry has been written nevertheless.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+
+#include "parthenon_arrays.hpp"
+
+namespace parthenon {
+namespace ArrayPool {
+
+struct Stats {
+  std::uint64_t requests = 0, hits = 0;
+  std::size_t bytes = 0, peak_bytes = 0; // storage held by the pool
+};
+
+namespace detail {
+extern bool enabled;
+extern std::mutex mutex;
+extern Stats stats;
+
+// type independent interface of the pools of the different value types; pools are
+// created and registered with the mutex held
+class PoolBase {
+ public:
+  PoolBase();
+  virtual ~PoolBase() = default;
+  // drops the arrays that are not in use and returns their size in bytes
+  virtual std::size_t Release() = 0;
+  virtual std::size_t BytesInUse() const = 0;
+  // the number of entries of the shared zero arrays that are not zero
+  virtual std::size_t SharedNonZeros() const = 0;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class TypedPool
+//  \brief pooled arrays of value type T, by label and extents
+
+template <typename T>
+class TypedPool : public PoolBase {
+ public:
+  static TypedPool &Instance() {
+    static TypedPool pool;
+    return pool;
+  }
+
+  // has to be called with the mutex held
+  ParArrayND<T> Get(const std::string &label, const std::array<int, 6> &n) {
+    stats.requests++;
+    auto &list = arrays_[std::make_pair(label, n)];
+    for (auto &v : list) {
+      if (v.use_count() == 1) {
+        stats.hits++;
+        Kokkos::deep_copy(v, T());
+        return ParArrayND<T>(v);
+      }
+    }
+    device_view_t<T> v(label, n[0], n[1], n[2], n[3], n[4], n[5]);
+    list.push_back(v);
+    stats.bytes += v.span() * sizeof(T);
+    if (stats.bytes > stats.peak_bytes) stats.peak_bytes = stats.bytes;
+    return ParArrayND<T>(v);
+  }
+
+  // has to be called with the mutex held
+  ParArrayND<T> SharedZeros(const std::array<int, 6> &n) {
+    auto it = zeros_.find(n);
+    if (it == zeros_.end()) {
+      device_view_t<T> v("zeros", n[0], n[1], n[2], n[3], n[4], n[5]);
+      it = zeros_.insert(std::make_pair(n, v)).first;
+    }
+    return ParArrayND<T>(it->second);
+  }
+
+  // the shared zero arrays are not part of the statistics
+  std::size_t Release() override {
+    for (auto it = zeros_.begin(); it != zeros_.end();) {
+      if (it->second.use_count() == 1)
+        it = zeros_.erase(it);
+      else
+        ++it;
+    }
+    std::size_t freed = 0;
+    for (auto &a : arrays_) {
+      auto &list = a.second;
+      for (auto it = list.begin(); it != list.end();) {
+        if (it->use_count() == 1) {
+          freed += it->span() * sizeof(T);
+          it = list.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    return freed;
+  }
+
+  std::size_t BytesInUse() const override {
+    std::size_t bytes = 0;
+    for (auto &a : arrays_) {
+      for (auto &v : a.second) {
+        if (v.use_count() > 1) bytes += v.span() * sizeof(T);
+      }
+    }
+    return bytes;
+  }
+
+  std::size_t SharedNonZeros() const override {
+    std::size_t count = 0;
+    for (auto &z : zeros_) {
+      const T *data = z.second.data();
+      std::size_t n = 0;
+      Kokkos::parallel_reduce(
+          "ArrayPool::SharedNonZeros", Kokkos::RangePolicy<>(0, z.second.span()),
+          KOKKOS_LAMBDA(const int i, std::size_t &lcount) { lcount += (data[i] != T()); },
+          n);
+      count += n;
+    }
+    return count;
+  }
+
+ private:
+  TypedPool() = default;
+  std::map<std::pair<std::string, std::array<int, 6>>, std::vector<device_view_t<T>>>
+      arrays_;
+  std::map<std::array<int, 6>, device_view_t<T>> zeros_;
+};
+} // namespace detail
+
+inline bool Enabled() { return detail::enabled; }
+void Initialize(bool enabled);
+// statistics and storage of the arrays in use on this rank
+Stats GetStats();
+std::size_t BytesInUse();
+// frees the pooled arrays that are not in use
+void Release();
+// whether all entries of the shared zero arrays are still zero
+bool SharedZerosIntact();
+// reports the statistics on rank 0 if enabled and frees the pools and the shared zero
+// arrays, has to be called before Kokkos::finalize()
+void Finalize();
+
+//----------------------------------------------------------------------------------------
+//! \fn ParArrayND<T> ArrayPool::Get(const std::string &label, int nx6, int nx5, int nx4,
+//                                   int nx3, int nx2, int nx1)
+//  \brief a zero-initialized array, taken from the pool if enabled
+
+template <typename T>
+ParArrayND<T> Get(const std::string &label, int nx6, int nx5, int nx4, int nx3, int nx2,
+                  int nx1) {
+  if (!Enabled()) return ParArrayND<T>(label, nx6, nx5, nx4, nx3, nx2, nx1);
+  std::lock_guard<std::mutex> lock(detail::mutex);
+  return detail::TypedPool<T>::Instance().Get(label, {nx6, nx5, nx4, nx3, nx2, nx1});
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ParArrayND<T> ArrayPool::SharedZeros(int nx6, int nx5, int nx4, int nx3, int nx2,
+//                                          int nx1)
+//  \brief a read-only array of zeros shared by all requests with the same extents
+
+template <typename T>
+ParArrayND<T> SharedZeros(int nx6, int nx5, int nx4, int nx3, int nx2, int nx1) {
+  std::lock_guard<std::mutex> lock(detail::mutex);
+  return detail::TypedPool<T>::Instance().SharedZeros({nx6, nx5, nx4, nx3, nx2, nx1});
+}
+
+} // namespace ArrayPool
+} // namespace parthenon
+
+#endif // UTILS_ARRAY_POOL_HPP_
@@ -19,7 +19,10 @@
 
 #include "utils/buffer_utils.hpp"
 
+#include <utility>
+
 #include "athena.hpp"
+#include "kokkos_abstraction.hpp"
 #include "parthenon_arrays.hpp"
 
 namespace parthenon {
@@ -100,6 +103,17 @@ void UnpackData(T *buf, ParArrayND<T> &dst, int si, int ei, int sj, int ej, int
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn ParArray1D<Real> DeviceBuffer(Real *buf, int size, ParArray1D<Real> &staging)
+//  \brief device view of a host communication buffer for pack and unpack kernels
+
+ParArray1D<Real> DeviceBuffer(Real *buf, int size, ParArray1D<Real> &staging) {
+  if (Kokkos::SpaceAccessibility<DevExecSpace, Kokkos::HostSpace>::accessible)
+    return ParArray1D<Real>(buf, size);
+  if (staging.extent_int(0) < size) staging = ParArray1D<Real>("buffer_staging", size);
+  return Kokkos::subview(staging, std::make_pair(0, size));
+}
+
 // provide explicit instantiation definitions (C++03) to allow the template definitions to
 // exist outside of header file (non-inline), but still provide the requisite instances
 // for other TUs during linking time (~13x files include "buffer_utils.hpp")
@@ -20,6 +20,7 @@
 //  \brief prototypes of utility functions to pack/unpack buffers
 
 #include "athena.hpp"
+#include "kokkos_abstraction.hpp"
 #include "parthenon_arrays.hpp"
 
 namespace parthenon {
@@ -43,6 +44,15 @@ template <typename T>
 void UnpackData(T *buf, ParArrayND<T> &dst, int si, int ei, int sj, int ej, int sk,
                 int ek, int &offset);
 
+// unmanaged view of a host communication buffer
+using HostBuffer = Kokkos::View<Real *, LayoutWrapper, Kokkos::HostSpace,
+                                Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+
+// device view of the first size elements of the host communication buffer buf, which is
+// the buffer itself if the device can access host memory and the (grown as needed)
+// staging buffer otherwise
+ParArray1D<Real> DeviceBuffer(Real *buf, int size, ParArray1D<Real> &staging);
+
 } // namespace BufferUtility
 } // namespace parthenon
 
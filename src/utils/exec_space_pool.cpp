@@ -0,0 +1,81 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file exec_space_pool.cpp
+//  \brief creation and destruction of the execution space instances
+
+#include "utils/exec_space_pool.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+
+#include "athena.hpp"
+#include "globals.hpp"
+
+namespace parthenon {
+namespace ExecSpacePool {
+
+namespace {
+std::vector<DevExecSpace> spaces;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void ExecSpacePool::Initialize(int nspaces)
+//  \brief creates nspaces instances of DevExecSpace, or none for nspaces = 1 or if the
+//  instances cannot overlap
+
+void Initialize(int nspaces) {
+  if (nspaces < 1) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [ExecSpacePool::Initialize]" << std::endl
+        << "The number of execution spaces must be positive, not " << nspaces
+        << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  Finalize();
+  if (nspaces == 1) return;
+  // Instances of a host space only run concurrently if the blocks' tasks are launched
+  // from different host threads, which the task lists do not do.  Partitions of the
+  // threads would only run each kernel on fewer of them.
+  if (!SpaceInstance<DevExecSpace>::overlap()) {
+    if (Globals::my_rank == 0) {
+      std::cout << "### WARNING in function [ExecSpacePool::Initialize]" << std::endl
+                << "The instances of " << DevExecSpace::name()
+                << " do not run concurrently, using one instead of " << nspaces
+                << std::endl;
+    }
+    return;
+  }
+  for (int n = 0; n < nspaces; n++)
+    spaces.push_back(SpaceInstance<DevExecSpace>::create());
+}
+
+void Finalize() {
+  for (auto &space : spaces)
+    SpaceInstance<DevExecSpace>::destroy(space);
+  spaces.clear();
+}
+
+int Size() { return spaces.empty() ? 1 : static_cast<int>(spaces.size()); }
+
+int Index(int gid) { return gid % Size(); }
+
+DevExecSpace Get(int gid) {
+  if (spaces.empty()) return DevExecSpace();
+  return spaces[Index(gid)];
+}
+
+} // namespace ExecSpacePool
+} // namespace parthenon
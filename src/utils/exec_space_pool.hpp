@@ -0,0 +1,48 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_EXEC_SPACE_POOL_HPP_
+#define UTILS_EXEC_SPACE_POOL_HPP_
+//! \file exec_space_pool.hpp
+//  \brief execution space instances shared round-robin by the MeshBlocks
+//
+// With <parthenon/execution> nspaces = n > 1, the MeshBlocks are assigned one of n
+// instances of DevExecSpace by their gid instead of all using the default instance, so
+// that the kernels and copies of different blocks do not serialize against each other.
+// On Cuda the instances are streams.  Execution spaces whose instances cannot overlap,
+// i.e. the host spaces and Cuda with CUDA_LAUNCH_BLOCKING=1, keep a single instance and
+// warn about nspaces > 1.  With nspaces = 1 (the default) every block uses
+// DevExecSpace().
+//
+// Kernels of different blocks are no longer ordered, so data of a block that is read on
+// the host or by another block has to be fenced with the block's exec_space first.
+
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+namespace ExecSpacePool {
+
+// creates the instances, has to be called after Kokkos::initialize()
+void Initialize(int nspaces);
+// destroys the instances, has to be called before Kokkos::finalize() and after the
+// MeshBlocks are gone
+void Finalize();
+int Size();
+// the index in [0, Size()) of the instance of the MeshBlock with the given gid
+int Index(int gid);
+// the instance of the MeshBlock with the given gid
+DevExecSpace Get(int gid);
+
+} // namespace ExecSpacePool
+} // namespace parthenon
+
+#endif // UTILS_EXEC_SPACE_POOL_HPP_
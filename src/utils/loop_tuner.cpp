@@ -0,0 +1,329 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file loop_tuner.cpp
+//  \brief trials, choices and tuning file of the loop patterns
+
+#include "utils/loop_tuner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+namespace LoopTuner {
+
+namespace detail {
+bool enabled = false;
+std::array<int, 3> tile = {4, 8, 0};
+int generation = 0;
+
+using Key = std::pair<std::string, std::array<int, 4>>;
+
+struct Kernel {
+  Choice choice; // pattern none: DEFAULT_LOOP_PATTERN
+  // set to false with release semantics after the final choice is written, so that
+  // Select() reads the choice of a tuned kernel without the lock
+  std::atomic<bool> tuning{false};
+  int ntrials = 0; // timed invocations so far
+  std::vector<double> best; // by the index of the choice in candidates
+};
+
+namespace {
+bool tune = false;
+int trials = 1;
+std::string fname;
+LoopPattern pattern = LoopPattern::none;
+std::map<std::string, LoopPattern> overrides;
+std::map<Key, Choice> loaded;    // choices read from the tuning file
+std::vector<Choice> candidates; // patterns and tiles that run on DevExecSpace
+// the tiles tried for the tiled pattern besides the default one, a stencil over large
+// blocks prefers a few k and j rows per tile, a kernel streaming through the cells
+// longer rows
+const std::vector<std::array<int, 3>> tiles = {{1, 8, 0}, {2, 8, 0}, {4, 8, 0},
+                                               {4, 16, 0}, {8, 8, 0}, {8, 16, 0}};
+// std::map keeps the addresses of its elements stable
+std::map<Key, Kernel> kernels;
+std::mutex kernels_mutex;
+} // namespace
+
+Kernel *Lookup(const std::string &name, const std::array<int, 4> &shape) {
+  std::lock_guard<std::mutex> lock(kernels_mutex);
+  Key key(name, shape);
+  auto it = kernels.find(key);
+  if (it != kernels.end()) return &it->second;
+
+  // the input file takes precedence over the tuning file
+  Kernel &kernel = kernels[key];
+  auto over = overrides.find(name);
+  auto prev = loaded.find(key);
+  if (over != overrides.end()) {
+    kernel.choice.pattern = over->second;
+  } else if (pattern != LoopPattern::none) {
+    kernel.choice.pattern = pattern;
+  } else if (prev != loaded.end()) {
+    kernel.choice = prev->second;
+  } else if (tune) {
+    kernel.tuning = true;
+    kernel.best.assign(candidates.size(), std::numeric_limits<double>::max());
+  }
+  return &kernel;
+}
+
+Choice Select(Kernel *kernel, bool &trial) {
+  trial = kernel->tuning.load(std::memory_order_acquire);
+  if (!trial) return kernel->choice;
+  std::lock_guard<std::mutex> lock(kernels_mutex);
+  trial = kernel->tuning.load(std::memory_order_relaxed);
+  if (!trial) return kernel->choice;
+  return candidates[kernel->ntrials / trials];
+}
+
+void Record(Kernel *kernel, const Choice &choice, double seconds) {
+  std::lock_guard<std::mutex> lock(kernels_mutex);
+  if (!kernel->tuning.load(std::memory_order_relaxed)) return;
+  // overlapping trials of a kernel may run the same choice, so the time belongs to the
+  // choice that ran and not to the one the trial count points at
+  auto it = std::find(candidates.begin(), candidates.end(), choice);
+  if (it == candidates.end()) return;
+  // the fastest invocation of each choice counts, which discards warm-up costs
+  double &best = kernel->best[it - candidates.begin()];
+  if (seconds < best) best = seconds;
+  kernel->ntrials++;
+  if (kernel->ntrials < trials * static_cast<int>(candidates.size())) return;
+  int fastest = 0;
+  for (int n = 1; n < static_cast<int>(candidates.size()); n++) {
+    if (kernel->best[n] < kernel->best[fastest]) fastest = n;
+  }
+  kernel->choice = candidates[fastest];
+  kernel->tuning.store(false, std::memory_order_release);
+}
+
+void Fence() { Kokkos::fence(); }
+} // namespace detail
+
+namespace {
+const std::vector<std::pair<LoopPattern, std::string>> &PatternNames() {
+  static const std::vector<std::pair<LoopPattern, std::string>> names = {
+      {LoopPattern::flatrange, "flatrange"}, {LoopPattern::mdrange, "mdrange"},
+      {LoopPattern::tpttr, "tpttr"},         {LoopPattern::tptvr, "tptvr"},
+      {LoopPattern::tpttrtvr, "tpttrtvr"},   {LoopPattern::simdfor, "simdfor"},
+      {LoopPattern::tiled, "tiled"},         {LoopPattern::none, "default"}};
+  return names;
+}
+
+std::string Trim(const std::string &s) {
+  auto first = s.find_first_not_of(" \t");
+  if (first == std::string::npos) return "";
+  return s.substr(first, s.find_last_not_of(" \t") - first + 1);
+}
+} // namespace
+
+LoopPattern ParsePattern(const std::string &name) {
+  for (auto &p : PatternNames()) {
+    if (p.second == name) return p.first;
+  }
+  std::stringstream msg;
+  msg << "### FATAL ERROR in function [LoopTuner::ParsePattern]" << std::endl
+      << "Unknown loop pattern '" << name << "'" << std::endl;
+  ATHENA_ERROR(msg);
+  return LoopPattern::none;
+}
+
+std::string PatternName(LoopPattern pattern) {
+  for (auto &p : PatternNames()) {
+    if (p.first == pattern) return p.second;
+  }
+  return "default";
+}
+
+Choice ParseChoice(const std::string &name) {
+  Choice choice;
+  const auto colon = name.find(':');
+  choice.pattern = ParsePattern(name.substr(0, colon));
+  if (colon == std::string::npos) return choice;
+  std::stringstream ss(name.substr(colon + 1));
+  char x1, x2;
+  auto &t = choice.tile;
+  if (choice.pattern != LoopPattern::tiled ||
+      !(ss >> t[0] >> x1 >> t[1] >> x2 >> t[2]) || x1 != 'x' || x2 != 'x' ||
+      !ss.eof() || t[0] < 0 || t[1] < 0 || t[2] < 0) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [LoopTuner::ParseChoice]" << std::endl
+        << "Loop pattern '" << name << "' is not a pattern or 'tiled:kxjxi'"
+        << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  return choice;
+}
+
+std::string ChoiceName(const Choice &choice) {
+  const auto &t = choice.tile;
+  if (choice.pattern != LoopPattern::tiled || t == std::array<int, 3>{0, 0, 0})
+    return PatternName(choice.pattern);
+  return PatternName(choice.pattern) + ":" + std::to_string(t[0]) + "x" +
+         std::to_string(t[1]) + "x" + std::to_string(t[2]);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoopTuner::Initialize(bool tune, int trials, const std::string &fname,
+//                                 const std::string &pattern,
+//                                 const std::string &overrides)
+//  \brief sets the choices from the input file and reads the tuning file
+
+void Initialize(bool tune, int trials, const std::string &fname,
+                const std::string &pattern, const std::string &overrides) {
+  detail::tune = tune;
+  detail::trials = (trials > 0 ? trials : 1);
+  detail::fname = fname;
+  detail::pattern = ParsePattern(pattern);
+  detail::overrides.clear();
+  detail::loaded.clear();
+  {
+    std::lock_guard<std::mutex> lock(detail::kernels_mutex);
+    detail::kernels.clear();
+    detail::generation++;
+  }
+
+  // the host-only patterns cannot run kernels on a device
+  const bool host = std::is_same<DevExecSpace, Kokkos::DefaultHostExecutionSpace>::value;
+  auto &c = detail::candidates;
+  c.clear();
+  for (auto p : {LoopPattern::flatrange, LoopPattern::mdrange, LoopPattern::tpttr,
+                 LoopPattern::tpttrtvr})
+    c.push_back({p, {0, 0, 0}});
+  if (host) {
+    c.push_back({LoopPattern::tptvr, {0, 0, 0}});
+    c.push_back({LoopPattern::simdfor, {0, 0, 0}});
+    // the default tile, then the others
+    c.push_back({LoopPattern::tiled, {0, 0, 0}});
+    for (auto &t : detail::tiles) {
+      if (t != detail::tile) c.push_back({LoopPattern::tiled, t});
+    }
+  }
+
+  std::stringstream list(overrides);
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    if (Trim(item).empty()) continue;
+    auto colon = item.find_last_of(':');
+    if (colon == std::string::npos) {
+      std::stringstream msg;
+      msg << "### FATAL ERROR in function [LoopTuner::Initialize]" << std::endl
+          << "Loop pattern override '" << item << "' is not of the form 'kernel:pattern'"
+          << std::endl;
+      ATHENA_ERROR(msg);
+    }
+    detail::overrides[Trim(item.substr(0, colon))] =
+        ParsePattern(Trim(item.substr(colon + 1)));
+  }
+
+  if (!host) {
+    std::vector<LoopPattern> fixed = {detail::pattern};
+    for (auto &o : detail::overrides)
+      fixed.push_back(o.second);
+    for (auto p : fixed) {
+      if (p != LoopPattern::tptvr && p != LoopPattern::simdfor && p != LoopPattern::tiled)
+        continue;
+      std::stringstream msg;
+      msg << "### FATAL ERROR in function [LoopTuner::Initialize]" << std::endl
+          << "Loop pattern '" << PatternName(p) << "' is not available on the device"
+          << std::endl;
+      ATHENA_ERROR(msg);
+    }
+  }
+
+  // each line of the tuning file is "choice n k j i name"
+  if (tune) {
+    std::ifstream is(fname);
+    std::string line;
+    while (std::getline(is, line)) {
+      std::stringstream ss(line);
+      std::string name;
+      std::array<int, 4> shape;
+      if (!(ss >> name >> shape[0] >> shape[1] >> shape[2] >> shape[3])) continue;
+      Choice choice = ParseChoice(name);
+      std::getline(ss, name);
+      // a file tuned on another architecture may name patterns that are not available,
+      // the tile of a tiled choice is kept even if it is not one of the candidates
+      auto available = [&](const Choice &a) { return a.pattern == choice.pattern; };
+      if (std::find_if(c.begin(), c.end(), available) == c.end()) continue;
+      detail::loaded[detail::Key(Trim(name), shape)] = choice;
+    }
+  }
+
+  detail::enabled =
+      tune || detail::pattern != LoopPattern::none || !detail::overrides.empty();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoopTuner::SetTileSize(int nk, int nj, int ni)
+//  \brief sets the default tile of the tiled pattern, 0 for the whole extent
+
+void SetTileSize(int nk, int nj, int ni) {
+  if (nk < 0 || nj < 0 || ni < 0) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [LoopTuner::SetTileSize]" << std::endl
+        << "Tile " << nk << " x " << nj << " x " << ni << " has a negative extent"
+        << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  detail::tile = {nk, nj, ni};
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoopTuner::Finalize()
+//  \brief writes the choices of the tuning file and of the tuned kernels on rank 0
+
+void Finalize() {
+  if (!detail::tune || Globals::my_rank != 0) return;
+  std::map<detail::Key, Choice> choices = detail::loaded;
+  {
+    std::lock_guard<std::mutex> lock(detail::kernels_mutex);
+    for (auto &k : detail::kernels) {
+      if (k.second.tuning || k.second.choice.pattern == LoopPattern::none) continue;
+      // fixed choices from the input file are not tuning results
+      if (detail::overrides.count(k.first.first) || detail::pattern != LoopPattern::none)
+        continue;
+      choices[k.first] = k.second.choice;
+    }
+  }
+  std::ofstream os(detail::fname);
+  if (!os) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [LoopTuner::Finalize]" << std::endl
+        << "Tuning file '" << detail::fname << "' could not be opened" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  for (auto &c : choices) {
+    auto &shape = c.first.second;
+    os << ChoiceName(c.second) << " " << shape[0] << " " << shape[1] << " " << shape[2]
+       << " " << shape[3] << " " << c.first.first << std::endl;
+  }
+}
+
+} // namespace LoopTuner
+} // namespace parthenon
@@ -0,0 +1,156 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_LOOP_TUNER_HPP_
+#define UTILS_LOOP_TUNER_HPP_
+//! \file loop_tuner.hpp
+//  \brief runtime selection of the loop pattern of the default 3D and 4D par_for
+//
+// With tuning enabled (input parameter <parthenon/loop_tuning> enable = true) every
+// kernel, identified by its name and the extents of its iteration space, runs each
+// candidate loop pattern for the first few invocations.  The invocations are fenced and
+// timed, and the kernel sticks with the fastest pattern afterwards.  The choices are
+// written to a tuning file by LoopTuner::Finalize() and read again by the next run, which
+// then skips the trials.  Patterns can also be fixed for all kernels or per kernel name
+// from the input file.  Without any of this, par_for uses DEFAULT_LOOP_PATTERN as before.
+//
+// The tiled pattern splits k, j and i into tiles of TileSize() cells (input parameters
+// <parthenon/loop_tuning> tile_k, tile_j and tile_i, 0 for the whole extent) unless a
+// kernel passes its own tile to par_for.  Tuning tries the tiled pattern with the
+// default tile and a few others, and keeps the tile of the fastest one per kernel.
+
+#include <array>
+#include <chrono>
+#include <string>
+
+namespace parthenon {
+
+enum class LoopPattern {
+  flatrange,
+  mdrange,
+  tpttr,
+  tptvr,
+  tpttrtvr,
+  simdfor,
+  tiled,
+  none
+};
+
+namespace LoopTuner {
+
+// a loop pattern and, for the tiled pattern, its tile in k, j and i, where an extent of 0
+// takes the one of TileSize()
+struct Choice {
+  LoopPattern pattern = LoopPattern::none;
+  std::array<int, 3> tile = {0, 0, 0};
+};
+inline bool operator==(const Choice &a, const Choice &b) {
+  return a.pattern == b.pattern && a.tile == b.tile;
+}
+inline bool operator!=(const Choice &a, const Choice &b) { return !(a == b); }
+
+namespace detail {
+extern bool enabled;
+extern std::array<int, 3> tile;
+// incremented by Initialize(), which invalidates all kernels
+extern int generation;
+struct Kernel;
+Kernel *Lookup(const std::string &name, const std::array<int, 4> &shape);
+// the choice of the next invocation and whether it is a timed trial
+Choice Select(Kernel *kernel, bool &trial);
+void Record(Kernel *kernel, const Choice &choice, double seconds);
+void Fence();
+
+// The kernel of the last invocation of a par_for call site on this thread.  A site that
+// keeps running the same kernel skips the locked lookup by name and shape.
+struct SiteCache {
+  Kernel *kernel = nullptr;
+  int generation = -1;
+  std::array<int, 4> shape;
+  std::string name;
+};
+
+inline Kernel *Lookup(const std::string &name, const std::array<int, 4> &shape,
+                      SiteCache &cache) {
+  if (cache.kernel == nullptr || cache.generation != generation ||
+      cache.shape != shape || cache.name != name) {
+    cache.kernel = Lookup(name, shape);
+    cache.generation = generation;
+    cache.shape = shape;
+    cache.name = name;
+  }
+  return cache.kernel;
+}
+} // namespace detail
+
+inline bool Enabled() { return detail::enabled; }
+// default tile of the tiled pattern in k, j and i, set before Initialize() so that the
+// tile search does not try it twice
+inline const std::array<int, 3> &TileSize() { return detail::tile; }
+void SetTileSize(int nk, int nj, int ni);
+// tune: try all patterns for kernels without a choice, trials: timed invocations per
+// pattern, fname: tuning file, pattern: pattern of all kernels ("default" for
+// DEFAULT_LOOP_PATTERN), overrides: comma separated "kernel name:pattern" list
+void Initialize(bool tune, int trials, const std::string &fname,
+                const std::string &pattern, const std::string &overrides);
+// writes the tuned choices of rank 0 to the tuning file
+void Finalize();
+// "flatrange", "mdrange", "tpttr", "tptvr", "tpttrtvr", "simdfor", "tiled", "default"
+// (none)
+LoopPattern ParsePattern(const std::string &name);
+std::string PatternName(LoopPattern pattern);
+// the name of the pattern, followed by ":k x j x i" for a tiled choice with its own tile,
+// e.g. "tiled:2x8x0", as in the tuning file
+Choice ParseChoice(const std::string &name);
+std::string ChoiceName(const Choice &choice);
+
+//----------------------------------------------------------------------------------------
+//! \class ScopedTrial
+//  \brief selects the pattern and tile of one invocation and times it if it is a trial
+
+class ScopedTrial {
+ public:
+  ScopedTrial(const std::string &name, const std::array<int, 4> &shape)
+      : ScopedTrial(detail::Lookup(name, shape)) {}
+  ScopedTrial(const std::string &name, const std::array<int, 4> &shape,
+              detail::SiteCache &cache)
+      : ScopedTrial(detail::Lookup(name, shape, cache)) {}
+  ~ScopedTrial() {
+    if (!trial_) return;
+    detail::Fence();
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start_;
+    detail::Record(kernel_, choice_, dt.count());
+  }
+  ScopedTrial(const ScopedTrial &) = delete;
+  ScopedTrial &operator=(const ScopedTrial &) = delete;
+
+  LoopPattern pattern() const { return choice_.pattern; }
+  const Choice &choice() const { return choice_; }
+
+ private:
+  explicit ScopedTrial(detail::Kernel *kernel) : kernel_(kernel) {
+    choice_ = detail::Select(kernel_, trial_);
+    if (!trial_) return;
+    detail::Fence();
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  detail::Kernel *kernel_;
+  Choice choice_;
+  bool trial_ = false;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace LoopTuner
+} // namespace parthenon
+
+#endif // UTILS_LOOP_TUNER_HPP_
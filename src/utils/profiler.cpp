@@ -0,0 +1,190 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file profiler.cpp
+//  \brief collects the timing regions and writes the JSON summary
+
+#include "utils/profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parthenon_mpi.hpp"
+
+namespace parthenon {
+namespace Profiler {
+
+namespace detail {
+bool enabled = false, fence_kernels = false;
+
+namespace {
+// std::map keeps the addresses of its elements stable, so regions can hold on to them
+std::map<std::string, RegionStats> regions;
+std::mutex regions_mutex;
+} // namespace
+
+RegionStats *Lookup(const std::string &name) {
+  std::lock_guard<std::mutex> lock(regions_mutex);
+  return &regions[name];
+}
+
+void Record(RegionStats *stats, double seconds) {
+  std::lock_guard<std::mutex> lock(regions_mutex);
+  if (stats->calls == 0 || seconds < stats->min) stats->min = seconds;
+  if (stats->calls == 0 || seconds > stats->max) stats->max = seconds;
+  stats->calls++;
+  stats->total += seconds;
+}
+
+void PushKokkosRegion(const std::string &name) { Kokkos::Profiling::pushRegion(name); }
+void PopKokkosRegion() { Kokkos::Profiling::popRegion(); }
+void Fence() { Kokkos::fence(); }
+} // namespace detail
+
+void Initialize(bool enabled, bool fence_kernels) {
+  detail::enabled = enabled;
+  detail::fence_kernels = fence_kernels;
+}
+
+void Reset() {
+  std::lock_guard<std::mutex> lock(detail::regions_mutex);
+  detail::regions.clear();
+}
+
+namespace {
+// statistics of a region over all ranks
+struct GlobalStats {
+  int ranks = 0;
+  std::uint64_t calls = 0;
+  double time_min = std::numeric_limits<double>::max(), time_max = 0.0, time_sum = 0.0;
+  double call_min = std::numeric_limits<double>::max(), call_max = 0.0;
+};
+
+std::string EscapeJSON(const std::string &s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out += ' ';
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Profiler::Finalize(const std::string &fname)
+//  \brief gathers the regions of all ranks on rank 0 and writes the summary
+
+void Finalize(const std::string &fname) {
+  if (!Enabled()) return;
+
+  // flatten the local regions: names separated by '\0', four values per region
+  std::string names;
+  std::vector<double> values;
+  {
+    std::lock_guard<std::mutex> lock(detail::regions_mutex);
+    for (auto &r : detail::regions) {
+      if (r.second.calls == 0) continue;
+      names += r.first;
+      names += '\0';
+      values.push_back(static_cast<double>(r.second.calls));
+      values.push_back(r.second.total);
+      values.push_back(r.second.min);
+      values.push_back(r.second.max);
+    }
+  }
+
+  std::vector<char> all_names(names.begin(), names.end());
+  std::vector<double> all_values(values);
+#ifdef MPI_PARALLEL
+  int nlen = names.size(), nval = values.size();
+  std::vector<int> lens(Globals::nranks), vals(Globals::nranks);
+  MPI_Gather(&nlen, 1, MPI_INT, lens.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Gather(&nval, 1, MPI_INT, vals.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<int> len_disp(Globals::nranks, 0), val_disp(Globals::nranks, 0);
+  for (int i = 1; i < Globals::nranks; i++) {
+    len_disp[i] = len_disp[i - 1] + lens[i - 1];
+    val_disp[i] = val_disp[i - 1] + vals[i - 1];
+  }
+  if (Globals::my_rank == 0) {
+    all_names.resize(len_disp.back() + lens.back());
+    all_values.resize(val_disp.back() + vals.back());
+  }
+  MPI_Gatherv(names.data(), nlen, MPI_CHAR, all_names.data(), lens.data(),
+              len_disp.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+  MPI_Gatherv(values.data(), nval, MPI_DOUBLE, all_values.data(), vals.data(),
+              val_disp.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+  if (Globals::my_rank != 0) return;
+
+  // every rank contributes each of its regions once, in the order of its names
+  std::map<std::string, GlobalStats> global;
+  std::size_t pos = 0, iv = 0;
+  while (pos < all_names.size()) {
+    std::string name(&all_names[pos]);
+    pos += name.size() + 1;
+    auto &g = global[name];
+    double total = all_values[iv + 1];
+    g.ranks++;
+    g.calls += static_cast<std::uint64_t>(all_values[iv]);
+    g.time_min = std::min(g.time_min, total);
+    g.time_max = std::max(g.time_max, total);
+    g.time_sum += total;
+    g.call_min = std::min(g.call_min, all_values[iv + 2]);
+    g.call_max = std::max(g.call_max, all_values[iv + 3]);
+    iv += 4;
+  }
+
+  // most expensive regions first
+  std::vector<std::pair<std::string, GlobalStats>> sorted(global.begin(), global.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    return a.second.time_max > b.second.time_max;
+  });
+
+  std::ofstream os(fname);
+  if (!os) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [Profiler::Finalize]" << std::endl
+        << "Profile file '" << fname << "' could not be opened" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  os << std::setprecision(9);
+  os << "{\n  \"nranks\": " << Globals::nranks << ",\n  \"regions\": [";
+  for (std::size_t n = 0; n < sorted.size(); n++) {
+    auto &g = sorted[n].second;
+    os << (n == 0 ? "\n" : ",\n") << "    {\"name\": \"" << EscapeJSON(sorted[n].first)
+       << "\", \"ranks\": " << g.ranks << ", \"calls\": " << g.calls
+       << ", \"time_min\": " << g.time_min
+       << ", \"time_avg\": " << g.time_sum / g.ranks << ", \"time_max\": " << g.time_max
+       << ", \"call_min\": " << g.call_min << ", \"call_max\": " << g.call_max << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+} // namespace Profiler
+} // namespace parthenon
@@ -0,0 +1,88 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_PROFILER_HPP_
+#define UTILS_PROFILER_HPP_
+//! \file profiler.hpp
+//  \brief named timing regions for tasks, kernels and communication
+//
+// Regions are timed only when profiling was enabled at runtime (input parameter
+// <parthenon/profiling> enable = true); otherwise constructing a region costs a single
+// branch.  Regions with the same name are accumulated, and Profiler::Finalize() writes
+// per-region call counts and min/avg/max times across ranks as JSON.  Regions are also
+// reported to Kokkos tools through Kokkos::Profiling::pushRegion/popRegion.
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace parthenon {
+namespace Profiler {
+
+struct RegionStats {
+  std::uint64_t calls = 0;
+  double total = 0.0, min = 0.0, max = 0.0; // seconds, min/max per call
+};
+
+namespace detail {
+extern bool enabled, fence_kernels;
+RegionStats *Lookup(const std::string &name);
+void Record(RegionStats *stats, double seconds);
+void PushKokkosRegion(const std::string &name);
+void PopKokkosRegion();
+void Fence();
+} // namespace detail
+
+inline bool Enabled() { return detail::enabled; }
+// with fence_kernels every timed kernel region waits for the kernel to complete, so that
+// asynchronous back ends report execution rather than launch times
+void Initialize(bool enabled, bool fence_kernels = false);
+// reduces the timings of all ranks and writes them to fname on rank 0
+void Finalize(const std::string &fname);
+// discards all timings collected so far
+void Reset();
+
+//----------------------------------------------------------------------------------------
+//! \class ScopedRegion
+//  \brief times the lifetime of the object under the given name
+
+class ScopedRegion {
+ public:
+  // kernel regions are not pushed to Kokkos tools, which already see the parallel
+  // dispatch under the same name
+  explicit ScopedRegion(const std::string &name, bool kernel = false) {
+    if (!Enabled()) return;
+    kernel_ = kernel;
+    stats_ = detail::Lookup(name);
+    if (!kernel_) detail::PushKokkosRegion(name);
+    start_ = std::chrono::steady_clock::now();
+  }
+  ~ScopedRegion() {
+    if (stats_ == nullptr) return;
+    if (kernel_ && detail::fence_kernels) detail::Fence();
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start_;
+    detail::Record(stats_, dt.count());
+    if (!kernel_) detail::PopKokkosRegion();
+  }
+  ScopedRegion(const ScopedRegion &) = delete;
+  ScopedRegion &operator=(const ScopedRegion &) = delete;
+
+ private:
+  RegionStats *stats_ = nullptr;
+  bool kernel_ = false;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace Profiler
+} // namespace parthenon
+
+#endif // UTILS_PROFILER_HPP_
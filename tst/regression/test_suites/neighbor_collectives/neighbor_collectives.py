@@ -0,0 +1,36 @@
+#========================================================================================
+# Athena++ astrophysical MHD code
+# Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+# Licensed under the 3-clause BSD License, see LICENSE file for details
+#========================================================================================
+# (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+#
+# This program was produced under U.S. Government contract 89233218CNA000001 for Los
+# Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+# for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+# in the program are reserved by Triad National Security, LLC, and the U.S. Department
+# of Energy/National Nuclear Security Administration. The Government is granted for
+# itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+# license in this material to reproduce, prepare derivative works, distribute copies to
+# the public, perform publicly and display publicly, and to permit others to do so.
+#========================================================================================
+
+# Modules
+import sys
+import utils.toggle_comparison
+
+""" To prevent littering up imported folders with .pyc files or __pycache_ folder"""
+sys.dont_write_bytecode = True
+
+class TestCase(utils.toggle_comparison.ToggleComparison):
+    """
+    Runs the advection example with point-to-point messages as the reference.  The driver
+    then runs with one neighborhood collective per round, e.g. with --mpirun_opts=-np\ 4.
+    Both runs are profiled and report their time per cycle.  The final outputs have to
+    agree exactly.
+    """
+    reference_toggle = 'parthenon/mpi/exchange=point_to_point'
+    driver_id = 'collective'
+    reference_label = 'point_to_point'
+    driver_label = 'neighborhood'
+    time_cycles = True
@@ -0,0 +1,34 @@
+#========================================================================================
+# Athena++ astrophysical MHD code
+# Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+# Licensed under the 3-clause BSD License, see LICENSE file for details
+#========================================================================================
+# (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+#
+# This program was produced under U.S. Government contract 89233218CNA000001 for Los
+# Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+# for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+# in the program are reserved by Triad National Security, LLC, and the U.S. Department
+# of Energy/National Nuclear Security Administration. The Government is granted for
+# itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+# license in this material to reproduce, prepare derivative works, distribute copies to
+# the public, perform publicly and display publicly, and to permit others to do so.
+#========================================================================================
+
+# Modules
+import sys
+import utils.toggle_comparison
+
+""" To prevent littering up imported folders with .pyc files or __pycache_ folder"""
+sys.dont_write_bytecode = True
+
+class TestCase(utils.toggle_comparison.ToggleComparison):
+    """
+    Runs the advection example with the MPI requests completed by the tasks as the
+    reference.  The driver then runs with the progress thread completing them, e.g. with
+    --mpirun_opts=-np\ 4.  The final outputs of both runs have to agree exactly.
+    """
+    reference_toggle = 'parthenon/mpi/progress_thread=false'
+    driver_id = 'progress'
+    reference_label = 'polling by the tasks'
+    driver_label = 'progress thread'
@@ -0,0 +1,145 @@
+#========================================================================================
+# Athena++ astrophysical MHD code
+# Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+# Licensed under the 3-clause BSD License, see LICENSE file for details
+#========================================================================================
+# (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+#
+# This program was produced under U.S. Government contract 89233218CNA000001 for Los
+# Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+# for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+# in the program are reserved by Triad National Security, LLC, and the U.S. Department
+# of Energy/National Nuclear Security Administration. The Government is granted for
+# itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+# license in this material to reproduce, prepare derivative works, distribute copies to
+# the public, perform publicly and display publicly, and to permit others to do so.
+#========================================================================================
+
+# Modules
+import glob
+import os
+import re
+import struct
+import sys
+import xml.etree.ElementTree as ET
+import numpy as np
+import utils.test_case
+
+""" To prevent littering up imported folders with .pyc files or __pycache_ folder"""
+sys.dont_write_bytecode = True
+
+# bytes per value of the VTK data types the writer uses
+type_sizes = {'Float32': 4, 'Float64': 8, 'Int32': 4, 'UInt8': 1}
+type_codes = {'Float32': 'f4', 'Float64': 'f8', 'Int32': 'i4', 'UInt8': 'u1'}
+
+def read_vtu(fname, ndim):
+    """
+    Reads a .vtu file of the writer and checks that the appended arrays follow each other
+    at the offsets given in the XML header, with size headers that match the shape of
+    each array.  Returns the type of the values and, for each variable, the values of
+    all Pieces in the order of the file.
+    """
+    with open(fname, 'rb') as f:
+        data = f.read()
+    marker = b'<AppendedData encoding="raw">\n_'
+    pos = data.find(marker)
+    if pos < 0:
+        raise ValueError(fname + ": no appended data")
+    header = data[:pos].decode()
+    base = pos + len(marker)
+    order = '<' if 'byte_order="LittleEndian"' in header else '>'
+
+    values = {}
+    value_type = None
+    offset = 0
+    for piece in re.finditer(r'<Piece NumberOfPoints="(\d+)" NumberOfCells="(\d+)">'
+                             r'(.*?)</Piece>', header, re.S):
+        npoints, ncells = int(piece.group(1)), int(piece.group(2))
+        for array in re.finditer(r'<DataArray ([^>]*)/>', piece.group(3)):
+            attrs = dict(re.findall(r'(\w+)="([^"]*)"', array.group(1)))
+            if attrs['format'] != 'appended':
+                raise ValueError(fname + ": array not appended")
+            if int(attrs['offset']) != offset:
+                raise ValueError(fname + ": offset %s, expected %d" %
+                                 (attrs['offset'], offset))
+            name = attrs.get('Name', 'Points')
+            ncomp = int(attrs.get('NumberOfComponents', '1'))
+            if name == 'Points':
+                count = 3 * npoints
+            elif name == 'connectivity':
+                count = (1 << ndim) * ncells
+            else:
+                count = ncomp * ncells
+            nbytes = struct.unpack(order + 'Q', data[base + offset:base + offset + 8])[0]
+            if nbytes != count * type_sizes[attrs['type']]:
+                raise ValueError(fname + ": array %s has %d bytes, expected %d" %
+                                 (name, nbytes, count * type_sizes[attrs['type']]))
+            start = base + offset + 8
+            if name not in ['Points', 'connectivity', 'offsets', 'types']:
+                value_type = attrs['type']
+                values.setdefault(name, []).append(
+                    np.frombuffer(data[start:start + nbytes],
+                                  dtype=order + type_codes[attrs['type']]))
+            offset += 8 + nbytes
+    if not data[base + offset:].startswith(b'\n  </AppendedData>'):
+        raise ValueError(fname + ": appended data does not end after the last array")
+    return value_type, {name: np.concatenate(v) for name, v in values.items()}
+
+class TestCase(utils.test_case.TestCaseAbs):
+    def Prepare(self,parameters):
+        return parameters
+
+    def Analyse(self,parameters):
+        """
+        Checks the .vtm index and the .vtu files of the last double (out0) and single
+        (out1) precision outputs.  Both have to hold the same values up to single
+        precision.
+        """
+        results = {}
+        for output_id, value_type in [('out0', 'Float64'), ('out1', 'Float32')]:
+            indices = sorted(glob.glob(os.path.join(parameters.output_path,
+                                                    'advection.' + output_id + '.*.vtm')))
+            if len(indices) == 0:
+                print("No index file of " + output_id)
+                return False
+            root = ET.parse(indices[-1]).getroot()
+            datasets = root.findall('./vtkMultiBlockDataSet/DataSet')
+            if len(datasets) == 0:
+                print(indices[-1] + " lists no rank files")
+                return False
+            values = {}
+            for n, dataset in enumerate(datasets):
+                if int(dataset.get('index')) != n:
+                    print(indices[-1] + ": data set indices are not consecutive")
+                    return False
+                fname = os.path.join(os.path.dirname(indices[-1]), dataset.get('file'))
+                if not os.path.isfile(fname):
+                    print(fname + " is listed in the index but missing")
+                    return False
+                try:
+                    vtype, rank_values = read_vtu(fname, 2)
+                except ValueError as err:
+                    print(err)
+                    return False
+                if vtype != value_type:
+                    print(fname + ": values are " + vtype + ", expected " + value_type)
+                    return False
+                for name, v in rank_values.items():
+                    values.setdefault(name, []).append(v)
+            results[output_id] = {name: np.concatenate(v) for name, v in values.items()}
+
+        for name in ['advected', 'one_minus_advected']:
+            if name not in results['out0'] or name not in results['out1']:
+                print("Variable " + name + " is missing")
+                return False
+            double, single = results['out0'][name], results['out1'][name]
+            # the mesh has 32x32 cells
+            if double.size != 32 * 32 or single.size != double.size:
+                print("Variable %s has %d and %d values" %
+                      (name, double.size, single.size))
+                return False
+            if not np.allclose(double, single.astype(np.float64), rtol=1e-6,
+                               atol=1e-7):
+                print("Single and double precision values of " + name + " differ")
+                return False
+        return True
@@ -0,0 +1,118 @@
+#========================================================================================
+# (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+#
+# This program was produced under U.S. Government contract 89233218CNA000001 for Los
+# Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+# for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+# in the program are reserved by Triad National Security, LLC, and the U.S. Department
+# of Energy/National Nuclear Security Administration. The Government is granted for
+# itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+# license in this material to reproduce, prepare derivative works, distribute copies to
+# the public, perform publicly and display publicly, and to permit others to do so.
+#========================================================================================
+
+# Modules
+import glob
+import json
+import os
+import subprocess
+import sys
+import h5py
+import numpy as np
+import utils.test_case
+
+""" To prevent littering up imported folders with .pyc files or __pycache_ folder"""
+sys.dont_write_bytecode = True
+
+class ToggleComparison(utils.test_case.TestCaseAbs):
+    """
+    A test that runs the driver twice, once as the reference with one input parameter
+    toggled from the command line and once as set in parthinput.regression, and requires
+    the final outputs of both runs to agree exactly.  A test suite derives its TestCase
+    from this class and sets the attributes below.
+    """
+    # the input parameter of the reference run, e.g. 'parthenon/mpi/shared_memory=false'
+    reference_toggle = None
+    # the problem_id of the run as set in parthinput.regression
+    driver_id = None
+    # the names of the reference and the driver run in the messages
+    reference_label = 'reference'
+    driver_label = 'driver'
+    # the variables compared in the final outputs
+    variables = ['advected']
+    # whether both runs are profiled to report their time per cycle
+    time_cycles = False
+
+    reference_id = 'reference'
+    # the profiler region that encloses each cycle of the driver
+    cycle_region = 'EvolutionDriver::Cycle'
+
+    def Prepare(self,parameters):
+        """
+        Runs the reference.  The driver itself is run by the test manager afterwards.
+        """
+        reference = []
+        if parameters.mpi_cmd != "":
+            reference.extend(parameters.mpi_cmd)
+        for opt in parameters.mpi_opts:
+            reference.extend(opt.split())
+        reference.extend([parameters.driver_path, '-i', parameters.driver_input_path,
+                          'parthenon/job/problem_id=' + self.reference_id,
+                          self.reference_toggle])
+        if self.time_cycles:
+            reference.extend(self.__ProfilingArgs(self.reference_id))
+            parameters.driver_cmd_line_args = (list(parameters.driver_cmd_line_args) +
+                                               self.__ProfilingArgs(self.driver_id))
+        subprocess.check_call(reference)
+        return parameters
+
+    def Analyse(self,parameters):
+        """
+        Reports the time per cycle of both runs if they were profiled.  The final outputs
+        have to agree exactly.
+        """
+        if self.time_cycles:
+            reference_time = self.__CycleTime(parameters, self.reference_id)
+            driver_time = self.__CycleTime(parameters, self.driver_id)
+            if reference_time is None or driver_time is None:
+                print("Profiles not found")
+                return False
+            print("Time per cycle %s: %.3e s, %s: %.3e s" %
+                  (self.reference_label, reference_time, self.driver_label, driver_time))
+
+        reference = self.__LastOutput(parameters, self.reference_id)
+        driver = self.__LastOutput(parameters, self.driver_id)
+        if reference is None or driver is None:
+            print("Outputs not found")
+            return False
+
+        with h5py.File(reference, 'r') as f_ref, h5py.File(driver, 'r') as f_drv:
+            for var in self.variables:
+                if not np.array_equal(f_ref[var][()], f_drv[var][()]):
+                    print("%s of %s differs from %s" %
+                          (var, self.driver_label, self.reference_label))
+                    return False
+        return True
+
+    def __ProfilingArgs(self, problem_id):
+        return ['parthenon/profiling/enable=true',
+                'parthenon/profiling/file=' + problem_id + '.profile.json']
+
+    def __CycleTime(self, parameters, problem_id):
+        """
+        The time per cycle of the slowest rank, None without a profile of the cycles.
+        """
+        fname = os.path.join(parameters.output_path, problem_id + '.profile.json')
+        if not os.path.isfile(fname):
+            return None
+        with open(fname, 'r') as f:
+            profile = json.load(f)
+        for region in profile['regions']:
+            if region['name'] == self.cycle_region and region['calls'] > 0:
+                return region['time_max'] * region['ranks'] / region['calls']
+        return None
+
+    def __LastOutput(self, parameters, problem_id):
+        files = sorted(glob.glob(os.path.join(parameters.output_path,
+                                              problem_id + '.out0.*.phdf')))
+        return files[-1] if len(files) > 0 else None
@@ -236,6 +236,28 @@ TEST_CASE("par_for loops", "[wrapper]") {
 
     REQUIRE(test_wrapper_3d(parthenon::loop_pattern_simdfor_tag, default_exec_space) ==
             true);
+
+    REQUIRE(test_wrapper_3d(parthenon::loop_pattern_tiled_tag, default_exec_space) ==
+            true);
+
+    // tiles that do not divide the loop
+    REQUIRE(test_wrapper_3d(parthenon::LoopPatternTiled{3, 5, 7}, default_exec_space) ==
+            true);
+
+    // empty ranges, e.g. the ghost zones of a direction without any, run no iterations
+    Kokkos::View<int> count("count");
+    parthenon::par_for(
+        parthenon::LoopPatternTiled{2, 2, 2}, "empty 3D", default_exec_space, 1, 0, 0,
+        3, 0, 3, KOKKOS_LAMBDA(const int k, const int j, const int i) {
+          Kokkos::atomic_add(&count(), 1);
+        });
+    parthenon::par_for(
+        parthenon::loop_pattern_tiled_tag, "empty 4D", default_exec_space, 0, 1, 0, 3,
+        0, 3, 2, 1, KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          Kokkos::atomic_add(&count(), 1);
+        });
+    auto count_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), count);
+    REQUIRE(count_host() == 0);
 #endif
   }
 
@@ -258,10 +280,280 @@ TEST_CASE("par_for loops", "[wrapper]") {
 
     REQUIRE(test_wrapper_4d(parthenon::loop_pattern_simdfor_tag, default_exec_space) ==
             true);
+
+    REQUIRE(test_wrapper_4d(parthenon::loop_pattern_tiled_tag, default_exec_space) ==
+            true);
+
+    // tiles that do not divide the loop
+    REQUIRE(test_wrapper_4d(parthenon::LoopPatternTiled{3, 5, 7}, default_exec_space) ==
+            true);
 #endif
   }
 }
 
+// fills arr(k, j, i) with i + N * (j + N * k), which sums up exactly
+template <class T>
+bool test_reduce_3d(T loop_pattern, DevExecSpace exec_space) {
+  const int N = 32;
+  ParArray3D<Real> arr_dev("device", N, N, N);
+  parthenon::par_for(
+      "fill 3D", exec_space, 0, N - 1, 0, N - 1, 0, N - 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        arr_dev(k, j, i) = static_cast<Real>(i + N * (j + N * k));
+      });
+
+  // sum, min and max at once over the interior
+  Real sum = 0.0, min = 0.0, max = 0.0;
+  parthenon::par_reduce(
+      loop_pattern, "unit test reduce 3D", exec_space, 1, N - 2, 1, N - 2, 1, N - 2,
+      KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lsum, Real &lmin,
+                    Real &lmax) {
+        lsum += arr_dev(k, j, i);
+        lmin = (arr_dev(k, j, i) < lmin ? arr_dev(k, j, i) : lmin);
+        lmax = (arr_dev(k, j, i) > lmax ? arr_dev(k, j, i) : lmax);
+      },
+      sum, Kokkos::Min<Real>(min), Kokkos::Max<Real>(max));
+
+  Real sum_host = 0.0;
+  for (int k = 1; k < N - 1; k++)
+    for (int j = 1; j < N - 1; j++)
+      for (int i = 1; i < N - 1; i++)
+        sum_host += static_cast<Real>(i + N * (j + N * k));
+
+  return sum == sum_host && min == 1 + N * (1 + N) &&
+         max == (N - 2) + N * ((N - 2) + N * (N - 2));
+}
+
+template <class T>
+bool test_reduce_4d(T loop_pattern, DevExecSpace exec_space) {
+  const int N = 16;
+  ParArray4D<Real> arr_dev("device", 3, N, N, N);
+  parthenon::par_for(
+      "fill 4D", exec_space, 0, 2, 0, N - 1, 0, N - 1, 0, N - 1,
+      KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+        arr_dev(n, k, j, i) = static_cast<Real>(i + N * (j + N * (k + N * n)));
+      });
+
+  Real max = 0.0;
+  parthenon::par_reduce(
+      loop_pattern, "unit test reduce 4D", exec_space, 0, 1, 0, N - 1, 0, N - 1, 0,
+      N - 1,
+      KOKKOS_LAMBDA(const int n, const int k, const int j, const int i, Real &lmax) {
+        lmax = (arr_dev(n, k, j, i) > lmax ? arr_dev(n, k, j, i) : lmax);
+      },
+      Kokkos::Max<Real>(max));
+
+  return max == 2 * N * N * N - 1;
+}
+
+TEST_CASE("par_reduce loops", "[wrapper]") {
+  auto default_exec_space = DevExecSpace();
+
+  SECTION("1D and 2D sums") {
+    const int N = 100;
+    int sum_1d = 0;
+    parthenon::par_reduce(
+        "unit test reduce 1D", default_exec_space, 1, N,
+        KOKKOS_LAMBDA(const int i, int &lsum) { lsum += i; }, sum_1d);
+    REQUIRE(sum_1d == N * (N + 1) / 2);
+
+    int sum_2d = 0;
+    parthenon::par_reduce(
+        "unit test reduce 2D", default_exec_space, 0, N - 1, 0, N - 1,
+        KOKKOS_LAMBDA(const int j, const int i, int &lsum) { lsum += (i == j); },
+        sum_2d);
+    REQUIRE(sum_2d == N);
+  }
+
+  SECTION("3D reductions") {
+    REQUIRE(test_reduce_3d(parthenon::loop_pattern_flatrange_tag, default_exec_space) ==
+            true);
+    REQUIRE(test_reduce_3d(parthenon::loop_pattern_mdrange_tag, default_exec_space) ==
+            true);
+  }
+
+  SECTION("4D reductions") {
+    REQUIRE(test_reduce_4d(parthenon::loop_pattern_flatrange_tag, default_exec_space) ==
+            true);
+    REQUIRE(test_reduce_4d(parthenon::loop_pattern_mdrange_tag, default_exec_space) ==
+            true);
+  }
+
+  SECTION("5D reductions") {
+    int count = 0;
+    Real max = 0.0;
+    parthenon::par_reduce(
+        "unit test reduce 5D", default_exec_space, 0, 1, 0, 2, 0, 3, 0, 4, 0, 5,
+        KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i,
+                      int &lcount, Real &lmax) {
+          lcount += 1;
+          const Real v = static_cast<Real>(m + n + k + j + i);
+          lmax = (v > lmax ? v : lmax);
+        },
+        count, Kokkos::Max<Real>(max));
+    REQUIRE(count == 2 * 3 * 4 * 5 * 6);
+    REQUIRE(max == 1 + 2 + 3 + 4 + 5);
+  }
+}
+
+TEST_CASE("par_scan loops", "[wrapper]") {
+  auto default_exec_space = DevExecSpace();
+
+  SECTION("1D exclusive scan") {
+    const int N = 100;
+    ParArray1D<int> offset("offset", N);
+    int total = 0;
+    parthenon::par_scan(
+        "unit test scan 1D", default_exec_space, 0, N - 1,
+        KOKKOS_LAMBDA(const int i, int &update, const bool final) {
+          if (final) offset(i) = update;
+          update += i;
+        },
+        total);
+    auto offset_h = Kokkos::create_mirror_view(offset);
+    Kokkos::deep_copy(offset_h, offset);
+
+    REQUIRE(total == N * (N - 1) / 2);
+    bool all_same = true;
+    for (int i = 0; i < N; i++)
+      if (offset_h(i) != i * (i - 1) / 2) all_same = false;
+    REQUIRE(all_same == true);
+  }
+
+  SECTION("3D inclusive scan in lexicographic order") {
+    const int N = 8;
+    ParArray3D<int> count("count", N, N, N);
+    int total = 0;
+    parthenon::par_scan(
+        "unit test scan 3D", default_exec_space, 0, N - 1, 0, N - 1, 0, N - 1,
+        KOKKOS_LAMBDA(const int k, const int j, const int i, int &update,
+                      const bool final) {
+          update += 1;
+          if (final) count(k, j, i) = update;
+        },
+        total);
+    auto count_h = Kokkos::create_mirror_view(count);
+    Kokkos::deep_copy(count_h, count);
+
+    REQUIRE(total == N * N * N);
+    bool all_same = true;
+    for (int k = 0; k < N; k++)
+      for (int j = 0; j < N; j++)
+        for (int i = 0; i < N; i++)
+          if (count_h(k, j, i) != i + N * (j + N * k) + 1) all_same = false;
+    REQUIRE(all_same == true);
+  }
+}
+
+TEST_CASE("par_reduce versus host loops", "[wrapper][performance]") {
+  auto default_exec_space = DevExecSpace();
+  const int N = 128;
+  const int nrep = 10;
+  ParArray3D<Real> arr_dev("device", N, N, N);
+  parthenon::par_for(
+      "fill", default_exec_space, 0, N - 1, 0, N - 1, 0, N - 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        arr_dev(k, j, i) = static_cast<Real>((i + j + k) % 7);
+      });
+  auto arr_host = Kokkos::create_mirror_view(arr_dev);
+  Kokkos::deep_copy(arr_host, arr_dev);
+
+  // the reductions of the examples used to be serial loops on the host
+  Kokkos::Timer timer;
+  Real sum_host = 0.0, max_host = 0.0;
+  for (int n = 0; n < nrep; n++) {
+    sum_host = 0.0;
+    max_host = 0.0;
+    for (int k = 0; k < N; k++)
+      for (int j = 0; j < N; j++)
+        for (int i = 0; i < N; i++) {
+          sum_host += arr_host(k, j, i);
+          max_host = (arr_host(k, j, i) > max_host ? arr_host(k, j, i) : max_host);
+        }
+  }
+  auto time_host = timer.seconds();
+
+  timer.reset();
+  Real sum = 0.0, max = 0.0;
+  for (int n = 0; n < nrep; n++) {
+    parthenon::par_reduce(
+        "sum and max", default_exec_space, 0, N - 1, 0, N - 1, 0, N - 1,
+        KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lsum, Real &lmax) {
+          lsum += arr_dev(k, j, i);
+          lmax = (arr_dev(k, j, i) > lmax ? arr_dev(k, j, i) : lmax);
+        },
+        sum, Kokkos::Max<Real>(max));
+  }
+  auto time_reduce = timer.seconds();
+
+  std::cout << "par_reduce versus host loops" << std::endl;
+  std::cout << "time host loop: " << time_host / nrep << std::endl;
+  std::cout << "time par_reduce: " << time_reduce / nrep << std::endl;
+
+  REQUIRE(sum == sum_host);
+  REQUIRE(max == max_host);
+}
+
+#ifndef KOKKOS_ENABLE_CUDA
+// seconds per application of a 7 point stencil to nvar variables of an N^3 block
+template <class T>
+double time_stencil(T loop_pattern, ParArray4D<Real> in, ParArray4D<Real> out,
+                    const int nrep) {
+  const int nvar = in.extent(0);
+  const int N = in.extent(1);
+  Kokkos::Timer timer;
+  for (int r = 0; r < nrep; r++) {
+    parthenon::par_for(
+        loop_pattern, "stencil", DevExecSpace(), 0, nvar - 1, 1, N - 2, 1, N - 2, 1,
+        N - 2, KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          out(n, k, j, i) = in(n, k, j, i + 1) + in(n, k, j, i - 1) +
+                            in(n, k, j + 1, i) + in(n, k, j - 1, i) +
+                            in(n, k + 1, j, i) + in(n, k - 1, j, i) -
+                            6.0 * in(n, k, j, i);
+        });
+  }
+  Kokkos::fence();
+  return timer.seconds() / nrep;
+}
+
+TEST_CASE("Stencil throughput of the tiled loop pattern", "[wrapper][performance]") {
+  const int nvar = 5;
+  const int nrep = 10;
+  // at most 3 arrays of 35 MB
+  for (int N : {32, 64, 96}) {
+    ParArray4D<Real> in("in", nvar, N, N, N);
+    ParArray4D<Real> out_flat("out", nvar, N, N, N);
+    ParArray4D<Real> out_tiled("out", nvar, N, N, N);
+    parthenon::par_for(
+        "fill", DevExecSpace(), 0, nvar - 1, 0, N - 1, 0, N - 1, 0, N - 1,
+        KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          in(n, k, j, i) = static_cast<Real>((n + 3 * i + 5 * j + 7 * k) % 11);
+        });
+
+    const double cells = static_cast<double>(nvar) * (N - 2) * (N - 2) * (N - 2);
+    const double t_flat =
+        time_stencil(parthenon::loop_pattern_flatrange_tag, in, out_flat, nrep);
+    const double t_simd =
+        time_stencil(parthenon::loop_pattern_simdfor_tag, in, out_flat, nrep);
+    const double t_tiled =
+        time_stencil(parthenon::loop_pattern_tiled_tag, in, out_tiled, nrep);
+    std::cout << "7 point stencil on " << nvar << " x " << N << "^3, Mcells/s: flatrange "
+              << 1e-6 * cells / t_flat << ", simdfor " << 1e-6 * cells / t_simd
+              << ", tiled " << 1e-6 * cells / t_tiled << std::endl;
+
+    auto flat_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), out_flat);
+    auto tiled_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), out_tiled);
+    bool all_same = true;
+    for (int n = 0; n < nvar; n++)
+      for (int k = 0; k < N; k++)
+        for (int j = 0; j < N; j++)
+          for (int i = 0; i < N; i++)
+            if (flat_h(n, k, j, i) != tiled_h(n, k, j, i)) all_same = false;
+    REQUIRE(all_same == true);
+  }
+}
+#endif
+
 template <class OuterLoopPattern, class InnerLoopPattern>
 bool test_wrapper_nested_3d(OuterLoopPattern outer_loop_pattern,
                             InnerLoopPattern inner_loop_pattern,
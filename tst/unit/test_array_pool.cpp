@@ -0,0 +1,78 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "kokkos_abstraction.hpp"
+#include "parthenon_arrays.hpp"
+#include "utils/array_pool.hpp"
+
+using parthenon::Real;
+namespace ArrayPool = parthenon::ArrayPool;
+
+// sum of all elements of a 3D array
+static Real Sum(parthenon::ParArrayND<Real> a) {
+  auto a_h = a.GetHostMirrorAndCopy();
+  Real sum = 0.0;
+  for (int k = 0; k < a.GetDim(3); k++)
+    for (int j = 0; j < a.GetDim(2); j++)
+      for (int i = 0; i < a.GetDim(1); i++)
+        sum += a_h(k, j, i);
+  return sum;
+}
+
+TEST_CASE("ArrayPool recycles released arrays", "[ArrayPool]") {
+  GIVEN("An enabled pool") {
+    ArrayPool::Initialize(true);
+    ArrayPool::Release();
+    const auto before = ArrayPool::GetStats();
+
+    WHEN("An array is filled and released") {
+      Real *data;
+      {
+        auto a = ArrayPool::Get<Real>("pool_test", 1, 1, 1, 4, 5, 6);
+        data = a.Get().data();
+        parthenon::par_for(
+            "fill", parthenon::DevExecSpace(), 0, 3, 0, 4, 0, 5,
+            KOKKOS_LAMBDA(const int k, const int j, const int i) { a(k, j, i) = 1.0; });
+        REQUIRE(Sum(a) == 120.0);
+        REQUIRE(ArrayPool::BytesInUse() == 120 * sizeof(Real));
+      }
+      REQUIRE(ArrayPool::BytesInUse() == 0);
+
+      THEN("The next request of the same label and extents reuses it zeroed") {
+        auto b = ArrayPool::Get<Real>("pool_test", 1, 1, 1, 4, 5, 6);
+        REQUIRE(b.Get().data() == data);
+        REQUIRE(Sum(b) == 0.0);
+        auto stats = ArrayPool::GetStats();
+        REQUIRE(stats.requests == before.requests + 2);
+        REQUIRE(stats.hits == before.hits + 1);
+      }
+      THEN("Arrays in use are not handed out twice") {
+        auto b = ArrayPool::Get<Real>("pool_test", 1, 1, 1, 4, 5, 6);
+        auto c = ArrayPool::Get<Real>("pool_test", 1, 1, 1, 4, 5, 6);
+        REQUIRE(b.Get().data() != c.Get().data());
+      }
+      THEN("Different extents are not reused") {
+        auto b = ArrayPool::Get<Real>("pool_test", 1, 1, 1, 6, 5, 4);
+        REQUIRE(b.Get().data() != data);
+      }
+      THEN("Releasing the pool frees the storage") {
+        ArrayPool::Release();
+        REQUIRE(ArrayPool::GetStats().bytes == 0);
+      }
+    }
+    ArrayPool::Release();
+    ArrayPool::Initialize(false);
+  }
+}
@@ -0,0 +1,135 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "basic_types.hpp"
+#include "bvals/boundary_conditions.hpp"
+#include "interface/container.hpp"
+#include "interface/metadata.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+
+using parthenon::BoundaryFace;
+using parthenon::BoundaryFlag;
+using parthenon::Container;
+using parthenon::MeshBlock;
+using parthenon::Metadata;
+using parthenon::PackIndexMap;
+using parthenon::Real;
+
+// initial value of component n of a variable in cell (k, j, i); nonzero, so that a
+// flipped sign shows
+KOKKOS_INLINE_FUNCTION Real Initial(const int n, const int k, const int j, const int i) {
+  return 1.0 + n + 10.0 * i + 100.0 * j + 1000.0 * k;
+}
+
+TEST_CASE("Physical boundary conditions fill the ghost cells of a block",
+          "[ApplyBoundaryConditions]") {
+  GIVEN("A 3D block with a scalar and a vector, reflecting at the inner faces and "
+        "outflowing at the outer ones") {
+    const int nx = 4;
+    MeshBlock pmb(nx, 3);
+    for (int f = 0; f < 6; f++)
+      pmb.boundary_flag[f] = (f % 2 == 0 ? BoundaryFlag::reflect : BoundaryFlag::outflow);
+    const int is = pmb.is, ie = pmb.ie, js = pmb.js, je = pmb.je, ks = pmb.ks,
+              ke = pmb.ke;
+
+    Container<Real> rc;
+    rc.setBlock(&pmb);
+    Metadata m_scalar({Metadata::Independent});
+    Metadata m_vector({Metadata::Independent, Metadata::Vector});
+    rc.Add("scalar", m_scalar, {pmb.ncells1, pmb.ncells2, pmb.ncells3});
+    rc.Add("vector", m_vector, {pmb.ncells1, pmb.ncells2, pmb.ncells3, 3});
+
+    PackIndexMap vmap;
+    auto q = rc.PackVariables({Metadata::Independent}, vmap);
+    const int nvar = q.GetDim(4);
+    REQUIRE(nvar == 4);
+    // the pack entries of the vector components
+    const int vl = vmap["vector"].first, vu = vmap["vector"].second;
+    REQUIRE(vu == vl + 2);
+    parthenon::par_for(
+        "Initialize variables", parthenon::DevExecSpace(), 0, nvar - 1, 0,
+        pmb.ncells3 - 1, 0, pmb.ncells2 - 1, 0, pmb.ncells1 - 1,
+        KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          q(n, k, j, i) = Initial(n >= vl && n <= vu ? n - vl : 0, k, j, i);
+        });
+
+    THEN("The vector directions of the pack entries are cached") {
+      auto vector_dir = rc.PackVectorDirections({Metadata::Independent});
+      auto vector_dir_h =
+          Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), vector_dir);
+      for (int n = 0; n < nvar; n++)
+        REQUIRE(vector_dir_h(n) == (n >= vl && n <= vu ? n - vl + 1 : 0));
+      auto again = rc.PackVectorDirections({Metadata::Independent});
+      REQUIRE(again.data() == vector_dir.data());
+    }
+
+    WHEN("The boundary conditions are applied") {
+      parthenon::ApplyBoundaryConditions(rc);
+      auto s = rc.Get("scalar").data.GetHostMirrorAndCopy();
+      auto v = rc.Get("vector").data.GetHostMirrorAndCopy();
+      // the value of component n, -1 for the scalar
+      auto value = [&](const int n, const int k, const int j, const int i) {
+        return n < 0 ? s(k, j, i) : v(n, k, j, i);
+      };
+      // the sign a reflection across a face normal to dir gives component n
+      auto sign = [](const int n, const int dir) { return n + 1 == dir ? -1.0 : 1.0; };
+
+      THEN("Ghost cells mirror the active cells at the inner faces, flipping the normal "
+           "vector component") {
+        for (int n = -1; n < 3; n++) {
+          const int c = (n < 0 ? 0 : n);
+          for (int m = 1; m <= NGHOST; m++) {
+            for (int b = 0; b < nx; b++) {
+              for (int a = 0; a < nx; a++) {
+                REQUIRE(value(n, ks + b, js + a, is - m) ==
+                        sign(n, 1) * Initial(c, ks + b, js + a, is + m - 1));
+                REQUIRE(value(n, ks + b, js - m, is + a) ==
+                        sign(n, 2) * Initial(c, ks + b, js + m - 1, is + a));
+                REQUIRE(value(n, ks - m, js + b, is + a) ==
+                        sign(n, 3) * Initial(c, ks + m - 1, js + b, is + a));
+              }
+            }
+          }
+          // the corner is reflected across all three faces
+          REQUIRE(value(n, ks - 1, js - 1, is - 1) ==
+                  sign(n, 1) * sign(n, 2) * sign(n, 3) * Initial(c, ks, js, is));
+        }
+      }
+
+      THEN("Ghost cells copy the last active cell at the outer faces") {
+        for (int n = -1; n < 3; n++) {
+          const int c = (n < 0 ? 0 : n);
+          for (int m = 1; m <= NGHOST; m++) {
+            for (int b = 0; b < nx; b++) {
+              for (int a = 0; a < nx; a++) {
+                REQUIRE(value(n, ks + b, js + a, ie + m) ==
+                        Initial(c, ks + b, js + a, ie));
+                REQUIRE(value(n, ks + b, je + m, is + a) ==
+                        Initial(c, ks + b, je, is + a));
+                REQUIRE(value(n, ke + m, js + b, is + a) ==
+                        Initial(c, ke, js + b, is + a));
+              }
+            }
+          }
+          REQUIRE(value(n, ke + 1, je + 1, ie + 1) == Initial(c, ke, je, ie));
+        }
+      }
+    }
+  }
+}
@@ -32,7 +32,9 @@
 #include "interface/variable_pack.hpp"
 #include "kokkos_abstraction.hpp"
 #include "parthenon_arrays.hpp"
+#include "utils/array_pool.hpp"
 
+namespace ArrayPool = parthenon::ArrayPool;
 using parthenon::CellVariable;
 using parthenon::CellVariableVector;
 using parthenon::Container;
@@ -42,6 +44,7 @@ using parthenon::loop_pattern_mdrange_tag;
 using parthenon::Metadata;
 using parthenon::MetadataFlag;
 using parthenon::PackIndexMap;
+using parthenon::PackLayout;
 using parthenon::par_for;
 using parthenon::ParArray4D;
 using parthenon::ParArrayND;
@@ -291,6 +294,76 @@ TEST_CASE("Can pull variables from containers based on Metadata", "[ContainerIte
       }
     }
 
+    WHEN("we add sparse fields that are allocated on demand") {
+      for (int id : {1, 13, 42}) {
+        rc.Add("vdemand", Metadata({Metadata::Sparse, Metadata::OnDemand}, id),
+               scalar_block_size);
+      }
+      const std::vector<std::string> names{"v3", "vdemand"};
+      THEN("the sparse ids are not allocated and are left out of the packs") {
+        PackIndexMap imap;
+        auto v = rc.PackVariables(names, imap);
+        REQUIRE(v.GetDim(4) == 3);
+        REQUIRE(!rc.GetSparseVariable("vdemand").Get(13).IsAllocated());
+        REQUIRE(imap["vdemand_13"].first == parthenon::kNotAllocated);
+        REQUIRE(imap["vdemand_13"].second < imap["vdemand_13"].first);
+      }
+      AND_THEN("allocated ids are packed and all-zero ids can be released again") {
+        rc.AllocateSparse("vdemand", 13);
+        rc.Get("vdemand", 42);
+        PackIndexMap imap;
+        auto v = rc.PackVariables(names, imap);
+        REQUIRE(v.GetDim(4) == 5);
+        REQUIRE(imap["vdemand"].second == imap["vdemand"].first + 1);
+        REQUIRE(!rc.GetSparseVariable("vdemand").Get(1).IsAllocated());
+
+        const int n42 = imap["vdemand_42"].first;
+        par_for(
+            "Set vdemand_42", DevExecSpace(), 0, 15, 0, 15, 0, 15,
+            KOKKOS_LAMBDA(const int k, const int j, const int i) {
+              v(n42, k, j, i) = (k == 3 ? 1.0 : 0.0);
+            });
+        rc.DeallocateSparseBelow(0.0);
+        REQUIRE(!rc.GetSparseVariable("vdemand").Get(13).IsAllocated());
+        REQUIRE(rc.GetSparseVariable("vdemand").Get(42).IsAllocated());
+        PackIndexMap imap2;
+        auto v2 = rc.PackVariables(names, imap2);
+        REQUIRE(v2.GetDim(4) == 4);
+      }
+      AND_THEN("unallocated ids share zeros that are not written through them") {
+        auto &sv = rc.GetSparseVariable("vdemand");
+        const Real *zeros = sv.Get(1).data.Get().data();
+        REQUIRE(sv.Get(13).data.Get().data() == zeros);
+        REQUIRE(sv.Get(42).data.Get().data() == zeros);
+        REQUIRE(ArrayPool::SharedZerosIntact());
+
+        // getting an id and packing it explicitly allocate it before it is written
+        auto v13 = rc.Get("vdemand", 13).data;
+        REQUIRE(v13.Get().data() != zeros);
+        PackIndexMap imap;
+        auto v = rc.PackVariables({"vdemand"}, {1}, imap);
+        const int n1 = imap["vdemand_1"].first;
+        REQUIRE(n1 >= 0);
+        par_for(
+            "Set vdemand", DevExecSpace(), 0, 15, 0, 15, 0, 15,
+            KOKKOS_LAMBDA(const int k, const int j, const int i) {
+              v13(k, j, i) = 1.0;
+              v(n1, k, j, i) = 2.0;
+            });
+        REQUIRE(!sv.Get(42).IsAllocated());
+        REQUIRE(ArrayPool::SharedZerosIntact());
+
+        // a write that bypasses the allocation is detected
+        auto v42 = sv.Get(42).data;
+        par_for(
+            "Write vdemand_42", DevExecSpace(), 0, 0, 0, 0, 0, 0,
+            KOKKOS_LAMBDA(const int k, const int j, const int i) { v42(k, j, i) = 1.0; });
+        REQUIRE(!ArrayPool::SharedZerosIntact());
+        Kokkos::deep_copy(v42.Get(), 0.0);
+        REQUIRE(ArrayPool::SharedZerosIntact());
+      }
+    }
+
     WHEN("we add a 2d variable") {
       std::vector<int> twod_block_size{16, 16, 1};
       rc.Add("v2d", m_in, twod_block_size);
@@ -299,6 +372,150 @@ TEST_CASE("Can pull variables from containers based on Metadata", "[ContainerIte
     }
   }
 }
+TEST_CASE("Cell variables can share one contiguous allocation", "[ContainerIterator]") {
+  GIVEN("A Container whose variables are moved into contiguous storage") {
+    using policy4D = Kokkos::MDRangePolicy<Kokkos::Rank<4>>;
+    Container<Real> rc;
+    Metadata m_in({Metadata::Independent, Metadata::FillGhost});
+    Metadata m_out;
+    std::vector<int> scalar_block_size{16, 16, 16};
+    std::vector<int> vector_block_size{16, 16, 16, 3};
+    rc.Add("v1", m_in, scalar_block_size);
+    rc.Add("v2", m_out, scalar_block_size);
+    rc.Add("v3", m_in, vector_block_size);
+    rc.Add("v4", m_out, scalar_block_size);
+    auto v3 = rc.Get("v3").data;
+    par_for(
+        "Set v3", DevExecSpace(), 0, 2, 0, 15, 0, 15, 0, 15,
+        KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+          v3(l, k, j, i) = l + 1.0;
+        });
+    Container<Real>::SetContiguous(true);
+    rc.AllocateContiguous();
+    Container<Real>::SetContiguous(false);
+
+    THEN("the Independent variables come first and keep their values") {
+      REQUIRE(rc.Get("v1").StorageOffset() == 0);
+      REQUIRE(rc.Get("v3").StorageOffset() == 1);
+      REQUIRE(rc.Get("v2").StorageOffset() == 4);
+      REQUIRE(rc.Get("v4").StorageOffset() == 5);
+      const Real *storage = rc.Get("v1").Storage().data();
+      REQUIRE(rc.Get("v4").Storage().data() == storage);
+      REQUIRE(rc.Get("v3").data.Get().data() == storage + 16 * 16 * 16);
+      REQUIRE(rc.Get("v3").StorageOffset(X1DIR) == 1);
+      REQUIRE(rc.Get("v2").Storage(X1DIR).size() == 0);
+
+      auto v = rc.Get("v3").data;
+      Real sum = 0.0;
+      Kokkos::parallel_reduce(
+          policy4D({0, 0, 0, 0}, {3, 16, 16, 16}),
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i, Real &vsum) {
+            vsum += v(l, k, j, i);
+          },
+          sum);
+      REQUIRE(std::abs(sum - 6.0 * 4096.0) < 1.e-14);
+    }
+
+    AND_THEN("packs of consecutive variables index the storage directly") {
+      REQUIRE(rc.PackVariables(std::vector<std::string>({"v3", "v2"})).IsContiguous());
+      REQUIRE(!rc.PackVariables(std::vector<std::string>({"v1", "v2"})).IsContiguous());
+      auto vf = rc.PackVariablesAndFluxes({Metadata::Independent, Metadata::FillGhost});
+      REQUIRE(vf.IsContiguous());
+      auto vc = vf.Contiguous();
+      REQUIRE(vc.GetLayout() == PackLayout::variable_contiguous);
+      REQUIRE(vc.GetDim(4) == vf.GetDim(4));
+      // the values through the view of views, the fluxes through the slabs
+      par_for(
+          "Set through the pack", DevExecSpace(), 0, vf.GetDim(4) - 1, 0,
+          vf.GetDim(3) - 1, 0, vf.GetDim(2) - 1, 0, vf.GetDim(1) - 1,
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+            vf(l, k, j, i) = 2.0;
+            vc.flux(X1DIR, l, k, j, i) = 1.0;
+          });
+
+      auto v = rc.Get("v3").data;
+      auto f = rc.Get("v3").flux[X1DIR];
+      Real sum = 0.0;
+      Kokkos::parallel_reduce(
+          policy4D({0, 0, 0, 0}, {3, 16, 16, 16}),
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i, Real &vsum) {
+            vsum += v(l, k, j, i) + f(l, k, j, i);
+          },
+          sum);
+      REQUIRE(std::abs(sum - 9.0 * 4096.0) < 1.e-14);
+    }
+  }
+}
+
+TEST_CASE("Packs can interleave the variables", "[ContainerIterator]") {
+  GIVEN("A Container with a scalar and a vector variable") {
+    using policy4D = Kokkos::MDRangePolicy<Kokkos::Rank<4>>;
+    Container<Real> rc;
+    Metadata m({Metadata::Independent});
+    rc.Add("v1", m, std::vector<int>({16, 16, 16}));
+    rc.Add("v3", m, std::vector<int>({16, 16, 16, 3}));
+    auto v = rc.PackVariables();
+    par_for(
+        "Initialize variables", DevExecSpace(), 0, 3, 0, 15, 0, 15, 0, 15,
+        KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+          v(l, k, j, i) = l + 0.01 * i;
+        });
+    PackIndexMap vmap;
+    auto q = rc.PackVariablesInterleaved(std::vector<std::string>({"v1", "v3"}), vmap);
+
+    THEN("the pack reads the values of the variables") {
+      REQUIRE(q.GetLayout() == PackLayout::variable_innermost);
+      REQUIRE(q.GetDim(4) == 4);
+      REQUIRE(vmap["v3"].first == 1);
+      Real diff = 1.0;
+      Kokkos::parallel_reduce(
+          policy4D({0, 0, 0, 0}, {4, 16, 16, 16}),
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i, Real &d) {
+            d += std::abs(q(l, k, j, i) - v(l, k, j, i));
+          },
+          diff);
+      REQUIRE(diff == 0.0);
+    }
+
+    AND_THEN("values written to the pack reach the variables with Scatter") {
+      par_for(
+          "Double through the pack", DevExecSpace(), 0, 3, 0, 15, 0, 15, 0, 15,
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+            q(l, k, j, i) *= 2.0;
+          });
+      q.Scatter(DevExecSpace());
+      Real diff = 1.0;
+      Kokkos::parallel_reduce(
+          policy4D({0, 0, 0, 0}, {4, 16, 16, 16}),
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i, Real &d) {
+            d += std::abs(v(l, k, j, i) - 2.0 * (l + 0.01 * i));
+          },
+          diff);
+      REQUIRE(diff < 1.e-12);
+    }
+
+    AND_THEN("the cached pack is gathered again each time it is returned") {
+      par_for(
+          "Change the variables", DevExecSpace(), 0, 3, 0, 15, 0, 15, 0, 15,
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+            v(l, k, j, i) = -1.0 - l;
+          });
+      auto p = rc.PackVariablesInterleaved(std::vector<std::string>({"v1", "v3"}), vmap);
+      // the cached pack shares its copy with q, so both see the new values
+      Real diff = 1.0;
+      Kokkos::parallel_reduce(
+          policy4D({0, 0, 0, 0}, {4, 16, 16, 16}),
+          KOKKOS_LAMBDA(const int l, const int k, const int j, const int i, Real &d) {
+            d += std::abs(p(l, k, j, i) - v(l, k, j, i)) +
+                 std::abs(q(l, k, j, i) - v(l, k, j, i));
+          },
+          diff);
+      REQUIRE(diff == 0.0);
+      REQUIRE(vmap["v3"].first == 1);
+    }
+  }
+}
+
 // Test wrapper to run a function multiple times
 template <typename InitFunc, typename PerfFunc>
 double performance_test_wrapper(const int n_burn, const int n_perf, InitFunc init_func,
@@ -529,3 +746,70 @@ TEST_CASE("Container Iterator Performance", "[ContainerIterator][performance]")
               << time_view_of_views / time_raw_array << std::endl;
   }
 }
+
+// piecewise linear reconstruction in x1 of all variables of a cell at once, with the
+// face states in the layout of the pack
+template <typename Pack>
+void plm_x1(const Pack &q, const ParArray4D<Real> &ql, const ParArray4D<Real> &qr,
+            const bool innermost, const int nvar, const int n) {
+  par_for(
+      "PLM x1", DevExecSpace(), 0, n - 1, 0, n - 1, 1, n - 2,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        for (int l = 0; l < nvar; l++) {
+          const Real dql = q(l, k, j, i) - q(l, k, j, i - 1);
+          const Real dqr = q(l, k, j, i + 1) - q(l, k, j, i);
+          const Real dq2 = dql * dqr;
+          const Real dqm = (dq2 > 0.0 ? 2.0 * dq2 / (dql + dqr) : 0.0);
+          if (innermost) {
+            ql(k, j, i + 1, l) = q(l, k, j, i) + 0.5 * dqm;
+            qr(k, j, i, l) = q(l, k, j, i) - 0.5 * dqm;
+          } else {
+            ql(l, k, j, i + 1) = q(l, k, j, i) + 0.5 * dqm;
+            qr(l, k, j, i) = q(l, k, j, i) - 0.5 * dqm;
+          }
+        }
+      });
+}
+
+TEST_CASE("Pack layouts on PLM reconstruction", "[ContainerIterator][performance]") {
+  const int N = 32 + 2; // one ghost cell on each side
+  const int n_burn = 10;
+  const int n_perf = 100;
+
+  for (const int nvar : {5, 10, 20}) {
+    Container<Real> container;
+    std::vector<std::string> names;
+    for (int l = 0; l < nvar; l++) {
+      names.push_back("q" + std::to_string(l));
+      container.Add(names.back(), Metadata({Metadata::Independent}),
+                    std::vector<int>({N, N, N}));
+    }
+    auto v = container.PackVariables();
+    par_for(
+        "Initialize", DevExecSpace(), 0, nvar - 1, 0, N - 1, 0, N - 1, 0, N - 1,
+        KOKKOS_LAMBDA(const int l, const int k, const int j, const int i) {
+          v(l, k, j, i) = sin(0.1 * (l + 1) * i) + 0.01 * (j + k);
+        });
+
+    PackIndexMap vmap;
+    auto outer = container.PackVariables(names, vmap);
+    auto inner = container.PackVariablesInterleaved(names, vmap);
+    ParArray4D<Real> ql_outer("ql", nvar, N, N, N), qr_outer("qr", nvar, N, N, N);
+    ParArray4D<Real> ql_inner("ql", N, N, N, nvar), qr_inner("qr", N, N, N, nvar);
+
+    double time_outer = performance_test_wrapper(
+        n_burn, n_perf, []() {},
+        [&]() { plm_x1(outer, ql_outer, qr_outer, false, nvar, N); });
+    double time_inner = performance_test_wrapper(
+        n_burn, n_perf, []() {},
+        [&]() { plm_x1(inner, ql_inner, qr_inner, true, nvar, N); });
+    double time_gather = performance_test_wrapper(
+        n_burn, n_perf, []() {}, [&]() { inner.Gather(DevExecSpace()); });
+
+    std::cout << "PLM reconstruction of " << nvar << " variables:\n"
+              << "\tvariable_outermost = " << time_outer << " s\n"
+              << "\tvariable_innermost = " << time_inner << " s (+ " << time_gather
+              << " s to gather)\n"
+              << std::endl;
+  }
+}
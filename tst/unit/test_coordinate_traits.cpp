@@ -0,0 +1,248 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "basic_types.hpp"
+#include "coordinates/coordinate_traits.hpp"
+#include "coordinates/uniform_cartesian.hpp"
+#include "interface/container.hpp"
+#include "interface/metadata.hpp"
+#include "interface/update.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/mesh_refinement_cc.hpp"
+
+using parthenon::Container;
+using parthenon::CoordinateTraits;
+using parthenon::MeshBlock;
+using parthenon::Metadata;
+using parthenon::ParArrayND;
+using parthenon::Real;
+using parthenon::UniformCartesian;
+namespace CellCenteredRefinement = parthenon::CellCenteredRefinement;
+namespace Update = parthenon::Update;
+
+namespace {
+
+// The same geometry as UniformCartesian, but without the CoordinateTraits specialization,
+// so that the kernels take their general path and look up the geometry per cell
+class GeneralCartesian : public UniformCartesian {
+ public:
+  using UniformCartesian::UniformCartesian;
+  explicit GeneralCartesian(const UniformCartesian &coords) : UniformCartesian(coords) {}
+};
+
+void FillRandom(ParArrayND<Real> &arr, const int seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<Real> dis(-1.0, 1.0);
+  auto h = arr.GetHostMirror();
+  for (int n = 0; n < h.GetDim(4); n++)
+    for (int k = 0; k < h.GetDim(3); k++)
+      for (int j = 0; j < h.GetDim(2); j++)
+        for (int i = 0; i < h.GetDim(1); i++)
+          h(n, k, j, i) = dis(gen);
+  arr.DeepCopy(h);
+}
+
+Real MaxDifference(ParArrayND<Real> &a, ParArrayND<Real> &b) {
+  auto a_h = a.GetHostMirrorAndCopy();
+  auto b_h = b.GetHostMirrorAndCopy();
+  Real diff = 0.0;
+  for (int n = 0; n < a_h.GetDim(4); n++)
+    for (int k = 0; k < a_h.GetDim(3); k++)
+      for (int j = 0; j < a_h.GetDim(2); j++)
+        for (int i = 0; i < a_h.GetDim(1); i++)
+          diff = std::max(diff, std::abs(a_h(n, k, j, i) - b_h(n, k, j, i)));
+  return diff;
+}
+
+// Run a kernel once to warm up, then return the time of nruns further calls
+template <typename Kernel>
+double TimeKernel(const int nruns, Kernel kernel) {
+  kernel();
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  for (int run = 0; run < nruns; run++)
+    kernel();
+  Kokkos::fence();
+  return timer.seconds();
+}
+
+// the times of the uniform and the general instantiations of the kernels
+struct KernelTimes {
+  double divergence[2], restriction[2], prolongation[2];
+};
+
+// Runs FluxDivergence and the cell centered restriction and prolongation nruns times
+// with UniformCartesian and with GeneralCartesian on an ndim dimensional block of n^ndim
+// cells and requires that both agree
+KernelTimes CompareKernels(const int ndim, const int n, const int nvar, const int nruns) {
+  MeshBlock pmb(n, ndim);
+  pmb.block_size.x1min = pmb.block_size.x2min = pmb.block_size.x3min = 0.0;
+  pmb.block_size.x1max = 1.0, pmb.block_size.x2max = 2.0, pmb.block_size.x3max = 3.0;
+  pmb.coords = parthenon::Coordinates_t(pmb.block_size, nullptr);
+  const UniformCartesian &uniform = pmb.coords;
+  const GeneralCartesian general(uniform);
+  const UniformCartesian uniform_coarse(uniform, 2);
+  const GeneralCartesian general_coarse(general, 2);
+  KernelTimes times;
+
+  // the variables are added before the block is set so that no boundary buffers are
+  // allocated, which would need a Mesh
+  const std::vector<int> dims({pmb.ncells1, pmb.ncells2, pmb.ncells3, nvar});
+  Container<Real> in, dudt_uniform, dudt_general;
+  in.Add("u", Metadata({Metadata::Independent, Metadata::FillGhost}), dims);
+  dudt_uniform.Add("u", Metadata({Metadata::Independent}), dims);
+  dudt_general.Add("u", Metadata({Metadata::Independent}), dims);
+  for (auto *c : {&in, &dudt_uniform, &dudt_general})
+    c->setBlock(&pmb);
+  for (int d = 1; d <= ndim; d++)
+    FillRandom(in.Get("u").flux[d], 1234 + d);
+  times.divergence[0] = TimeKernel(
+      nruns, [&]() { Update::FluxDivergence(in, dudt_uniform, uniform); });
+  times.divergence[1] = TimeKernel(
+      nruns, [&]() { Update::FluxDivergence(in, dudt_general, general); });
+  REQUIRE(MaxDifference(dudt_uniform.Get("u").data, dudt_general.Get("u").data) <
+          1.0e-10);
+
+  ParArrayND<Real> fine("fine", nvar, pmb.ncells3, pmb.ncells2, pmb.ncells1);
+  ParArrayND<Real> coarse("coarse", nvar, pmb.ncc3, pmb.ncc2, pmb.ncc1);
+  FillRandom(fine, 4321);
+  FillRandom(coarse, 5678);
+
+  ParArrayND<Real> coarse_uniform("coarse_uniform", nvar, pmb.ncc3, pmb.ncc2, pmb.ncc1);
+  ParArrayND<Real> coarse_general("coarse_general", nvar, pmb.ncc3, pmb.ncc2, pmb.ncc1);
+  times.restriction[0] = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::Restrict(&pmb, uniform, fine, coarse_uniform, 0, nvar - 1,
+                                     pmb.cis, pmb.cie, pmb.cjs, pmb.cje, pmb.cks,
+                                     pmb.cke);
+  });
+  times.restriction[1] = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::Restrict(&pmb, general, fine, coarse_general, 0, nvar - 1,
+                                     pmb.cis, pmb.cie, pmb.cjs, pmb.cje, pmb.cks,
+                                     pmb.cke);
+  });
+  REQUIRE(MaxDifference(coarse_uniform, coarse_general) < 1.0e-12);
+
+  ParArrayND<Real> fine_uniform("fine_uniform", nvar, pmb.ncells3, pmb.ncells2,
+                                pmb.ncells1);
+  ParArrayND<Real> fine_general("fine_general", nvar, pmb.ncells3, pmb.ncells2,
+                                pmb.ncells1);
+  times.prolongation[0] = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::Prolongate(&pmb, uniform, uniform_coarse, coarse,
+                                       fine_uniform, 0, nvar - 1, pmb.cis, pmb.cie,
+                                       pmb.cjs, pmb.cje, pmb.cks, pmb.cke);
+  });
+  times.prolongation[1] = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::Prolongate(&pmb, general, general_coarse, coarse,
+                                       fine_general, 0, nvar - 1, pmb.cis, pmb.cie,
+                                       pmb.cjs, pmb.cje, pmb.cks, pmb.cke);
+  });
+  REQUIRE(MaxDifference(fine_uniform, fine_general) < 1.0e-12);
+  return times;
+}
+
+} // namespace
+
+TEST_CASE("The uniform geometry kernels agree with the general ones",
+          "[CoordinateTraits]") {
+  STATIC_REQUIRE(CoordinateTraits<UniformCartesian>::uniform_spacing);
+  STATIC_REQUIRE(CoordinateTraits<UniformCartesian>::constant_area);
+  STATIC_REQUIRE(CoordinateTraits<UniformCartesian>::constant_volume);
+  STATIC_REQUIRE(!CoordinateTraits<GeneralCartesian>::uniform_spacing);
+  STATIC_REQUIRE(!CoordinateTraits<GeneralCartesian>::constant_area);
+  STATIC_REQUIRE(!CoordinateTraits<GeneralCartesian>::constant_volume);
+
+  for (int ndim = 1; ndim <= 3; ndim++) {
+    SECTION(std::to_string(ndim) + "D") { CompareKernels(ndim, 8, 3, 1); }
+  }
+}
+
+TEST_CASE("Uniform geometry fast paths against the general kernels",
+          "[CoordinateTraits][performance]") {
+  const int nvar = 5, n = 64, nruns = 20;
+  const auto t = CompareKernels(3, n, nvar, nruns);
+  std::cout << "Uniform geometry kernels, " << nruns << " runs on " << nvar << " x " << n
+            << "^3 cells:\n"
+            << "\tFluxDivergence general     = " << t.divergence[1] << " s\n"
+            << "\tFluxDivergence fast path   = " << t.divergence[0] << " s\n"
+            << "\tRestriction general        = " << t.restriction[1] << " s\n"
+            << "\tRestriction fast path      = " << t.restriction[0] << " s\n"
+            << "\tProlongation general       = " << t.prolongation[1] << " s\n"
+            << "\tProlongation fast path     = " << t.prolongation[0] << " s\n"
+            << std::endl;
+}
+
+TEST_CASE("Refinement kernels on rank 4 views against ParArrayND",
+          "[ParArrayND][performance]") {
+  const int nvar = 5, n = 64, nruns = 20;
+  MeshBlock pmb(n, 3);
+  pmb.block_size.x1min = pmb.block_size.x2min = pmb.block_size.x3min = 0.0;
+  pmb.block_size.x1max = pmb.block_size.x2max = pmb.block_size.x3max = 1.0;
+  pmb.coords = parthenon::Coordinates_t(pmb.block_size, nullptr);
+  const UniformCartesian &coords = pmb.coords;
+  const UniformCartesian coarse_coords(coords, 2);
+  const std::true_type uniform;
+
+  ParArrayND<Real> fine("fine", nvar, pmb.ncells3, pmb.ncells2, pmb.ncells1);
+  ParArrayND<Real> coarse("coarse", nvar, pmb.ncc3, pmb.ncc2, pmb.ncc1);
+  FillRandom(fine, 1357);
+  FillRandom(coarse, 2468);
+  ParArrayND<Real> restricted[2], prolongated[2];
+  for (int m = 0; m < 2; m++) {
+    restricted[m] = ParArrayND<Real>("restricted", nvar, pmb.ncc3, pmb.ncc2, pmb.ncc1);
+    prolongated[m] =
+        ParArrayND<Real>("prolongated", nvar, pmb.ncells3, pmb.ncells2, pmb.ncells1);
+  }
+
+  // the kernels as called by CellCenteredRefinement, with the rank 4 views, and with the
+  // ParArrayNDs themselves, whose accesses go through the 6D index arithmetic
+  const double t_res_nd = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::detail::Restrict(uniform, &pmb, coords, fine, restricted[0],
+                                             0, nvar - 1, pmb.cis, pmb.cie, pmb.cjs,
+                                             pmb.cje, pmb.cks, pmb.cke);
+  });
+  const double t_res_4d = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::Restrict(&pmb, coords, fine, restricted[1], 0, nvar - 1,
+                                     pmb.cis, pmb.cie, pmb.cjs, pmb.cje, pmb.cks,
+                                     pmb.cke);
+  });
+  const double t_pro_nd = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::detail::Prolongate(
+        uniform, &pmb, coords, coarse_coords, coarse, prolongated[0], 0, nvar - 1,
+        pmb.cis, pmb.cie, pmb.cjs, pmb.cje, pmb.cks, pmb.cke);
+  });
+  const double t_pro_4d = TimeKernel(nruns, [&]() {
+    CellCenteredRefinement::Prolongate(&pmb, coords, coarse_coords, coarse,
+                                       prolongated[1], 0, nvar - 1, pmb.cis, pmb.cie,
+                                       pmb.cjs, pmb.cje, pmb.cks, pmb.cke);
+  });
+  REQUIRE(MaxDifference(restricted[0], restricted[1]) == 0.0);
+  REQUIRE(MaxDifference(prolongated[0], prolongated[1]) == 0.0);
+
+  std::cout << "Refinement kernels, " << nruns << " runs on " << nvar << " x " << n
+            << "^3 fine cells:\n"
+            << "\tRestriction  ParArrayND     = " << t_res_nd << " s\n"
+            << "\tRestriction  rank 4 views   = " << t_res_4d << " s\n"
+            << "\tProlongation ParArrayND     = " << t_pro_nd << " s\n"
+            << "\tProlongation rank 4 views   = " << t_pro_4d << " s\n"
+            << std::endl;
+}
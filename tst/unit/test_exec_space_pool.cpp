@@ -0,0 +1,106 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <iostream>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "kokkos_abstraction.hpp"
+#include "parthenon_arrays.hpp"
+#include "utils/exec_space_pool.hpp"
+
+using parthenon::DevExecSpace;
+using parthenon::ParArray3D;
+using parthenon::Real;
+namespace ExecSpacePool = parthenon::ExecSpacePool;
+
+// runs nrep updates of nblocks blocks of N^3 cells on the instances of the pool and
+// returns the seconds it took, blocks[b](k, j, i) ends up as nrep
+static double UpdateBlocks(std::vector<ParArray3D<Real>> &blocks, int N, int nrep) {
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  for (int r = 0; r < nrep; r++) {
+    for (int b = 0; b < static_cast<int>(blocks.size()); b++) {
+      auto &q = blocks[b];
+      parthenon::par_for(
+          "update block", ExecSpacePool::Get(b), 0, N - 1, 0, N - 1, 0, N - 1,
+          KOKKOS_LAMBDA(const int k, const int j, const int i) { q(k, j, i) += 1.0; });
+    }
+  }
+  Kokkos::fence();
+  return timer.seconds();
+}
+
+TEST_CASE("Blocks are assigned the instances round-robin", "[ExecSpacePool]") {
+  const int N = 8, nrep = 3;
+  for (int n : {1, 3}) {
+    ExecSpacePool::Initialize(n);
+    // instances that cannot overlap are not created
+    const int nspaces = (parthenon::SpaceInstance<DevExecSpace>::overlap() ? n : 1);
+    REQUIRE(ExecSpacePool::Size() == nspaces);
+
+    for (int b = 0; b < 7; b++)
+      REQUIRE(ExecSpacePool::Index(b) == b % nspaces);
+#ifdef KOKKOS_ENABLE_CUDA
+    // each instance is a stream of its own, which identifies it
+    std::vector<cudaStream_t> streams;
+    for (int n = 0; n < nspaces; n++)
+      streams.push_back(ExecSpacePool::Get(n).cuda_stream());
+    if (nspaces == 1) REQUIRE(streams[0] == DevExecSpace().cuda_stream());
+    for (int n = 0; n < nspaces; n++)
+      for (int m = 0; m < n; m++)
+        REQUIRE(streams[n] != streams[m]);
+    for (int b = 0; b < 7; b++)
+      REQUIRE(ExecSpacePool::Get(b).cuda_stream() == streams[b % nspaces]);
+#endif
+
+    std::vector<ParArray3D<Real>> blocks;
+    for (int b = 0; b < 5; b++)
+      blocks.emplace_back("block", N, N, N);
+    UpdateBlocks(blocks, N, nrep);
+
+    bool all_same = true;
+    for (auto &q : blocks) {
+      auto q_h = Kokkos::create_mirror_view(q);
+      Kokkos::deep_copy(q_h, q);
+      for (int k = 0; k < N; k++)
+        for (int j = 0; j < N; j++)
+          for (int i = 0; i < N; i++)
+            if (q_h(k, j, i) != nrep) all_same = false;
+    }
+    REQUIRE(all_same == true);
+  }
+  ExecSpacePool::Finalize();
+  REQUIRE(ExecSpacePool::Size() == 1);
+}
+
+TEST_CASE("Throughput of many small blocks", "[ExecSpacePool][performance]") {
+  const int N = 16;        // cells per block and direction
+  const int nblocks = 256; // many small blocks
+  const int nrep = 20;
+
+  std::vector<ParArray3D<Real>> blocks;
+  for (int b = 0; b < nblocks; b++)
+    blocks.emplace_back("block", N, N, N);
+
+  for (int nspaces : {1, 2, 4, 8}) {
+    ExecSpacePool::Initialize(nspaces);
+    UpdateBlocks(blocks, N, 1); // warmup
+    const double time = UpdateBlocks(blocks, N, nrep);
+    std::cout << nspaces << " execution space instances: "
+              << static_cast<double>(nblocks) * N * N * N * nrep / time
+              << " cell updates per second" << std::endl;
+  }
+  ExecSpacePool::Finalize();
+}
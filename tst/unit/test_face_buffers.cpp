@@ -0,0 +1,163 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "bvals/bvals_interfaces.hpp"
+#include "bvals/fc/bvals_fc.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+
+using parthenon::FaceBufferRanges;
+using parthenon::FaceField;
+using parthenon::MeshBlock;
+using parthenon::NeighborBlock;
+using parthenon::NeighborConnect;
+using parthenon::ParArray1D;
+using parthenon::Real;
+
+// the value of component c at the face with global indices (gk, gj, gi), unique for all
+// faces of the blocks below
+static Real Value(const int c, const int gk, const int gj, const int gi) {
+  return c * 1.0e6 + (gk + 50) * 1.0e4 + (gj + 50) * 1.0e2 + (gi + 50);
+}
+
+// a neighbor in direction (ox1, ox2, ox3), with its connection type
+static NeighborBlock Neighbor(const int ox1, const int ox2, const int ox3,
+                              const int fi1 = 0, const int fi2 = 0) {
+  const int n = (ox1 != 0) + (ox2 != 0) + (ox3 != 0);
+  NeighborBlock nb{};
+  nb.ni.ox1 = ox1, nb.ni.ox2 = ox2, nb.ni.ox3 = ox3;
+  nb.ni.fi1 = fi1, nb.ni.fi2 = fi2;
+  nb.ni.type = (n == 1 ? NeighborConnect::face
+                       : (n == 2 ? NeighborConnect::edge : NeighborConnect::corner));
+  return nb;
+}
+
+// fills all faces of f, whose first index (k, j, i) = first lies at the global indices
+// origin
+static void Fill(FaceField &f, const int first[3], const int origin[3]) {
+  for (int c = 0; c < 3; c++) {
+    auto &v = f.Get(c + 1);
+    auto h = v.GetHostMirror();
+    for (int k = 0; k < v.GetDim(3); k++)
+      for (int j = 0; j < v.GetDim(2); j++)
+        for (int i = 0; i < v.GetDim(1); i++)
+          h(k, j, i) = Value(c, origin[0] + k - first[0], origin[1] + j - first[1],
+                             origin[2] + i - first[2]);
+    v.DeepCopy(h);
+  }
+}
+
+// whether the faces of f in the ranges r, whose first index lies at the global index 0,
+// hold the values of the neighbors
+static bool Check(FaceField &f, const FaceBufferRanges &r, const int first[3]) {
+  bool ok = true;
+  for (int c = 0; c < 3; c++) {
+    auto h = f.Get(c + 1).GetHostMirrorAndCopy();
+    for (int k = r.sk[c]; k <= r.ek[c]; k++)
+      for (int j = r.sj[c]; j <= r.ej[c]; j++)
+        for (int i = r.si[c]; i <= r.ei[c]; i++)
+          ok = ok && (h(k, j, i) == Value(c, k - first[0], j - first[1], i - first[2]));
+  }
+  return ok;
+}
+
+static int Size(const FaceBufferRanges &r) { return r.Size(0) + r.Size(1) + r.Size(2); }
+
+TEST_CASE("Face buffers are unpacked into the ghost faces they were packed for",
+          "[FaceBufferRanges][PackFaceBuffer][UnpackFaceBuffer]") {
+  GIVEN("3D blocks and all their neighbors") {
+    const int nx = 8;
+    MeshBlock pmb(nx, 3);
+    const int first[3] = {pmb.ks, pmb.js, pmb.is};
+    const int cfirst[3] = {pmb.cks, pmb.cjs, pmb.cis};
+    ParArray1D<Real> staging;
+
+    THEN("A neighbor on the same level fills the ghost faces with its own faces") {
+      for (const bool multilevel : {false, true}) {
+        for (int ox3 = -1; ox3 <= 1; ox3++) {
+          for (int ox2 = -1; ox2 <= 1; ox2++) {
+            for (int ox1 = -1; ox1 <= 1; ox1++) {
+              if (ox1 == 0 && ox2 == 0 && ox3 == 0) continue;
+              // the neighbor sends towards this block, which lies in the opposite
+              // direction
+              FaceField send("send", pmb.ncells3, pmb.ncells2, pmb.ncells1);
+              const int origin[3] = {ox3 * nx, ox2 * nx, ox1 * nx};
+              Fill(send, first, origin);
+              auto rs = FaceBufferRanges::SendSameLevel(&pmb, Neighbor(-ox1, -ox2, -ox3),
+                                                        multilevel);
+              std::vector<Real> buf(Size(rs));
+              REQUIRE(parthenon::PackFaceBuffer(&pmb, send, rs, buf.data(), staging) ==
+                      Size(rs));
+
+              FaceField recv("recv", pmb.ncells3, pmb.ncells2, pmb.ncells1);
+              auto rr = FaceBufferRanges::RecvSameLevel(&pmb, Neighbor(ox1, ox2, ox3),
+                                                        multilevel);
+              REQUIRE(Size(rr) == Size(rs));
+              parthenon::UnpackFaceBuffer(&pmb, recv, rr, buf.data(), staging);
+              Kokkos::fence();
+              REQUIRE(Check(recv, rr, first));
+            }
+          }
+        }
+      }
+    }
+
+    THEN("A finer neighbor fills the ghost faces with its restricted faces") {
+      for (int ox3 = -1; ox3 <= 1; ox3++) {
+        for (int ox2 = -1; ox2 <= 1; ox2++) {
+          for (int ox1 = -1; ox1 <= 1; ox1++) {
+            const int ox[3] = {ox3, ox2, ox1};
+            const int nzero = (ox1 == 0) + (ox2 == 0) + (ox3 == 0);
+            if (nzero == 3) continue;
+            // fi1 (fi2) selects the half of the first (second) direction in which the
+            // fine neighbor does not lie next to this block
+            for (int fi2 = 0; fi2 <= (nzero > 1); fi2++) {
+              for (int fi1 = 0; fi1 <= (nzero > 0); fi1++) {
+                // the global indices of the first coarse face of the fine block, in the
+                // units of this block
+                int origin[3], nf = 0;
+                for (int d = 2; d >= 0; d--) {
+                  if (ox[d] > 0)
+                    origin[d] = nx;
+                  else if (ox[d] < 0)
+                    origin[d] = -nx / 2;
+                  else
+                    origin[d] = (nf++ == 0 ? fi1 : fi2) * nx / 2;
+                }
+                FaceField coarse("coarse", pmb.ncc3, pmb.ncc2, pmb.ncc1);
+                Fill(coarse, cfirst, origin);
+                auto rs =
+                    FaceBufferRanges::SendToCoarser(&pmb, Neighbor(-ox1, -ox2, -ox3));
+                std::vector<Real> buf(Size(rs));
+                REQUIRE(parthenon::PackFaceBuffer(&pmb, coarse, rs, buf.data(),
+                                                  staging) == Size(rs));
+
+                FaceField recv("recv", pmb.ncells3, pmb.ncells2, pmb.ncells1);
+                auto rr = FaceBufferRanges::RecvFromFiner(
+                    &pmb, Neighbor(ox1, ox2, ox3, fi1, fi2));
+                REQUIRE(Size(rr) == Size(rs));
+                parthenon::UnpackFaceBuffer(&pmb, recv, rr, buf.data(), staging);
+                Kokkos::fence();
+                REQUIRE(Check(recv, rr, first));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
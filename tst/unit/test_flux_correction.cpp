@@ -0,0 +1,151 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "bvals/bvals_interfaces.hpp"
+#include "bvals/cc/bvals_cc.hpp"
+#include "coordinates/coordinates.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+
+using parthenon::BoundaryFace;
+using parthenon::MeshBlock;
+using parthenon::NeighborBlock;
+using parthenon::ParArray1D;
+using parthenon::ParArrayND;
+using parthenon::Real;
+
+// the flux of variable n through the face (k, j, i) normal to dir, distinct everywhere
+static Real Flux(const int dir, const int n, const int k, const int j, const int i) {
+  return dir * 1.0e6 + n * 1.0e5 + k * 1.0e4 + j * 1.0e2 + i + 0.25 * (i % 3);
+}
+
+// the fluxes normal to dir of nvar variables on the block, with one more face along dir
+static ParArrayND<Real> Fluxes(const MeshBlock &pmb, const int dir, const int nvar) {
+  return ParArrayND<Real>("flux", nvar, pmb.ncells3 + (dir == parthenon::X3DIR),
+                          pmb.ncells2 + (dir == parthenon::X2DIR),
+                          pmb.ncells1 + (dir == parthenon::X1DIR));
+}
+
+TEST_CASE("Flux corrections restrict the fine fluxes onto the coarse faces",
+          "[PackFluxCorrection][UnpackFluxCorrection]") {
+  for (const int ndim : {2, 3}) {
+    GIVEN("A " + std::to_string(ndim) + "D block with cells of different widths") {
+      const int nx = 8, nvar = 3, nl = 1, nu = 2;
+      MeshBlock pmb(nx, ndim);
+      pmb.block_size.x1min = pmb.block_size.x2min = pmb.block_size.x3min = 0.0;
+      pmb.block_size.x1max = 1.0, pmb.block_size.x2max = 2.0, pmb.block_size.x3max = 4.0;
+      pmb.coords = parthenon::Coordinates_t(pmb.block_size, nullptr);
+      // the first and last active cell, and the cells along each direction
+      const int s[3] = {pmb.ks, pmb.js, pmb.is}, e[3] = {pmb.ke, pmb.je, pmb.ie};
+      const int n[3] = {e[0] - s[0] + 1, e[1] - s[1] + 1, e[2] - s[2] + 1};
+      ParArray1D<Real> staging;
+
+      for (int f = 0; f < 2 * ndim; f++) {
+        const int dir = f / 2 + 1, d = 3 - dir;
+        // the (k, j, i) indices of the outer (a) and inner (b) tangential directions,
+        // ta < 0 if a has a single cell
+        const int ta = (dir == parthenon::X3DIR ? 1 : (ndim < 3 ? -1 : 0));
+        const int tb = (dir == parthenon::X1DIR ? 1 : 2);
+        // the face of the block normal to dir
+        int first[3] = {s[0], s[1], s[2]};
+        first[d] += n[d] * (f & 1);
+
+        NeighborBlock nb{};
+        nb.fid = static_cast<BoundaryFace>(f);
+        auto flux = Fluxes(pmb, dir, nvar);
+        auto h = flux.GetHostMirror();
+        for (int m = 0; m < nvar; m++)
+          for (int k = 0; k < h.GetDim(3); k++)
+            for (int j = 0; j < h.GetDim(2); j++)
+              for (int i = 0; i < h.GetDim(1); i++)
+                h(m, k, j, i) = Flux(dir, m, k, j, i);
+        flux.DeepCopy(h);
+
+        // the coarse faces along a and b, a has one face unless the block is 3D
+        const int nca = (ta < 0 ? 1 : n[ta] / 2), ncb = n[tb] / 2;
+        const int size = (nu - nl + 1) * nca * ncb;
+        std::vector<Real> buf(size);
+        REQUIRE(parthenon::PackFluxCorrection(&pmb, flux, nb, nl, nu, buf.data(),
+                                              staging) == size);
+
+        THEN("Face " + std::to_string(f) + " packs the area weighted average of the "
+                                           "fine fluxes") {
+          const auto &coords = pmb.coords;
+          for (int m = nl; m <= nu; m++) {
+            for (int a = 0; a < nca; a++) {
+              for (int b = 0; b < ncb; b++) {
+                Real tarea = 0.0, tflux = 0.0;
+                for (int ma = 0; ma <= (ta >= 0); ma++) {
+                  for (int mb = 0; mb <= 1; mb++) {
+                    int idx[3] = {first[0], first[1], first[2]};
+                    if (ta >= 0) idx[ta] += 2 * a + ma;
+                    idx[tb] += 2 * b + mb;
+                    const Real area = coords.Area(dir, idx[0], idx[1], idx[2]);
+                    tarea += area;
+                    tflux += area * h(m, idx[0], idx[1], idx[2]);
+                  }
+                }
+                REQUIRE(buf[((m - nl) * nca + a) * ncb + b] == Approx(tflux / tarea));
+              }
+            }
+          }
+        }
+
+        THEN("Face " + std::to_string(f ^ 1) + " of a coarser block applies the "
+                                               "corrections where the block covers it") {
+          // the coarse neighbor shares its opposite face
+          NeighborBlock cnb{};
+          cnb.fid = static_cast<BoundaryFace>(f ^ 1);
+          int cfirst[3] = {s[0], s[1], s[2]};
+          cfirst[d] += n[d] * ((f ^ 1) & 1);
+          for (int fi2 = 0; fi2 <= (ta >= 0); fi2++) {
+            for (int fi1 = 0; fi1 <= 1; fi1++) {
+              cnb.ni.fi1 = fi1, cnb.ni.fi2 = fi2;
+              auto cflux = Fluxes(pmb, dir, nvar);
+              parthenon::UnpackFluxCorrection(&pmb, cflux, cnb, nl, nu, buf.data(),
+                                              staging);
+              Kokkos::fence();
+              auto ch = cflux.GetHostMirrorAndCopy();
+              int nset = 0;
+              for (int m = 0; m < nvar; m++) {
+                for (int a = 0; a < (ta < 0 ? 1 : n[ta]); a++) {
+                  for (int b = 0; b < n[tb]; b++) {
+                    int idx[3] = {cfirst[0], cfirst[1], cfirst[2]};
+                    if (ta >= 0) idx[ta] += a;
+                    idx[tb] += b;
+                    const int ca = a - fi2 * nca, cb = b - fi1 * ncb;
+                    const bool covered = (m >= nl && m <= nu && ca >= 0 && ca < nca &&
+                                          cb >= 0 && cb < ncb);
+                    const Real value = ch(m, idx[0], idx[1], idx[2]);
+                    if (covered) {
+                      nset++;
+                      REQUIRE(value == buf[((m - nl) * nca + ca) * ncb + cb]);
+                    } else {
+                      REQUIRE(value == 0.0);
+                    }
+                  }
+                }
+              }
+              REQUIRE(nset == size);
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,182 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <array>
+#include <cstdio>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "kokkos_abstraction.hpp"
+#include "parthenon_arrays.hpp"
+#include "utils/loop_tuner.hpp"
+
+using parthenon::LoopPattern;
+using parthenon::Real;
+namespace LoopTuner = parthenon::LoopTuner;
+
+// fills a 3D array with the default par_for and returns the sum of its elements
+static Real FillAndSum(parthenon::ParArrayND<Real> a) {
+  parthenon::par_for(
+      "loop_tuner_fill", parthenon::DevExecSpace(), 0, a.GetDim(3) - 1, 0,
+      a.GetDim(2) - 1, 0, a.GetDim(1) - 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) { a(k, j, i) += 1.0; });
+  auto a_h = a.GetHostMirrorAndCopy();
+  Real sum = 0.0;
+  for (int k = 0; k < a.GetDim(3); k++)
+    for (int j = 0; j < a.GetDim(2); j++)
+      for (int i = 0; i < a.GetDim(1); i++)
+        sum += a_h(k, j, i);
+  return sum;
+}
+
+TEST_CASE("Loop pattern names are parsed", "[LoopTuner]") {
+  for (auto name : {"flatrange", "mdrange", "tpttr", "tptvr", "tpttrtvr", "simdfor",
+                    "tiled"})
+    REQUIRE(LoopTuner::PatternName(LoopTuner::ParsePattern(name)) == name);
+  REQUIRE(LoopTuner::ParsePattern("default") == LoopPattern::none);
+
+  // the tile of a tiled choice follows the pattern
+  const auto choice = LoopTuner::ParseChoice("tiled:2x16x0");
+  REQUIRE(choice.pattern == LoopPattern::tiled);
+  REQUIRE(choice.tile == std::array<int, 3>{2, 16, 0});
+  REQUIRE(LoopTuner::ChoiceName(choice) == "tiled:2x16x0");
+  REQUIRE(LoopTuner::ChoiceName(LoopTuner::ParseChoice("tiled")) == "tiled");
+  REQUIRE(LoopTuner::ParseChoice("mdrange").pattern == LoopPattern::mdrange);
+}
+
+TEST_CASE("The loop tuner selects and stores loop patterns", "[LoopTuner]") {
+  const std::string fname = "loop_tuner_test.txt";
+  std::remove(fname.c_str());
+
+  GIVEN("Tuning with a fixed pattern for one kernel") {
+    LoopTuner::Initialize(true, 1, fname, "default", " fixed : mdrange ");
+    REQUIRE(LoopTuner::Enabled());
+
+    THEN("The fixed kernel uses its pattern without trials") {
+      LoopTuner::ScopedTrial trial("fixed", {1, 2, 3, 4});
+      REQUIRE(trial.pattern() == LoopPattern::mdrange);
+    }
+
+    THEN("A tuned kernel gives the same results with every pattern and tile") {
+      parthenon::ParArrayND<Real> a("a", 4, 5, 6);
+      for (int n = 1; n <= 16; n++)
+        REQUIRE(FillAndSum(a) == n * 120.0);
+
+      AND_THEN("Its choice is read back from the tuning file") {
+        LoopTuner::Finalize();
+        LoopTuner::Initialize(true, 1, fname, "default", "");
+        LoopTuner::ScopedTrial trial("loop_tuner_fill", {1, 4, 5, 6});
+        REQUIRE(trial.pattern() != LoopPattern::none);
+        LoopTuner::ScopedTrial other("loop_tuner_fill", {1, 4, 5, 7});
+        REQUIRE(other.pattern() == LoopPattern::flatrange);
+      }
+    }
+  }
+
+  LoopTuner::Initialize(false, 1, fname, "default", "");
+  REQUIRE(!LoopTuner::Enabled());
+  std::remove(fname.c_str());
+}
+
+TEST_CASE("Overlapping trials are recorded for the pattern that ran", "[LoopTuner]") {
+  namespace detail = LoopTuner::detail;
+  const std::string fname = "loop_tuner_test_overlap.txt";
+  LoopTuner::Initialize(true, 1, fname, "default", "");
+  auto kernel = detail::Lookup("overlapping", {1, 2, 3, 4});
+
+  // two invocations start before either is recorded and both run the first candidate
+  bool trial1, trial2;
+  const LoopTuner::Choice first = detail::Select(kernel, trial1);
+  REQUIRE(detail::Select(kernel, trial2) == first);
+  REQUIRE((trial1 && trial2));
+  detail::Record(kernel, first, 5.0);
+  detail::Record(kernel, first, 1.0);
+
+  // all other patterns are slower than the fastest run of the first one
+  bool trial = true;
+  int nrecorded = 2;
+  while (true) {
+    const LoopTuner::Choice p = detail::Select(kernel, trial);
+    if (!trial) {
+      REQUIRE(p == first);
+      break;
+    }
+    REQUIRE(p != first);
+    detail::Record(kernel, p, 2.0);
+    REQUIRE(++nrecorded < 100);
+  }
+
+  LoopTuner::Initialize(false, 1, fname, "default", "");
+}
+
+TEST_CASE("The tile of the tiled pattern is tuned per kernel", "[LoopTuner]") {
+  namespace detail = LoopTuner::detail;
+  const std::string fname = "loop_tuner_test_tiles.txt";
+  std::remove(fname.c_str());
+  LoopTuner::Initialize(true, 1, fname, "default", "");
+  auto kernel = detail::Lookup("tiles", {1, 64, 64, 64});
+
+  // on the host the tiled pattern is tried with several tiles, the one with the 2x8 tile
+  // is the fastest here
+  const LoopTuner::Choice fast{LoopPattern::tiled, {2, 8, 0}};
+  bool trial = true;
+  int ntiles = 0;
+  while (true) {
+    const LoopTuner::Choice c = detail::Select(kernel, trial);
+    if (!trial) {
+      REQUIRE(c == (ntiles > 1 ? fast : c));
+      break;
+    }
+    if (c.pattern == LoopPattern::tiled) ntiles++;
+    detail::Record(kernel, c, c == fast ? 1.0 : 2.0);
+  }
+
+  if (ntiles > 1) {
+    // the tile is written to the tuning file and read back
+    LoopTuner::Finalize();
+    LoopTuner::Initialize(true, 1, fname, "default", "");
+    LoopTuner::ScopedTrial tuned("tiles", {1, 64, 64, 64});
+    REQUIRE(tuned.choice() == fast);
+  }
+
+  LoopTuner::Initialize(false, 1, fname, "default", "");
+  std::remove(fname.c_str());
+}
+
+TEST_CASE("Call sites cache their kernel until the tuner is initialized again",
+          "[LoopTuner]") {
+  namespace detail = LoopTuner::detail;
+  const std::string fname = "loop_tuner_test_cache.txt";
+  LoopTuner::Initialize(true, 1, fname, "default", "");
+  detail::SiteCache cache;
+  auto kernel = detail::Lookup("cached", {1, 2, 3, 4}, cache);
+  REQUIRE(kernel == detail::Lookup("cached", {1, 2, 3, 4}));
+  REQUIRE(detail::Lookup("cached", {1, 2, 3, 4}, cache) == kernel);
+
+  // another shape or name is another kernel
+  REQUIRE(detail::Lookup("cached", {1, 2, 3, 5}, cache) != kernel);
+  REQUIRE(detail::Lookup("cached", {1, 2, 3, 5}, cache) ==
+          detail::Lookup("cached", {1, 2, 3, 5}));
+  REQUIRE(detail::Lookup("other", {1, 2, 3, 5}, cache) ==
+          detail::Lookup("other", {1, 2, 3, 5}));
+
+  // Initialize discards all kernels
+  LoopTuner::Initialize(true, 1, fname, "mdrange", "");
+  kernel = detail::Lookup("other", {1, 2, 3, 5}, cache);
+  REQUIRE(kernel == detail::Lookup("other", {1, 2, 3, 5}));
+  LoopTuner::ScopedTrial trial("other", {1, 2, 3, 5}, cache);
+  REQUIRE(trial.pattern() == LoopPattern::mdrange);
+
+  LoopTuner::Initialize(false, 1, fname, "default", "");
+}
@@ -0,0 +1,232 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/meshblock_tree.hpp"
+
+using parthenon::LogicalLocation;
+using parthenon::MeshBlockTree;
+using parthenon::RootGridInfo;
+
+static RootGridInfo MakeRootGrid(int nrb, bool periodic) {
+  RootGridInfo grid;
+  grid.ndim = 3;
+  for (grid.root_level = 0; (1 << grid.root_level) < nrb; grid.root_level++) {
+  }
+  grid.nrbx1 = grid.nrbx2 = grid.nrbx3 = nrb;
+  for (int f = 0; f < 6; f++)
+    grid.periodic[f] = periodic;
+  return grid;
+}
+
+static LogicalLocation MakeLoc(std::int64_t lx1, std::int64_t lx2, std::int64_t lx3,
+                               int level) {
+  LogicalLocation loc;
+  loc.lx1 = lx1, loc.lx2 = lx2, loc.lx3 = lx3, loc.level = level;
+  return loc;
+}
+
+static bool SameLoc(const LogicalLocation &a, const LogicalLocation &b) {
+  return parthenon::LogicalLocationEqual()(a, b);
+}
+
+// the search MeshBlockTree::FindNeighbor used before the index: descend from the root
+// one level at a time, for a periodic grid
+static MeshBlockTree *FindNeighborFromRoot(MeshBlockTree &tree, const RootGridInfo &grid,
+                                           const LogicalLocation &loc, int ox1, int ox2,
+                                           int ox3) {
+  const int ll = loc.level;
+  auto wrap = [&](std::int64_t l, int nrb) {
+    const std::int64_t n = static_cast<std::int64_t>(nrb) << (ll - grid.root_level);
+    return (l + n) % n;
+  };
+  std::int64_t lx = wrap(loc.lx1 + ox1, grid.nrbx1);
+  std::int64_t ly = wrap(loc.lx2 + ox2, grid.nrbx2);
+  std::int64_t lz = wrap(loc.lx3 + ox3, grid.nrbx3);
+  MeshBlockTree *bt = &tree;
+  for (int level = 0; level < ll; level++) {
+    if (bt->IsLeaf()) return bt; // coarser neighbor
+    int sh = ll - level - 1;
+    bt = bt->GetLeaf((lx >> sh) & 1, (ly >> sh) & 1, (lz >> sh) & 1);
+  }
+  return bt;
+}
+
+template <typename Search>
+static std::int64_t CountNeighbors(Search &&search,
+                                   const std::vector<LogicalLocation> &list) {
+  std::int64_t nneighbors = 0;
+  for (auto &loc : list) {
+    for (int ox3 = -1; ox3 <= 1; ox3++) {
+      for (int ox2 = -1; ox2 <= 1; ox2++) {
+        for (int ox1 = -1; ox1 <= 1; ox1++) {
+          if (ox1 == 0 && ox2 == 0 && ox3 == 0) continue;
+          MeshBlockTree *neibt = search(loc, ox1, ox2, ox3);
+          if (neibt == nullptr) continue;
+          if (neibt->IsLeaf()) {
+            nneighbors++;
+            continue;
+          }
+          // finer neighbors touching this block: both halves along the directions
+          // without offset, the half facing this block otherwise
+          auto fs = [](int ox) { return ox == 0 ? 0 : (1 - ox) / 2; };
+          auto fe = [](int ox) { return ox == 0 ? 1 : (1 - ox) / 2; };
+          for (int f3 = fs(ox3); f3 <= fe(ox3); f3++) {
+            for (int f2 = fs(ox2); f2 <= fe(ox2); f2++) {
+              for (int f1 = fs(ox1); f1 <= fe(ox1); f1++) {
+                if (neibt->GetLeaf(f1, f2, f3)->GetGid() >= 0) nneighbors++;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return nneighbors;
+}
+
+// visits all neighbors of all blocks like BoundaryBase::SearchAndSetNeighbors and
+// returns the number of neighbor blocks found
+static std::int64_t FindAllNeighbors(MeshBlockTree &tree,
+                                     const std::vector<LogicalLocation> &list) {
+  return CountNeighbors(
+      [&](const LogicalLocation &loc, int ox1, int ox2, int ox3) {
+        return tree.FindNeighbor(loc, ox1, ox2, ox3);
+      },
+      list);
+}
+
+// the same with the search from the root
+static std::int64_t FindAllNeighborsFromRoot(MeshBlockTree &tree,
+                                             const RootGridInfo &grid,
+                                             const std::vector<LogicalLocation> &list) {
+  return CountNeighbors(
+      [&](const LogicalLocation &loc, int ox1, int ox2, int ox3) {
+        return FindNeighborFromRoot(tree, grid, loc, ox1, ox2, ox3);
+      },
+      list);
+}
+
+// refines all root blocks within a sphere around the center of the domain
+static void RefineSphere(MeshBlockTree &tree, const RootGridInfo &grid, double radius) {
+  int nnew = 0;
+  double c = 0.5 * (grid.nrbx1 - 1);
+  for (std::int64_t k = 0; k < grid.nrbx3; k++) {
+    for (std::int64_t j = 0; j < grid.nrbx2; j++) {
+      for (std::int64_t i = 0; i < grid.nrbx1; i++) {
+        double r2 = (i - c) * (i - c) + (j - c) * (j - c) + (k - c) * (k - c);
+        if (r2 > radius * radius) continue;
+        tree.AddMeshBlock(MakeLoc(2 * i, 2 * j, 2 * k, grid.root_level + 1), nnew);
+      }
+    }
+  }
+}
+
+static std::vector<LogicalLocation> GetList(MeshBlockTree &tree) {
+  int nbtotal;
+  tree.CountMeshBlock(nbtotal);
+  std::vector<LogicalLocation> list(nbtotal);
+  tree.GetMeshBlockList(list.data(), nullptr, nbtotal);
+  return list;
+}
+
+TEST_CASE("MeshBlockTree finds neighbors through its index", "[MeshBlockTree]") {
+  GIVEN("A periodic 4x4x4 root grid with one refined block") {
+    RootGridInfo grid = MakeRootGrid(4, true);
+    MeshBlockTree tree(nullptr);
+    tree.CreateRootGrid(grid);
+    int nnew = 0;
+    tree.AddMeshBlock(MakeLoc(2, 2, 2, 3), nnew);
+    auto list = GetList(tree);
+
+    THEN("The refined block is replaced by eight finer ones") {
+      REQUIRE(list.size() == 64 - 1 + 8);
+      REQUIRE(tree.FindMeshBlock(MakeLoc(3, 3, 3, 3))->IsLeaf());
+      REQUIRE_FALSE(tree.FindMeshBlock(MakeLoc(1, 1, 1, 2))->IsLeaf());
+      REQUIRE(tree.FindMeshBlock(MakeLoc(4, 4, 4, 3)) == nullptr);
+    }
+    THEN("Neighbors on the same level are found across periodic boundaries") {
+      MeshBlockTree *bt = tree.FindNeighbor(MakeLoc(0, 0, 0, 2), -1, 0, -1);
+      REQUIRE(bt->IsLeaf());
+      REQUIRE(SameLoc(bt->GetLocation(), MakeLoc(3, 0, 3, 2)));
+    }
+    THEN("A coarser neighbor is returned for a fine block") {
+      MeshBlockTree *bt = tree.FindNeighbor(MakeLoc(2, 2, 2, 3), -1, 0, 0);
+      REQUIRE(bt->IsLeaf());
+      REQUIRE(SameLoc(bt->GetLocation(), MakeLoc(0, 1, 1, 2)));
+    }
+    THEN("The parent of finer neighbors is returned for a coarse block") {
+      MeshBlockTree *bt = tree.FindNeighbor(MakeLoc(0, 1, 1, 2), 1, 0, 0);
+      REQUIRE_FALSE(bt->IsLeaf());
+      REQUIRE(SameLoc(bt->GetLeaf(0, 1, 0)->GetLocation(), MakeLoc(2, 3, 2, 3)));
+    }
+    THEN("Every block has 26 neighbor regions") {
+      // coarse blocks see one block per region except for the 6 (12) sharing a face
+      // (an edge) with the refined block, which see 4 (2) finer blocks there; the 8 fine
+      // blocks see 7 fine and 19 coarse neighbors
+      REQUIRE(FindAllNeighbors(tree, list) == 63 * 26 + 6 * 3 + 12 * 1 + 8 * 26);
+    }
+    THEN("The index finds the same neighbors as the search from the root") {
+      for (auto &loc : list)
+        for (int ox3 = -1; ox3 <= 1; ox3++)
+          for (int ox2 = -1; ox2 <= 1; ox2++)
+            for (int ox1 = -1; ox1 <= 1; ox1++)
+              REQUIRE(tree.FindNeighbor(loc, ox1, ox2, ox3) ==
+                      FindNeighborFromRoot(tree, grid, loc, ox1, ox2, ox3));
+    }
+  }
+
+  GIVEN("A non-periodic root grid") {
+    RootGridInfo grid = MakeRootGrid(4, false);
+    MeshBlockTree tree(nullptr);
+    tree.CreateRootGrid(grid);
+    THEN("There are no neighbors beyond the domain boundary") {
+      REQUIRE(tree.FindNeighbor(MakeLoc(0, 2, 2, 2), -1, 0, 0) == nullptr);
+      REQUIRE(tree.FindNeighbor(MakeLoc(3, 2, 2, 2), 1, 0, 0) == nullptr);
+      REQUIRE(tree.FindNeighbor(MakeLoc(3, 2, 2, 2), -1, 0, 0) != nullptr);
+    }
+  }
+}
+
+TEST_CASE("MeshBlockTree neighbor search scales with the number of blocks",
+          "[MeshBlockTree][performance]") {
+  // about 10^3 to 3*10^4 blocks; a sphere in the center is refined once
+  for (int nrb : {10, 16, 32}) {
+    RootGridInfo grid = MakeRootGrid(nrb, true);
+    MeshBlockTree tree(nullptr);
+    Kokkos::Timer timer;
+    tree.CreateRootGrid(grid);
+    RefineSphere(tree, grid, nrb / 8.0);
+    auto list = GetList(tree);
+    double t_build = timer.seconds();
+    timer.reset();
+    std::int64_t nneighbors = FindAllNeighbors(tree, list);
+    double t_index = timer.seconds();
+    timer.reset();
+    std::int64_t nneighbors_root = FindAllNeighborsFromRoot(tree, grid, list);
+    double t_root = timer.seconds();
+    const double ndir = 26.0 * list.size();
+    std::cout << "MeshBlockTree with " << list.size() << " blocks: build " << t_build
+              << " s, neighbor search " << 1.0e9 * t_index / ndir
+              << " ns per direction with the index, " << 1.0e9 * t_root / ndir
+              << " ns from the root" << std::endl;
+    REQUIRE(nneighbors >= 26 * static_cast<std::int64_t>(list.size()));
+    REQUIRE(nneighbors == nneighbors_root);
+  }
+}
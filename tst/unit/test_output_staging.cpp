@@ -0,0 +1,109 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <array>
+#include <string>
+#include <type_traits>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "interface/metadata.hpp"
+#include "interface/variable.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "parthenon_arrays.hpp"
+
+using parthenon::CellVariable;
+using parthenon::DevExecSpace;
+using parthenon::MeshBlock;
+using parthenon::Metadata;
+using parthenon::OutputStaging;
+using parthenon::par_for;
+using parthenon::ParArrayHost;
+using parthenon::Real;
+
+// sets all cells of a variable to value
+static void Fill(CellVariable<Real> &var, const Real value) {
+  auto v = var.data;
+  par_for(
+      "Fill variable", DevExecSpace(), 0, v.GetDim(3) - 1, 0, v.GetDim(2) - 1, 0,
+      v.GetDim(1) - 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) { v(k, j, i) = value; });
+  Kokkos::fence();
+}
+
+// whether all cells of a host copy equal value
+static bool AllEqual(const ParArrayHost<Real> &h, const Real value) {
+  for (int k = 0; k < h.GetDim(3); k++)
+    for (int j = 0; j < h.GetDim(2); j++)
+      for (int i = 0; i < h.GetDim(1); i++)
+        if (h(k, j, i) != value) return false;
+  return true;
+}
+
+TEST_CASE("Outputs of one cycle share their host copies", "[OutputStaging]") {
+  // on CPUs the host copies are the variables themselves
+  constexpr bool alias =
+      std::is_same<typename parthenon::host_view_t<Real>::memory_space,
+                   typename parthenon::device_view_t<Real>::memory_space>::value;
+
+  GIVEN("A MeshBlock with two variables") {
+    MeshBlock pmb(8, 3);
+    pmb.gid = 0;
+    const std::array<int, 6> dims({8, 8, 8, 1, 1, 1});
+    Metadata m({Metadata::Independent});
+    CellVariable<Real> a("a", dims, m);
+    CellVariable<Real> b("b", dims, m);
+    Fill(a, 1.0);
+    Fill(b, 2.0);
+
+    OutputStaging staging;
+    REQUIRE(staging.NumCopies() == 0);
+
+    WHEN("two output types write both variables in the same cycle") {
+      staging.BeginOutputs(0, 0);
+      const auto &ha = staging.Get(&pmb, a);
+      const auto &hb = staging.Get(&pmb, b);
+      const auto &ha2 = staging.Get(&pmb, a);
+      const auto &hb2 = staging.Get(&pmb, b);
+
+      THEN("each variable is copied once and both outputs see the same copy") {
+        REQUIRE(&ha == &ha2);
+        REQUIRE(&hb == &hb2);
+        REQUIRE(staging.NumCopies() == (alias ? 0 : 2));
+        REQUIRE(AllEqual(ha, 1.0));
+        REQUIRE(AllEqual(hb, 2.0));
+        if (alias) {
+          REQUIRE(ha.Get().data() == a.data.Get().data());
+          REQUIRE(hb.Get().data() == b.data.Get().data());
+        }
+      }
+
+      AND_WHEN("the variables change before the next cycle's outputs") {
+        Fill(a, 3.0);
+        Fill(b, 4.0);
+        staging.BeginOutputs(0, 0);
+        const auto &ha3 = staging.Get(&pmb, a);
+        const auto &hb3 = staging.Get(&pmb, b);
+        staging.Get(&pmb, a);
+
+        THEN("they are copied again, once each") {
+          REQUIRE(staging.NumCopies() == (alias ? 0 : 4));
+          REQUIRE(AllEqual(ha3, 3.0));
+          REQUIRE(AllEqual(hb3, 4.0));
+        }
+      }
+    }
+  }
+}
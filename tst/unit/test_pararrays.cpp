@@ -21,6 +21,7 @@
 #include <iostream>
 #include <random>
 #include <string>
+#include <utility>
 
 #include <catch2/catch.hpp>
 
@@ -29,6 +30,7 @@
 
 using parthenon::DevExecSpace;
 using parthenon::DevMemSpace;
+using parthenon::ParArray1D;
 using parthenon::ParArray3D;
 using parthenon::ParArrayND;
 using Real = double;
@@ -636,3 +638,91 @@ TEST_CASE("Check many arrays", "[ParArrayND][performance]") {
             << "\tsub views   = " << time_subviews << " s\n"
             << std::endl;
 }
+
+// the outer views of the variable packs, holding nvars 3D arrays of extents N each
+void fill_outer(ParArrayND<ParArray3D<Real>> &outer, const ParArray3D<Real> &arr,
+                const int nvars) {
+  auto outer_h = outer.GetHostMirror();
+  for (int n = 0; n < nvars; n++)
+    outer_h(n) = Kokkos::subview(arr, std::make_pair(n * N, (n + 1) * N), Kokkos::ALL(),
+                                 Kokkos::ALL());
+  outer.DeepCopy(outer_h);
+}
+
+void fill_outer(ParArray1D<ParArray3D<Real>> &outer, const ParArray3D<Real> &arr,
+                const int nvars) {
+  auto outer_h = Kokkos::create_mirror_view(outer);
+  for (int n = 0; n < nvars; n++)
+    outer_h(n) = Kokkos::subview(arr, std::make_pair(n * N, (n + 1) * N), Kokkos::ALL(),
+                                 Kokkos::ALL());
+  Kokkos::deep_copy(outer, outer_h);
+}
+
+// times nruns of UpdateContainer and FluxDivergence like kernels over the outer views
+// of the variable packs and returns the achieved bandwidths in GB/s
+template <typename Outer>
+std::pair<double, double> time_pack_kernels(const std::string &name, const int nvars) {
+  auto exec_space = DevExecSpace();
+  Kokkos::Timer timer;
+  const int nruns = 10;
+  const Real dt = 0.1;
+  ParArray3D<Real> in_data("in", nvars * N, N, N), out_data("out", nvars * N, N, N),
+      dudt_data("dudt", nvars * N, N, N), flux_data("flux", nvars * N, N, N);
+  Outer in("in", nvars), out("out", nvars), dudt("dudt", nvars), flux("flux", nvars);
+  fill_outer(in, in_data, nvars);
+  fill_outer(out, out_data, nvars);
+  fill_outer(dudt, dudt_data, nvars);
+  fill_outer(flux, flux_data, nvars);
+
+  auto update = [&]() {
+    parthenon::par_for(
+        parthenon::loop_pattern_flatrange_tag, "update " + name, exec_space, 0,
+        nvars - 1, 0, N - 1, 0, N - 1, 0, N - 1,
+        KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          out(n)(k, j, i) = in(n)(k, j, i) + dt * dudt(n)(k, j, i);
+        });
+  };
+  auto divergence = [&]() {
+    parthenon::par_for(
+        parthenon::loop_pattern_flatrange_tag, "divergence " + name, exec_space, 0,
+        nvars - 1, NG, N - 1 - NG, NG, N - 1 - NG, NG, N - 1 - NG,
+        KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+          dudt(n)(k, j, i) = -((flux(n)(k, j, i + 1) - flux(n)(k, j, i)) +
+                               (flux(n)(k, j + 1, i) - flux(n)(k, j, i)) +
+                               (flux(n)(k + 1, j, i) - flux(n)(k, j, i)));
+        });
+  };
+
+  // warmup first
+  update();
+  divergence();
+  Kokkos::fence();
+  timer.reset();
+  for (int run = 0; run < nruns; run++)
+    update();
+  Kokkos::fence();
+  auto time_update = timer.seconds();
+  timer.reset();
+  for (int run = 0; run < nruns; run++)
+    divergence();
+  Kokkos::fence();
+  auto time_divergence = timer.seconds();
+
+  // three arrays are moved by the update and two by the flux divergence
+  const double gb = nruns * nvars * N * N * N * sizeof(Real) / 1.0e9;
+  return std::make_pair(3 * gb / time_update, 2 * gb / time_divergence);
+}
+
+TEST_CASE("Bandwidth of the variable pack kernels", "[ParArrayND][performance]") {
+  const int nvars = 8;
+  // the outer view of the packs before and after it was made rank 1
+  auto nd = time_pack_kernels<ParArrayND<ParArray3D<Real>>>("ParArrayND", nvars);
+  auto rank1 = time_pack_kernels<ParArray1D<ParArray3D<Real>>>("ParArray1D", nvars);
+
+  std::cout << "Bandwidth of the variable pack kernels:\n"
+            << "\tUpdateContainer ND outer view     = " << nd.first << " GB/s\n"
+            << "\tUpdateContainer 1D outer view     = " << rank1.first << " GB/s\n"
+            << "\tFluxDivergence  ND outer view     = " << nd.second << " GB/s\n"
+            << "\tFluxDivergence  1D outer view     = " << rank1.second << " GB/s\n"
+            << std::endl;
+}
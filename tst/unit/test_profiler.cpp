@@ -0,0 +1,124 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include "globals.hpp"
+#include "utils/profiler.hpp"
+
+namespace Profiler = parthenon::Profiler;
+using Profiler::ScopedRegion;
+
+// the calls of a region so far, a lookup creates an empty region
+static std::uint64_t Calls(const std::string &name) {
+  return Profiler::detail::Lookup(name)->calls;
+}
+
+static void Sleep() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+
+TEST_CASE("Disabled regions are not timed", "[Profiler]") {
+  Profiler::Initialize(false);
+  Profiler::Reset();
+  REQUIRE(Profiler::Enabled() == false);
+  {
+    ScopedRegion region("disabled");
+    ScopedRegion kernel("disabled kernel", true);
+  }
+  REQUIRE(Calls("disabled") == 0);
+  REQUIRE(Calls("disabled kernel") == 0);
+
+  // nothing is written either
+  const std::string fname = "profiler_test_disabled.json";
+  std::remove(fname.c_str());
+  Profiler::Finalize(fname);
+  REQUIRE(!std::ifstream(fname).good());
+}
+
+TEST_CASE("Nested regions are counted and timed", "[Profiler]") {
+  Profiler::Initialize(true);
+  Profiler::Reset();
+  for (int n = 0; n < 3; n++) {
+    ScopedRegion outer("outer");
+    Sleep();
+    for (int m = 0; m < 2; m++) {
+      ScopedRegion inner("inner", true);
+      Sleep();
+    }
+  }
+  const auto &outer = *Profiler::detail::Lookup("outer");
+  const auto &inner = *Profiler::detail::Lookup("inner");
+  REQUIRE(outer.calls == 3);
+  REQUIRE(inner.calls == 6);
+  // each outer call contains two inner ones
+  REQUIRE(inner.min > 0.0);
+  REQUIRE(inner.min <= inner.max);
+  REQUIRE(outer.min >= 2 * inner.min);
+  REQUIRE(outer.total >= inner.total);
+  REQUIRE(outer.total >= 3 * outer.min);
+  REQUIRE(outer.total <= 3 * outer.max);
+
+  Profiler::Reset();
+  REQUIRE(Calls("outer") == 0);
+  Profiler::Initialize(false);
+}
+
+// Finalize reduces over the ranks with MPI, which the unit tests do not initialize
+#ifndef MPI_PARALLEL
+TEST_CASE("The JSON summary lists the regions by their maximum time", "[Profiler]") {
+  const int nranks = parthenon::Globals::nranks;
+  parthenon::Globals::nranks = 1;
+  Profiler::Initialize(true);
+  Profiler::Reset();
+  {
+    ScopedRegion slow("slow \"quoted\"");
+    Sleep();
+    Sleep();
+  }
+  for (int n = 0; n < 4; n++) {
+    ScopedRegion fast("fast");
+  }
+  Profiler::detail::Lookup("never called");
+
+  const std::string fname = "profiler_test.json";
+  Profiler::Finalize(fname);
+  std::ifstream is(fname);
+  REQUIRE(is.good());
+  std::stringstream ss;
+  ss << is.rdbuf();
+  const std::string json = ss.str();
+
+  REQUIRE(json.find("\"nranks\": 1") != std::string::npos);
+  // names are escaped and regions that were never called are left out
+  const auto slow =
+      json.find("{\"name\": \"slow \\\"quoted\\\"\", \"ranks\": 1, \"calls\": 1,");
+  const auto fast = json.find("{\"name\": \"fast\", \"ranks\": 1, \"calls\": 4,");
+  REQUIRE(slow != std::string::npos);
+  REQUIRE(fast != std::string::npos);
+  REQUIRE(slow < fast);
+  REQUIRE(json.find("never called") == std::string::npos);
+  for (const std::string key :
+       {"time_min", "time_avg", "time_max", "call_min", "call_max"})
+    REQUIRE(json.find("\"" + key + "\": ") != std::string::npos);
+
+  std::remove(fname.c_str());
+  Profiler::Reset();
+  Profiler::Initialize(false);
+  parthenon::Globals::nranks = nranks;
+}
+#endif
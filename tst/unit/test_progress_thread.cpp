@@ -0,0 +1,87 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include "bvals/bvals_interfaces.hpp"
+#include "bvals/progress_thread.hpp"
+
+using parthenon::BoundaryStatus;
+namespace ProgressThread = parthenon::ProgressThread;
+
+// Without MPI the thread completes stand-in requests, with MPI the unit tests do not
+// initialize MPI
+#ifndef MPI_PARALLEL
+TEST_CASE("Requests are tested and waited for without the thread", "[ProgressThread]") {
+  REQUIRE(!ProgressThread::Enabled());
+  std::atomic<bool> complete{false};
+  std::atomic<BoundaryStatus> flag{BoundaryStatus::waiting};
+  ProgressThread::Request req{&complete};
+
+  // Post does nothing without the thread, Test and Wait check the request itself
+  ProgressThread::Post(&req, &flag, BoundaryStatus::arrived);
+  REQUIRE(!ProgressThread::Test(&req, &flag, BoundaryStatus::arrived));
+  complete = true;
+  ProgressThread::Wait(&req, &flag, BoundaryStatus::arrived);
+  REQUIRE(req.complete == nullptr);
+  REQUIRE(flag == BoundaryStatus::waiting);
+}
+
+TEST_CASE("The thread completes the posted requests", "[ProgressThread]") {
+  ProgressThread::Initialize(true);
+  REQUIRE(ProgressThread::Enabled());
+  const int n = 3;
+  std::atomic<bool> complete[n];
+  std::atomic<BoundaryStatus> flag[n];
+  ProgressThread::Request req[n];
+  for (int m = 0; m < n; m++) {
+    complete[m] = false;
+    flag[m] = BoundaryStatus::completed;
+    req[m].complete = &complete[m];
+    ProgressThread::Post(&req[m], &flag[m], BoundaryStatus::arrived);
+    // the flag is reset when the request is posted
+    REQUIRE(flag[m] != BoundaryStatus::arrived);
+  }
+
+  // the requests complete in any order and only the flag of a completed one is set
+  complete[1] = true;
+  ProgressThread::Wait(&req[1], &flag[1], BoundaryStatus::arrived);
+  REQUIRE(req[1].complete == nullptr);
+  REQUIRE(!ProgressThread::Test(&req[0], &flag[0], BoundaryStatus::arrived));
+  REQUIRE(!ProgressThread::Test(&req[2], &flag[2], BoundaryStatus::arrived));
+
+  // a request that completes after the thread has backed off to sleeping is still seen
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  complete[0] = true;
+  ProgressThread::Wait(&req[0], &flag[0], BoundaryStatus::arrived);
+  REQUIRE(req[0].complete == nullptr);
+  REQUIRE(!ProgressThread::Test(&req[2], &flag[2], BoundaryStatus::arrived));
+
+  // as is a request that is posted while it sleeps
+  std::atomic<bool> late{true};
+  std::atomic<BoundaryStatus> late_flag{BoundaryStatus::waiting};
+  ProgressThread::Request late_req{&late};
+  ProgressThread::Post(&late_req, &late_flag, BoundaryStatus::completed);
+  ProgressThread::Wait(&late_req, &late_flag, BoundaryStatus::completed);
+  REQUIRE(late_flag == BoundaryStatus::completed);
+
+  complete[2] = true;
+  ProgressThread::Wait(&req[2], &flag[2], BoundaryStatus::arrived);
+  REQUIRE(ProgressThread::Test(&req[2], &flag[2], BoundaryStatus::arrived));
+  ProgressThread::Finalize();
+  REQUIRE(!ProgressThread::Enabled());
+}
+#endif
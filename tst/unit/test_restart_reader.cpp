@@ -0,0 +1,149 @@
+//========================================================================================
+// (C) (or copyright) 2020. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "athena.hpp"
+#include "basic_types.hpp"
+#include "interface/metadata.hpp"
+#include "interface/variable.hpp"
+#include "kokkos_abstraction.hpp"
+#include "outputs/io_wrapper.hpp"
+#include "outputs/restart.hpp"
+
+using parthenon::CellVariable;
+using parthenon::IOWrapper;
+using parthenon::IOWrapperSizeT;
+using parthenon::Metadata;
+using parthenon::Real;
+using parthenon::RestartReader;
+
+// the IOWrapper needs MPI to be initialized when built with MPI, the unit tests don't
+#ifndef MPI_PARALLEL
+
+using VarList = std::vector<std::shared_ptr<CellVariable<Real>>>;
+
+// value stored for element n of variable v of block b
+static Real RestartValue(int b, int v, int n) { return 1.0e6 * b + 1.0e4 * v + n; }
+
+static VarList MakeVars() {
+  Metadata m({Metadata::Independent});
+  VarList vars;
+  vars.push_back(std::make_shared<CellVariable<Real>>(
+      "scalar", std::array<int, 6>{20, 20, 20, 1, 1, 1}, m));
+  vars.push_back(std::make_shared<CellVariable<Real>>(
+      "vector", std::array<int, 6>{20, 20, 20, 3, 1, 1}, m));
+  return vars;
+}
+
+static bool BlockMatches(int b, const VarList &vars) {
+  for (int v = 0; v < vars.size(); v++) {
+    auto h = vars[v]->data.GetHostMirrorAndCopy();
+    const Real *p = h.Get().data();
+    for (int n = 0; n < vars[v]->data.GetSize(); n++) {
+      if (p[n] != RestartValue(b, v, n)) return false;
+    }
+  }
+  return true;
+}
+
+TEST_CASE("RestartReader loads MeshBlock data", "[RestartReader]") {
+  GIVEN("A restart file with a parameter header and the data of several blocks") {
+    const std::string fname = "restart_reader_test.rst";
+    const int nblocks = 8;
+    VarList vars = MakeVars();
+    IOWrapperSizeT blocksize = 0;
+    for (auto &pvar : vars)
+      blocksize += pvar->data.GetSize() * sizeof(Real);
+    // the offsets of the block index followed by the size of the data section
+    std::vector<IOWrapperSizeT> offsets(nblocks + 1);
+    for (int b = 0; b <= nblocks; b++)
+      offsets[b] = b * blocksize;
+    // a header length that is not a multiple of the page size
+    const std::string header = "<job>\nproblem_id = test\n<par_end>\n";
+    IOWrapperSizeT data_offset = header.size();
+
+    std::FILE *fp = std::fopen(fname.c_str(), "wb");
+    REQUIRE(fp != nullptr);
+    std::fwrite(header.c_str(), 1, header.size(), fp);
+    for (int b = 0; b < nblocks; b++) {
+      for (int v = 0; v < vars.size(); v++) {
+        std::vector<Real> block(vars[v]->data.GetSize());
+        for (int n = 0; n < block.size(); n++)
+          block[n] = RestartValue(b, v, n);
+        std::fwrite(block.data(), sizeof(Real), block.size(), fp);
+      }
+    }
+    std::fclose(fp);
+
+    IOWrapper resfile;
+    resfile.Open(fname.c_str(), IOWrapper::FileMode::read);
+
+    // a rank owning blocks [nbs, nbs + nb)
+    const int nbs = 3, nb = 4;
+    auto load_all = [&](bool use_mmap) {
+      Kokkos::Timer timer;
+      RestartReader reader(resfile, data_offset, offsets);
+      reader.ReadBlocks(nbs, nb, use_mmap);
+      bool ok = true;
+      for (int b = nbs; b < nbs + nb; b++) {
+        reader.LoadBlock(b, vars);
+        ok = ok && BlockMatches(b, vars);
+      }
+      Kokkos::fence();
+      std::cout << "RestartReader with" << (reader.IsMapped() ? " mmap " : " reads ")
+                << "took " << timer.seconds() << " s" << std::endl;
+      return ok;
+    };
+
+    WHEN("The blocks are read through the IOWrapper") {
+      THEN("Every variable holds the values of its block") { REQUIRE(load_all(false)); }
+    }
+    WHEN("The blocks are memory mapped") {
+      THEN("Every variable holds the values of its block") { REQUIRE(load_all(true)); }
+    }
+    WHEN("The blocks are distributed over a different number of ranks") {
+      // e.g. 8 blocks written by 2 ranks and restarted on 3
+      const std::vector<int> nslist{0, 3, 6}, nblist{3, 3, 2};
+      bool ok = true;
+      for (int r = 0; r < nslist.size(); r++) {
+        RestartReader reader(resfile, data_offset, offsets);
+        reader.ReadBlocks(nslist[r], nblist[r], false);
+        for (int b = nslist[r]; b < nslist[r] + nblist[r]; b++) {
+          REQUIRE(reader.BlockSize(b) == blocksize);
+          reader.LoadBlock(b, vars);
+          ok = ok && BlockMatches(b, vars);
+        }
+      }
+      THEN("Each rank reads the values of the blocks assigned to it") { REQUIRE(ok); }
+    }
+#ifdef ENABLE_EXCEPTIONS
+    WHEN("A block outside the read range is requested") {
+      RestartReader reader(resfile, data_offset, offsets);
+      reader.ReadBlocks(nbs, nb, true);
+      THEN("An error is raised") { REQUIRE_THROWS(reader.LoadBlock(nbs + nb, vars)); }
+    }
+#endif
+
+    resfile.Close();
+    std::remove(fname.c_str());
+  }
+}
+
+#endif // MPI_PARALLEL
@@ -16,12 +16,19 @@
 //========================================================================================
 
 #include <string>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
 #include "task_list/tasks.hpp"
 
+using parthenon::SimpleTask;
 using parthenon::TaskID;
+using parthenon::TaskList;
+using parthenon::TaskListStatus;
+using parthenon::TaskRegion;
+using parthenon::TaskStatus;
+namespace TaskPriority = parthenon::TaskPriority;
 
 TEST_CASE("Just check everything", "[CheckDependencies][SetFinished][equal][or]") {
   GIVEN("Some TaskIDs") {
@@ -50,3 +57,80 @@ TEST_CASE("Just check everything", "[CheckDependencies][SetFinished][equal][or]"
     }
   }
 }
+
+TEST_CASE("Order of the ready tasks", "[TaskList][DoAvailable][SetTaskPriority]") {
+  GIVEN("A task list with a chain, a leaf and a communication task") {
+    std::vector<int> order;
+    auto Record = [&order](int n) {
+      return [&order, n]() {
+        order.push_back(n);
+        return TaskStatus::complete;
+      };
+    };
+    auto MakeList = [&](TaskList &tl) {
+      TaskID none(0);
+      auto t1 = tl.AddTask<SimpleTask>(Record(1), none);
+      tl.AddTask<SimpleTask>(Record(2), none);
+      auto t3 = tl.AddTask<SimpleTask>(Record(3), t1);
+      tl.AddTask<SimpleTask>(Record(4), t3);
+      auto t5 = tl.AddTask<SimpleTask>(Record(5), t1);
+      tl.SetTaskPriority(t5, TaskPriority::communication);
+    };
+
+    WHEN("the tasks are prioritized") {
+      TaskList::SetPrioritized(true);
+      TaskList tl;
+      MakeList(tl);
+      THEN("the tasks run by priority, then by critical path, in one call") {
+        REQUIRE(tl.DoAvailable() == TaskListStatus::complete);
+        REQUIRE(order == std::vector<int>{1, 5, 3, 2, 4});
+      }
+    }
+
+    WHEN("the tasks are not prioritized") {
+      TaskList::SetPrioritized(false);
+      TaskList tl;
+      MakeList(tl);
+      THEN("the tasks run in the order they were added") {
+        REQUIRE(tl.DoAvailable() == TaskListStatus::complete);
+        REQUIRE(order == std::vector<int>{1, 2, 3, 4, 5});
+      }
+      TaskList::SetPrioritized(true);
+    }
+  }
+}
+
+TEST_CASE("Collective tasks of a task region", "[TaskRegion][AddCollectiveTask]") {
+  GIVEN("A region of two block lists and a rank list") {
+    std::vector<std::string> order;
+    auto Record = [&order](const std::string &name) {
+      return [&order, name]() {
+        order.push_back(name);
+        return TaskStatus::complete;
+      };
+    };
+    TaskID none(0);
+    TaskRegion region(3);
+    // block 0 runs ahead of block 1, which has to wait for a message twice
+    auto a0 = region[0].AddTask<SimpleTask>("a", Record("a0"), none);
+    auto c0 = region[0].AddTask<SimpleTask>(Record("c0"), a0);
+    region.AddCollectiveTask<SimpleTask>(0, "sum", Record("b0"), c0);
+    int ncalls = 0;
+    auto a1 = region[1].AddTask<SimpleTask>(
+        [&]() {
+          if (++ncalls < 3) return TaskStatus::incomplete;
+          order.push_back("a1");
+          return TaskStatus::complete;
+        },
+        none);
+    region[1].SetTaskName(a1, "a");
+    region.AddCollectiveTask<SimpleTask>(1, "sum", Record("b1"), a1);
+    auto sum = region.AddCollectiveTask<SimpleTask>(2, "a", Record("sum"), none);
+    region[2].SetTaskName(sum, "sum");
+
+    THEN("the lists only wait for each other at the collective tasks") {
+      REQUIRE(region.Execute() == TaskListStatus::complete);
+      REQUIRE(order == std::vector<std::string>{"a0", "c0", "a1", "sum", "b0", "b1"});
+    }
+  }
+}